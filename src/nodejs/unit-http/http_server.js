@@ -36,6 +36,14 @@ ServerResponse.prototype.headersSent = false;
 ServerResponse.prototype.destroyed = false;
 ServerResponse.prototype.finished = false;
 
+/* The client has gone away; the response is still to be ended. */
+ServerResponse.prototype._cancel = function _cancel() {
+    this._request.aborted = true;
+    this._request.emit('aborted');
+    this._request.emit('close');
+    this.emit('close');
+};
+
 ServerResponse.prototype.destroy = function destroy(error) {
     if (!this.destroyed) {
         this.destroyed = true;
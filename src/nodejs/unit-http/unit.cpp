@@ -269,6 +269,7 @@ Unit::create_server(napi_env env, napi_callback_info info)
     unit_init.callbacks.request_handler   = request_handler_cb;
     unit_init.callbacks.websocket_handler = websocket_handler_cb;
     unit_init.callbacks.close_handler     = close_handler_cb;
+    unit_init.callbacks.cancel_handler    = cancel_handler_cb;
     unit_init.callbacks.shm_ack_handler   = shm_ack_handler_cb;
     unit_init.callbacks.add_port          = add_port;
     unit_init.callbacks.remove_port       = remove_port;
@@ -433,6 +434,43 @@ Unit::close_handler(nxt_unit_request_info_t *req)
 }
 
 
+void
+Unit::cancel_handler_cb(nxt_unit_request_info_t *req)
+{
+    Unit  *obj;
+
+    obj = reinterpret_cast<Unit *>(req->unit->data);
+
+    obj->cancel_handler(req);
+}
+
+
+void
+Unit::cancel_handler(nxt_unit_request_info_t *req)
+{
+    napi_value  resp, resp_cancel;
+    req_data_t  *req_data;
+
+    req_data = (req_data_t *) req->data;
+
+    try {
+        nxt_handle_scope  scope(env());
+
+        resp = get_reference_value(req_data->resp_ref);
+
+        resp_cancel = get_named_property(resp, "_cancel");
+
+        nxt_async_context   async_context(env(), "cancel_handler");
+        nxt_callback_scope  async_scope(async_context);
+
+        make_callback(async_context, resp, resp_cancel);
+
+    } catch (exception &e) {
+        nxt_unit_req_warn(req, "cancel_handler: %s", e.str);
+    }
+}
+
+
 void
 Unit::shm_ack_handler_cb(nxt_unit_ctx_t *ctx)
 {
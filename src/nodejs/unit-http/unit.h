@@ -37,6 +37,9 @@ class Unit : public nxt_napi {
     static void close_handler_cb(nxt_unit_request_info_t *req);
     void close_handler(nxt_unit_request_info_t *req);
 
+    static void cancel_handler_cb(nxt_unit_request_info_t *req);
+    void cancel_handler(nxt_unit_request_info_t *req);
+
     static void shm_ack_handler_cb(nxt_unit_ctx_t *ctx);
     void shm_ack_handler(nxt_unit_ctx_t *ctx);
 
@@ -85,6 +85,13 @@ nxt_app_queue_notification_received(nxt_app_queue_t volatile *q)
 }
 
 
+nxt_inline nxt_bool_t
+nxt_app_queue_is_empty(nxt_app_queue_t volatile *q)
+{
+    return nxt_app_nncq_head(&q->queue) == nxt_app_nncq_tail(&q->queue);
+}
+
+
 nxt_inline nxt_bool_t
 nxt_app_queue_cancel(nxt_app_queue_t volatile *q, uint32_t cookie,
     uint32_t tracking)
@@ -506,6 +506,7 @@ static nxt_int_t
 nxt_proto_setup(nxt_task_t *task, nxt_process_t *process)
 {
     nxt_int_t              ret;
+    nxt_cpuset_t           cpuset;
     nxt_app_lang_module_t  *lang;
     nxt_common_app_conf_t  *app_conf;
 
@@ -540,6 +541,23 @@ nxt_proto_setup(nxt_task_t *task, nxt_process_t *process)
         return NXT_ERROR;
     }
 
+    /* Application processes inherit the CPU affinity of the prototype. */
+
+    if (app_conf->cpu_affinity.length != 0) {
+        ret = nxt_cpuset_parse(process->mem_pool, &cpuset,
+                               &app_conf->cpu_affinity);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            nxt_alert(task, "invalid \"cpu_affinity\" value \"%V\"",
+                      &app_conf->cpu_affinity);
+            return NXT_ERROR;
+        }
+
+        ret = nxt_cpuset_bind(task, cpuset.cpu, cpuset.n);
+        if (nxt_slow_path(ret == NXT_ERROR)) {
+            return NXT_ERROR;
+        }
+    }
+
     if (nxt_app->setup != NULL) {
         ret = nxt_app->setup(task, process, app_conf);
         if (nxt_slow_path(ret != NXT_OK)) {
@@ -585,6 +603,30 @@ nxt_proto_setup(nxt_task_t *task, nxt_process_t *process)
 static nxt_int_t
 nxt_proto_start(nxt_task_t *task, nxt_process_data_t *data)
 {
+    nxt_int_t  ret;
+
+    /*
+     * The application is loaded after the prototype has changed its root,
+     * working directory, and credentials, so application processes forked
+     * later inherit it in the same environment.
+     */
+
+    if (data->app->preload) {
+
+        if (nxt_app->preload != NULL) {
+            nxt_debug(task, "prototype preloads application");
+
+            ret = nxt_app->preload(task, data);
+            if (nxt_slow_path(ret != NXT_OK)) {
+                return ret;
+            }
+
+        } else {
+            nxt_log(task, NXT_LOG_WARN, "the \"%V\" application module "
+                    "does not support preload", &data->app->type);
+        }
+    }
+
     nxt_debug(task, "prototype waiting for clone messages");
 
     return NXT_OK;
@@ -645,7 +687,16 @@ nxt_proto_start_process_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 
     init->siblings = &nxt_proto_children;
 
+    if (nxt_app->before_fork != NULL) {
+        nxt_app->before_fork(task);
+    }
+
     ret = nxt_process_start(task, process);
+
+    if (ret != NXT_AGAIN && nxt_app->after_fork != NULL) {
+        nxt_app->after_fork(task);
+    }
+
     if (nxt_slow_path(ret == NXT_ERROR)) {
         nxt_process_use(task, process, -1);
 
@@ -1157,6 +1208,9 @@ nxt_unit_default_init(nxt_task_t *task, nxt_unit_init_t *init,
     init->log_fd = 2;
 
     init->shm_limit = conf->shm_limit;
+    init->shm_segment = conf->shm_segment;
+    init->shm_huge_pages = conf->shm_huge_pages;
+    init->busy_poll = conf->busy_poll;
     init->request_limit = conf->request_limit;
 
     return NXT_OK;
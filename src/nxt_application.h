@@ -30,6 +30,7 @@ typedef enum {
 typedef struct nxt_app_module_s  nxt_app_module_t;
 typedef nxt_int_t (*nxt_application_setup_t)(nxt_task_t *task,
     nxt_process_t *process, nxt_common_app_conf_t *conf);
+typedef void (*nxt_application_fork_t)(nxt_task_t *task);
 
 
 typedef struct {
@@ -114,6 +115,7 @@ struct nxt_common_app_conf_s {
     char                       *stderr_log;
 
     char                       *working_directory;
+    nxt_str_t                  cpu_affinity;
     nxt_conf_value_t           *environment;
 
     nxt_conf_value_t           *isolation;
@@ -121,6 +123,10 @@ struct nxt_common_app_conf_s {
 
     size_t                     shm_limit;
     uint32_t                   request_limit;
+    uint32_t                   shm_segment;
+    uint8_t                    shm_huge_pages;
+    uint32_t                   busy_poll;
+    uint8_t                    preload;
 
     nxt_fd_t                   shared_port_fd;
     nxt_fd_t                   shared_queue_fd;
@@ -151,6 +157,11 @@ struct nxt_app_module_s {
 
     nxt_application_setup_t    setup;
     nxt_process_start_t        start;
+    nxt_process_start_t        preload;
+
+    /* Called by the prototype around fork() of application processes. */
+    nxt_application_fork_t     before_fork;
+    nxt_application_fork_t     after_fork;
 };
 
 
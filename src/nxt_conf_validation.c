@@ -13,6 +13,7 @@
 #include <nxt_sockaddr.h>
 #include <nxt_http_route_addr.h>
 #include <nxt_regex.h>
+#include <nxt_port_memory_int.h>
 
 
 typedef enum {
@@ -131,10 +132,32 @@ static nxt_int_t nxt_conf_vldt_python_protocol(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_python_prefix(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_processes_policy(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_sendfile_root(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_cache_size(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_cache_stale(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_cache_collapse(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_restart_mode(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_restart_batch(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_restart_drain_timeout(
+    nxt_conf_validation_t *vldt, nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_threads(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_thread_stack_size(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_shm_segment(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_busy_poll(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_cpu_affinity(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_routes(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_routes_member(nxt_conf_validation_t *vldt,
@@ -209,6 +232,10 @@ static nxt_int_t nxt_conf_vldt_server_weight(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
 static nxt_int_t nxt_conf_vldt_access_log(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_tracing(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
+static nxt_int_t nxt_conf_vldt_tracing_sampling(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data);
 
 static nxt_int_t nxt_conf_vldt_isolation(nxt_conf_validation_t *vldt,
     nxt_conf_value_t *value, void *data);
@@ -241,6 +268,8 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_setting_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_http_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_websocket_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_static_members[];
+static nxt_conf_vldt_object_t  nxt_conf_vldt_http_cache_members[];
+static nxt_conf_vldt_object_t  nxt_conf_vldt_action_cache_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_forwarded_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_client_ip_members[];
 #if (NXT_TLS)
@@ -255,6 +284,7 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_php_target_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_wasm_access_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_common_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_app_limits_members[];
+static nxt_conf_vldt_object_t  nxt_conf_vldt_app_restart_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_app_processes_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_app_isolation_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_app_namespaces_members[];
@@ -265,6 +295,7 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_app_cgroup_members[];
 static nxt_conf_vldt_object_t  nxt_conf_vldt_app_automount_members[];
 #endif
 static nxt_conf_vldt_object_t  nxt_conf_vldt_access_log_members[];
+static nxt_conf_vldt_object_t  nxt_conf_vldt_tracing_members[];
 
 
 static nxt_conf_vldt_object_t  nxt_conf_vldt_root_members[] = {
@@ -296,6 +327,10 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_root_members[] = {
         .name       = nxt_string("access_log"),
         .type       = NXT_CONF_VLDT_STRING | NXT_CONF_VLDT_OBJECT,
         .validator  = nxt_conf_vldt_access_log,
+    }, {
+        .name       = nxt_string("tracing"),
+        .type       = NXT_CONF_VLDT_OBJECT,
+        .validator  = nxt_conf_vldt_tracing,
     },
 
     NXT_CONF_VLDT_END
@@ -308,6 +343,10 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_setting_members[] = {
         .type       = NXT_CONF_VLDT_OBJECT,
         .validator  = nxt_conf_vldt_object,
         .u.members  = nxt_conf_vldt_http_members,
+    }, {
+        .name       = nxt_string("cpu_affinity"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_cpu_affinity,
 #if (NXT_HAVE_NJS)
     }, {
         .name       = nxt_string("js_module"),
@@ -361,6 +400,11 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_http_members[] = {
         .type       = NXT_CONF_VLDT_OBJECT,
         .validator  = nxt_conf_vldt_object,
         .u.members  = nxt_conf_vldt_static_members,
+    }, {
+        .name       = nxt_string("cache"),
+        .type       = NXT_CONF_VLDT_OBJECT,
+        .validator  = nxt_conf_vldt_object,
+        .u.members  = nxt_conf_vldt_http_cache_members,
     }, {
         .name       = nxt_string("log_route"),
         .type       = NXT_CONF_VLDT_BOOLEAN,
@@ -401,6 +445,23 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_static_members[] = {
 };
 
 
+static nxt_conf_vldt_object_t  nxt_conf_vldt_http_cache_members[] = {
+    {
+        .name       = nxt_string("size"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_cache_size,
+        .u.string   = "size",
+    }, {
+        .name       = nxt_string("max_entry_size"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_cache_size,
+        .u.string   = "max_entry_size",
+    },
+
+    NXT_CONF_VLDT_END
+};
+
+
 static nxt_conf_vldt_object_t  nxt_conf_vldt_listener_members[] = {
     {
         .name       = nxt_string("pass"),
@@ -702,12 +763,36 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_action_common_members[] = {
 };
 
 
+static nxt_conf_vldt_object_t  nxt_conf_vldt_action_cache_members[] = {
+    {
+        .name       = nxt_string("key"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .flags      = NXT_CONF_VLDT_TSTR,
+    }, {
+        .name       = nxt_string("stale_while_revalidate"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_cache_stale,
+    }, {
+        .name       = nxt_string("collapse"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_cache_collapse,
+    },
+
+    NXT_CONF_VLDT_END
+};
+
+
 static nxt_conf_vldt_object_t  nxt_conf_vldt_pass_action_members[] = {
     {
         .name       = nxt_string("pass"),
         .type       = NXT_CONF_VLDT_STRING,
         .validator  = nxt_conf_vldt_pass,
         .flags      = NXT_CONF_VLDT_TSTR,
+    }, {
+        .name       = nxt_string("cache"),
+        .type       = NXT_CONF_VLDT_OBJECT,
+        .validator  = nxt_conf_vldt_object,
+        .u.members  = nxt_conf_vldt_action_cache_members,
     },
 
     NXT_CONF_VLDT_NEXT(nxt_conf_vldt_action_common_members)
@@ -778,6 +863,11 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_proxy_action_members[] = {
         .name       = nxt_string("proxy"),
         .type       = NXT_CONF_VLDT_STRING,
         .validator  = nxt_conf_vldt_proxy,
+    }, {
+        .name       = nxt_string("cache"),
+        .type       = NXT_CONF_VLDT_OBJECT,
+        .validator  = nxt_conf_vldt_object,
+        .u.members  = nxt_conf_vldt_action_cache_members,
     },
 
     NXT_CONF_VLDT_NEXT(nxt_conf_vldt_action_common_members)
@@ -1117,6 +1207,11 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_common_members[] = {
         .type       = NXT_CONF_VLDT_INTEGER | NXT_CONF_VLDT_OBJECT,
         .validator  = nxt_conf_vldt_processes,
         .u.members  = nxt_conf_vldt_app_processes_members,
+    }, {
+        .name       = nxt_string("restart"),
+        .type       = NXT_CONF_VLDT_OBJECT,
+        .validator  = nxt_conf_vldt_object,
+        .u.members  = nxt_conf_vldt_app_restart_members,
     }, {
         .name       = nxt_string("user"),
         .type       = NXT_CONF_VLDT_STRING,
@@ -1126,6 +1221,20 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_common_members[] = {
     }, {
         .name       = nxt_string("working_directory"),
         .type       = NXT_CONF_VLDT_STRING,
+    }, {
+        .name       = nxt_string("sendfile_root"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_sendfile_root,
+    }, {
+        .name       = nxt_string("ignore_client_abort"),
+        .type       = NXT_CONF_VLDT_BOOLEAN,
+    }, {
+        .name       = nxt_string("cpu_affinity"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_cpu_affinity,
+    }, {
+        .name       = nxt_string("preload"),
+        .type       = NXT_CONF_VLDT_BOOLEAN,
     }, {
         .name       = nxt_string("environment"),
         .type       = NXT_CONF_VLDT_OBJECT,
@@ -1158,6 +1267,36 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_app_limits_members[] = {
     }, {
         .name       = nxt_string("shm"),
         .type       = NXT_CONF_VLDT_INTEGER,
+    }, {
+        .name       = nxt_string("shm_segment"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_shm_segment,
+    }, {
+        .name       = nxt_string("shm_huge_pages"),
+        .type       = NXT_CONF_VLDT_BOOLEAN,
+    }, {
+        .name       = nxt_string("busy_poll"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_busy_poll,
+    },
+
+    NXT_CONF_VLDT_END
+};
+
+
+static nxt_conf_vldt_object_t  nxt_conf_vldt_app_restart_members[] = {
+    {
+        .name       = nxt_string("mode"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_restart_mode,
+    }, {
+        .name       = nxt_string("batch"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_restart_batch,
+    }, {
+        .name       = nxt_string("drain_timeout"),
+        .type       = NXT_CONF_VLDT_INTEGER,
+        .validator  = nxt_conf_vldt_restart_drain_timeout,
     },
 
     NXT_CONF_VLDT_END
@@ -1174,6 +1313,13 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_app_processes_members[] = {
     }, {
         .name       = nxt_string("idle_timeout"),
         .type       = NXT_CONF_VLDT_INTEGER,
+    }, {
+        .name       = nxt_string("policy"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .validator  = nxt_conf_vldt_processes_policy,
+    }, {
+        .name       = nxt_string("cooldown"),
+        .type       = NXT_CONF_VLDT_INTEGER,
     },
 
     NXT_CONF_VLDT_END
@@ -1374,6 +1520,21 @@ static nxt_conf_vldt_object_t  nxt_conf_vldt_access_log_members[] = {
 };
 
 
+static nxt_conf_vldt_object_t  nxt_conf_vldt_tracing_members[] = {
+    {
+        .name       = nxt_string("path"),
+        .type       = NXT_CONF_VLDT_STRING,
+        .flags      = NXT_CONF_VLDT_REQUIRED,
+    }, {
+        .name       = nxt_string("sampling"),
+        .type       = NXT_CONF_VLDT_NUMBER,
+        .validator  = nxt_conf_vldt_tracing_sampling,
+    },
+
+    NXT_CONF_VLDT_END
+};
+
+
 nxt_int_t
 nxt_conf_validate(nxt_conf_validation_t *vldt)
 {
@@ -2053,6 +2214,64 @@ nxt_conf_vldt_thread_stack_size(nxt_conf_validation_t *vldt,
 }
 
 
+static nxt_int_t
+nxt_conf_vldt_shm_segment(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    int64_t  size;
+
+    size = nxt_conf_get_number(value);
+
+    if (size < PORT_MMAP_CHUNK_SIZE || size > PORT_MMAP_DATA_SIZE) {
+        return nxt_conf_vldt_error(vldt, "The \"shm_segment\" number must "
+                                   "be between %d and %d.",
+                                   PORT_MMAP_CHUNK_SIZE, PORT_MMAP_DATA_SIZE);
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_busy_poll(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    int64_t  usec;
+
+    usec = nxt_conf_get_number(value);
+
+    if (usec < 0 || usec > 100000) {
+        return nxt_conf_vldt_error(vldt, "The \"busy_poll\" number must "
+                                   "be between 0 and 100000.");
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_cpu_affinity(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    nxt_str_t     str;
+    nxt_int_t     ret;
+    nxt_cpuset_t  cpuset;
+
+    nxt_conf_get_string(value, &str);
+
+    ret = nxt_cpuset_parse(vldt->pool, &cpuset, &str);
+
+    if (ret == NXT_DECLINED) {
+        return nxt_conf_vldt_error(vldt, "The \"cpu_affinity\" value must be "
+                                   "\"auto\" or a list of CPU numbers and "
+                                   "ranges less than %d, like \"0-3,8\".",
+                                   NXT_CPUSET_MAX);
+    }
+
+    return ret;
+}
+
+
 static nxt_int_t
 nxt_conf_vldt_routes(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
     void *data)
@@ -2755,6 +2974,7 @@ typedef struct {
     int64_t  spare;
     int64_t  max;
     int64_t  idle_timeout;
+    int64_t  cooldown;
 } nxt_conf_vldt_processes_conf_t;
 
 
@@ -2776,6 +2996,12 @@ static nxt_conf_map_t  nxt_conf_vldt_processes_conf_map[] = {
         NXT_CONF_MAP_INT64,
         offsetof(nxt_conf_vldt_processes_conf_t, idle_timeout),
     },
+
+    {
+        nxt_string("cooldown"),
+        NXT_CONF_MAP_INT64,
+        offsetof(nxt_conf_vldt_processes_conf_t, cooldown),
+    },
 };
 
 
@@ -2811,6 +3037,7 @@ nxt_conf_vldt_processes(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
     proc.spare = 0;
     proc.max = 1;
     proc.idle_timeout = 15;
+    proc.cooldown = 10;
 
     ret = nxt_conf_map_object(vldt->pool, value,
                               nxt_conf_vldt_processes_conf_map,
@@ -2855,6 +3082,184 @@ nxt_conf_vldt_processes(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
                                    "exceed %d.", NXT_INT32_T_MAX / 1000);
     }
 
+    if (proc.cooldown < 0) {
+        return nxt_conf_vldt_error(vldt, "The \"cooldown\" number must not "
+                                   "be negative.");
+    }
+
+    if (proc.cooldown > NXT_INT32_T_MAX / 1000) {
+        return nxt_conf_vldt_error(vldt, "The \"cooldown\" number must not "
+                                   "exceed %d.", NXT_INT32_T_MAX / 1000);
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_processes_policy(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    nxt_str_t  policy;
+
+    static const nxt_str_t  fixed = nxt_string("static");
+    static const nxt_str_t  adaptive = nxt_string("adaptive");
+
+    nxt_conf_get_string(value, &policy);
+
+    if (nxt_strstr_eq(&policy, &fixed) || nxt_strstr_eq(&policy, &adaptive)) {
+        return NXT_OK;
+    }
+
+    return nxt_conf_vldt_error(vldt, "The \"policy\" can either be "
+                                     "\"static\" or \"adaptive\".");
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_sendfile_root(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    nxt_str_t  root;
+
+    nxt_conf_get_string(value, &root);
+
+    if (root.length == 0 || root.start[0] != '/') {
+        return nxt_conf_vldt_error(vldt, "The \"sendfile_root\" must be "
+                                   "an absolute path.");
+    }
+
+    if (memchr(root.start, '\0', root.length) != NULL) {
+        return nxt_conf_vldt_error(vldt, "The \"sendfile_root\" must not "
+                                   "contain null character.");
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_cache_size(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
+    void *data)
+{
+    int64_t  size;
+
+    size = nxt_conf_get_number(value);
+
+    if (size < 0) {
+        return nxt_conf_vldt_error(vldt, "The \"%s\" number must be equal "
+                                   "to or greater than 0.", data);
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_cache_stale(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
+    void *data)
+{
+    int64_t  stale;
+
+    stale = nxt_conf_get_number(value);
+
+    if (stale < 0) {
+        return nxt_conf_vldt_error(vldt, "The \"stale_while_revalidate\" "
+                                   "number must be equal to or greater "
+                                   "than 0.");
+    }
+
+    if (stale > NXT_INT32_T_MAX) {
+        return nxt_conf_vldt_error(vldt, "The \"stale_while_revalidate\" "
+                                   "number must not exceed %d.",
+                                   NXT_INT32_T_MAX);
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_cache_collapse(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    nxt_str_t  collapse;
+
+    static const nxt_str_t  thread = nxt_string("thread");
+    static const nxt_str_t  all = nxt_string("all");
+
+    nxt_conf_get_string(value, &collapse);
+
+    if (nxt_strstr_eq(&collapse, &thread) || nxt_strstr_eq(&collapse, &all)) {
+        return NXT_OK;
+    }
+
+    return nxt_conf_vldt_error(vldt, "The \"collapse\" can either be "
+                                     "\"thread\" or \"all\".");
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_restart_mode(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    nxt_str_t  mode;
+
+    static const nxt_str_t  immediate = nxt_string("immediate");
+    static const nxt_str_t  rolling = nxt_string("rolling");
+
+    nxt_conf_get_string(value, &mode);
+
+    if (nxt_strstr_eq(&mode, &immediate) || nxt_strstr_eq(&mode, &rolling)) {
+        return NXT_OK;
+    }
+
+    return nxt_conf_vldt_error(vldt, "The \"mode\" can either be "
+                                     "\"immediate\" or \"rolling\".");
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_restart_batch(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    int64_t  batch;
+
+    batch = nxt_conf_get_number(value);
+
+    if (batch < 1) {
+        return nxt_conf_vldt_error(vldt, "The \"batch\" number must be "
+                                         "equal to or greater than 1.");
+    }
+
+    if (batch > NXT_INT32_T_MAX) {
+        return nxt_conf_vldt_error(vldt, "The \"batch\" number must not "
+                                         "exceed %d.", NXT_INT32_T_MAX);
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_restart_drain_timeout(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    int64_t  timeout;
+
+    timeout = nxt_conf_get_number(value);
+
+    if (timeout < 0) {
+        return nxt_conf_vldt_error(vldt, "The \"drain_timeout\" number must "
+                                         "not be negative.");
+    }
+
+    if (timeout > NXT_INT32_T_MAX / 1000) {
+        return nxt_conf_vldt_error(vldt, "The \"drain_timeout\" number must "
+                                         "not exceed %d.",
+                                         NXT_INT32_T_MAX / 1000);
+    }
+
     return NXT_OK;
 }
 
@@ -3441,3 +3846,48 @@ nxt_conf_vldt_access_log(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
 
     return NXT_OK;
 }
+
+
+static nxt_int_t
+nxt_conf_vldt_tracing(nxt_conf_validation_t *vldt, nxt_conf_value_t *value,
+    void *data)
+{
+    nxt_int_t         ret;
+    nxt_str_t         path;
+    nxt_conf_value_t  *member;
+
+    static nxt_str_t  path_str = nxt_string("path");
+
+    ret = nxt_conf_vldt_object(vldt, value, nxt_conf_vldt_tracing_members);
+    if (ret != NXT_OK) {
+        return ret;
+    }
+
+    member = nxt_conf_get_object_member(value, &path_str, NULL);
+
+    nxt_conf_get_string(member, &path);
+
+    if (path.length == 0) {
+        return nxt_conf_vldt_error(vldt,
+                                   "The \"path\" string must not be empty.");
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_conf_vldt_tracing_sampling(nxt_conf_validation_t *vldt,
+    nxt_conf_value_t *value, void *data)
+{
+    double  num_value;
+
+    num_value = nxt_conf_get_number(value);
+
+    if (num_value < 0 || num_value > 1) {
+        return nxt_conf_vldt_error(vldt, "The \"sampling\" number must be "
+                                   "between 0 and 1.");
+    }
+
+    return NXT_OK;
+}
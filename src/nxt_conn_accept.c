@@ -200,6 +200,8 @@ nxt_conn_accept(nxt_task_t *task, nxt_listen_event_t *lev, nxt_conn_t *c)
 
     engine->accepted_conns_cnt++;
 
+    nxt_probe2(conn_accept, c, c->socket.fd);
+
     nxt_conn_idle(engine, c);
 
     c->listen = lev;
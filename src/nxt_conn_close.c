@@ -116,6 +116,8 @@ nxt_conn_close_handler(nxt_task_t *task, void *obj, void *data)
     events_pending = nxt_fd_event_close(engine, &c->socket);
 
     if (events_pending == 0) {
+        nxt_probe2(conn_close, c, c->socket.fd);
+
         nxt_socket_close(task, c->socket.fd);
         c->socket.fd = -1;
 
@@ -154,6 +156,8 @@ nxt_conn_close_timer_handler(nxt_task_t *task, void *obj, void *data)
     engine = task->thread->engine;
 
     if (c->socket.fd != -1) {
+        nxt_probe2(conn_close, c, c->socket.fd);
+
         nxt_socket_close(task, c->socket.fd);
         c->socket.fd = -1;
 
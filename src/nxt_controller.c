@@ -33,6 +33,10 @@ typedef struct {
     nxt_uint_t        status;
     nxt_conf_value_t  *conf;
 
+    /* A non-JSON response body. */
+    nxt_buf_t         *body;
+    nxt_str_t         type;
+
     u_char            *title;
     nxt_str_t         detail;
     ssize_t           offset;
@@ -91,8 +95,12 @@ static void nxt_controller_process_status(nxt_task_t *task,
     nxt_controller_request_t *req);
 static void nxt_controller_status_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg, void *data);
+static nxt_conf_value_t *nxt_controller_status_get(
+    nxt_controller_request_t *req);
 static void nxt_controller_status_response(nxt_task_t *task,
     nxt_controller_request_t *req, nxt_str_t *path);
+static void nxt_controller_status_metrics(nxt_task_t *task,
+    nxt_controller_request_t *req);
 #if (NXT_TLS)
 static void nxt_controller_process_cert(nxt_task_t *task,
     nxt_controller_request_t *req, nxt_str_t *path);
@@ -121,6 +129,8 @@ static void nxt_controller_conf_store(nxt_task_t *task,
     nxt_conf_value_t *conf);
 static void nxt_controller_response(nxt_task_t *task,
     nxt_controller_request_t *req, nxt_controller_response_t *resp);
+static nxt_buf_t *nxt_controller_response_json(nxt_conn_t *c,
+    nxt_controller_response_t *resp);
 static u_char *nxt_controller_date(u_char *buf, nxt_realtime_t *now,
     struct tm *tm, size_t size, const char *format);
 
@@ -138,6 +148,7 @@ static nxt_controller_conf_t   nxt_controller_conf;
 static nxt_queue_t             nxt_controller_waiting_requests;
 static nxt_bool_t              nxt_controller_waiting_init_conf;
 static nxt_conf_value_t        *nxt_controller_status;
+static nxt_status_report_t     *nxt_controller_status_report;
 
 
 static const nxt_event_conn_state_t  nxt_controller_conn_read_state;
@@ -1068,7 +1079,7 @@ nxt_controller_process_request(nxt_task_t *task, nxt_controller_request_t *req)
     uint32_t                   i, count;
     nxt_str_t                  path;
     nxt_conn_t                 *c;
-    nxt_conf_value_t           *value;
+    nxt_conf_value_t           *value, *status_value;
     nxt_controller_response_t  resp;
 #if (NXT_TLS)
     nxt_conf_value_t           *certs;
@@ -1119,11 +1130,16 @@ nxt_controller_process_request(nxt_task_t *task, nxt_controller_request_t *req)
             goto invalid_method;
         }
 
-        if (nxt_controller_status == NULL) {
+        if (nxt_controller_status_report == NULL) {
             nxt_controller_process_status(task, req);
             return;
         }
 
+        if (nxt_str_eq(&path, "/status/metrics", 15)) {
+            nxt_controller_status_metrics(task, req);
+            return;
+        }
+
         if (path.length == 7) {
             path.length = 1;
 
@@ -1188,11 +1204,16 @@ nxt_controller_process_request(nxt_task_t *task, nxt_controller_request_t *req)
             goto invalid_method;
         }
 
-        if (nxt_controller_status == NULL) {
+        if (nxt_controller_status_report == NULL) {
             nxt_controller_process_status(task, req);
             return;
         }
 
+        status_value = nxt_controller_status_get(req);
+        if (nxt_slow_path(status_value == NULL)) {
+            goto alloc_fail;
+        }
+
         count = 2;
 #if (NXT_TLS)
         count++;
@@ -1227,7 +1248,7 @@ nxt_controller_process_request(nxt_task_t *task, nxt_controller_request_t *req)
 #endif
 
         nxt_conf_set_member(value, &config, nxt_controller_conf.root, i++);
-        nxt_conf_set_member(value, &status, nxt_controller_status, i);
+        nxt_conf_set_member(value, &status, status_value, i);
 
         resp.status = 200;
         resp.conf = value;
@@ -1624,7 +1645,7 @@ static void
 nxt_controller_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
     void *data)
 {
-    nxt_conf_value_t           *status;
+    nxt_status_report_t        *report;
     nxt_controller_request_t   *req;
     nxt_controller_response_t  resp;
 
@@ -1633,13 +1654,13 @@ nxt_controller_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
     req = data;
 
     if (msg->port_msg.type == NXT_PORT_MSG_RPC_READY) {
-        status = nxt_status_get((nxt_status_report_t *) msg->buf->mem.pos,
-                                req->conn->mem_pool);
+        report = (nxt_status_report_t *) msg->buf->mem.pos;
+
     } else {
-        status = NULL;
+        report = NULL;
     }
 
-    if (status == NULL) {
+    if (report == NULL) {
         nxt_queue_remove(&req->link);
 
         nxt_memzero(&resp, sizeof(nxt_controller_response_t));
@@ -1651,11 +1672,28 @@ nxt_controller_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
         nxt_controller_response(task, req, &resp);
     }
 
-    nxt_controller_status = status;
+    /*
+     * The status tree is built only if some of the waiting requests
+     * needs it; metrics are rendered directly from the report.
+     */
+    nxt_controller_status_report = report;
 
     nxt_controller_flush_requests(task);
 
     nxt_controller_status = NULL;
+    nxt_controller_status_report = NULL;
+}
+
+
+static nxt_conf_value_t *
+nxt_controller_status_get(nxt_controller_request_t *req)
+{
+    if (nxt_controller_status == NULL) {
+        nxt_controller_status = nxt_status_get(nxt_controller_status_report,
+                                               req->conn->mem_pool);
+    }
+
+    return nxt_controller_status;
 }
 
 
@@ -1666,10 +1704,21 @@ nxt_controller_status_response(nxt_task_t *task, nxt_controller_request_t *req,
     nxt_conf_value_t           *status;
     nxt_controller_response_t  resp;
 
-    status = nxt_conf_get_path(nxt_controller_status, path);
-
     nxt_memzero(&resp, sizeof(nxt_controller_response_t));
 
+    status = nxt_controller_status_get(req);
+
+    if (nxt_slow_path(status == NULL)) {
+        resp.status = 500;
+        resp.title = (u_char *) "Failed to get status.";
+        resp.offset = -1;
+
+        nxt_controller_response(task, req, &resp);
+        return;
+    }
+
+    status = nxt_conf_get_path(status, path);
+
     if (status == NULL) {
         resp.status = 404;
         resp.title = (u_char *) "Invalid path.";
@@ -1686,6 +1735,33 @@ nxt_controller_status_response(nxt_task_t *task, nxt_controller_request_t *req,
 }
 
 
+static void
+nxt_controller_status_metrics(nxt_task_t *task, nxt_controller_request_t *req)
+{
+    nxt_controller_response_t  resp;
+
+    nxt_memzero(&resp, sizeof(nxt_controller_response_t));
+
+    resp.body = nxt_status_metrics(nxt_controller_status_report,
+                                   req->conn->mem_pool);
+
+    if (nxt_slow_path(resp.body == NULL)) {
+        resp.status = 500;
+        resp.title = (u_char *) "Memory allocation failed.";
+        resp.offset = -1;
+
+        nxt_controller_response(task, req, &resp);
+        return;
+    }
+
+    resp.status = 200;
+    nxt_str_set(&resp.type,
+                "application/openmetrics-text; version=1.0.0; charset=utf-8");
+
+    nxt_controller_response(task, req, &resp);
+}
+
+
 #if (NXT_TLS)
 
 static void
@@ -2478,21 +2554,10 @@ static void
 nxt_controller_response(nxt_task_t *task, nxt_controller_request_t *req,
     nxt_controller_response_t *resp)
 {
-    size_t                  size;
-    nxt_str_t               status_line, str;
-    nxt_buf_t               *b, *body;
-    nxt_conn_t              *c;
-    nxt_uint_t              n;
-    nxt_conf_value_t        *value, *location;
-    nxt_conf_json_pretty_t  pretty;
-
-    static nxt_str_t  success_str = nxt_string("success");
-    static nxt_str_t  error_str = nxt_string("error");
-    static nxt_str_t  detail_str = nxt_string("detail");
-    static nxt_str_t  location_str = nxt_string("location");
-    static nxt_str_t  offset_str = nxt_string("offset");
-    static nxt_str_t  line_str = nxt_string("line");
-    static nxt_str_t  column_str = nxt_string("column");
+    size_t      size;
+    nxt_str_t   status_line, str, type;
+    nxt_buf_t   *b, *body;
+    nxt_conn_t  *c;
 
     static nxt_time_string_t  date_cache = {
         (nxt_atomic_uint_t) -1,
@@ -2527,6 +2592,97 @@ nxt_controller_response(nxt_task_t *task, nxt_controller_request_t *req,
     }
 
     c = req->conn;
+
+    if (resp->body != NULL) {
+        body = resp->body;
+        type = resp->type;
+
+    } else {
+        body = nxt_controller_response_json(c, resp);
+        if (nxt_slow_path(body == NULL)) {
+            nxt_controller_conn_close(task, c, req);
+            return;
+        }
+
+        nxt_str_set(&type, "application/json");
+    }
+
+    size = nxt_length("HTTP/1.1 " "\r\n") + status_line.length
+           + nxt_length("Server: " NXT_SERVER "\r\n")
+           + nxt_length("Date: Wed, 31 Dec 1986 16:40:00 GMT\r\n")
+           + nxt_length("Content-Type: \r\n") + type.length
+           + nxt_length("Content-Length: " "\r\n") + NXT_SIZE_T_LEN
+           + nxt_length("Connection: close\r\n")
+           + nxt_length("\r\n");
+
+    b = nxt_buf_mem_alloc(c->mem_pool, size, 0);
+    if (nxt_slow_path(b == NULL)) {
+        nxt_controller_conn_close(task, c, req);
+        return;
+    }
+
+    b->next = body;
+
+    nxt_str_set(&str, "HTTP/1.1 ");
+
+    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
+    b->mem.free = nxt_cpymem(b->mem.free, status_line.start,
+                             status_line.length);
+
+    nxt_str_set(&str, "\r\n"
+                      "Server: " NXT_SERVER "\r\n"
+                      "Date: ");
+
+    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
+
+    b->mem.free = nxt_thread_time_string(task->thread, &date_cache,
+                                         b->mem.free);
+
+    nxt_str_set(&str, "\r\n"
+                      "Content-Type: ");
+
+    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
+    b->mem.free = nxt_cpymem(b->mem.free, type.start, type.length);
+
+    nxt_str_set(&str, "\r\n"
+                      "Content-Length: ");
+
+    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
+
+    b->mem.free = nxt_sprintf(b->mem.free, b->mem.end, "%uz",
+                              nxt_buf_mem_used_size(&body->mem));
+
+    nxt_str_set(&str, "\r\n"
+                      "Connection: close\r\n"
+                      "\r\n");
+
+    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
+
+    c->write = b;
+    c->write_state = &nxt_controller_conn_write_state;
+
+    nxt_conn_write(task->thread->engine, c);
+}
+
+
+static nxt_buf_t *
+nxt_controller_response_json(nxt_conn_t *c, nxt_controller_response_t *resp)
+{
+    size_t                  size;
+    nxt_str_t               str;
+    nxt_buf_t               *body;
+    nxt_uint_t              n;
+    nxt_conf_value_t        *value, *location;
+    nxt_conf_json_pretty_t  pretty;
+
+    static nxt_str_t  success_str = nxt_string("success");
+    static nxt_str_t  error_str = nxt_string("error");
+    static nxt_str_t  detail_str = nxt_string("detail");
+    static nxt_str_t  location_str = nxt_string("location");
+    static nxt_str_t  offset_str = nxt_string("offset");
+    static nxt_str_t  line_str = nxt_string("line");
+    static nxt_str_t  column_str = nxt_string("column");
+
     value = resp->conf;
 
     if (value == NULL) {
@@ -2537,8 +2693,7 @@ nxt_controller_response(nxt_task_t *task, nxt_controller_request_t *req,
         value = nxt_conf_create_object(c->mem_pool, n);
 
         if (nxt_slow_path(value == NULL)) {
-            nxt_controller_conn_close(task, c, req);
-            return;
+            return NULL;
         }
 
         str.length = nxt_strlen(resp->title);
@@ -2585,8 +2740,7 @@ nxt_controller_response(nxt_task_t *task, nxt_controller_request_t *req,
 
     body = nxt_buf_mem_alloc(c->mem_pool, size, 0);
     if (nxt_slow_path(body == NULL)) {
-        nxt_controller_conn_close(task, c, req);
-        return;
+        return NULL;
     }
 
     nxt_memzero(&pretty, sizeof(nxt_conf_json_pretty_t));
@@ -2595,56 +2749,7 @@ nxt_controller_response(nxt_task_t *task, nxt_controller_request_t *req,
 
     body->mem.free = nxt_cpymem(body->mem.free, "\r\n", 2);
 
-    size = nxt_length("HTTP/1.1 " "\r\n") + status_line.length
-           + nxt_length("Server: " NXT_SERVER "\r\n")
-           + nxt_length("Date: Wed, 31 Dec 1986 16:40:00 GMT\r\n")
-           + nxt_length("Content-Type: application/json\r\n")
-           + nxt_length("Content-Length: " "\r\n") + NXT_SIZE_T_LEN
-           + nxt_length("Connection: close\r\n")
-           + nxt_length("\r\n");
-
-    b = nxt_buf_mem_alloc(c->mem_pool, size, 0);
-    if (nxt_slow_path(b == NULL)) {
-        nxt_controller_conn_close(task, c, req);
-        return;
-    }
-
-    b->next = body;
-
-    nxt_str_set(&str, "HTTP/1.1 ");
-
-    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
-    b->mem.free = nxt_cpymem(b->mem.free, status_line.start,
-                             status_line.length);
-
-    nxt_str_set(&str, "\r\n"
-                      "Server: " NXT_SERVER "\r\n"
-                      "Date: ");
-
-    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
-
-    b->mem.free = nxt_thread_time_string(task->thread, &date_cache,
-                                         b->mem.free);
-
-    nxt_str_set(&str, "\r\n"
-                      "Content-Type: application/json\r\n"
-                      "Content-Length: ");
-
-    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
-
-    b->mem.free = nxt_sprintf(b->mem.free, b->mem.end, "%uz",
-                              nxt_buf_mem_used_size(&body->mem));
-
-    nxt_str_set(&str, "\r\n"
-                      "Connection: close\r\n"
-                      "\r\n");
-
-    b->mem.free = nxt_cpymem(b->mem.free, str.start, str.length);
-
-    c->write = b;
-    c->write_state = &nxt_controller_conn_write_state;
-
-    nxt_conn_write(task->thread->engine, c);
+    return body;
 }
 
 
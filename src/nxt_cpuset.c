@@ -0,0 +1,208 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_main.h>
+
+
+static void nxt_cpuset_allowed(uint8_t *map);
+static nxt_int_t nxt_cpuset_number(u_char **pos, u_char *end);
+static nxt_int_t nxt_cpuset_create(nxt_mp_t *mp, nxt_cpuset_t *set,
+    uint8_t *map);
+
+
+/*
+ * The "auto" string stands for all CPUs the process is allowed to run on,
+ * otherwise the string is a comma separated list of CPU numbers and ranges.
+ * The resulting list is sorted and has no duplicates.
+ */
+
+nxt_int_t
+nxt_cpuset_parse(nxt_mp_t *mp, nxt_cpuset_t *set, nxt_str_t *str)
+{
+    u_char     *p, *end;
+    uint8_t    map[NXT_CPUSET_MAX / 8];
+    nxt_int_t  n, first, last;
+
+    nxt_memzero(map, sizeof(map));
+
+    if (nxt_str_eq(str, "auto", 4)) {
+        nxt_cpuset_allowed(map);
+
+        return nxt_cpuset_create(mp, set, map);
+    }
+
+    p = str->start;
+    end = p + str->length;
+
+    for ( ;; ) {
+        first = nxt_cpuset_number(&p, end);
+        if (first < 0) {
+            return NXT_DECLINED;
+        }
+
+        last = first;
+
+        if (p < end && *p == '-') {
+            p++;
+
+            last = nxt_cpuset_number(&p, end);
+            if (last < first) {
+                return NXT_DECLINED;
+            }
+        }
+
+        for (n = first; n <= last; n++) {
+            map[n / 8] |= 1 << (n % 8);
+        }
+
+        if (p == end) {
+            break;
+        }
+
+        if (*p != ',') {
+            return NXT_DECLINED;
+        }
+
+        p++;
+    }
+
+    return nxt_cpuset_create(mp, set, map);
+}
+
+
+static void
+nxt_cpuset_allowed(uint8_t *map)
+{
+    nxt_uint_t  n;
+
+#if (NXT_HAVE_SCHED_SETAFFINITY)
+
+    cpu_set_t   set;
+
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0) {
+
+        for (n = 0; n < NXT_CPUSET_MAX && n < CPU_SETSIZE; n++) {
+            if (CPU_ISSET(n, &set)) {
+                map[n / 8] |= 1 << (n % 8);
+            }
+        }
+
+        return;
+    }
+
+#endif
+
+    for (n = 0; n < NXT_CPUSET_MAX && n < nxt_ncpu; n++) {
+        map[n / 8] |= 1 << (n % 8);
+    }
+}
+
+
+static nxt_int_t
+nxt_cpuset_number(u_char **pos, u_char *end)
+{
+    u_char     *p;
+    nxt_int_t  n;
+
+    p = *pos;
+    n = 0;
+
+    if (p == end || *p < '0' || *p > '9') {
+        return -1;
+    }
+
+    while (p < end && *p >= '0' && *p <= '9') {
+        n = n * 10 + (*p++ - '0');
+
+        if (n >= NXT_CPUSET_MAX) {
+            return -1;
+        }
+    }
+
+    *pos = p;
+
+    return n;
+}
+
+
+static nxt_int_t
+nxt_cpuset_create(nxt_mp_t *mp, nxt_cpuset_t *set, uint8_t *map)
+{
+    uint32_t    *cpu;
+    nxt_uint_t  i, n;
+
+    n = 0;
+
+    for (i = 0; i < NXT_CPUSET_MAX; i++) {
+        n += (map[i / 8] >> (i % 8)) & 1;
+    }
+
+    if (n == 0) {
+        return NXT_DECLINED;
+    }
+
+    cpu = nxt_mp_alloc(mp, n * sizeof(uint32_t));
+    if (nxt_slow_path(cpu == NULL)) {
+        return NXT_ERROR;
+    }
+
+    set->n = n;
+    set->cpu = cpu;
+
+    for (i = 0; i < NXT_CPUSET_MAX; i++) {
+        if ((map[i / 8] >> (i % 8)) & 1) {
+            *cpu++ = i;
+        }
+    }
+
+    return NXT_OK;
+}
+
+
+/*
+ * Binds the calling thread to the CPUs, an empty list
+ * releases the thread to all CPUs allowed to the process.
+ */
+
+nxt_int_t
+nxt_cpuset_bind(nxt_task_t *task, uint32_t *cpu, nxt_uint_t n)
+{
+#if (NXT_HAVE_SCHED_SETAFFINITY)
+
+    nxt_uint_t  i;
+    cpu_set_t   set;
+
+    CPU_ZERO(&set);
+
+    if (n == 0) {
+        for (i = 0; i < CPU_SETSIZE; i++) {
+            CPU_SET(i, &set);
+        }
+
+    } else {
+        for (i = 0; i < n; i++) {
+            if (cpu[i] < CPU_SETSIZE) {
+                CPU_SET(cpu[i], &set);
+            }
+        }
+    }
+
+    if (nxt_slow_path(sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0)) {
+        nxt_alert(task, "sched_setaffinity() failed %E", nxt_errno);
+        return NXT_ERROR;
+    }
+
+    return NXT_OK;
+
+#else
+
+    if (n != 0) {
+        nxt_log(task, NXT_LOG_WARN, "CPU affinity is not supported");
+    }
+
+    return NXT_DECLINED;
+
+#endif
+}
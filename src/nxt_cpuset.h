@@ -0,0 +1,27 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NXT_CPUSET_H_INCLUDED_
+#define _NXT_CPUSET_H_INCLUDED_
+
+
+/* A list of CPU numbers, e.g. parsed from the "0-3,8-11" string. */
+
+typedef struct {
+    uint32_t   n;
+    uint32_t   *cpu;
+} nxt_cpuset_t;
+
+
+#define NXT_CPUSET_MAX  1024
+
+
+NXT_EXPORT nxt_int_t nxt_cpuset_parse(nxt_mp_t *mp, nxt_cpuset_t *set,
+    nxt_str_t *str);
+NXT_EXPORT nxt_int_t nxt_cpuset_bind(nxt_task_t *task, uint32_t *cpu,
+    nxt_uint_t n);
+
+
+#endif /* _NXT_CPUSET_H_INCLUDED_ */
@@ -257,9 +257,14 @@ nxt_event_engine_post(nxt_event_engine_t *engine, nxt_work_t *work)
     }
 #endif
 
-    nxt_locked_work_queue_add(&engine->locked_work_queue, work);
+    /*
+     * The engine is signaled only if the post queue was empty, otherwise
+     * the engine has been already signaled and will take all the works.
+     */
 
-    nxt_event_engine_signal(engine, 0);
+    if (nxt_atomic_work_queue_add(&engine->post_work_queue, work)) {
+        nxt_event_engine_signal(engine, 0);
+    }
 }
 
 
@@ -335,7 +340,7 @@ nxt_event_engine_post_handler(nxt_task_t *task, void *obj, void *data)
     thread = task->thread;
     engine = thread->engine;
 
-    nxt_locked_work_queue_move(thread, &engine->locked_work_queue,
+    nxt_atomic_work_queue_move(thread, &engine->post_work_queue,
                                &engine->fast_work_queue);
 }
 
@@ -427,6 +432,13 @@ nxt_event_engine_change(nxt_event_engine_t *engine,
         return NXT_ERROR;
     }
 
+    /*
+     * Posts which have signaled the previous event facility
+     * are not signaled again, so move them explicitly.
+     */
+    nxt_atomic_work_queue_move(engine->task.thread, &engine->post_work_queue,
+                               &engine->fast_work_queue);
+
     if (engine->signals != NULL) {
 
         if (!engine->event.signal_support) {
@@ -453,7 +453,7 @@ struct nxt_event_engine_s {
     nxt_work_queue_t           shutdown_work_queue;
     nxt_work_queue_t           close_work_queue;
 
-    nxt_locked_work_queue_t    locked_work_queue;
+    nxt_atomic_work_queue_t    post_work_queue;
 
     nxt_event_interface_t      event;
 
@@ -21,6 +21,8 @@
 #if (NXT_TLS)
 static ssize_t nxt_http_idle_io_read_handler(nxt_task_t *task, nxt_conn_t *c);
 static void nxt_http_conn_test(nxt_task_t *task, void *obj, void *data);
+static void nxt_h1p_conn_tls_account(nxt_task_t *task, nxt_conn_t *c,
+    nxt_bool_t done);
 #endif
 static ssize_t nxt_h1p_idle_io_read_handler(nxt_task_t *task, nxt_conn_t *c);
 static void nxt_h1p_conn_proto_init(nxt_task_t *task, void *obj, void *data);
@@ -55,6 +57,10 @@ static nxt_off_t nxt_h1p_request_body_bytes_sent(nxt_task_t *task,
     nxt_http_proto_t proto);
 static void nxt_h1p_request_discard(nxt_task_t *task, nxt_http_request_t *r,
     nxt_buf_t *last);
+static void nxt_h1p_request_disconnect_watch(nxt_task_t *task,
+    nxt_http_request_t *r);
+static void nxt_h1p_conn_request_closed(nxt_task_t *task, void *obj,
+    void *data);
 static void nxt_h1p_conn_request_error(nxt_task_t *task, void *obj, void *data);
 static void nxt_h1p_conn_request_timeout(nxt_task_t *task, void *obj,
     void *data);
@@ -139,6 +145,7 @@ const nxt_http_proto_table_t  nxt_http_proto[3] = {
         .send             = nxt_h1p_request_send,
         .body_bytes_sent  = nxt_h1p_request_body_bytes_sent,
         .discard          = nxt_h1p_request_discard,
+        .disconnect_watch = nxt_h1p_request_disconnect_watch,
         .close            = nxt_h1p_request_close,
 
         .peer_connect     = nxt_h1p_peer_connect,
@@ -376,6 +383,54 @@ nxt_http_conn_test(nxt_task_t *task, void *obj, void *data)
     tls->conn_init(task, tls, c);
 }
 
+
+/*
+ * A TLS connection is accounted once, before the HTTP/1 protocol state
+ * is created: the TLS library reports a completed handshake, whereas
+ * closing, an error, or a timeout before it mean a failed or abandoned
+ * handshake.
+ */
+
+void
+nxt_http_conn_tls_handshake(nxt_task_t *task, nxt_conn_t *c)
+{
+    nxt_h1p_conn_tls_account(task, c, 1);
+
+    c->tls_handshake = 1;
+}
+
+
+static void
+nxt_h1p_conn_tls_account(nxt_task_t *task, nxt_conn_t *c, nxt_bool_t done)
+{
+    nxt_socket_conf_t        *skcf;
+    nxt_status_traffic_t     *traffic;
+    nxt_socket_conf_joint_t  *joint;
+
+    if (c->u.tls == NULL || c->socket.data != NULL || c->tls_handshake) {
+        return;
+    }
+
+    joint = c->listen->socket.data;
+
+    if (nxt_slow_path(joint == NULL)) {
+        return;
+    }
+
+    skcf = joint->socket_conf;
+
+    traffic = nxt_router_traffic(task, skcf->router_conf, skcf->traffic);
+
+    if (traffic != NULL) {
+        if (done) {
+            traffic->tls_handshakes++;
+
+        } else {
+            traffic->tls_failures++;
+        }
+    }
+}
+
 #endif
 
 
@@ -1235,6 +1290,11 @@ nxt_h1p_request_header_send(nxt_task_t *task, nxt_http_request_t *r,
 
     r->header_sent = 1;
     h1p = r->proto.h1;
+
+    if (h1p->disconnect_watch) {
+        h1p->disconnect_watch = 0;
+        nxt_fd_event_block_read(task->thread->engine, &h1p->conn->socket);
+    }
     n = r->status;
 
     if (n >= NXT_HTTP_CONTINUE && n <= NXT_HTTP_LAST_INFORMATIONAL) {
@@ -1589,6 +1649,121 @@ nxt_h1p_request_discard(nxt_task_t *task, nxt_http_request_t *r,
 }
 
 
+/*
+ * The client connection is not read while an application handles the request,
+ * so a client that goes away is noticed only when the response is written.
+ * Watch the socket meanwhile to cancel the request in the application early.
+ *
+ * The socket is only peeked, so on TLS connections the records cannot be
+ * decrypted: a plaintext alert record, such as close_notify of TLS 1.2 and
+ * earlier, is treated as closing.  TLS 1.3 alerts are encrypted and look as
+ * a pipelined request, so then the watch stops and the client that goes
+ * away is noticed when the response is written, as without the watch.
+ */
+
+static void
+nxt_h1p_request_disconnect_watch(nxt_task_t *task, nxt_http_request_t *r)
+{
+    nxt_conn_t          *c;
+    nxt_h1proto_t       *h1p;
+    nxt_event_engine_t  *engine;
+
+    h1p = r->proto.h1;
+
+    if (r->header_sent || h1p->websocket || h1p->disconnect_watch) {
+        return;
+    }
+
+    nxt_debug(task, "h1p request disconnect watch");
+
+    h1p->disconnect_watch = 1;
+
+    c = h1p->conn;
+    engine = task->thread->engine;
+
+    c->socket.read_work_queue = &engine->fast_work_queue;
+    c->socket.read_handler = nxt_h1p_conn_request_closed;
+    c->socket.error_handler = nxt_h1p_conn_request_closed;
+
+    if (c->socket.read_ready) {
+        nxt_work_queue_add(&engine->fast_work_queue,
+                           nxt_h1p_conn_request_closed, task, c, h1p);
+        return;
+    }
+
+    if (nxt_fd_event_is_disabled(c->socket.read)) {
+        nxt_fd_event_enable_read(engine, &c->socket);
+    }
+}
+
+
+static void
+nxt_h1p_conn_request_closed(nxt_task_t *task, void *obj, void *data)
+{
+    u_char              ch;
+    ssize_t             n;
+    nxt_err_t           err;
+    nxt_conn_t          *c;
+    nxt_h1proto_t       *h1p;
+    nxt_http_request_t  *r;
+    nxt_event_engine_t  *engine;
+
+    c = obj;
+    h1p = data;
+
+    if (!h1p->disconnect_watch) {
+        return;
+    }
+
+    engine = task->thread->engine;
+
+    n = recv(c->socket.fd, &ch, 1, MSG_PEEK);
+
+    if (n < 0) {
+        err = nxt_socket_errno;
+
+        if (err == NXT_EAGAIN || err == NXT_EINTR) {
+            c->socket.read_ready = 0;
+
+            if (nxt_fd_event_is_disabled(c->socket.read)) {
+                nxt_fd_event_enable_read(engine, &c->socket);
+            }
+
+            return;
+        }
+    }
+
+    h1p->disconnect_watch = 0;
+    nxt_fd_event_block_read(engine, &c->socket);
+
+#if (NXT_TLS)
+    /* The TLS alert record content type. */
+
+    if (n > 0 && c->u.tls != NULL && ch == 0x15) {
+        n = 0;
+    }
+#endif
+
+    if (n > 0) {
+        /* A pipelined request, the client is still there. */
+        return;
+    }
+
+    r = h1p->request;
+
+    if (r == NULL || r->header_sent) {
+        return;
+    }
+
+    nxt_debug(task, "h1p conn request closed by client");
+
+    h1p->keepalive = 0;
+    c->socket.closed = 1;
+
+    nxt_http_request_error_handler(task, r, h1p);
+}
+
+
 static void
 nxt_h1p_conn_request_error(nxt_task_t *task, void *obj, void *data)
 {
@@ -1749,6 +1924,10 @@ nxt_h1p_conn_close(nxt_task_t *task, void *obj, void *data)
 
     nxt_debug(task, "h1p conn close");
 
+#if (NXT_TLS)
+    nxt_h1p_conn_tls_account(task, c, 0);
+#endif
+
     nxt_conn_active(task->thread->engine, c);
 
     nxt_h1p_shutdown(task, c);
@@ -1764,6 +1943,10 @@ nxt_h1p_conn_error(nxt_task_t *task, void *obj, void *data)
 
     nxt_debug(task, "h1p conn error");
 
+#if (NXT_TLS)
+    nxt_h1p_conn_tls_account(task, c, 0);
+#endif
+
     nxt_conn_active(task->thread->engine, c);
 
     nxt_h1p_shutdown(task, c);
@@ -1885,6 +2068,10 @@ nxt_h1p_idle_timeout(nxt_task_t *task, void *obj, void *data)
     c = nxt_read_timer_conn(timer);
     c->block_read = 1;
 
+#if (NXT_TLS)
+    nxt_h1p_conn_tls_account(task, c, 0);
+#endif
+
     nxt_conn_active(task->thread->engine, c);
 
     nxt_h1p_idle_response(task, c);
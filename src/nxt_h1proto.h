@@ -34,6 +34,7 @@ struct nxt_h1proto_s {
 
     uint8_t                   websocket_cont_expected;  /* 1 bit */
     uint8_t                   websocket_closed;         /* 1 bit */
+    uint8_t                   disconnect_watch;         /* 1 bit */
 
     uint32_t                  header_size;
 
@@ -109,11 +109,14 @@ typedef struct {
     nxt_http_field_t                *date;
     nxt_http_field_t                *content_type;
     nxt_http_field_t                *content_length;
+    nxt_http_field_t                *x_sendfile;
     nxt_off_t                       content_length_n;
 } nxt_http_response_t;
 
 
 typedef struct nxt_upstream_server_s  nxt_upstream_server_t;
+typedef struct nxt_http_cache_conf_s   nxt_http_cache_conf_t;
+typedef struct nxt_http_cache_ctx_s    nxt_http_cache_ctx_t;
 
 typedef struct {
     nxt_http_proto_t                proto;
@@ -129,6 +132,25 @@ typedef struct {
 } nxt_http_peer_t;
 
 
+/*
+ * Monotonic times at which the request phases completed;
+ * zero if the request has not reached the phase.
+ */
+
+typedef struct {
+    nxt_nsec_t                      header;
+    nxt_nsec_t                      body;
+    nxt_nsec_t                      route;
+    nxt_nsec_t                      app_queued;
+    nxt_nsec_t                      app_acked;
+    nxt_nsec_t                      app_done;
+    nxt_nsec_t                      upstream;
+    nxt_nsec_t                      upstream_header;
+    nxt_nsec_t                      upstream_done;
+    nxt_nsec_t                      response_header;
+} nxt_http_request_timing_t;
+
+
 struct nxt_http_request_s {
     nxt_http_proto_t                proto;
     nxt_socket_conf_joint_t         *conf;
@@ -141,6 +163,7 @@ struct nxt_http_request_s {
     const nxt_http_request_state_t  *state;
 
     nxt_nsec_t                      start_time;
+    nxt_http_request_timing_t       timing;
 
     nxt_str_t                       host;
     nxt_str_t                       server_name;
@@ -176,6 +199,9 @@ struct nxt_http_request_s {
     nxt_http_action_t               *action;
     void                            *req_rpc_data;
 
+    /* Traffic counters of the last matched route step. */
+    nxt_router_traffic_t            *route_traffic;
+
 #if (NXT_HAVE_REGEX)
     nxt_regex_match_t               *regex_match;
 #endif
@@ -183,6 +209,8 @@ struct nxt_http_request_s {
     nxt_http_peer_t                 *peer;
     nxt_buf_t                       *last;
 
+    nxt_http_cache_ctx_t            *cache;
+
     nxt_queue_link_t                app_link;   /* nxt_app_t.ack_waiting_req */
     nxt_event_engine_t              *engine;
     nxt_work_t                      err_work;
@@ -202,6 +230,7 @@ struct nxt_http_request_s {
     uint8_t                         inconsistent; /* 1 bit  */
     uint8_t                         error;        /* 1 bit  */
     uint8_t                         websocket_handshake;  /* 1 bit */
+    uint8_t                         x_sendfile;   /* 1 bit  */
 };
 
 
@@ -240,6 +269,7 @@ typedef struct {
     nxt_conf_value_t                *traverse_mounts;
     nxt_conf_value_t                *types;
     nxt_conf_value_t                *fallback;
+    nxt_conf_value_t                *cache;
 } nxt_http_action_conf_t;
 
 
@@ -259,6 +289,7 @@ struct nxt_http_action_s {
     nxt_tstr_t                      *rewrite;
     nxt_array_t                     *set_headers;  /* of nxt_http_field_t */
     nxt_http_action_t               *fallback;
+    nxt_http_cache_conf_t           *cache;
 };
 
 
@@ -270,6 +301,7 @@ typedef struct {
     void (*send)(nxt_task_t *task, nxt_http_request_t *r, nxt_buf_t *out);
     nxt_off_t (*body_bytes_sent)(nxt_task_t *task, nxt_http_proto_t proto);
     void (*discard)(nxt_task_t *task, nxt_http_request_t *r, nxt_buf_t *last);
+    void (*disconnect_watch)(nxt_task_t *task, nxt_http_request_t *r);
     void (*close)(nxt_task_t *task, nxt_http_proto_t proto,
         nxt_socket_conf_joint_t *joint);
 
@@ -322,6 +354,9 @@ nxt_int_t nxt_h1p_init(nxt_task_t *task);
 nxt_int_t nxt_http_response_hash_init(nxt_task_t *task);
 
 void nxt_http_conn_init(nxt_task_t *task, void *obj, void *data);
+#if (NXT_TLS)
+void nxt_http_conn_tls_handshake(nxt_task_t *task, nxt_conn_t *c);
+#endif
 nxt_http_request_t *nxt_http_request_create(nxt_task_t *task);
 void nxt_http_request_error(nxt_task_t *task, nxt_http_request_t *r,
     nxt_http_status_t status);
@@ -332,6 +367,8 @@ void nxt_http_request_ws_frame_start(nxt_task_t *task, nxt_http_request_t *r,
     nxt_buf_t *ws_frame);
 void nxt_http_request_send(nxt_task_t *task, nxt_http_request_t *r,
     nxt_buf_t *out);
+void nxt_http_request_disconnect_watch(nxt_task_t *task,
+    nxt_http_request_t *r);
 nxt_buf_t *nxt_http_buf_mem(nxt_task_t *task, nxt_http_request_t *r,
     size_t size);
 nxt_buf_t *nxt_http_buf_last(nxt_http_request_t *r);
@@ -394,11 +431,23 @@ nxt_int_t nxt_http_set_headers(nxt_http_request_t *r);
 nxt_int_t nxt_http_return_init(nxt_router_conf_t *rtcf,
     nxt_http_action_t *action, nxt_http_action_conf_t *acf);
 
+nxt_int_t nxt_http_cache_create(nxt_task_t *task);
+nxt_int_t nxt_http_cache_init(nxt_router_conf_t *rtcf,
+    nxt_http_action_t *action, nxt_http_action_conf_t *acf);
+nxt_http_action_t *nxt_http_cache_handler(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_http_action_t *action);
+void nxt_http_cache_header(nxt_task_t *task, nxt_http_request_t *r);
+void nxt_http_cache_body(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_buf_t *out);
+void nxt_http_cache_status(nxt_http_request_t *r, nxt_str_t *str);
+
 nxt_int_t nxt_http_static_init(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     nxt_http_action_t *action, nxt_http_action_conf_t *acf);
 nxt_int_t nxt_http_static_mtypes_init(nxt_mp_t *mp, nxt_lvlhsh_t *hash);
 nxt_int_t nxt_http_static_mtypes_hash_add(nxt_mp_t *mp, nxt_lvlhsh_t *hash,
     const nxt_str_t *exten, nxt_str_t *type);
+void nxt_http_static_sendfile(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_str_t *root, nxt_str_t *path);
 nxt_str_t *nxt_http_static_mtype_get(nxt_lvlhsh_t *hash,
     const nxt_str_t *exten);
 
@@ -0,0 +1,1664 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_router.h>
+#include <nxt_http.h>
+
+
+/*
+ * The response cache of the router.
+ *
+ * Responses of "pass" and "proxy" actions with the "cache" option are
+ * stored in memory shared by all router threads and indexed by a key built
+ * from the "key" template.  The key is prefixed with the "pass" or "proxy"
+ * value of the action, so the actions of different targets never share
+ * entries.  The freshness of a response is taken from its
+ * Cache-Control "s-maxage" or "max-age" directives or from Expires; the
+ * responses without explicit freshness, with "no-store", "no-cache",
+ * "private", Set-Cookie, or "Vary: *" are not stored.  Requests other than
+ * GET and requests with cookies or credentials bypass the cache.
+ *
+ * An expired response may still be served within its stale-while-revalidate
+ * period: the first request that finds it expired goes to the application
+ * or upstream to refresh it and the others get the stale response
+ * meanwhile.
+ *
+ * With the "collapse" option, concurrent requests that miss the same key
+ * wait for the first one instead of passing to the application or upstream
+ * too.  The response of the first request is then sent to the waiting ones
+ * even if it is not fresh enough to be stored, unless it is private.  The
+ * requests of different router threads are collapsed only with "all".
+ */
+
+
+struct nxt_http_cache_conf_s {
+    nxt_tstr_t                  *key;
+    nxt_str_t                   scope;
+    int32_t                     stale_while_revalidate;
+    uint8_t                     collapse;  /* 2 bits */
+};
+
+
+#define NXT_HTTP_CACHE_COLLAPSE_THREAD  1
+#define NXT_HTTP_CACHE_COLLAPSE_ALL     2
+
+
+typedef struct {
+    nxt_thread_mutex_t          mutex;
+    nxt_lvlhsh_t                hash;
+    nxt_queue_t                 lru;
+    size_t                      size;
+
+    /* The requests passed to collapse the others, by key. */
+    nxt_lvlhsh_t                locks;
+} nxt_http_cache_t;
+
+
+typedef struct {
+    nxt_queue_link_t            link;
+
+    nxt_str_t                   key;
+    uint32_t                    key_hash;
+
+    /* The references of the index and of the requests, under the mutex. */
+    uint32_t                    count;
+
+    nxt_time_t                  date;
+    nxt_time_t                  expires;
+    nxt_time_t                  stale;
+
+    size_t                      size;
+
+    nxt_http_field_t            *fields;
+    nxt_uint_t                  nfields;
+
+    /* Request fields listed in Vary and their values. */
+    nxt_http_field_t            *vary;
+    nxt_uint_t                  nvary;
+
+    u_char                      *body;
+    size_t                      body_length;
+
+    nxt_http_status_t           status:16;
+    uint8_t                     updating;  /* 1 bit */
+} nxt_http_cache_entry_t;
+
+
+typedef struct {
+    /* The key resides in the memory pool of the request holding the lock. */
+    nxt_str_t                   key;
+    uint32_t                    key_hash;
+
+    nxt_event_engine_t          *engine;
+    nxt_queue_t                 waiters;  /* of nxt_http_cache_ctx_t.link */
+} nxt_http_cache_lock_t;
+
+
+typedef enum {
+    NXT_HTTP_CACHE_BYPASS = 0,
+    NXT_HTTP_CACHE_MISS,
+    NXT_HTTP_CACHE_EXPIRED,
+    NXT_HTTP_CACHE_UPDATING,
+    NXT_HTTP_CACHE_COLLAPSED,
+    NXT_HTTP_CACHE_HIT,
+} nxt_http_cache_status_t;
+
+
+struct nxt_http_cache_ctx_s {
+    nxt_http_action_t           *action;
+    nxt_str_t                   key;
+    uint32_t                    key_hash;
+
+    /* The entry served, or the expired entry being revalidated. */
+    nxt_http_cache_entry_t      *entry;
+
+    nxt_http_field_t            *fields;
+    nxt_uint_t                  nfields;
+    nxt_http_field_t            *vary;
+    nxt_uint_t                  nvary;
+
+    u_char                      *body;
+    size_t                      body_length;
+    size_t                      body_size;
+
+    nxt_time_t                  date;
+    nxt_time_t                  expires;
+    nxt_time_t                  stale;
+
+    /* The lock held, or the link and the work of a waiting request. */
+    nxt_http_cache_lock_t       *lock;
+    nxt_queue_link_t            link;
+    nxt_work_t                  work;
+
+    nxt_http_cache_status_t     status:8;
+    uint8_t                     capture;  /* 1 bit */
+    uint8_t                     store;    /* 1 bit */
+    uint8_t                     retry;    /* 1 bit */
+};
+
+
+typedef struct {
+    nxt_int_t                   max_age;
+    nxt_int_t                   s_maxage;
+    nxt_int_t                   stale_while_revalidate;
+    uint8_t                     no_store;  /* 1 bit */
+} nxt_http_cache_control_t;
+
+
+static void nxt_http_cache_key_ready(nxt_task_t *task, void *obj, void *data);
+static void nxt_http_cache_key_error(nxt_task_t *task, void *obj, void *data);
+static nxt_int_t nxt_http_cache_key_scope(nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx);
+static void nxt_http_cache_continue(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_action_t *action);
+static nxt_http_action_t *nxt_http_cache_lookup(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx);
+static nxt_bool_t nxt_http_cache_vary_match(nxt_http_request_t *r,
+    nxt_http_cache_entry_t *entry);
+static nxt_bool_t nxt_http_cache_collapse(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx);
+static void nxt_http_cache_unlock(nxt_task_t *task, nxt_http_cache_ctx_t *ctx,
+    nxt_http_cache_entry_t *entry, nxt_bool_t retry);
+static void nxt_http_cache_wake(nxt_task_t *task, void *obj, void *data);
+static nxt_http_field_t *nxt_http_cache_request_field(nxt_http_request_t *r,
+    u_char *name, size_t length);
+static void nxt_http_cache_send(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx);
+static void nxt_http_cache_body_handler(nxt_task_t *task, void *obj,
+    void *data);
+static nxt_bool_t nxt_http_cache_response(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx);
+static nxt_bool_t nxt_http_cache_status_cacheable(nxt_uint_t status);
+static nxt_int_t nxt_http_cache_control_parse(nxt_http_field_t *field,
+    nxt_http_cache_control_t *cc);
+static nxt_int_t nxt_http_cache_vary_parse(nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx, nxt_http_field_t *field);
+static nxt_bool_t nxt_http_cache_hop_by_hop(nxt_http_field_t *field);
+static nxt_int_t nxt_http_cache_field_copy(nxt_mp_t *mp, nxt_http_field_t *dst,
+    nxt_http_field_t *src);
+static void nxt_http_cache_body_append(nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx, u_char *data, size_t size);
+static void nxt_http_cache_store(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx);
+static nxt_http_cache_entry_t *nxt_http_cache_entry_create(
+    nxt_http_cache_ctx_t *ctx);
+static void nxt_http_cache_remove(nxt_http_cache_entry_t *entry);
+static void nxt_http_cache_release(nxt_http_cache_entry_t *entry);
+static nxt_int_t nxt_http_cache_key_test(nxt_lvlhsh_query_t *lhq, void *data);
+static nxt_int_t nxt_http_cache_lock_test(nxt_lvlhsh_query_t *lhq, void *data);
+static void nxt_http_cache_cleanup(nxt_task_t *task, void *obj, void *data);
+
+
+static nxt_http_cache_t  nxt_http_cache;
+
+
+static const nxt_lvlhsh_proto_t  nxt_http_cache_proto  nxt_aligned(64) = {
+    NXT_LVLHSH_DEFAULT,
+    nxt_http_cache_key_test,
+    nxt_lvlhsh_alloc,
+    nxt_lvlhsh_free,
+};
+
+
+static const nxt_lvlhsh_proto_t  nxt_http_cache_lock_proto  nxt_aligned(64) = {
+    NXT_LVLHSH_DEFAULT,
+    nxt_http_cache_lock_test,
+    nxt_lvlhsh_alloc,
+    nxt_lvlhsh_free,
+};
+
+
+static const nxt_http_request_state_t  nxt_http_cache_send_state;
+
+
+static nxt_str_t  nxt_http_cache_statuses[] = {
+    nxt_string("BYPASS"),
+    nxt_string("MISS"),
+    nxt_string("EXPIRED"),
+    nxt_string("UPDATING"),
+    nxt_string("COLLAPSED"),
+    nxt_string("HIT"),
+};
+
+
+nxt_int_t
+nxt_http_cache_create(nxt_task_t *task)
+{
+    if (nxt_slow_path(nxt_thread_mutex_create(&nxt_http_cache.mutex)
+                      != NXT_OK))
+    {
+        return NXT_ERROR;
+    }
+
+    nxt_lvlhsh_init(&nxt_http_cache.hash);
+    nxt_queue_init(&nxt_http_cache.lru);
+    nxt_lvlhsh_init(&nxt_http_cache.locks);
+
+    return NXT_OK;
+}
+
+
+static nxt_conf_map_t  nxt_http_cache_conf[] = {
+    {
+        nxt_string("stale_while_revalidate"),
+        NXT_CONF_MAP_INT32,
+        offsetof(nxt_http_cache_conf_t, stale_while_revalidate),
+    },
+};
+
+
+nxt_int_t
+nxt_http_cache_init(nxt_router_conf_t *rtcf, nxt_http_action_t *action,
+    nxt_http_action_conf_t *acf)
+{
+    u_char                 *p;
+    nxt_int_t              ret;
+    nxt_str_t              str;
+    nxt_conf_value_t       *value;
+    nxt_http_cache_conf_t  *conf;
+
+    static nxt_str_t  key_path = nxt_string("/key");
+    static nxt_str_t  collapse_path = nxt_string("/collapse");
+    static nxt_str_t  default_key = nxt_string("$host$request_uri");
+
+    conf = nxt_mp_zget(rtcf->mem_pool, sizeof(nxt_http_cache_conf_t));
+    if (nxt_slow_path(conf == NULL)) {
+        return NXT_ERROR;
+    }
+
+    ret = nxt_conf_map_object(rtcf->mem_pool, acf->cache, nxt_http_cache_conf,
+                              nxt_nitems(nxt_http_cache_conf), conf);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        return NXT_ERROR;
+    }
+
+    value = nxt_conf_get_path(acf->cache, &key_path);
+
+    if (value != NULL) {
+        nxt_conf_get_string(value, &str);
+
+    } else {
+        str = default_key;
+    }
+
+    conf->key = nxt_tstr_compile(rtcf->tstr_state, &str, 0);
+    if (nxt_slow_path(conf->key == NULL)) {
+        return NXT_ERROR;
+    }
+
+    value = (acf->proxy != NULL) ? acf->proxy : acf->pass;
+
+    nxt_conf_get_string(value, &str);
+
+    p = nxt_mp_nget(rtcf->mem_pool, str.length + 1);
+    if (nxt_slow_path(p == NULL)) {
+        return NXT_ERROR;
+    }
+
+    conf->scope.start = p;
+    conf->scope.length = str.length + 1;
+
+    p = nxt_cpymem(p, str.start, str.length);
+    *p = ' ';
+
+    value = nxt_conf_get_path(acf->cache, &collapse_path);
+
+    if (value != NULL) {
+        nxt_conf_get_string(value, &str);
+
+        conf->collapse = nxt_str_eq(&str, "all", 3)
+                         ? NXT_HTTP_CACHE_COLLAPSE_ALL
+                         : NXT_HTTP_CACHE_COLLAPSE_THREAD;
+    }
+
+    action->cache = conf;
+
+    return NXT_OK;
+}
+
+
+nxt_http_action_t *
+nxt_http_cache_handler(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_action_t *action)
+{
+    nxt_int_t              ret;
+    nxt_router_conf_t      *rtcf;
+    nxt_http_cache_ctx_t   *ctx;
+    nxt_http_cache_conf_t  *conf;
+
+    ctx = nxt_mp_zget(r->mem_pool, sizeof(nxt_http_cache_ctx_t));
+    if (nxt_slow_path(ctx == NULL)) {
+        return NXT_HTTP_ACTION_ERROR;
+    }
+
+    r->cache = ctx;
+    ctx->action = action;
+    ctx->status = NXT_HTTP_CACHE_BYPASS;
+
+    rtcf = r->conf->socket_conf->router_conf;
+
+    if (rtcf->cache_size == 0
+        || !nxt_str_eq(r->method, "GET", 3)
+        || r->cookie != NULL
+        || r->authorization != NULL)
+    {
+        nxt_debug(task, "http cache bypass");
+        return action;
+    }
+
+    ret = nxt_mp_cleanup(r->mem_pool, nxt_http_cache_cleanup, &r->task,
+                         ctx, NULL);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        return NXT_HTTP_ACTION_ERROR;
+    }
+
+    conf = action->cache;
+
+    if (nxt_tstr_is_const(conf->key)) {
+        nxt_tstr_str(conf->key, &ctx->key);
+
+        if (nxt_slow_path(nxt_http_cache_key_scope(r, ctx) != NXT_OK)) {
+            return NXT_HTTP_ACTION_ERROR;
+        }
+
+        return nxt_http_cache_lookup(task, r, ctx);
+    }
+
+    ret = nxt_tstr_query_init(&r->tstr_query, rtcf->tstr_state, &r->tstr_cache,
+                              r, r->mem_pool);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        return NXT_HTTP_ACTION_ERROR;
+    }
+
+    nxt_tstr_query(task, r->tstr_query, conf->key, &ctx->key);
+    nxt_tstr_query_resolve(task, r->tstr_query, ctx, nxt_http_cache_key_ready,
+                           nxt_http_cache_key_error);
+    return NULL;
+}
+
+
+static void
+nxt_http_cache_key_ready(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_http_action_t     *action;
+    nxt_http_request_t    *r;
+    nxt_http_cache_ctx_t  *ctx;
+
+    r = obj;
+    ctx = data;
+
+    if (nxt_slow_path(nxt_http_cache_key_scope(r, ctx) != NXT_OK)) {
+        nxt_http_request_error(task, r, NXT_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    action = nxt_http_cache_lookup(task, r, ctx);
+
+    nxt_http_cache_continue(task, r, action);
+}
+
+
+static nxt_int_t
+nxt_http_cache_key_scope(nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx)
+{
+    u_char     *p;
+    nxt_str_t  *scope;
+
+    scope = &ctx->action->cache->scope;
+
+    p = nxt_mp_nget(r->mem_pool, scope->length + ctx->key.length);
+    if (nxt_slow_path(p == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_memcpy(p, scope->start, scope->length);
+    nxt_memcpy(p + scope->length, ctx->key.start, ctx->key.length);
+
+    ctx->key.start = p;
+    ctx->key.length += scope->length;
+
+    return NXT_OK;
+}
+
+
+static void
+nxt_http_cache_key_error(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = obj;
+
+    nxt_http_request_error(task, r, NXT_HTTP_INTERNAL_SERVER_ERROR);
+}
+
+
+static void
+nxt_http_cache_continue(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_action_t *action)
+{
+    if (action == NULL) {
+        return;
+    }
+
+    if (nxt_slow_path(action == NXT_HTTP_ACTION_ERROR)) {
+        nxt_http_request_error(task, r, NXT_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    nxt_http_request_action(task, r, action);
+}
+
+
+static nxt_http_action_t *
+nxt_http_cache_lookup(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx)
+{
+    nxt_time_t              now;
+    nxt_lvlhsh_query_t      lhq;
+    nxt_http_cache_entry_t  *entry;
+
+    nxt_debug(task, "http cache key: \"%V\"", &ctx->key);
+
+    ctx->key_hash = nxt_djb_hash(ctx->key.start, ctx->key.length);
+
+    lhq.key_hash = ctx->key_hash;
+    lhq.key = ctx->key;
+    lhq.proto = &nxt_http_cache_proto;
+
+    now = nxt_thread_time(task->thread);
+
+    ctx->status = NXT_HTTP_CACHE_MISS;
+
+    nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+
+    if (nxt_lvlhsh_find(&nxt_http_cache.hash, &lhq) == NXT_OK) {
+        entry = lhq.value;
+
+        if (!nxt_http_cache_vary_match(r, entry)) {
+            /* The response will replace the entry if cacheable. */
+
+        } else if (now < entry->expires) {
+            ctx->status = NXT_HTTP_CACHE_HIT;
+
+        } else if (now < entry->stale && entry->updating) {
+            ctx->status = NXT_HTTP_CACHE_UPDATING;
+
+        } else {
+            ctx->status = NXT_HTTP_CACHE_EXPIRED;
+
+            if (now < entry->stale) {
+                /* This request refreshes the entry while others get it. */
+                entry->updating = 1;
+                entry->count++;
+                ctx->entry = entry;
+            }
+        }
+
+        if (ctx->status == NXT_HTTP_CACHE_HIT
+            || ctx->status == NXT_HTTP_CACHE_UPDATING)
+        {
+            entry->count++;
+            ctx->entry = entry;
+
+            nxt_queue_remove(&entry->link);
+            nxt_queue_insert_head(&nxt_http_cache.lru, &entry->link);
+        }
+    }
+
+    if (ctx->entry == NULL
+        && ctx->action->cache->collapse != 0
+        && nxt_http_cache_collapse(task, r, ctx))
+    {
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        nxt_debug(task, "http cache waits for \"%V\"", &ctx->key);
+
+        return NULL;
+    }
+
+    nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+    nxt_debug(task, "http cache %V", &nxt_http_cache_statuses[ctx->status]);
+
+    if (ctx->status == NXT_HTTP_CACHE_HIT
+        || ctx->status == NXT_HTTP_CACHE_UPDATING)
+    {
+        nxt_http_cache_send(task, r, ctx);
+        return NULL;
+    }
+
+    ctx->capture = 1;
+
+    return ctx->action;
+}
+
+
+/*
+ * The cache mutex must be locked.  Returns 1 if the request waits for
+ * another one, or 0 if it is passed holding the lock, if any.
+ */
+
+static nxt_bool_t
+nxt_http_cache_collapse(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx)
+{
+    nxt_int_t              ret;
+    nxt_event_engine_t     *engine;
+    nxt_lvlhsh_query_t     lhq;
+    nxt_http_cache_lock_t  *lock;
+
+    engine = task->thread->engine;
+
+    lhq.key_hash = ctx->key_hash;
+    lhq.key = ctx->key;
+    lhq.proto = &nxt_http_cache_lock_proto;
+
+    if (nxt_lvlhsh_find(&nxt_http_cache.locks, &lhq) == NXT_OK) {
+        lock = lhq.value;
+
+        if (lock->engine != engine
+            && ctx->action->cache->collapse != NXT_HTTP_CACHE_COLLAPSE_ALL)
+        {
+            return 0;
+        }
+
+        ctx->work.handler = nxt_http_cache_wake;
+        ctx->work.task = &r->task;
+        ctx->work.obj = r;
+        ctx->work.data = ctx;
+        ctx->work.next = NULL;
+
+        nxt_queue_insert_tail(&lock->waiters, &ctx->link);
+
+        /*
+         * The request memory pool is retained while the request is linked
+         * in the waiters and is released by nxt_http_cache_wake().
+         */
+        nxt_mp_retain(r->mem_pool);
+
+        return 1;
+    }
+
+    lock = nxt_malloc(sizeof(nxt_http_cache_lock_t));
+    if (nxt_slow_path(lock == NULL)) {
+        return 0;
+    }
+
+    lock->key = ctx->key;
+    lock->key_hash = ctx->key_hash;
+    lock->engine = engine;
+    nxt_queue_init(&lock->waiters);
+
+    lhq.replace = 0;
+    lhq.value = lock;
+    lhq.pool = NULL;
+
+    ret = nxt_lvlhsh_insert(&nxt_http_cache.locks, &lhq);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        nxt_free(lock);
+        return 0;
+    }
+
+    ctx->lock = lock;
+
+    return 0;
+}
+
+
+/*
+ * Passes the entry, if any, to the requests waiting for the lock; "retry"
+ * means the request failed and the waiting ones should look up again.
+ */
+
+static void
+nxt_http_cache_unlock(nxt_task_t *task, nxt_http_cache_ctx_t *ctx,
+    nxt_http_cache_entry_t *entry, nxt_bool_t retry)
+{
+    nxt_queue_link_t       *link;
+    nxt_lvlhsh_query_t     lhq;
+    nxt_http_cache_ctx_t   *waiter;
+    nxt_http_cache_lock_t  *lock;
+
+    lock = ctx->lock;
+
+    if (lock == NULL) {
+        return;
+    }
+
+    ctx->lock = NULL;
+
+    lhq.key_hash = lock->key_hash;
+    lhq.key = lock->key;
+    lhq.proto = &nxt_http_cache_lock_proto;
+    lhq.pool = NULL;
+
+    nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+
+    (void) nxt_lvlhsh_delete(&nxt_http_cache.locks, &lhq);
+
+    nxt_queue_each(waiter, &lock->waiters, nxt_http_cache_ctx_t, link) {
+
+        if (entry != NULL) {
+            entry->count++;
+        }
+
+        waiter->entry = entry;
+        waiter->retry = retry;
+
+    } nxt_queue_loop;
+
+    nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+    nxt_debug(task, "http cache unlock \"%V\"", &lock->key);
+
+    /* The waiters are not accessible to other threads anymore. */
+
+    while (!nxt_queue_is_empty(&lock->waiters)) {
+        link = nxt_queue_first(&lock->waiters);
+        nxt_queue_remove(link);
+
+        waiter = nxt_queue_link_data(link, nxt_http_cache_ctx_t, link);
+
+        nxt_event_engine_post(waiter->work.task->thread->engine,
+                              &waiter->work);
+    }
+
+    nxt_free(lock);
+}
+
+
+static void
+nxt_http_cache_wake(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_mp_t                *mp;
+    nxt_http_action_t       *action;
+    nxt_http_request_t      *r;
+    nxt_http_cache_ctx_t    *ctx;
+    nxt_http_cache_entry_t  *entry;
+
+    r = obj;
+    ctx = data;
+
+    mp = r->mem_pool;
+    entry = ctx->entry;
+
+    if (r->proto.any == NULL) {
+        /* The request has been closed meanwhile. */
+        goto done;
+    }
+
+    if (entry != NULL && nxt_http_cache_vary_match(r, entry)) {
+        ctx->status = NXT_HTTP_CACHE_COLLAPSED;
+
+        nxt_debug(task, "http cache collapsed \"%V\"", &ctx->key);
+
+        nxt_http_cache_send(task, r, ctx);
+        goto done;
+    }
+
+    if (entry != NULL) {
+        nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+        nxt_http_cache_release(entry);
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        ctx->entry = NULL;
+
+    } else if (ctx->retry) {
+        ctx->retry = 0;
+
+        action = nxt_http_cache_lookup(task, r, ctx);
+
+        nxt_http_cache_continue(task, r, action);
+        goto done;
+    }
+
+    ctx->status = NXT_HTTP_CACHE_MISS;
+    ctx->capture = 1;
+
+    nxt_http_request_action(task, r, ctx->action);
+
+done:
+
+    nxt_mp_release(mp);
+}
+
+
+static nxt_bool_t
+nxt_http_cache_vary_match(nxt_http_request_t *r, nxt_http_cache_entry_t *entry)
+{
+    nxt_uint_t        i;
+    nxt_http_field_t  *vary, *field;
+
+    for (i = 0; i < entry->nvary; i++) {
+        vary = &entry->vary[i];
+
+        field = nxt_http_cache_request_field(r, vary->name, vary->name_length);
+
+        if (field == NULL) {
+            if (vary->value_length != 0) {
+                return 0;
+            }
+
+            continue;
+        }
+
+        if (field->value_length != vary->value_length
+            || memcmp(field->value, vary->value, vary->value_length) != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+static nxt_http_field_t *
+nxt_http_cache_request_field(nxt_http_request_t *r, u_char *name,
+    size_t length)
+{
+    nxt_http_field_t  *field;
+
+    nxt_list_each(field, r->fields) {
+
+        if (field->name_length == length
+            && nxt_memcasecmp(field->name, name, length) == 0)
+        {
+            return field;
+        }
+
+    } nxt_list_loop;
+
+    return NULL;
+}
+
+
+static void
+nxt_http_cache_send(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx)
+{
+    u_char                  *p;
+    nxt_uint_t              i;
+    nxt_time_t              age;
+    nxt_http_field_t        *field;
+    nxt_http_cache_entry_t  *entry;
+
+    entry = ctx->entry;
+
+    for (i = 0; i < entry->nfields; i++) {
+        field = nxt_list_add(r->resp.fields);
+        if (nxt_slow_path(field == NULL)) {
+            goto fail;
+        }
+
+        *field = entry->fields[i];
+    }
+
+    field = nxt_list_zero_add(r->resp.fields);
+    if (nxt_slow_path(field == NULL)) {
+        goto fail;
+    }
+
+    nxt_http_field_name_set(field, "Age");
+
+    p = nxt_mp_nget(r->mem_pool, NXT_TIME_T_LEN);
+    if (nxt_slow_path(p == NULL)) {
+        goto fail;
+    }
+
+    age = nxt_max(nxt_thread_time(task->thread) - entry->date, 0);
+
+    field->value = p;
+    field->value_length = nxt_sprintf(p, p + NXT_TIME_T_LEN, "%T", age) - p;
+
+    r->status = entry->status;
+    r->resp.content_length_n = entry->body_length;
+
+    r->state = &nxt_http_cache_send_state;
+
+    if (entry->body_length == 0) {
+        nxt_http_request_header_send(task, r, NULL, NULL);
+
+    } else {
+        nxt_http_request_header_send(task, r, nxt_http_cache_body_handler,
+                                     ctx);
+    }
+
+    return;
+
+fail:
+
+    nxt_http_request_error(task, r, NXT_HTTP_INTERNAL_SERVER_ERROR);
+}
+
+
+static void
+nxt_http_cache_body_handler(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_buf_t               *b;
+    nxt_http_request_t      *r;
+    nxt_http_cache_ctx_t    *ctx;
+    nxt_http_cache_entry_t  *entry;
+
+    r = obj;
+    ctx = data;
+    entry = ctx->entry;
+
+    /* The entry is referenced until the request memory pool is destroyed. */
+
+    b = nxt_http_buf_mem(task, r, 0);
+    if (nxt_slow_path(b == NULL)) {
+        return;
+    }
+
+    b->mem.start = entry->body;
+    b->mem.pos = entry->body;
+    b->mem.free = entry->body + entry->body_length;
+    b->mem.end = b->mem.free;
+
+    b->next = nxt_http_buf_last(r);
+
+    nxt_http_request_send(task, r, b);
+}
+
+
+static const nxt_http_request_state_t  nxt_http_cache_send_state
+    nxt_aligned(64) =
+{
+    .error_handler = nxt_http_request_error_handler,
+};
+
+
+void
+nxt_http_cache_header(nxt_task_t *task, nxt_http_request_t *r)
+{
+    nxt_http_cache_ctx_t  *ctx;
+
+    ctx = r->cache;
+
+    if (!ctx->capture) {
+        return;
+    }
+
+    ctx->capture = nxt_http_cache_response(task, r, ctx);
+
+    if (!ctx->capture) {
+        nxt_http_cache_unlock(task, ctx, NULL, 0);
+    }
+}
+
+
+/*
+ * Returns 1 if the response is to be stored, or to be sent to the requests
+ * waiting for the lock.
+ */
+
+static nxt_bool_t
+nxt_http_cache_response(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx)
+{
+    size_t                    max_size;
+    nxt_int_t                 ret;
+    nxt_uint_t                n;
+    nxt_time_t                now, expires, freshness;
+    nxt_http_field_t          *field, *copy;
+    nxt_router_conf_t         *rtcf;
+    nxt_http_cache_conf_t     *conf;
+    nxt_http_cache_control_t  cc;
+
+    if (!nxt_http_cache_status_cacheable(r->status)) {
+        return 0;
+    }
+
+    rtcf = r->conf->socket_conf->router_conf;
+    max_size = rtcf->cache_max_entry_size;
+
+    if (r->resp.content_length_n > (nxt_off_t) max_size) {
+        return 0;
+    }
+
+    cc.max_age = -1;
+    cc.s_maxage = -1;
+    cc.stale_while_revalidate = -1;
+    cc.no_store = 0;
+
+    expires = -1;
+    n = 0;
+
+    nxt_list_each(field, r->resp.fields) {
+
+        if (field->skip) {
+            continue;
+        }
+
+        n++;
+
+        if (nxt_http_cache_hop_by_hop(field)) {
+            continue;
+        }
+
+        if (field->name_length == nxt_length("Cache-Control")
+            && nxt_memcasecmp(field->name, "Cache-Control",
+                              field->name_length) == 0)
+        {
+            ret = nxt_http_cache_control_parse(field, &cc);
+
+        } else if (field->name_length == nxt_length("Expires")
+                   && nxt_memcasecmp(field->name, "Expires",
+                                     field->name_length) == 0)
+        {
+            expires = nxt_time_parse(field->value, field->value_length);
+            ret = NXT_OK;
+
+            if (expires == -1) {
+                /* An invalid date means the response has already expired. */
+                expires = 0;
+            }
+
+        } else if (field->name_length == nxt_length("Set-Cookie")
+                   && nxt_memcasecmp(field->name, "Set-Cookie",
+                                     field->name_length) == 0)
+        {
+            ret = NXT_DECLINED;
+
+        } else if (field->name_length == nxt_length("Vary")
+                   && nxt_memcasecmp(field->name, "Vary",
+                                     field->name_length) == 0)
+        {
+            ret = nxt_http_cache_vary_parse(r, ctx, field);
+
+        } else {
+            ret = NXT_OK;
+        }
+
+        if (ret != NXT_OK) {
+            nxt_debug(task, "http cache: response is not cacheable");
+            return 0;
+        }
+
+    } nxt_list_loop;
+
+    now = nxt_thread_time(task->thread);
+
+    if (cc.no_store) {
+        return 0;
+    }
+
+    if (cc.s_maxage >= 0) {
+        freshness = cc.s_maxage;
+
+    } else if (cc.max_age >= 0) {
+        freshness = cc.max_age;
+
+    } else if (expires >= 0) {
+        freshness = nxt_max(expires - now, 0);
+
+    } else {
+        freshness = -1;
+    }
+
+    conf = ctx->action->cache;
+
+    ctx->date = now;
+    ctx->expires = now + freshness;
+    ctx->stale = ctx->expires
+                 + ((cc.stale_while_revalidate >= 0)
+                    ? cc.stale_while_revalidate
+                    : conf->stale_while_revalidate);
+
+    ctx->store = (freshness >= 0 && ctx->stale > now);
+
+    if (!ctx->store && ctx->lock == NULL) {
+        return 0;
+    }
+
+    /* The response fields may reside in port buffers released when sent. */
+
+    ctx->fields = nxt_mp_get(r->mem_pool, n * sizeof(nxt_http_field_t));
+    if (nxt_slow_path(ctx->fields == NULL)) {
+        return 0;
+    }
+
+    nxt_list_each(field, r->resp.fields) {
+
+        if (field->skip || nxt_http_cache_hop_by_hop(field)) {
+            continue;
+        }
+
+        copy = &ctx->fields[ctx->nfields];
+
+        if (nxt_http_cache_field_copy(r->mem_pool, copy, field) != NXT_OK) {
+            return 0;
+        }
+
+        ctx->nfields++;
+
+    } nxt_list_loop;
+
+    if (r->resp.content_length_n > 0) {
+        ctx->body_size = r->resp.content_length_n;
+
+        ctx->body = nxt_malloc(ctx->body_size);
+        if (nxt_slow_path(ctx->body == NULL)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+static nxt_bool_t
+nxt_http_cache_status_cacheable(nxt_uint_t status)
+{
+    /* The statuses cacheable by default, RFC 9110, Section 15.1. */
+
+    switch (status) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 410:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+
+static nxt_int_t
+nxt_http_cache_control_parse(nxt_http_field_t *field,
+    nxt_http_cache_control_t *cc)
+{
+    u_char     *p, *end, *name, *value;
+    size_t     name_length, value_length;
+    nxt_int_t  n;
+
+    p = field->value;
+    end = p + field->value_length;
+
+    while (p < end) {
+
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) {
+            p++;
+        }
+
+        name = p;
+
+        while (p < end && *p != '=' && *p != ',' && *p != ' ') {
+            p++;
+        }
+
+        name_length = p - name;
+
+        value = NULL;
+        value_length = 0;
+
+        if (p < end && *p == '=') {
+            p++;
+
+            if (p < end && *p == '"') {
+                p++;
+            }
+
+            value = p;
+
+            while (p < end && *p != ',' && *p != '"' && *p != ' ') {
+                p++;
+            }
+
+            value_length = p - value;
+
+            while (p < end && *p != ',') {
+                p++;
+            }
+        }
+
+        if (name_length == 0) {
+            continue;
+        }
+
+#define nxt_http_cache_directive(dir)                                         \
+    (name_length == nxt_length(dir)                                           \
+     && nxt_memcasecmp(name, dir, name_length) == 0)
+
+        if (nxt_http_cache_directive("no-store")
+            || nxt_http_cache_directive("no-cache")
+            || nxt_http_cache_directive("private"))
+        {
+            cc->no_store = 1;
+            continue;
+        }
+
+        if (value == NULL) {
+            continue;
+        }
+
+        n = nxt_int_parse(value, value_length);
+
+        if (nxt_http_cache_directive("max-age")) {
+            cc->max_age = (n >= 0) ? n : 0;
+
+        } else if (nxt_http_cache_directive("s-maxage")) {
+            cc->s_maxage = (n >= 0) ? n : 0;
+
+        } else if (nxt_http_cache_directive("stale-while-revalidate")) {
+            cc->stale_while_revalidate = (n >= 0) ? n : 0;
+        }
+
+#undef nxt_http_cache_directive
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_http_cache_vary_parse(nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx,
+    nxt_http_field_t *field)
+{
+    u_char            *p, *end, *name;
+    size_t            length;
+    nxt_uint_t        n;
+    nxt_http_field_t  *vary, *rf, *prev;
+
+    p = field->value;
+    end = p + field->value_length;
+
+    n = 1;
+
+    while (p < end) {
+        if (*p++ == ',') {
+            n++;
+        }
+    }
+
+    prev = ctx->vary;
+
+    vary = nxt_mp_get(r->mem_pool, (ctx->nvary + n) * sizeof(nxt_http_field_t));
+    if (nxt_slow_path(vary == NULL)) {
+        return NXT_ERROR;
+    }
+
+    if (prev != NULL) {
+        nxt_memcpy(vary, prev, ctx->nvary * sizeof(nxt_http_field_t));
+    }
+
+    ctx->vary = vary;
+
+    p = field->value;
+
+    while (p < end) {
+
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) {
+            p++;
+        }
+
+        name = p;
+
+        while (p < end && *p != ',' && *p != ' ' && *p != '\t') {
+            p++;
+        }
+
+        length = p - name;
+
+        if (length == 0) {
+            continue;
+        }
+
+        if (length == 1 && *name == '*') {
+            return NXT_DECLINED;
+        }
+
+        if (length > 255) {
+            return NXT_DECLINED;
+        }
+
+        vary = &ctx->vary[ctx->nvary];
+
+        nxt_memzero(vary, sizeof(nxt_http_field_t));
+
+        vary->name = nxt_mp_nget(r->mem_pool, length);
+        if (nxt_slow_path(vary->name == NULL)) {
+            return NXT_ERROR;
+        }
+
+        nxt_memcpy(vary->name, name, length);
+        vary->name_length = length;
+
+        rf = nxt_http_cache_request_field(r, name, length);
+
+        if (rf != NULL) {
+            vary->value = rf->value;
+            vary->value_length = rf->value_length;
+        }
+
+        ctx->nvary++;
+    }
+
+    return NXT_OK;
+}
+
+
+static nxt_bool_t
+nxt_http_cache_hop_by_hop(nxt_http_field_t *field)
+{
+    nxt_uint_t  i;
+
+    static const nxt_str_t  skip[] = {
+        nxt_string("Connection"),
+        nxt_string("Keep-Alive"),
+        nxt_string("Transfer-Encoding"),
+        nxt_string("Content-Length"),
+        nxt_string("Date"),
+        nxt_string("Age"),
+    };
+
+    if (field->hopbyhop) {
+        return 1;
+    }
+
+    for (i = 0; i < nxt_nitems(skip); i++) {
+        if (field->name_length == skip[i].length
+            && nxt_memcasecmp(field->name, skip[i].start,
+                              skip[i].length) == 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static nxt_int_t
+nxt_http_cache_field_copy(nxt_mp_t *mp, nxt_http_field_t *dst,
+    nxt_http_field_t *src)
+{
+    u_char  *p;
+
+    p = nxt_mp_nget(mp, src->name_length + src->value_length);
+    if (nxt_slow_path(p == NULL)) {
+        return NXT_ERROR;
+    }
+
+    *dst = *src;
+
+    dst->name = p;
+    p = nxt_cpymem(p, src->name, src->name_length);
+
+    dst->value = p;
+    nxt_memcpy(p, src->value, src->value_length);
+
+    return NXT_OK;
+}
+
+
+void
+nxt_http_cache_body(nxt_task_t *task, nxt_http_request_t *r, nxt_buf_t *out)
+{
+    nxt_buf_t             *b;
+    nxt_http_cache_ctx_t  *ctx;
+
+    ctx = r->cache;
+
+    if (!ctx->capture) {
+        return;
+    }
+
+    for (b = out; b != NULL; b = b->next) {
+
+        if (nxt_buf_is_file(b)) {
+            ctx->capture = 0;
+            nxt_http_cache_unlock(task, ctx, NULL, 0);
+            return;
+        }
+
+        if (nxt_buf_is_mem(b) && !nxt_buf_is_sync(b)) {
+            nxt_http_cache_body_append(r, ctx, b->mem.pos,
+                                       nxt_buf_mem_used_size(&b->mem));
+
+            if (!ctx->capture) {
+                nxt_http_cache_unlock(task, ctx, NULL, 0);
+                return;
+            }
+        }
+
+        if (nxt_buf_is_last(b)) {
+            nxt_http_cache_store(task, r, ctx);
+            return;
+        }
+    }
+}
+
+
+static void
+nxt_http_cache_body_append(nxt_http_request_t *r, nxt_http_cache_ctx_t *ctx,
+    u_char *data, size_t size)
+{
+    u_char             *p;
+    size_t             max_size, body_size;
+    nxt_router_conf_t  *rtcf;
+
+    if (size == 0) {
+        return;
+    }
+
+    if (ctx->body_length + size > ctx->body_size) {
+        rtcf = r->conf->socket_conf->router_conf;
+        max_size = rtcf->cache_max_entry_size;
+
+        body_size = nxt_max(ctx->body_size * 2, ctx->body_length + size);
+        body_size = nxt_max(body_size, 4096);
+        body_size = nxt_min(body_size, max_size);
+
+        if (ctx->body_length + size > body_size) {
+            ctx->capture = 0;
+            return;
+        }
+
+        p = nxt_realloc(ctx->body, body_size);
+        if (nxt_slow_path(p == NULL)) {
+            ctx->capture = 0;
+            return;
+        }
+
+        ctx->body = p;
+        ctx->body_size = body_size;
+    }
+
+    nxt_memcpy(ctx->body + ctx->body_length, data, size);
+    ctx->body_length += size;
+}
+
+
+static void
+nxt_http_cache_store(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_cache_ctx_t *ctx)
+{
+    size_t                  max_size;
+    nxt_queue_link_t        *link;
+    nxt_router_conf_t       *rtcf;
+    nxt_lvlhsh_query_t      lhq;
+    nxt_http_cache_entry_t  *entry, *prev;
+
+    ctx->capture = 0;
+
+    if (r->error) {
+        nxt_http_cache_unlock(task, ctx, NULL, 1);
+        return;
+    }
+
+    rtcf = r->conf->socket_conf->router_conf;
+    max_size = rtcf->cache_size;
+
+    entry = nxt_http_cache_entry_create(ctx);
+    if (nxt_slow_path(entry == NULL)) {
+        nxt_http_cache_unlock(task, ctx, NULL, 0);
+        return;
+    }
+
+    entry->status = r->status;
+
+    if (!ctx->store || entry->size > max_size) {
+        /* The entry is only sent to the waiting requests, if any. */
+
+        nxt_http_cache_unlock(task, ctx, entry, 0);
+
+        nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+        nxt_http_cache_release(entry);
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        return;
+    }
+
+    lhq.key_hash = entry->key_hash;
+    lhq.key = entry->key;
+    lhq.proto = &nxt_http_cache_proto;
+    lhq.replace = 1;
+    lhq.value = entry;
+    lhq.pool = NULL;
+
+    nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+
+    if (nxt_slow_path(nxt_lvlhsh_insert(&nxt_http_cache.hash, &lhq)
+                      != NXT_OK))
+    {
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        nxt_http_cache_release(entry);
+        nxt_http_cache_unlock(task, ctx, NULL, 0);
+        return;
+    }
+
+    prev = lhq.value;
+
+    if (prev != entry) {
+        nxt_queue_remove(&prev->link);
+        nxt_http_cache.size -= prev->size;
+
+        nxt_http_cache_release(prev);
+    }
+
+    nxt_queue_insert_head(&nxt_http_cache.lru, &entry->link);
+    nxt_http_cache.size += entry->size;
+
+    while (nxt_http_cache.size > max_size) {
+        link = nxt_queue_last(&nxt_http_cache.lru);
+        prev = nxt_queue_link_data(link, nxt_http_cache_entry_t, link);
+
+        nxt_http_cache_remove(prev);
+    }
+
+    if (ctx->lock == NULL) {
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        nxt_debug(task, "http cache stored \"%V\"", &entry->key);
+
+        return;
+    }
+
+    /* The entry may be evicted by other threads until it is passed. */
+    entry->count++;
+
+    nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+    nxt_debug(task, "http cache stored \"%V\"", &entry->key);
+
+    nxt_http_cache_unlock(task, ctx, entry, 0);
+
+    nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+    nxt_http_cache_release(entry);
+    nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+}
+
+
+static nxt_http_cache_entry_t *
+nxt_http_cache_entry_create(nxt_http_cache_ctx_t *ctx)
+{
+    u_char                  *p;
+    size_t                  size;
+    nxt_uint_t              i;
+    nxt_http_field_t        *field;
+    nxt_http_cache_entry_t  *entry;
+
+    size = sizeof(nxt_http_cache_entry_t) + ctx->key.length
+           + (ctx->nfields + ctx->nvary) * sizeof(nxt_http_field_t);
+
+    for (i = 0; i < ctx->nfields; i++) {
+        size += ctx->fields[i].name_length + ctx->fields[i].value_length;
+    }
+
+    for (i = 0; i < ctx->nvary; i++) {
+        size += ctx->vary[i].name_length + ctx->vary[i].value_length;
+    }
+
+    entry = nxt_malloc(size);
+    if (nxt_slow_path(entry == NULL)) {
+        return NULL;
+    }
+
+    nxt_memzero(entry, sizeof(nxt_http_cache_entry_t));
+
+    entry->count = 1;
+    entry->size = size + ctx->body_size;
+
+    entry->date = ctx->date;
+    entry->expires = ctx->expires;
+    entry->stale = ctx->stale;
+
+    entry->fields = nxt_pointer_to(entry, sizeof(nxt_http_cache_entry_t));
+    entry->nfields = ctx->nfields;
+
+    entry->vary = entry->fields + ctx->nfields;
+    entry->nvary = ctx->nvary;
+
+    p = (u_char *) (entry->vary + ctx->nvary);
+
+    for (i = 0; i < ctx->nfields + ctx->nvary; i++) {
+        field = (i < ctx->nfields) ? &ctx->fields[i]
+                                   : &ctx->vary[i - ctx->nfields];
+
+        entry->fields[i] = *field;
+
+        entry->fields[i].name = p;
+        p = nxt_cpymem(p, field->name, field->name_length);
+
+        entry->fields[i].value = p;
+        p = nxt_cpymem(p, field->value, field->value_length);
+    }
+
+    entry->key.start = p;
+    entry->key.length = ctx->key.length;
+    nxt_memcpy(p, ctx->key.start, ctx->key.length);
+
+    entry->key_hash = ctx->key_hash;
+
+    entry->body = ctx->body;
+    entry->body_length = ctx->body_length;
+
+    ctx->body = NULL;
+
+    return entry;
+}
+
+
+/* The cache mutex must be locked. */
+
+static void
+nxt_http_cache_remove(nxt_http_cache_entry_t *entry)
+{
+    nxt_lvlhsh_query_t  lhq;
+
+    lhq.key_hash = entry->key_hash;
+    lhq.key = entry->key;
+    lhq.proto = &nxt_http_cache_proto;
+    lhq.pool = NULL;
+
+    (void) nxt_lvlhsh_delete(&nxt_http_cache.hash, &lhq);
+
+    nxt_queue_remove(&entry->link);
+    nxt_http_cache.size -= entry->size;
+
+    nxt_http_cache_release(entry);
+}
+
+
+/*
+ * The cache mutex must be locked unless the entry has not been
+ * inserted yet.
+ */
+
+static void
+nxt_http_cache_release(nxt_http_cache_entry_t *entry)
+{
+    if (--entry->count != 0) {
+        return;
+    }
+
+    if (entry->body != NULL) {
+        nxt_free(entry->body);
+    }
+
+    nxt_free(entry);
+}
+
+
+static nxt_int_t
+nxt_http_cache_key_test(nxt_lvlhsh_query_t *lhq, void *data)
+{
+    nxt_http_cache_entry_t  *entry;
+
+    entry = data;
+
+    if (nxt_strstr_eq(&lhq->key, &entry->key)) {
+        return NXT_OK;
+    }
+
+    return NXT_DECLINED;
+}
+
+
+static nxt_int_t
+nxt_http_cache_lock_test(nxt_lvlhsh_query_t *lhq, void *data)
+{
+    nxt_http_cache_lock_t  *lock;
+
+    lock = data;
+
+    if (nxt_strstr_eq(&lhq->key, &lock->key)) {
+        return NXT_OK;
+    }
+
+    return NXT_DECLINED;
+}
+
+
+static void
+nxt_http_cache_cleanup(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_http_cache_ctx_t    *ctx;
+    nxt_http_cache_entry_t  *entry;
+
+    ctx = obj;
+    entry = ctx->entry;
+
+    nxt_http_cache_unlock(task, ctx, NULL, 1);
+
+    if (entry != NULL) {
+        nxt_thread_mutex_lock(&nxt_http_cache.mutex);
+
+        if (ctx->status == NXT_HTTP_CACHE_EXPIRED) {
+            entry->updating = 0;
+        }
+
+        nxt_http_cache_release(entry);
+
+        nxt_thread_mutex_unlock(&nxt_http_cache.mutex);
+
+        ctx->entry = NULL;
+    }
+
+    if (ctx->body != NULL) {
+        nxt_free(ctx->body);
+        ctx->body = NULL;
+    }
+}
+
+
+void
+nxt_http_cache_status(nxt_http_request_t *r, nxt_str_t *str)
+{
+    if (r->cache == NULL) {
+        nxt_str_null(str);
+        return;
+    }
+
+    *str = nxt_http_cache_statuses[r->cache->status];
+}
@@ -104,7 +104,7 @@ nxt_http_js_ext_uri(njs_vm_t *vm, njs_object_prop_t *prop,
 {
     nxt_http_request_t  *r;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -120,7 +120,7 @@ nxt_http_js_ext_host(njs_vm_t *vm, njs_object_prop_t *prop,
 {
     nxt_http_request_t  *r;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -136,7 +136,7 @@ nxt_http_js_ext_remote_addr(njs_vm_t *vm, njs_object_prop_t *prop,
 {
     nxt_http_request_t  *r;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -157,7 +157,7 @@ nxt_http_js_ext_get_args(njs_vm_t *vm, njs_object_prop_t *prop,
     njs_opaque_value_t  val;
     nxt_http_request_t  *r;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -187,7 +187,7 @@ nxt_http_js_ext_get_header(njs_vm_t *vm, njs_object_prop_t *prop,
     nxt_http_field_t    *f;
     nxt_http_request_t  *r;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -228,7 +228,7 @@ nxt_http_js_ext_keys_header(njs_vm_t *vm, njs_value_t *value, njs_value_t *keys)
         return NJS_ERROR;
     }
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         return NJS_OK;
     }
@@ -261,7 +261,7 @@ nxt_http_js_ext_get_cookie(njs_vm_t *vm, njs_object_prop_t *prop,
     nxt_http_request_t     *r;
     nxt_http_name_value_t  *nv, *start, *end;
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         njs_value_undefined_set(retval);
         return NJS_DECLINED;
@@ -310,7 +310,7 @@ nxt_http_js_ext_keys_cookie(njs_vm_t *vm, njs_value_t *value, njs_value_t *keys)
         return NJS_ERROR;
     }
 
-    r = njs_vm_external(vm, nxt_js_proto_id, value);
+    r = nxt_js_external(vm, value);
     if (r == NULL) {
         return NJS_OK;
     }
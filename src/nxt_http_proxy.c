@@ -136,6 +136,8 @@ nxt_upstream_proxy_handler(nxt_task_t *task, nxt_http_request_t *r,
     peer->request = r;
     r->peer = peer;
 
+    r->timing.upstream = nxt_thread_monotonic_time(task->thread);
+
     nxt_mp_retain(r->mem_pool);
 
     us->state = &nxt_upstream_proxy_state;
@@ -254,6 +256,7 @@ nxt_http_proxy_header_read(nxt_task_t *task, void *obj, void *data)
     peer = data;
 
     r->status = peer->status;
+    r->timing.upstream_header = nxt_thread_monotonic_time(task->thread);
 
     nxt_debug(task, "http proxy status: %d", peer->status);
 
@@ -309,6 +312,8 @@ nxt_http_proxy_send_body(nxt_task_t *task, void *obj, void *data)
         nxt_http_proto[peer->protocol].peer_read(task, peer);
 
     } else {
+        r->timing.upstream_done = nxt_thread_monotonic_time(task->thread);
+
         nxt_http_proto[peer->protocol].peer_close(task, peer);
 
         nxt_mp_release(r->mem_pool);
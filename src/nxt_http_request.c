@@ -24,6 +24,10 @@ static void nxt_http_request_proto_info(nxt_task_t *task,
 static void nxt_http_request_mem_buf_completion(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_http_request_done(nxt_task_t *task, void *obj, void *data);
+static void nxt_http_request_account(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_proto_t proto);
+static void nxt_http_traffic_account(nxt_status_traffic_t *traffic,
+    nxt_http_request_t *r, nxt_off_t sent);
 
 static u_char *nxt_http_date_cache_handler(u_char *buf, nxt_realtime_t *now,
     struct tm *tm, size_t size, const char *format);
@@ -73,6 +77,12 @@ nxt_http_init(nxt_task_t *task)
         return ret;
     }
 
+    ret = nxt_http_cache_create(task);
+
+    if (ret != NXT_OK) {
+        return ret;
+    }
+
     return nxt_http_response_hash_init(task);
 }
 
@@ -311,6 +321,10 @@ nxt_http_request_start(nxt_task_t *task, void *obj, void *data)
 
     r = obj;
 
+    r->timing.header = nxt_thread_monotonic_time(task->thread);
+
+    nxt_probe3(http_request_start, r, r->path->start, r->path->length);
+
     r->state = &nxt_http_request_body_state;
 
     skcf = r->conf->socket_conf;
@@ -547,6 +561,8 @@ nxt_http_request_ready(nxt_task_t *task, void *obj, void *data)
     r = obj;
     action = r->conf->socket_conf->action;
 
+    r->timing.body = nxt_thread_monotonic_time(task->thread);
+
     nxt_http_request_action(task, r, action);
 }
 
@@ -560,6 +576,18 @@ nxt_http_request_action(nxt_task_t *task, nxt_http_request_t *r,
     if (nxt_fast_path(action != NULL)) {
 
         do {
+            if (action->cache != NULL && r->cache == NULL) {
+                action = nxt_http_cache_handler(task, r, action);
+
+                if (action == NULL) {
+                    return;
+                }
+
+                if (action == NXT_HTTP_ACTION_ERROR) {
+                    break;
+                }
+            }
+
             ret = nxt_http_rewrite(task, r);
             if (nxt_slow_path(ret != NXT_OK)) {
                 break;
@@ -634,6 +662,10 @@ nxt_http_request_header_send(nxt_task_t *task, nxt_http_request_t *r,
     nxt_http_field_t   *server, *date, *content_length;
     nxt_socket_conf_t  *skcf;
 
+    if (r->cache != NULL) {
+        nxt_http_cache_header(task, r);
+    }
+
     ret = nxt_http_set_headers(r);
     if (nxt_slow_path(ret != NXT_OK)) {
         goto fail;
@@ -699,6 +731,8 @@ nxt_http_request_header_send(nxt_task_t *task, nxt_http_request_t *r,
         r->resp.content_length = content_length;
     }
 
+    r->timing.response_header = nxt_thread_monotonic_time(task->thread);
+
     if (nxt_fast_path(r->proto.any != NULL)) {
         nxt_http_proto[r->protocol].header_send(task, r, body_handler, data);
     }
@@ -724,12 +758,25 @@ nxt_http_request_ws_frame_start(nxt_task_t *task, nxt_http_request_t *r,
 void
 nxt_http_request_send(nxt_task_t *task, nxt_http_request_t *r, nxt_buf_t *out)
 {
+    if (r->cache != NULL) {
+        nxt_http_cache_body(task, r, out);
+    }
+
     if (nxt_fast_path(r->proto.any != NULL)) {
         nxt_http_proto[r->protocol].send(task, r, out);
     }
 }
 
 
+void
+nxt_http_request_disconnect_watch(nxt_task_t *task, nxt_http_request_t *r)
+{
+    if (nxt_fast_path(r->proto.any != NULL)) {
+        nxt_http_proto[r->protocol].disconnect_watch(task, r);
+    }
+}
+
+
 nxt_buf_t *
 nxt_http_buf_mem(nxt_task_t *task, nxt_http_request_t *r, size_t size)
 {
@@ -831,6 +878,12 @@ nxt_http_request_close_handler(nxt_task_t *task, void *obj, void *data)
     if (!r->logged) {
         r->logged = 1;
 
+        nxt_http_request_account(task, r, proto);
+
+        if (conf->socket_conf->router_conf->trace_log != NULL) {
+            nxt_router_trace_write(task, r);
+        }
+
         access_log = conf->socket_conf->router_conf->access_log;
         log_format = conf->socket_conf->router_conf->log_format;
 
@@ -866,6 +919,65 @@ nxt_http_request_close_handler(nxt_task_t *task, void *obj, void *data)
 }
 
 
+/*
+ * Accounts the request to per-engine counters of its listener and of
+ * the route step it matched.
+ */
+
+static void
+nxt_http_request_account(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_http_proto_t proto)
+{
+    nxt_off_t             sent;
+    nxt_socket_conf_t     *skcf;
+    nxt_router_conf_t     *rtcf;
+    nxt_status_traffic_t  *traffic;
+
+    skcf = r->conf->socket_conf;
+    rtcf = skcf->router_conf;
+
+    sent = 0;
+
+    if (nxt_fast_path(proto.any != NULL)) {
+        sent = nxt_http_proto[r->protocol].body_bytes_sent(task, proto);
+    }
+
+    nxt_probe3(http_request_done, r, r->status, sent);
+
+    traffic = nxt_router_traffic(task, rtcf, skcf->traffic);
+
+    if (traffic != NULL) {
+        nxt_http_traffic_account(traffic, r, sent);
+    }
+
+    traffic = nxt_router_traffic(task, rtcf, r->route_traffic);
+
+    if (traffic != NULL) {
+        nxt_http_traffic_account(traffic, r, sent);
+    }
+}
+
+
+static void
+nxt_http_traffic_account(nxt_status_traffic_t *traffic, nxt_http_request_t *r,
+    nxt_off_t sent)
+{
+    traffic->requests++;
+
+    if (r->content_length_n > 0) {
+        traffic->bytes_in += r->content_length_n;
+    }
+
+    if (sent > 0) {
+        traffic->bytes_out += sent;
+    }
+
+    if (r->status >= 100 && r->status < 600) {
+        traffic->responses[r->status / 100 - 1]++;
+    }
+}
+
+
 static u_char *
 nxt_http_date_cache_handler(u_char *buf, nxt_realtime_t *now, struct tm *tm,
     size_t size, const char *format)
@@ -139,6 +139,7 @@ typedef union {
 typedef struct {
     uint32_t                       items;
     nxt_http_action_t              action;
+    nxt_router_traffic_t           *traffic;
     nxt_http_route_test_t          test[0];
 } nxt_http_route_match_t;
 
@@ -158,6 +159,8 @@ struct nxt_http_routes_s {
 
 static nxt_http_route_t *nxt_http_route_create(nxt_task_t *task,
     nxt_router_temp_conf_t *tmcf, nxt_conf_value_t *cv);
+static nxt_int_t nxt_http_route_steps_init(nxt_router_conf_t *rtcf,
+    nxt_http_route_t *route);
 static nxt_http_route_match_t *nxt_http_route_match_create(nxt_task_t *task,
     nxt_router_temp_conf_t *tmcf, nxt_conf_value_t *cv);
 static nxt_http_route_table_t *nxt_http_route_table_create(nxt_task_t *task,
@@ -273,6 +276,13 @@ nxt_http_routes_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
             if (nxt_slow_path(string == NULL)) {
                 return NULL;
             }
+
+            if (nxt_slow_path(nxt_http_route_steps_init(tmcf->router_conf,
+                                                        route)
+                              != NXT_OK))
+            {
+                return NULL;
+            }
         }
 
     } else {
@@ -285,12 +295,75 @@ nxt_http_routes_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
 
         route->name.length = 0;
         route->name.start = NULL;
+
+        if (nxt_slow_path(nxt_http_route_steps_init(tmcf->router_conf, route)
+                          != NXT_OK))
+        {
+            return NULL;
+        }
     }
 
     return routes;
 }
 
 
+/*
+ * Registers traffic counters of route steps under the names used
+ * by the "log_route" option, such as "routes/main/0".
+ */
+
+static nxt_int_t
+nxt_http_route_steps_init(nxt_router_conf_t *rtcf, nxt_http_route_t *route)
+{
+    u_char                   *p;
+    size_t                   size;
+    uint32_t                 i;
+    nxt_router_route_step_t  *step;
+
+    if (rtcf->route_steps == NULL) {
+        rtcf->route_steps = nxt_array_create(rtcf->mem_pool, 4,
+                                             sizeof(nxt_router_route_step_t));
+        if (nxt_slow_path(rtcf->route_steps == NULL)) {
+            return NXT_ERROR;
+        }
+    }
+
+    size = nxt_length("routes//") + route->name.length + NXT_INT32_T_LEN;
+
+    for (i = 0; i < route->items; i++) {
+        step = nxt_array_add(rtcf->route_steps);
+        if (nxt_slow_path(step == NULL)) {
+            return NXT_ERROR;
+        }
+
+        p = nxt_mp_nget(rtcf->mem_pool, size);
+        if (nxt_slow_path(p == NULL)) {
+            return NXT_ERROR;
+        }
+
+        step->name.start = p;
+
+        if (route->name.length == 0) {
+            p = nxt_sprintf(p, p + size, "routes/%uD", i);
+
+        } else {
+            p = nxt_sprintf(p, p + size, "routes/%V/%uD", &route->name, i);
+        }
+
+        step->name.length = p - step->name.start;
+
+        step->traffic = nxt_router_traffic_create(rtcf);
+        if (nxt_slow_path(step->traffic == NULL)) {
+            return NXT_ERROR;
+        }
+
+        route->match[i]->traffic = step->traffic;
+    }
+
+    return NXT_OK;
+}
+
+
 static nxt_conf_map_t  nxt_http_route_match_conf[] = {
     {
         nxt_string("scheme"),
@@ -643,6 +716,11 @@ static nxt_conf_map_t  nxt_http_route_action_conf[] = {
         NXT_CONF_MAP_PTR,
         offsetof(nxt_http_action_conf_t, fallback)
     },
+    {
+        nxt_string("cache"),
+        NXT_CONF_MAP_PTR,
+        offsetof(nxt_http_action_conf_t, cache)
+    },
 };
 
 
@@ -683,6 +761,13 @@ nxt_http_action_init(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
         }
     }
 
+    if (acf.cache != NULL) {
+        ret = nxt_http_cache_init(rtcf, action, &acf);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            return ret;
+        }
+    }
+
     if (acf.ret != NULL) {
         return nxt_http_return_init(rtcf, action, &acf);
     }
@@ -1588,6 +1673,11 @@ nxt_http_route_handler(nxt_task_t *task, nxt_http_request_t *r,
 
             if (action != NXT_HTTP_ACTION_ERROR) {
                 r->action = action;
+                r->route_traffic = route->match[i]->traffic;
+                r->timing.route = nxt_thread_monotonic_time(task->thread);
+
+                nxt_probe4(http_route_match, r, route->name.start,
+                           route->name.length, i);
             }
 
             return action;
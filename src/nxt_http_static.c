@@ -36,6 +36,7 @@ typedef struct {
 #endif
     uint32_t                    share_idx;
     uint8_t                     need_body;  /* 1 bit */
+    uint8_t                     sendfile;   /* 1 bit */
 } nxt_http_static_ctx_t;
 
 
@@ -53,6 +54,9 @@ static void nxt_http_static_next(nxt_task_t *task, nxt_http_request_t *r,
     nxt_http_static_ctx_t *ctx, nxt_http_status_t status);
 #if (NXT_HAVE_OPENAT2)
 static u_char *nxt_http_static_chroot_match(u_char *chr, u_char *shr);
+#else
+static nxt_bool_t nxt_http_static_sendfile_inside(nxt_str_t *root,
+    nxt_str_t *path);
 #endif
 static void nxt_http_static_extract_extension(nxt_str_t *path,
     nxt_str_t *exten);
@@ -70,6 +74,20 @@ static void nxt_http_static_mtypes_hash_free(void *data, void *p);
 static const nxt_http_request_state_t  nxt_http_static_send_state;
 
 
+/* The files named by applications are served with a single share. */
+
+static nxt_http_static_share_t  nxt_http_static_sendfile_share;
+
+static nxt_http_static_conf_t  nxt_http_static_sendfile_conf = {
+    .nshares = 1,
+    .shares = &nxt_http_static_sendfile_share,
+};
+
+static nxt_http_action_t  nxt_http_static_sendfile_action = {
+    .u.conf = &nxt_http_static_sendfile_conf,
+};
+
+
 nxt_int_t
 nxt_http_static_init(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     nxt_http_action_t *action, nxt_http_action_conf_t *acf)
@@ -227,6 +245,80 @@ nxt_http_static(nxt_task_t *task, nxt_http_request_t *r,
 }
 
 
+/*
+ * Serves the file named by the "X-Sendfile" field of an application
+ * response; the path is relative to or must reside in the root.
+ */
+
+void
+nxt_http_static_sendfile(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_str_t *root, nxt_str_t *path)
+{
+    u_char                 *p;
+    nxt_http_static_ctx_t  *ctx;
+
+    if (path->length == 0
+        || path->start[path->length - 1] == '/'
+        || memchr(path->start, '\0', path->length) != NULL)
+    {
+        nxt_log(task, NXT_LOG_ERR, "invalid \"X-Sendfile\" path \"%V\"",
+                path);
+
+        nxt_http_request_error(task, r, NXT_HTTP_NOT_FOUND);
+        return;
+    }
+
+    ctx = nxt_mp_zget(r->mem_pool, sizeof(nxt_http_static_ctx_t));
+    if (nxt_slow_path(ctx == NULL)) {
+        goto fail;
+    }
+
+    ctx->action = &nxt_http_static_sendfile_action;
+    ctx->need_body = !nxt_str_eq(r->method, "HEAD", 4);
+    ctx->sendfile = 1;
+
+    p = nxt_mp_nget(r->mem_pool, root->length + path->length + 2);
+    if (nxt_slow_path(p == NULL)) {
+        goto fail;
+    }
+
+    ctx->share.start = p;
+
+    if (path->start[0] != '/') {
+        p = nxt_cpymem(p, root->start, root->length);
+        *p++ = '/';
+    }
+
+    p = nxt_cpymem(p, path->start, path->length);
+    *p = '\0';
+
+    ctx->share.length = p - ctx->share.start;
+
+    nxt_debug(task, "http static sendfile: \"%V\", root: \"%V\"",
+              &ctx->share, root);
+
+#if (NXT_HAVE_OPENAT2)
+    ctx->chroot = *root;
+#else
+    if (!nxt_http_static_sendfile_inside(root, &ctx->share)) {
+        nxt_log(task, NXT_LOG_ERR, "\"%V\" is outside of \"%V\"",
+                &ctx->share, root);
+
+        nxt_http_request_error(task, r, NXT_HTTP_FORBIDDEN);
+        return;
+    }
+#endif
+
+    nxt_http_static_send_ready(task, r, ctx);
+
+    return;
+
+fail:
+
+    nxt_http_request_error(task, r, NXT_HTTP_INTERNAL_SERVER_ERROR);
+}
+
+
 static void
 nxt_http_static_iterate(nxt_task_t *task, nxt_http_request_t *r,
     nxt_http_static_ctx_t *ctx)
@@ -561,7 +653,9 @@ nxt_http_static_send_ready(nxt_task_t *task, void *obj, void *data)
             mtype = nxt_http_static_mtype_get(&rtcf->mtypes_hash, &exten);
         }
 
-        if (mtype->length != 0) {
+        /* An application may set the type of the file it names. */
+
+        if (mtype->length != 0 && r->resp.content_type == NULL) {
             field = nxt_list_zero_add(r->resp.fields);
             if (nxt_slow_path(field == NULL)) {
                 goto fail;
@@ -596,7 +690,8 @@ nxt_http_static_send_ready(nxt_task_t *task, void *obj, void *data)
         nxt_file_close(task, f);
 
         if (nxt_slow_path(!nxt_is_dir(&fi)
-                          || shr->start[shr->length - 1] == '/'))
+                          || shr->start[shr->length - 1] == '/'
+                          || ctx->sendfile))
         {
             nxt_log(task, NXT_LOG_ERR, "\"%FN\" is not a regular file",
                     f->name);
@@ -760,6 +855,49 @@ nxt_http_static_chroot_match(u_char *chr, u_char *shr)
     return (*shr != '\0') ? shr : NULL;
 }
 
+#else
+
+static nxt_bool_t
+nxt_http_static_sendfile_inside(nxt_str_t *root, nxt_str_t *path)
+{
+    u_char  *p, *end, *segment;
+    size_t  length;
+
+    length = root->length;
+
+    while (length > 1 && root->start[length - 1] == '/') {
+        length--;
+    }
+
+    if (path->length <= length
+        || memcmp(path->start, root->start, length) != 0
+        || (path->start[length] != '/' && length != 1))
+    {
+        return 0;
+    }
+
+    p = path->start + length;
+    end = path->start + path->length;
+
+    while (p < end) {
+        while (p < end && *p == '/') {
+            p++;
+        }
+
+        segment = p;
+
+        while (p < end && *p != '/') {
+            p++;
+        }
+
+        if (p - segment == 2 && segment[0] == '.' && segment[1] == '.') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 #endif
 
 
@@ -12,6 +12,24 @@ static nxt_int_t nxt_http_var_dollar(nxt_task_t *task, nxt_str_t *str,
     void *ctx, void *data);
 static nxt_int_t nxt_http_var_request_time(nxt_task_t *task, nxt_str_t *str,
     void *ctx, void *data);
+static nxt_int_t nxt_http_var_request_header_time(nxt_task_t *task,
+    nxt_str_t *str, void *ctx, void *data);
+static nxt_int_t nxt_http_var_request_body_time(nxt_task_t *task,
+    nxt_str_t *str, void *ctx, void *data);
+static nxt_int_t nxt_http_var_route_time(nxt_task_t *task, nxt_str_t *str,
+    void *ctx, void *data);
+static nxt_int_t nxt_http_var_queue_time(nxt_task_t *task, nxt_str_t *str,
+    void *ctx, void *data);
+static nxt_int_t nxt_http_var_app_time(nxt_task_t *task, nxt_str_t *str,
+    void *ctx, void *data);
+static nxt_int_t nxt_http_var_upstream_header_time(nxt_task_t *task,
+    nxt_str_t *str, void *ctx, void *data);
+static nxt_int_t nxt_http_var_upstream_time(nxt_task_t *task, nxt_str_t *str,
+    void *ctx, void *data);
+static nxt_int_t nxt_http_var_response_header_time(nxt_task_t *task,
+    nxt_str_t *str, void *ctx, void *data);
+static nxt_int_t nxt_http_var_interval(nxt_http_request_t *r, nxt_str_t *str,
+    nxt_nsec_t start, nxt_nsec_t end);
 static nxt_int_t nxt_http_var_method(nxt_task_t *task, nxt_str_t *str,
     void *ctx, void *data);
 static nxt_int_t nxt_http_var_request_uri(nxt_task_t *task, nxt_str_t *str,
@@ -42,6 +60,8 @@ static nxt_int_t nxt_http_var_response_content_length(nxt_task_t *task,
     nxt_str_t *str, void *ctx, void *data);
 static nxt_int_t nxt_http_var_response_transfer_encoding(nxt_task_t *task,
     nxt_str_t *str, void *ctx, void *data);
+static nxt_int_t nxt_http_var_cache_status(nxt_task_t *task, nxt_str_t *str,
+    void *ctx, void *data);
 static nxt_int_t nxt_http_var_arg(nxt_task_t *task, nxt_str_t *str, void *ctx,
     void *data);
 static nxt_int_t nxt_http_var_header(nxt_task_t *task, nxt_str_t *str,
@@ -61,6 +81,38 @@ static nxt_var_decl_t  nxt_http_vars[] = {
         .name = nxt_string("request_time"),
         .handler = nxt_http_var_request_time,
         .cacheable = 1,
+    }, {
+        .name = nxt_string("request_header_time"),
+        .handler = nxt_http_var_request_header_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("request_body_time"),
+        .handler = nxt_http_var_request_body_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("route_time"),
+        .handler = nxt_http_var_route_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("queue_time"),
+        .handler = nxt_http_var_queue_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("app_time"),
+        .handler = nxt_http_var_app_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("upstream_header_time"),
+        .handler = nxt_http_var_upstream_header_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("upstream_time"),
+        .handler = nxt_http_var_upstream_time,
+        .cacheable = 1,
+    }, {
+        .name = nxt_string("response_header_time"),
+        .handler = nxt_http_var_response_header_time,
+        .cacheable = 1,
     }, {
         .name = nxt_string("method"),
         .handler = nxt_http_var_method,
@@ -117,6 +169,10 @@ static nxt_var_decl_t  nxt_http_vars[] = {
         .name = nxt_string("header_user_agent"),
         .handler = nxt_http_var_user_agent,
         .cacheable = 1,
+    }, {
+        .name = nxt_string("cache_status"),
+        .handler = nxt_http_var_cache_status,
+        .cacheable = 0,
     },
 };
 
@@ -256,6 +312,139 @@ nxt_http_var_request_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
 }
 
 
+static nxt_int_t
+nxt_http_var_request_header_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->start_time, r->timing.header);
+}
+
+
+static nxt_int_t
+nxt_http_var_request_body_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.header, r->timing.body);
+}
+
+
+static nxt_int_t
+nxt_http_var_route_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.body, r->timing.route);
+}
+
+
+static nxt_int_t
+nxt_http_var_queue_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.app_queued,
+                                 r->timing.app_acked);
+}
+
+
+static nxt_int_t
+nxt_http_var_app_time(nxt_task_t *task, nxt_str_t *str, void *ctx, void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.app_acked,
+                                 r->timing.app_done);
+}
+
+
+static nxt_int_t
+nxt_http_var_upstream_header_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.upstream,
+                                 r->timing.upstream_header);
+}
+
+
+static nxt_int_t
+nxt_http_var_upstream_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->timing.upstream,
+                                 r->timing.upstream_done);
+}
+
+
+static nxt_int_t
+nxt_http_var_response_header_time(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    return nxt_http_var_interval(r, str, r->start_time,
+                                 r->timing.response_header);
+}
+
+
+/*
+ * Formats the time between two phase boundaries in seconds with
+ * millisecond resolution, or "-" if either boundary was not reached.
+ */
+
+static nxt_int_t
+nxt_http_var_interval(nxt_http_request_t *r, nxt_str_t *str, nxt_nsec_t start,
+    nxt_nsec_t end)
+{
+    u_char      *p;
+    nxt_msec_t  ms;
+
+    if (start == 0 || end < start) {
+        nxt_str_set(str, "-");
+        return NXT_OK;
+    }
+
+    ms = (end - start) / 1000000;
+
+    str->start = nxt_mp_nget(r->mem_pool, NXT_TIME_T_LEN + 4);
+    if (nxt_slow_path(str->start == NULL)) {
+        return NXT_ERROR;
+    }
+
+    p = nxt_sprintf(str->start, str->start + NXT_TIME_T_LEN, "%T.%03M",
+                    (nxt_time_t) ms / 1000, ms % 1000);
+
+    str->length = p - str->start;
+
+    return NXT_OK;
+}
+
+
 static nxt_int_t
 nxt_http_var_method(nxt_task_t *task, nxt_str_t *str, void *ctx, void *data)
 {
@@ -576,6 +765,20 @@ nxt_http_var_response_transfer_encoding(nxt_task_t *task, nxt_str_t *str,
 }
 
 
+static nxt_int_t
+nxt_http_var_cache_status(nxt_task_t *task, nxt_str_t *str, void *ctx,
+    void *data)
+{
+    nxt_http_request_t  *r;
+
+    r = ctx;
+
+    nxt_http_cache_status(r, str);
+
+    return NXT_OK;
+}
+
+
 static nxt_int_t
 nxt_http_var_arg(nxt_task_t *task, nxt_str_t *str, void *ctx, void *data)
 {
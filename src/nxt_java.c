@@ -64,6 +64,9 @@ NXT_EXPORT nxt_app_module_t  nxt_app_module = {
     nxt_nitems(nxt_java_mounts),
     nxt_java_setup,
     nxt_java_start,
+    NULL,
+    NULL,
+    NULL,
 };
 
 typedef struct {
@@ -6,6 +6,16 @@
 #include <nxt_main.h>
 
 
+/* The number of idle VM clones kept for reuse by a configuration. */
+#define NXT_JS_VM_POOL  64
+
+/*
+ * A clone keeps the memory allocated by all calls made in it,
+ * so it is destroyed after serving this number of requests.
+ */
+#define NXT_JS_VM_USES  256
+
+
 struct nxt_js_s {
     uint32_t            index;
 };
@@ -25,10 +35,18 @@ struct nxt_js_conf_s {
     nxt_str_t           init;
     nxt_array_t         *modules;  /* of nxt_js_module_t */
     nxt_array_t         *funcs;
+
+    nxt_thread_spinlock_t  lock;
+    nxt_uint_t          nvms;
+    nxt_js_cache_t      *vms;  /* idle clones */
+
     uint8_t             test;  /* 1 bit */
 };
 
 
+static nxt_int_t nxt_js_vm_get(nxt_js_conf_t *jcf, nxt_js_cache_t *cache);
+
+
 njs_mod_t *
 nxt_js_module_loader(njs_vm_t *vm, njs_external_ptr_t external, njs_str_t *name)
 {
@@ -110,6 +128,12 @@ nxt_js_conf_new(nxt_mp_t *mp, nxt_bool_t test)
 void
 nxt_js_conf_release(nxt_js_conf_t *jcf)
 {
+    nxt_uint_t  i;
+
+    for (i = 0; i < jcf->nvms; i++) {
+        njs_vm_destroy(jcf->vms[i].vm);
+    }
+
     njs_vm_destroy(jcf->vm);
 }
 
@@ -307,6 +331,14 @@ nxt_js_compile(nxt_js_conf_t *jcf)
         return NXT_ERROR;
     }
 
+    if (jcf->modules->nelts == 0) {
+        jcf->vms = nxt_mp_get(jcf->pool,
+                              NXT_JS_VM_POOL * sizeof(nxt_js_cache_t));
+        if (nxt_slow_path(jcf->vms == NULL)) {
+            return NXT_ERROR;
+        }
+    }
+
     size = jcf->init.length + 2;
     func = jcf->funcs->elts;
 
@@ -399,28 +431,24 @@ nxt_js_call(nxt_task_t *task, nxt_js_conf_t *jcf, nxt_js_cache_t *cache,
     static const njs_str_t  headers_str = njs_str("headers");
     static const njs_str_t  cookies_str = njs_str("cookies");
 
-    vm = cache->vm;
-
-    if (vm == NULL) {
-        vm = njs_vm_clone(jcf->vm, ctx);
-        if (nxt_slow_path(vm == NULL)) {
-            return NXT_ERROR;
-        }
-
-        cache->vm = vm;
-
-        ret = njs_vm_start(vm, &cache->array);
-        if (ret != NJS_OK) {
+    if (cache->vm == NULL) {
+        ret = nxt_js_vm_get(jcf, cache);
+        if (nxt_slow_path(ret != NXT_OK)) {
             return NXT_ERROR;
         }
     }
 
+    vm = cache->vm;
+
     value = njs_vm_array_prop(vm, &cache->array, js->index, &opaque_value);
     func = njs_value_function(value);
 
+    *cache->ctx = ctx;
+
     ret = njs_vm_external_create(vm, njs_value_arg(&opaque_value),
-                                 nxt_js_proto_id, ctx, 0);
+                                 nxt_js_proto_id, cache->ctx, 0);
     if (nxt_slow_path(ret != NJS_OK)) {
+        cache->failed = 1;
         return NXT_ERROR;
     }
 
@@ -464,6 +492,8 @@ nxt_js_call(nxt_task_t *task, nxt_js_conf_t *jcf, nxt_js_cache_t *cache,
                         njs_value_arg(&retval));
 
     if (ret != NJS_OK) {
+        cache->failed = 1;
+
         ret = njs_vm_exception_string(vm, &res);
         if (ret == NJS_OK) {
             nxt_alert(task, "js exception: %V", &res);
@@ -481,11 +511,94 @@ nxt_js_call(nxt_task_t *task, nxt_js_conf_t *jcf, nxt_js_cache_t *cache,
 }
 
 
+/*
+ * Cloning and starting a VM for each request is costly, so a clone is
+ * returned to the configuration after the request and reused by the next
+ * requests of any engine.  Values returned to a request stay in the clone
+ * memory until the request is released.
+ *
+ * A script may keep the request objects, e.g. in globalThis, so they refer
+ * to the request through a context cell allocated in the clone memory for
+ * each request and cleared on its release: afterwards such objects are
+ * empty instead of pointing to a freed request.
+ *
+ * Modules may keep state in their variables, including the request objects,
+ * which must not outlive the request, so with "js_module" each request gets
+ * its own clone.
+ */
+
+static nxt_int_t
+nxt_js_vm_get(nxt_js_conf_t *jcf, nxt_js_cache_t *cache)
+{
+    njs_int_t  ret;
+
+    nxt_thread_spin_lock(&jcf->lock);
+
+    if (jcf->nvms != 0) {
+        *cache = jcf->vms[--jcf->nvms];
+    }
+
+    nxt_thread_spin_unlock(&jcf->lock);
+
+    if (cache->vm == NULL) {
+        cache->vm = njs_vm_clone(jcf->vm, jcf);
+        if (nxt_slow_path(cache->vm == NULL)) {
+            return NXT_ERROR;
+        }
+
+        cache->uses = 0;
+        cache->failed = 0;
+
+        ret = njs_vm_start(cache->vm, &cache->array);
+        if (nxt_slow_path(ret != NJS_OK)) {
+            goto fail;
+        }
+    }
+
+    cache->ctx = njs_mp_alloc(cache->vm->mem_pool, sizeof(void *));
+    if (nxt_slow_path(cache->ctx == NULL)) {
+        goto fail;
+    }
+
+    *cache->ctx = NULL;
+
+    return NXT_OK;
+
+fail:
+
+    njs_vm_destroy(cache->vm);
+    cache->vm = NULL;
+
+    return NXT_ERROR;
+}
+
+
 void
-nxt_js_release(nxt_js_cache_t *cache)
+nxt_js_release(nxt_js_conf_t *jcf, nxt_js_cache_t *cache)
 {
+    if (cache->vm == NULL) {
+        return;
+    }
+
+    if (cache->ctx != NULL) {
+        *cache->ctx = NULL;
+        cache->ctx = NULL;
+    }
+
+    if (jcf->vms != NULL && !cache->failed && ++cache->uses < NXT_JS_VM_USES) {
+        nxt_thread_spin_lock(&jcf->lock);
+
+        if (jcf->nvms < NXT_JS_VM_POOL) {
+            jcf->vms[jcf->nvms++] = *cache;
+            cache->vm = NULL;
+        }
+
+        nxt_thread_spin_unlock(&jcf->lock);
+    }
+
     if (cache->vm != NULL) {
         njs_vm_destroy(cache->vm);
+        cache->vm = NULL;
     }
 }
 
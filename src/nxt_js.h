@@ -18,6 +18,9 @@ typedef struct nxt_js_conf_s  nxt_js_conf_t;
 typedef struct {
     njs_vm_t            *vm;
     njs_value_t         array;
+    void                **ctx;
+    uint32_t            uses;
+    uint8_t             failed;  /* 1 bit */
 } nxt_js_cache_t;
 
 
@@ -33,13 +36,24 @@ nxt_int_t nxt_js_compile(nxt_js_conf_t *jcf);
 nxt_int_t nxt_js_test(nxt_js_conf_t *jcf, nxt_str_t *str, u_char *error);
 nxt_int_t nxt_js_call(nxt_task_t *task, nxt_js_conf_t *jcf,
     nxt_js_cache_t *cache, nxt_js_t *js, nxt_str_t *str, void *ctx);
-void nxt_js_release(nxt_js_cache_t *cache);
+void nxt_js_release(nxt_js_conf_t *jcf, nxt_js_cache_t *cache);
 nxt_int_t nxt_js_error(njs_vm_t *vm, u_char *error);
 
 
 extern njs_int_t  nxt_js_proto_id;
 
 
+nxt_inline void *
+nxt_js_external(njs_vm_t *vm, njs_value_t *value)
+{
+    void  **ctx;
+
+    ctx = njs_vm_external(vm, nxt_js_proto_id, value);
+
+    return (ctx != NULL) ? *ctx : NULL;
+}
+
+
 #endif /* NXT_HAVE_NJS */
 
 #endif /* _NXT_JS_H_INCLUDED_ */
@@ -31,6 +31,7 @@ typedef void (*nxt_work_handler_t)(nxt_task_t *task, void *obj, void *data);
 
 #include <nxt_unix.h>
 #include <nxt_clang.h>
+#include <nxt_probe.h>
 #include <nxt_types.h>
 #include <nxt_time.h>
 #include <nxt_mp.h>
@@ -139,6 +140,7 @@ nxt_thread_extern_data(nxt_thread_t, nxt_thread_context);
 #include <nxt_port_memory.h>
 #include <nxt_port_rpc.h>
 #include <nxt_thread_pool.h>
+#include <nxt_cpuset.h>
 
 
 typedef void (*nxt_event_conn_handler_t)(nxt_thread_t *thr, nxt_conn_t *c);
@@ -141,6 +141,18 @@ static nxt_conf_map_t  nxt_common_app_conf[] = {
         offsetof(nxt_common_app_conf_t, working_directory),
     },
 
+    {
+        nxt_string("cpu_affinity"),
+        NXT_CONF_MAP_STR,
+        offsetof(nxt_common_app_conf_t, cpu_affinity),
+    },
+
+    {
+        nxt_string("preload"),
+        NXT_CONF_MAP_INT8,
+        offsetof(nxt_common_app_conf_t, preload),
+    },
+
     {
         nxt_string("environment"),
         NXT_CONF_MAP_PTR,
@@ -175,6 +187,24 @@ static nxt_conf_map_t  nxt_common_app_limits_conf[] = {
         offsetof(nxt_common_app_conf_t, request_limit),
     },
 
+    {
+        nxt_string("shm_segment"),
+        NXT_CONF_MAP_INT32,
+        offsetof(nxt_common_app_conf_t, shm_segment),
+    },
+
+    {
+        nxt_string("shm_huge_pages"),
+        NXT_CONF_MAP_INT8,
+        offsetof(nxt_common_app_conf_t, shm_huge_pages),
+    },
+
+    {
+        nxt_string("busy_poll"),
+        NXT_CONF_MAP_INT32,
+        offsetof(nxt_common_app_conf_t, busy_poll),
+    },
+
 };
 
 
@@ -507,6 +537,9 @@ nxt_main_start_process_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 
     app_conf->shm_limit = 100 * 1024 * 1024;
     app_conf->request_limit = 0;
+    app_conf->shm_segment = 0;
+    app_conf->shm_huge_pages = 0;
+    app_conf->busy_poll = 0;
 
     start += app_conf->name.length + 1;
 
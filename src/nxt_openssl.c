@@ -435,6 +435,8 @@ nxt_openssl_server_init(nxt_task_t *task, nxt_mp_t *mp,
 
 fail:
 
+    bundle->ctx = NULL;
+
     SSL_CTX_free(ctx);
 
 #if (OPENSSL_VERSION_NUMBER >= 0x1010100fL \
@@ -1278,6 +1280,10 @@ nxt_openssl_conn_handshake(nxt_task_t *task, void *obj, void *data)
         /* ret == 1, the handshake was successfully completed. */
         tls->handshake = 1;
 
+        if (tls->conf->handshake_handler != NULL) {
+            tls->conf->handshake_handler(task, c);
+        }
+
         if (c->read_state != NULL) {
             if (state->io_read_handler != NULL || c->read != NULL) {
                 nxt_conn_read(task->thread->engine, c);
@@ -356,6 +356,9 @@ NXT_EXPORT nxt_app_module_t  nxt_app_module = {
     0,
     nxt_php_setup,
     nxt_php_start,
+    NULL,
+    NULL,
+    NULL,
 };
 
 
@@ -1295,6 +1298,13 @@ nxt_php_unbuffered_write(const char *str, uint str_length TSRMLS_DC)
 
     ctx = SG(server_context);
 
+    /* Lets connection_aborted() and ignore_user_abort() see the client. */
+
+    if (nxt_slow_path(nxt_unit_request_is_cancelled(ctx->req))) {
+        php_handle_aborted_connection();
+        return 0;
+    }
+
     rc = nxt_unit_response_write(ctx->req, str, str_length);
     if (nxt_fast_path(rc == NXT_UNIT_OK)) {
         return str_length;
@@ -129,6 +129,11 @@ nxt_port_release(nxt_task_t *task, nxt_port_t *port)
     nxt_debug(task, "port %p %d:%d release, type %d", port, port->pid,
               port->id, port->type);
 
+    nxt_debug(task, "port %p %d:%d sent %ui messages in %ui calls, "
+              "received %ui messages in %ui calls", port, port->pid, port->id,
+              port->sent_msgs, port->send_calls, port->recv_msgs,
+              port->recv_calls);
+
     port->app = NULL;
 
     if (port->link.next != NULL) {
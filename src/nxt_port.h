@@ -48,6 +48,7 @@ struct nxt_port_handlers_s {
     nxt_port_handler_t  req_headers;
     nxt_port_handler_t  req_headers_ack;
     nxt_port_handler_t  req_body;
+    nxt_port_handler_t  req_cancel;
 
     /* Websocket frame. */
     nxt_port_handler_t  websocket_frame;
@@ -109,6 +110,7 @@ typedef enum {
     _NXT_PORT_MSG_REQ_HEADERS     = nxt_port_handler_idx(req_headers),
     _NXT_PORT_MSG_REQ_HEADERS_ACK = nxt_port_handler_idx(req_headers_ack),
     _NXT_PORT_MSG_REQ_BODY        = nxt_port_handler_idx(req_body),
+    _NXT_PORT_MSG_REQ_CANCEL      = nxt_port_handler_idx(req_cancel),
     _NXT_PORT_MSG_WEBSOCKET       = nxt_port_handler_idx(websocket_frame),
 
     _NXT_PORT_MSG_DATA            = nxt_port_handler_idx(data),
@@ -152,6 +154,7 @@ typedef enum {
 
     NXT_PORT_MSG_REQ_HEADERS      = _NXT_PORT_MSG_REQ_HEADERS,
     NXT_PORT_MSG_REQ_BODY         = _NXT_PORT_MSG_REQ_BODY,
+    NXT_PORT_MSG_REQ_CANCEL       = nxt_msg_last(_NXT_PORT_MSG_REQ_CANCEL),
     NXT_PORT_MSG_WEBSOCKET        = _NXT_PORT_MSG_WEBSOCKET,
     NXT_PORT_MSG_WEBSOCKET_LAST   = nxt_msg_last(_NXT_PORT_MSG_WEBSOCKET),
 
@@ -249,6 +252,12 @@ struct nxt_port_s {
     nxt_queue_t         messages;   /* of nxt_port_send_msg_t */
     nxt_thread_mutex_t  write_mutex;
 
+    /* Messages and system calls to send and receive them, for debugging. */
+    nxt_uint_t          sent_msgs;
+    nxt_uint_t          send_calls;
+    nxt_uint_t          recv_msgs;
+    nxt_uint_t          recv_calls;
+
     /* Maximum size of message part. */
     uint32_t            max_size;
     /* Maximum interleave of message parts. */
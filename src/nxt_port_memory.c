@@ -43,6 +43,17 @@ nxt_port_mmap_handler_use(nxt_port_mmap_handler_t *mmap_handler, int i)
 }
 
 
+nxt_inline uint32_t
+nxt_port_mmaps_chunks(nxt_port_mmaps_t *mmaps)
+{
+    if (mmaps->chunks == 0 || mmaps->chunks > PORT_MMAP_CHUNK_COUNT) {
+        return PORT_MMAP_CHUNK_COUNT;
+    }
+
+    return mmaps->chunks;
+}
+
+
 static nxt_port_mmap_t *
 nxt_port_mmap_at(nxt_port_mmaps_t *port_mmaps, uint32_t i)
 {
@@ -323,6 +334,17 @@ nxt_port_new_port_mmap(nxt_task_t *task, nxt_port_mmaps_t *mmaps,
         goto remove_fail;
     }
 
+#if (NXT_HAVE_MADV_HUGEPAGE)
+
+    if (mmaps->huge_pages
+        && madvise(mem, PORT_MMAP_SIZE, MADV_HUGEPAGE) != 0)
+    {
+        nxt_log(task, NXT_LOG_WARN, "madvise(MADV_HUGEPAGE) failed %E",
+                nxt_errno);
+    }
+
+#endif
+
     mmap_handler->hdr = mem;
     mmap_handler->fd = fd;
     port_mmap->mmap_handler = mmap_handler;
@@ -345,9 +367,14 @@ nxt_port_new_port_mmap(nxt_task_t *task, nxt_port_mmaps_t *mmaps,
         nxt_port_mmap_set_chunk_busy(free_map, i);
     }
 
-    /* Mark as busy chunk followed the last available chunk. */
-    nxt_port_mmap_set_chunk_busy(hdr->free_map, PORT_MMAP_CHUNK_COUNT);
-    nxt_port_mmap_set_chunk_busy(hdr->free_tracking_map, PORT_MMAP_CHUNK_COUNT);
+    /*
+     * Mark as busy chunks followed the last available chunk, the pages
+     * of a smaller segment beyond its chunks are never touched.
+     */
+    for (i = nxt_port_mmaps_chunks(mmaps); i <= PORT_MMAP_CHUNK_COUNT; i++) {
+        nxt_port_mmap_set_chunk_busy(hdr->free_map, i);
+        nxt_port_mmap_set_chunk_busy(hdr->free_tracking_map, i);
+    }
 
     nxt_log(task, NXT_LOG_DEBUG, "new mmap #%D created for %PI -> ...",
             hdr->id, nxt_pid);
@@ -503,8 +530,12 @@ nxt_port_mmap_get(nxt_task_t *task, nxt_port_mmaps_t *mmaps, nxt_chunk_id_t *c,
     *c = 0;
     mmap_handler = nxt_port_new_port_mmap(task, mmaps, tracking, n);
 
+    nxt_probe2(shm_segment, mmaps->size, n);
+
 unlock_return:
 
+    nxt_probe3(shm_alloc, mmap_handler, *c, n);
+
     nxt_thread_mutex_unlock(&mmaps->mutex);
 
     return mmap_handler;
@@ -553,7 +584,7 @@ nxt_port_mmap_get_buf(nxt_task_t *task, nxt_port_mmaps_t *mmaps, size_t size)
 
     nchunks = (size + PORT_MMAP_CHUNK_SIZE - 1) / PORT_MMAP_CHUNK_SIZE;
 
-    if (nxt_slow_path(nchunks > PORT_MMAP_CHUNK_COUNT)) {
+    if (nxt_slow_path(nchunks > (nxt_int_t) nxt_port_mmaps_chunks(mmaps))) {
         nxt_alert(task, "requested buffer (%z) too big", size);
 
         return NULL;
@@ -74,6 +74,13 @@ nxt_port_queue_send(nxt_port_queue_t volatile *q, const void *p, uint8_t size,
 }
 
 
+nxt_inline nxt_bool_t
+nxt_port_queue_is_empty(nxt_port_queue_t volatile *q)
+{
+    return nxt_nncq_head(&q->queue) == nxt_nncq_tail(&q->queue);
+}
+
+
 nxt_inline ssize_t
 nxt_port_queue_recv(nxt_port_queue_t volatile *q, void *p)
 {
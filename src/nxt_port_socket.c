@@ -13,6 +13,38 @@
 #define NXT_PORT_MAX_ENQUEUE_BUF_SIZE \
           (int) (NXT_PORT_QUEUE_MSG_SIZE - sizeof(nxt_port_msg_t))
 
+/* The maximum number of messages sent or received in a system call. */
+
+#if (NXT_HAVE_SENDMMSG)
+#define NXT_PORT_SEND_BATCH  8
+#endif
+
+#if (NXT_HAVE_RECVMMSG)
+#define NXT_PORT_RECV_BATCH  4
+#else
+#define NXT_PORT_RECV_BATCH  1
+#endif
+
+
+#if (NXT_HAVE_SENDMMSG)
+
+typedef struct {
+    nxt_port_send_msg_t  *msg;
+    size_t               size;
+    size_t               plain_size;
+    nxt_send_oob_t       oob;
+    struct iovec         iov[NXT_IOBUF_MAX];
+} nxt_port_send_batch_t;
+
+#endif
+
+
+typedef struct {
+    nxt_port_recv_msg_t  msg;
+    nxt_recv_oob_t       oob;
+    struct iovec         iov[2];
+} nxt_port_recv_batch_t;
+
 
 static nxt_bool_t nxt_port_can_enqueue_buf(nxt_buf_t *b);
 static uint8_t nxt_port_enqueue_buf(nxt_task_t *task, nxt_port_msg_t *pm,
@@ -21,6 +53,13 @@ static nxt_int_t nxt_port_msg_chk_insert(nxt_task_t *task, nxt_port_t *port,
     nxt_port_send_msg_t *msg);
 static nxt_port_send_msg_t *nxt_port_msg_alloc(const nxt_port_send_msg_t *m);
 static void nxt_port_write_handler(nxt_task_t *task, void *obj, void *data);
+static size_t nxt_port_write_prepare(nxt_task_t *task, nxt_port_t *port,
+    nxt_port_send_msg_t *msg, struct iovec *iov, nxt_sendbuf_coalesce_t *sb,
+    void *mmsg_buf, nxt_port_method_t *method);
+#if (NXT_HAVE_SENDMMSG)
+static nxt_int_t nxt_port_write_batch(nxt_task_t *task, nxt_port_t *port,
+    nxt_work_queue_t *wq, int *use_delta);
+#endif
 static nxt_port_send_msg_t *nxt_port_msg_first(nxt_port_t *port);
 nxt_inline void nxt_port_msg_close_fd(nxt_port_send_msg_t *msg);
 nxt_inline void nxt_port_close_fds(nxt_fd_t *fd);
@@ -29,6 +68,8 @@ static nxt_buf_t *nxt_port_buf_completion(nxt_task_t *task,
 static nxt_port_send_msg_t *nxt_port_msg_insert_tail(nxt_port_t *port,
     nxt_port_send_msg_t *msg);
 static void nxt_port_read_handler(nxt_task_t *task, void *obj, void *data);
+static ssize_t nxt_port_read_batch(nxt_port_t *port,
+    nxt_port_recv_batch_t *batch, nxt_uint_t n);
 static void nxt_port_queue_read_handler(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_port_read_msg_process(nxt_task_t *task, nxt_port_t *port,
@@ -369,6 +410,9 @@ nxt_port_write_handler(nxt_task_t *task, void *obj, void *data)
     int                     use_delta;
     size_t                  plain_size;
     ssize_t                 n;
+#if (NXT_HAVE_SENDMMSG)
+    nxt_int_t               ret;
+#endif
     uint32_t                mmsg_buf[3 * NXT_IOBUF_MAX * 10];
     nxt_bool_t              block_write, enable_write;
     nxt_port_t              *port;
@@ -391,6 +435,20 @@ nxt_port_write_handler(nxt_task_t *task, void *obj, void *data)
             msg = data;
 
         } else {
+#if (NXT_HAVE_SENDMMSG)
+            ret = nxt_port_write_batch(task, port, wq, &use_delta);
+
+            if (ret == NXT_OK || ret == NXT_AGAIN) {
+                continue;
+            }
+
+            if (nxt_slow_path(ret == NXT_ERROR)) {
+                goto fail;
+            }
+
+            /* NXT_DECLINED */
+#endif
+
             msg = nxt_port_msg_first(port);
 
             if (msg == NULL) {
@@ -401,51 +459,15 @@ nxt_port_write_handler(nxt_task_t *task, void *obj, void *data)
 
 next_fragment:
 
-        iov[0].iov_base = &msg->port_msg;
-        iov[0].iov_len = sizeof(nxt_port_msg_t);
-
-        sb.buf = msg->buf;
-        sb.iobuf = &iov[1];
-        sb.nmax = NXT_IOBUF_MAX - 1;
-        sb.sync = 0;
-        sb.last = 0;
-        sb.size = 0;
-        sb.limit = port->max_size;
-
-        sb.limit_reached = 0;
-        sb.nmax_reached = 0;
-
-        m = nxt_port_mmap_get_method(task, port, msg->buf);
-
-        if (m == NXT_PORT_METHOD_MMAP) {
-            sb.limit = (1ULL << 31) - 1;
-            sb.nmax = nxt_min(NXT_IOBUF_MAX * 10 - 1,
-                              port->max_size / PORT_MMAP_MIN_SIZE);
-        }
-
-        sb.limit -= iov[0].iov_len;
-
-        nxt_sendbuf_mem_coalesce(task, &sb);
-
-        plain_size = sb.size;
-
-        /*
-         * Send through mmap enabled only when payload
-         * is bigger than PORT_MMAP_MIN_SIZE.
-         */
-        if (m == NXT_PORT_METHOD_MMAP && plain_size > PORT_MMAP_MIN_SIZE) {
-            nxt_port_mmap_write(task, port, msg, &sb, mmsg_buf);
-
-        } else {
-            m = NXT_PORT_METHOD_PLAIN;
-        }
-
-        msg->port_msg.last |= sb.last;
-        msg->port_msg.mf = sb.limit_reached || sb.nmax_reached;
+        plain_size = nxt_port_write_prepare(task, port, msg, iov, &sb,
+                                            mmsg_buf, &m);
 
         n = nxt_socketpair_send(&port->socket, msg->fd, iov, sb.niov + 1);
 
         if (n > 0) {
+            port->sent_msgs++;
+            port->send_calls++;
+
             if (nxt_slow_path((size_t) n != sb.size + iov[0].iov_len)) {
                 nxt_alert(task, "port %d: short write: %z instead of %uz",
                           port->socket.fd, n, sb.size + iov[0].iov_len);
@@ -565,6 +587,189 @@ nxt_port_write_handler(nxt_task_t *task, void *obj, void *data)
 }
 
 
+static size_t
+nxt_port_write_prepare(nxt_task_t *task, nxt_port_t *port,
+    nxt_port_send_msg_t *msg, struct iovec *iov, nxt_sendbuf_coalesce_t *sb,
+    void *mmsg_buf, nxt_port_method_t *method)
+{
+    size_t             plain_size;
+    nxt_port_method_t  m;
+
+    iov[0].iov_base = &msg->port_msg;
+    iov[0].iov_len = sizeof(nxt_port_msg_t);
+
+    sb->buf = msg->buf;
+    sb->iobuf = &iov[1];
+    sb->nmax = NXT_IOBUF_MAX - 1;
+    sb->sync = 0;
+    sb->last = 0;
+    sb->size = 0;
+    sb->limit = port->max_size;
+
+    sb->limit_reached = 0;
+    sb->nmax_reached = 0;
+
+    m = nxt_port_mmap_get_method(task, port, msg->buf);
+
+    if (m == NXT_PORT_METHOD_MMAP) {
+        sb->limit = (1ULL << 31) - 1;
+        sb->nmax = nxt_min(NXT_IOBUF_MAX * 10 - 1,
+                           port->max_size / PORT_MMAP_MIN_SIZE);
+    }
+
+    sb->limit -= iov[0].iov_len;
+
+    nxt_sendbuf_mem_coalesce(task, sb);
+
+    plain_size = sb->size;
+
+    /*
+     * Send through mmap enabled only when payload
+     * is bigger than PORT_MMAP_MIN_SIZE.
+     */
+    if (m == NXT_PORT_METHOD_MMAP && plain_size > PORT_MMAP_MIN_SIZE) {
+        nxt_port_mmap_write(task, port, msg, sb, mmsg_buf);
+
+    } else {
+        m = NXT_PORT_METHOD_PLAIN;
+    }
+
+    msg->port_msg.last |= sb->last;
+    msg->port_msg.mf = sb->limit_reached || sb->nmax_reached;
+
+    *method = m;
+
+    return plain_size;
+}
+
+
+#if (NXT_HAVE_SENDMMSG)
+
+/*
+ * Queued plain messages which fit in a single datagram are sent with one
+ * sendmmsg() call.  Messages with shared memory buffers, fragmented
+ * messages and single messages are left to nxt_port_write_handler() and
+ * then NXT_DECLINED is returned.  Preparing a plain message has no side
+ * effects besides its header flags, so the messages which were not sent
+ * are prepared again on the next pass.
+ */
+
+static nxt_int_t
+nxt_port_write_batch(nxt_task_t *task, nxt_port_t *port, nxt_work_queue_t *wq,
+    int *use_delta)
+{
+    ssize_t                 n;
+    nxt_uint_t              i, nmsgs;
+    struct mmsghdr          mmsg[NXT_PORT_SEND_BATCH];
+    nxt_queue_link_t        *lnk;
+    nxt_port_method_t       m;
+    nxt_port_send_msg_t     *msg;
+    nxt_port_send_batch_t   *bm, batch[NXT_PORT_SEND_BATCH];
+    nxt_sendbuf_coalesce_t  sb;
+
+    nmsgs = 0;
+
+    nxt_thread_mutex_lock(&port->write_mutex);
+
+    for (lnk = nxt_queue_first(&port->messages);
+         lnk != nxt_queue_tail(&port->messages) && nmsgs < NXT_PORT_SEND_BATCH;
+         lnk = nxt_queue_next(lnk))
+    {
+        batch[nmsgs++].msg = nxt_queue_link_data(lnk, nxt_port_send_msg_t,
+                                                 link);
+    }
+
+    nxt_thread_mutex_unlock(&port->write_mutex);
+
+    if (nmsgs < 2) {
+        return NXT_DECLINED;
+    }
+
+    for (i = 0; i < nmsgs; i++) {
+        bm = &batch[i];
+        msg = bm->msg;
+
+        if (nxt_port_mmap_get_method(task, port, msg->buf)
+            == NXT_PORT_METHOD_MMAP)
+        {
+            break;
+        }
+
+        bm->plain_size = nxt_port_write_prepare(task, port, msg, bm->iov, &sb,
+                                                NULL, &m);
+
+        if (msg->port_msg.mf || sb.buf != NULL) {
+            break;
+        }
+
+        bm->size = sb.size + sizeof(nxt_port_msg_t);
+
+        nxt_socket_msg_oob_init(&bm->oob, msg->fd);
+
+        nxt_memzero(&mmsg[i], sizeof(struct mmsghdr));
+
+        mmsg[i].msg_hdr.msg_iov = bm->iov;
+        mmsg[i].msg_hdr.msg_iovlen = sb.niov + 1;
+
+        if (bm->oob.size != 0) {
+            mmsg[i].msg_hdr.msg_control = bm->oob.buf;
+            mmsg[i].msg_hdr.msg_controllen = bm->oob.size;
+        }
+    }
+
+    nmsgs = i;
+
+    if (nmsgs < 2) {
+        return NXT_DECLINED;
+    }
+
+    n = nxt_socketpair_send_batch(&port->socket, mmsg, nmsgs);
+
+    if (n <= 0) {
+        return n;
+    }
+
+    port->sent_msgs += n;
+    port->send_calls++;
+
+    for (i = 0; i < (nxt_uint_t) n; i++) {
+        if (nxt_slow_path(mmsg[i].msg_len != batch[i].size)) {
+            nxt_alert(task, "port %d: short write: %uD instead of %uz",
+                      port->socket.fd, mmsg[i].msg_len, batch[i].size);
+            return NXT_ERROR;
+        }
+    }
+
+    for (i = 0; i < (nxt_uint_t) n; i++) {
+        bm = &batch[i];
+        msg = bm->msg;
+
+        nxt_port_msg_close_fd(msg);
+
+        msg->buf = nxt_port_buf_completion(task, wq, msg->buf, bm->plain_size,
+                                           0);
+    }
+
+    nxt_thread_mutex_lock(&port->write_mutex);
+
+    for (i = 0; i < (nxt_uint_t) n; i++) {
+        nxt_queue_remove(&batch[i].msg->link);
+    }
+
+    nxt_thread_mutex_unlock(&port->write_mutex);
+
+    for (i = 0; i < (nxt_uint_t) n; i++) {
+        nxt_port_release_send_msg(batch[i].msg);
+    }
+
+    *use_delta -= n;
+
+    return NXT_OK;
+}
+
+#endif
+
+
 static nxt_port_send_msg_t *
 nxt_port_msg_first(nxt_port_t *port)
 {
@@ -730,59 +935,91 @@ nxt_port_read_close(nxt_port_t *port)
 static void
 nxt_port_read_handler(nxt_task_t *task, void *obj, void *data)
 {
-    ssize_t              n;
-    nxt_buf_t            *b;
-    nxt_int_t            ret;
-    nxt_port_t           *port;
-    nxt_recv_oob_t       oob;
-    nxt_port_recv_msg_t  msg;
-    struct iovec         iov[2];
+    ssize_t                n;
+    nxt_buf_t              *b;
+    nxt_int_t              ret;
+    nxt_uint_t             i, nbufs;
+    nxt_port_t             *port;
+    nxt_port_recv_msg_t    *msg;
+    nxt_port_recv_batch_t  batch[NXT_PORT_RECV_BATCH];
 
-    port = msg.port = nxt_container_of(obj, nxt_port_t, socket);
+    port = nxt_container_of(obj, nxt_port_t, socket);
 
     nxt_assert(port->engine == task->thread->engine);
 
     for ( ;; ) {
-        b = nxt_port_buf_alloc(port);
 
-        if (nxt_slow_path(b == NULL)) {
-            /* TODO: disable event for some time */
-        }
+        for (nbufs = 0; nbufs < NXT_PORT_RECV_BATCH; nbufs++) {
+            b = nxt_port_buf_alloc(port);
+
+            if (nxt_slow_path(b == NULL)) {
+                /* TODO: disable event for some time */
+                break;
+            }
+
+            msg = &batch[nbufs].msg;
+
+            msg->port = port;
+            msg->buf = b;
+
+            batch[nbufs].iov[0].iov_base = &msg->port_msg;
+            batch[nbufs].iov[0].iov_len = sizeof(nxt_port_msg_t);
 
-        iov[0].iov_base = &msg.port_msg;
-        iov[0].iov_len = sizeof(nxt_port_msg_t);
+            batch[nbufs].iov[1].iov_base = b->mem.pos;
+            batch[nbufs].iov[1].iov_len = port->max_size;
+        }
 
-        iov[1].iov_base = b->mem.pos;
-        iov[1].iov_len = port->max_size;
+        if (nxt_slow_path(nbufs == 0)) {
+            n = 0;
+            goto fail;
+        }
 
-        n = nxt_socketpair_recv(&port->socket, iov, 2, &oob);
+        n = nxt_port_read_batch(port, batch, nbufs);
 
         if (n > 0) {
-            msg.fd[0] = -1;
-            msg.fd[1] = -1;
+            port->recv_msgs += n;
+            port->recv_calls++;
 
-            ret = nxt_socket_msg_oob_get(&oob, msg.fd,
-                                         nxt_recv_msg_cmsg_pid_ref(&msg));
-            if (nxt_slow_path(ret != NXT_OK)) {
-                nxt_alert(task, "failed to get oob data from %d",
-                          port->socket.fd);
+            for (i = 0; i < (nxt_uint_t) n; i++) {
+                msg = &batch[i].msg;
+                b = msg->buf;
 
-                nxt_port_close_fds(msg.fd);
+                msg->fd[0] = -1;
+                msg->fd[1] = -1;
 
-                goto fail;
-            }
+                ret = nxt_socket_msg_oob_get(&batch[i].oob, msg->fd,
+                                             nxt_recv_msg_cmsg_pid_ref(msg));
+                if (nxt_slow_path(ret != NXT_OK)) {
+                    nxt_alert(task, "failed to get oob data from %d",
+                              port->socket.fd);
 
-            msg.buf = b;
-            msg.size = n;
+                    nxt_port_close_fds(msg->fd);
 
-            nxt_port_read_msg_process(task, port, &msg);
+                    n = i;
+                    goto fail;
+                }
 
-            /*
-             * To disable instant completion or buffer re-usage,
-             * handler should reset 'msg.buf'.
-             */
-            if (msg.buf == b) {
-                nxt_port_buf_free(port, b);
+                /* The read side may be closed by a previous message. */
+
+                if (nxt_slow_path(port->pair[0] == -1)) {
+                    nxt_port_close_fds(msg->fd);
+                    nxt_port_buf_free(port, b);
+                    continue;
+                }
+
+                nxt_port_read_msg_process(task, port, msg);
+
+                /*
+                 * To disable instant completion or buffer re-usage,
+                 * handler should reset 'msg->buf'.
+                 */
+                if (msg->buf == b) {
+                    nxt_port_buf_free(port, b);
+                }
+            }
+
+            for (i = n; i < nbufs; i++) {
+                nxt_port_buf_free(port, batch[i].msg.buf);
             }
 
             if (port->socket.read_ready) {
@@ -793,14 +1030,23 @@ nxt_port_read_handler(nxt_task_t *task, void *obj, void *data)
         }
 
         if (n == NXT_AGAIN) {
-            nxt_port_buf_free(port, b);
+            for (i = 0; i < nbufs; i++) {
+                nxt_port_buf_free(port, batch[i].msg.buf);
+            }
 
             nxt_fd_event_enable_read(task->thread->engine, &port->socket);
             return;
         }
 
+        n = 0;
+
 fail:
         /* n == 0 || error  */
+
+        for (i = n; i < nbufs; i++) {
+            nxt_port_buf_free(port, batch[i].msg.buf);
+        }
+
         nxt_work_queue_add(&task->thread->engine->fast_work_queue,
                            nxt_port_error_handler, task, &port->socket, NULL);
         return;
@@ -808,6 +1054,46 @@ nxt_port_read_handler(nxt_task_t *task, void *obj, void *data)
 }
 
 
+static ssize_t
+nxt_port_read_batch(nxt_port_t *port, nxt_port_recv_batch_t *batch,
+    nxt_uint_t n)
+{
+    ssize_t         ret;
+#if (NXT_HAVE_RECVMMSG)
+    nxt_uint_t      i;
+    struct mmsghdr  mmsg[NXT_PORT_RECV_BATCH];
+
+    for (i = 0; i < n; i++) {
+        nxt_memzero(&mmsg[i], sizeof(struct mmsghdr));
+
+        mmsg[i].msg_hdr.msg_iov = batch[i].iov;
+        mmsg[i].msg_hdr.msg_iovlen = 2;
+        mmsg[i].msg_hdr.msg_control = batch[i].oob.buf;
+        mmsg[i].msg_hdr.msg_controllen = sizeof(batch[i].oob.buf);
+    }
+
+    ret = nxt_socketpair_recv_batch(&port->socket, mmsg, n);
+
+    for (i = 0; i < (nxt_uint_t) nxt_max(ret, 0); i++) {
+        batch[i].msg.size = mmsg[i].msg_len;
+        batch[i].oob.size = mmsg[i].msg_hdr.msg_controllen;
+    }
+
+#else
+
+    ret = nxt_socketpair_recv(&port->socket, batch[0].iov, 2, &batch[0].oob);
+
+    if (ret > 0) {
+        batch[0].msg.size = ret;
+        ret = 1;
+    }
+
+#endif
+
+    return ret;
+}
+
+
 static void
 nxt_port_queue_read_handler(nxt_task_t *task, void *obj, void *data)
 {
@@ -0,0 +1,48 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NXT_PROBE_H_INCLUDED_
+#define _NXT_PROBE_H_INCLUDED_
+
+
+/*
+ * USDT static probes of the "unit" provider.  With "--usdt" each probe is
+ * a single nop instruction plus an ELF note describing where its arguments
+ * are, so arguments should be values already at hand; without "--usdt"
+ * the macros expand to nothing.  Probe names are used by tracers as is,
+ * e.g. "usdt:unitd:unit:http_request_start".
+ */
+
+#if (NXT_HAVE_USDT)
+
+#include <sys/sdt.h>
+
+#define nxt_probe(name)                                                       \
+    DTRACE_PROBE(unit, name)
+
+#define nxt_probe1(name, a1)                                                  \
+    DTRACE_PROBE1(unit, name, a1)
+
+#define nxt_probe2(name, a1, a2)                                              \
+    DTRACE_PROBE2(unit, name, a1, a2)
+
+#define nxt_probe3(name, a1, a2, a3)                                          \
+    DTRACE_PROBE3(unit, name, a1, a2, a3)
+
+#define nxt_probe4(name, a1, a2, a3, a4)                                      \
+    DTRACE_PROBE4(unit, name, a1, a2, a3, a4)
+
+#else
+
+#define nxt_probe(name)
+#define nxt_probe1(name, a1)
+#define nxt_probe2(name, a1, a2)
+#define nxt_probe3(name, a1, a2, a3)
+#define nxt_probe4(name, a1, a2, a3, a4)
+
+#endif
+
+
+#endif /* _NXT_PROBE_H_INCLUDED_ */
@@ -604,6 +604,8 @@ nxt_process_create(nxt_task_t *task, nxt_process_t *process)
     process->pid = pid;
     process->isolated_pid = pid;
 
+    nxt_probe3(process_spawn, pid, process->name, nxt_process_type(process));
+
     rt = task->thread->runtime;
 
     if (rt->is_pid_isolated) {
@@ -845,6 +847,8 @@ nxt_process_whoami_ok(nxt_task_t *task, nxt_port_recv_msg_t *msg, void *data)
                                      -1, 0, 0, NULL);
 
         nxt_log(task, NXT_LOG_INFO, "%s started", process->name);
+
+        nxt_probe2(process_ready, nxt_pid, process->name);
     }
 
     if (nxt_slow_path(nxt_process_do_start(task, process) != NXT_OK)) {
@@ -923,6 +927,8 @@ nxt_process_created_ok(nxt_task_t *task, nxt_port_recv_msg_t *msg, void *data)
 
     nxt_log(task, NXT_LOG_INFO, "%s started", process->name);
 
+    nxt_probe2(process_ready, nxt_pid, process->name);
+
     ret = nxt_process_send_ready(task, process);
     if (nxt_slow_path(ret != NXT_OK)) {
         goto fail;
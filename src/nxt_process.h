@@ -64,6 +64,10 @@ typedef struct {
     uint32_t            size;
     uint32_t            cap;
     nxt_port_mmap_t     *elts;
+
+    /* Chunks available in new segments, zero stands for all chunks. */
+    uint32_t            chunks;
+    uint8_t             huge_pages;  /* 1 bit */
 } nxt_port_mmaps_t;
 
 
@@ -31,8 +31,18 @@ typedef struct {
     uint32_t          spare_processes;
     nxt_msec_t        timeout;
     nxt_msec_t        idle_timeout;
+    nxt_msec_t        cooldown;
+    nxt_str_t         policy;
+    nxt_str_t         restart_mode;
+    uint32_t          restart_batch;
+    nxt_msec_t        drain_timeout;
+    size_t            shm_segment;
+    uint8_t           shm_huge_pages;
+    nxt_str_t         sendfile_root;
+    uint8_t           ignore_client_abort;
     nxt_conf_value_t  *limits_value;
     nxt_conf_value_t  *processes_value;
+    nxt_conf_value_t  *restart_value;
     nxt_conf_value_t  *targets_value;
 } nxt_router_app_conf_t;
 
@@ -105,12 +115,28 @@ static void nxt_router_conf_data_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg);
 static void nxt_router_app_restart_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg);
+static nxt_int_t nxt_router_app_restart_rolling(nxt_task_t *task,
+    nxt_app_t *app, nxt_port_t *shared_port);
+static void nxt_router_app_restart_switch(nxt_app_t *app);
+static void nxt_router_app_restart_timeout(nxt_task_t *task, void *obj,
+    void *data);
+static void nxt_router_app_quit_graceful(nxt_task_t *task, nxt_port_t *port);
+static void nxt_router_app_restart_done(nxt_task_t *task,
+    nxt_app_restart_t *restart);
 static void nxt_router_status_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg);
+static void nxt_router_traffic_status(nxt_router_conf_t *rtcf,
+    nxt_router_traffic_t *traffic, nxt_status_traffic_t *stat);
+static void nxt_router_app_shm_status(nxt_app_t *app,
+    nxt_status_app_t *app_stat);
+static void nxt_router_mmaps_status(nxt_port_mmaps_t *mmaps, uint32_t chunks,
+    nxt_status_app_t *app_stat);
 static void nxt_router_remove_pid_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg);
 
 static nxt_router_temp_conf_t *nxt_router_temp_conf(nxt_task_t *task);
+static void nxt_router_listeners_traffic_keep(nxt_queue_t *updating,
+    nxt_queue_t *keeping);
 static void nxt_router_conf_ready(nxt_task_t *task,
     nxt_router_temp_conf_t *tmcf);
 static void nxt_router_conf_send(nxt_task_t *task,
@@ -126,6 +152,7 @@ static nxt_int_t nxt_router_conf_forward_header(nxt_mp_t *mp,
     nxt_conf_value_t *conf, nxt_http_forward_header_t *fh);
 
 static nxt_app_t *nxt_router_app_find(nxt_queue_t *queue, nxt_str_t *name);
+static nxt_int_t nxt_router_app_stats_init(nxt_app_t *app, uint32_t nstats);
 static nxt_int_t nxt_router_apps_hash_test(nxt_lvlhsh_query_t *lhq, void *data);
 static nxt_int_t nxt_router_apps_hash_add(nxt_router_conf_t *rtcf,
     nxt_app_t *app);
@@ -152,6 +179,11 @@ static void nxt_router_tls_rpc_handler(nxt_task_t *task,
 static nxt_int_t nxt_router_conf_tls_insert(nxt_router_temp_conf_t *tmcf,
     nxt_conf_value_t *value, nxt_socket_conf_t *skcf, nxt_tls_init_t *tls_init,
     nxt_bool_t last);
+static nxt_int_t nxt_router_tls_conf_get(nxt_router_temp_conf_t *tmcf,
+    nxt_socket_conf_t *skcf, nxt_conf_value_t *value);
+static void nxt_router_tls_conf_release(nxt_task_t *task,
+    nxt_thread_spinlock_t *lock, nxt_queue_t *sockets);
+static void nxt_router_tls_conf_free(nxt_task_t *task, nxt_tls_conf_t *tlscf);
 #endif
 #if (NXT_HAVE_NJS)
 static void nxt_router_js_module_rpc_handler(nxt_task_t *task,
@@ -179,6 +211,8 @@ static nxt_int_t nxt_router_engine_conf_update(nxt_router_temp_conf_t *tmcf,
     nxt_router_engine_conf_t *recf);
 static nxt_int_t nxt_router_engine_conf_delete(nxt_router_temp_conf_t *tmcf,
     nxt_router_engine_conf_t *recf);
+static nxt_int_t nxt_router_engine_cpu_bind(nxt_router_temp_conf_t *tmcf,
+    nxt_router_engine_conf_t *recf, nxt_uint_t n);
 static nxt_int_t nxt_router_engine_joints_create(nxt_router_temp_conf_t *tmcf,
     nxt_router_engine_conf_t *recf, nxt_queue_t *sockets,
     nxt_work_handler_t handler);
@@ -210,12 +244,18 @@ static void nxt_router_listen_socket_delete(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_worker_thread_quit(nxt_task_t *task, void *obj,
     void *data);
+static void nxt_router_worker_thread_cpu_bind(nxt_task_t *task, void *obj,
+    void *data);
 static void nxt_router_listen_socket_close(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_thread_exit_handler(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_req_headers_ack_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg, nxt_request_rpc_data_t *req_rpc_data);
+static nxt_int_t nxt_router_x_sendfile(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_str_t *path);
+static void nxt_router_response_discard(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_buf_t *b);
 static void nxt_router_listen_socket_release(nxt_task_t *task,
     nxt_socket_conf_t *skcf);
 
@@ -231,6 +271,8 @@ static void nxt_router_app_port_release(nxt_task_t *task, nxt_app_t *app,
     nxt_port_t *port, nxt_apr_action_t action);
 static void nxt_router_app_port_get(nxt_task_t *task, nxt_app_t *app,
     nxt_request_rpc_data_t *req_rpc_data);
+static void nxt_router_app_request_account(nxt_task_t *task,
+    nxt_request_rpc_data_t *req_rpc_data, nxt_status_req_outcome_t outcome);
 static void nxt_router_http_request_error(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_http_request_done(nxt_task_t *task, void *obj,
@@ -398,7 +440,7 @@ nxt_router_start_app_process_handler(nxt_task_t *task, nxt_port_t *port,
     nxt_int_t            ret;
     nxt_app_t            *app;
     nxt_buf_t            *b;
-    nxt_port_t           *dport;
+    nxt_port_t           *dport, *shared_port;
     nxt_runtime_t        *rt;
     nxt_app_joint_rpc_t  *app_joint_rpc;
 
@@ -443,8 +485,16 @@ nxt_router_start_app_process_handler(nxt_task_t *task, nxt_port_t *port,
         *b->mem.free++ = '\0';
         nxt_buf_cpystr(b, &app->conf);
 
-        port_fd = app->shared_port->pair[0];
-        queue_fd = app->shared_port->queue_fd;
+        nxt_thread_mutex_lock(&app->mutex);
+
+        shared_port = (app->restart != NULL
+                       && app->restart->next_shared_port != NULL)
+                      ? app->restart->next_shared_port : app->shared_port;
+
+        nxt_thread_mutex_unlock(&app->mutex);
+
+        port_fd = shared_port->pair[0];
+        queue_fd = shared_port->queue_fd;
     }
 
     app_joint_rpc = nxt_port_rpc_register_handler_ex(task, port,
@@ -609,6 +659,26 @@ nxt_request_rpc_data_unlink(nxt_task_t *task,
 
     app = req_rpc_data->app;
 
+    nxt_router_app_request_account(task, req_rpc_data,
+                                   NXT_STATUS_REQ_CANCELLED);
+
+    /*
+     * The application has taken the request but not finished the response,
+     * so tell it to stop: the response has nowhere to go.
+     */
+
+    if (req_rpc_data->rpc_cancel
+        && req_rpc_data->acked != 0
+        && req_rpc_data->app_port != NULL)
+    {
+        nxt_debug(task, "stream #%uD: cancel in app", req_rpc_data->stream);
+
+        (void) nxt_port_socket_write(task, req_rpc_data->app_port,
+                                     NXT_PORT_MSG_REQ_CANCEL, -1,
+                                     req_rpc_data->stream,
+                                     task->thread->engine->port->id, NULL);
+    }
+
     if (req_rpc_data->app_port != NULL) {
         nxt_router_app_port_release(task, app, req_rpc_data->app_port,
                                     req_rpc_data->apr_action);
@@ -872,6 +942,12 @@ nxt_router_app_restart_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
     app = nxt_router_app_find(&nxt_router->apps, &app_name);
 
     if (nxt_fast_path(app != NULL)) {
+        if (nxt_slow_path(app->restart != NULL)) {
+            nxt_log(task, NXT_LOG_WARN, "application \"%V\" restart is "
+                    "already in progress", &app->name);
+            goto fail;
+        }
+
         shared_port = nxt_port_new(task, NXT_SHARED_PORT_ID, nxt_pid,
                                    NXT_PROCESS_APP);
         if (nxt_slow_path(shared_port == NULL)) {
@@ -894,6 +970,23 @@ nxt_router_app_restart_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 
         nxt_port_write_enable(task, shared_port);
 
+        if (app->rolling_restart) {
+            ret = nxt_router_app_restart_rolling(task, app, shared_port);
+
+            if (ret == NXT_OK) {
+                reply = NXT_PORT_MSG_RPC_READY_LAST;
+                goto done;
+            }
+
+            if (nxt_slow_path(ret == NXT_ERROR)) {
+                nxt_port_close(task, shared_port);
+                nxt_port_use(task, shared_port, -1);
+                goto fail;
+            }
+
+            /* NXT_DECLINED: there are no processes to replace. */
+        }
+
         nxt_thread_mutex_lock(&app->mutex);
 
         proto_port = app->proto_port;
@@ -938,23 +1031,297 @@ nxt_router_app_restart_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
         reply = NXT_PORT_MSG_RPC_ERROR;
     }
 
+done:
+
     nxt_port_socket_write(task, reply_port, reply, -1, msg->port_msg.stream,
                           0, NULL);
 }
 
 
+/*
+ * Rolling restart keeps the current processes serving requests while
+ * replacement processes are started from a new prototype and attached
+ * to a new shared port.  Once "batch" replacements are ready, requests are
+ * switched to the new shared port.  The old processes then finish requests
+ * left in the old shared queue, get a graceful QUIT and exit after their
+ * active requests are done.  Processes still running after "drain_timeout"
+ * are stopped.
+ */
+
+#define NXT_ROUTER_RESTART_POLL   100   /* msec */
+
+/* Matches NXT_QUIT_GRACEFUL in libunit. */
+#define NXT_ROUTER_QUIT_GRACEFUL  1
+
+
+static nxt_int_t
+nxt_router_app_restart_rolling(nxt_task_t *task, nxt_app_t *app,
+    nxt_port_t *shared_port)
+{
+    uint32_t            i, n, batch;
+    nxt_port_t          *port;
+    nxt_app_restart_t   *restart;
+    nxt_event_engine_t  *engine;
+
+    nxt_thread_mutex_lock(&app->mutex);
+
+    batch = (app->restart_batch != 0) ? app->restart_batch : app->processes;
+
+    if (batch == 0) {
+        nxt_thread_mutex_unlock(&app->mutex);
+
+        return NXT_DECLINED;
+    }
+
+    n = 0;
+
+    nxt_queue_each(port, &app->ports, nxt_port_t, app_link) {
+        n++;
+    } nxt_queue_loop;
+
+    restart = nxt_zalloc(sizeof(nxt_app_restart_t) + n * sizeof(nxt_port_t *));
+    if (nxt_slow_path(restart == NULL)) {
+        nxt_thread_mutex_unlock(&app->mutex);
+
+        return NXT_ERROR;
+    }
+
+    restart->old_ports = (nxt_port_t **) (restart + 1);
+
+    nxt_queue_each(port, &app->ports, nxt_port_t, app_link) {
+        nxt_port_inc_use(port);
+
+        restart->old_ports[restart->nold_ports++] = port;
+    } nxt_queue_loop;
+
+    restart->app = app;
+    restart->next_shared_port = shared_port;
+    restart->batch = batch;
+
+    port = app->proto_port;
+
+    if (port != NULL) {
+        app->proto_port = NULL;
+        port->app = NULL;
+    }
+
+    restart->old_proto_port = port;
+
+    app->generation++;
+    app->pending_processes += batch;
+    app->restart = restart;
+
+    nxt_thread_mutex_unlock(&app->mutex);
+
+    nxt_router_app_use(task, app, 1);
+
+    engine = task->thread->engine;
+
+    restart->timer.bias = NXT_TIMER_DEFAULT_BIAS;
+    restart->timer.work_queue = &engine->fast_work_queue;
+    restart->timer.handler = nxt_router_app_restart_timeout;
+    restart->timer.task = &engine->task;
+    restart->timer.log = engine->task.log;
+
+    restart->deadline = engine->timers.now + app->drain_timeout;
+
+    nxt_timer_add(engine, &restart->timer, app->drain_timeout);
+
+    nxt_log(task, NXT_LOG_INFO, "application \"%V\" rolling restart, "
+            "starting %uD processes", &app->name, batch);
+
+    for (i = 0; i < batch; i++) {
+        nxt_router_start_app_process(task, app);
+    }
+
+    return NXT_OK;
+}
+
+
+/* Called with app->mutex locked. */
+
+static void
+nxt_router_app_restart_switch(nxt_app_t *app)
+{
+    nxt_app_restart_t  *restart;
+
+    restart = app->restart;
+
+    restart->old_shared_port = app->shared_port;
+    restart->old_shared_port->app = NULL;
+
+    app->shared_port = restart->next_shared_port;
+    app->shared_port->app = app;
+
+    restart->next_shared_port = NULL;
+}
+
+
+static void
+nxt_router_app_restart_timeout(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_app_t           *app;
+    nxt_bool_t          expired, graceful;
+    nxt_port_t          *port;
+    nxt_uint_t          i, alive;
+    nxt_timer_t         *timer;
+    nxt_app_restart_t   *restart;
+    nxt_event_engine_t  *engine;
+
+    timer = obj;
+    restart = nxt_timer_data(timer, nxt_app_restart_t, timer);
+    app = restart->app;
+    engine = task->thread->engine;
+
+    expired = (nxt_msec_diff(engine->timers.now, restart->deadline) >= 0);
+
+    if (restart->next_shared_port != NULL) {
+        nxt_thread_mutex_lock(&app->mutex);
+
+        nxt_router_app_restart_switch(app);
+
+        nxt_thread_mutex_unlock(&app->mutex);
+
+        nxt_log(task, NXT_LOG_WARN, "application \"%V\" rolling restart: "
+                "%uD of %uD processes are ready, switching requests anyway",
+                &app->name, restart->ready, restart->batch);
+
+        restart->deadline = engine->timers.now + app->drain_timeout;
+        expired = (app->drain_timeout == 0);
+    }
+
+    /*
+     * Processes stop reading the shared queue after a graceful QUIT,
+     * so it is sent only when requests left in the old queue are taken.
+     */
+    graceful = !expired && !restart->quit_sent
+               && nxt_app_queue_is_empty(restart->old_shared_port->queue);
+
+    alive = 0;
+
+    for (i = 0; i < restart->nold_ports; i++) {
+        port = restart->old_ports[i];
+
+        if (port->pair[1] == -1) {
+            continue;
+        }
+
+        alive++;
+
+        if (expired) {
+            nxt_debug(task, "app '%V' send QUIT to pid %PI (drain timeout)",
+                      &app->name, port->pid);
+
+            (void) nxt_port_socket_write(task, port, NXT_PORT_MSG_QUIT,
+                                         -1, 0, 0, NULL);
+
+        } else if (graceful) {
+            nxt_router_app_quit_graceful(task, port);
+        }
+    }
+
+    if (graceful) {
+        restart->quit_sent = 1;
+    }
+
+    if (alive == 0 || expired) {
+        nxt_router_app_restart_done(task, restart);
+        return;
+    }
+
+    nxt_timer_add(engine, timer, NXT_ROUTER_RESTART_POLL);
+}
+
+
+static void
+nxt_router_app_quit_graceful(nxt_task_t *task, nxt_port_t *port)
+{
+    nxt_int_t  ret;
+    nxt_buf_t  *b;
+
+    nxt_debug(task, "send graceful QUIT to pid %PI", port->pid);
+
+    b = nxt_buf_mem_alloc(task->thread->engine->mem_pool, 1, 0);
+    if (nxt_slow_path(b == NULL)) {
+        return;
+    }
+
+    *b->mem.free++ = NXT_ROUTER_QUIT_GRACEFUL;
+
+    ret = nxt_port_socket_write(task, port, NXT_PORT_MSG_QUIT, -1, 0, 0, b);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        nxt_mp_free(b->data, b);
+    }
+}
+
+
+static void
+nxt_router_app_restart_done(nxt_task_t *task, nxt_app_restart_t *restart)
+{
+    nxt_app_t   *app;
+    nxt_uint_t  i;
+    nxt_port_t  *port;
+
+    /* Called from the timer handler, so the timer is not armed. */
+
+    app = restart->app;
+
+    nxt_thread_mutex_lock(&app->mutex);
+
+    app->restart = NULL;
+
+    nxt_thread_mutex_unlock(&app->mutex);
+
+    for (i = 0; i < restart->nold_ports; i++) {
+        nxt_port_use(task, restart->old_ports[i], -1);
+    }
+
+    port = restart->old_proto_port;
+
+    if (port != NULL) {
+        nxt_debug(task, "send QUIT to prototype '%V' pid %PI", &app->name,
+                  port->pid);
+
+        (void) nxt_port_socket_write(task, port, NXT_PORT_MSG_QUIT,
+                                     -1, 0, 0, NULL);
+
+        nxt_port_close(task, port);
+
+        nxt_port_use(task, port, -1);
+    }
+
+    port = restart->old_shared_port;
+
+    nxt_port_close(task, port);
+    nxt_port_use(task, port, -1);
+
+    nxt_log(task, NXT_LOG_INFO, "application \"%V\" rolling restart "
+            "finished", &app->name);
+
+    nxt_free(restart);
+
+    nxt_router_app_use(task, app, -1);
+}
+
+
 static void
 nxt_router_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 {
-    u_char               *p;
-    size_t               alloc;
-    nxt_app_t            *app;
-    nxt_buf_t            *b;
-    nxt_uint_t           type;
-    nxt_port_t           *port;
-    nxt_status_app_t     *app_stat;
-    nxt_event_engine_t   *engine;
-    nxt_status_report_t  *report;
+    u_char                   *p;
+    size_t                   alloc;
+    uint32_t                 i;
+    nxt_app_t                *app;
+    nxt_buf_t                *b;
+    nxt_uint_t               n, type;
+    nxt_port_t               *port;
+    nxt_router_conf_t        *rtcf;
+    nxt_socket_conf_t        *skcf;
+    nxt_status_app_t         *app_stat;
+    nxt_status_route_t       *route_stat;
+    nxt_event_engine_t       *engine;
+    nxt_status_report_t      *report;
+    nxt_status_listener_t    *listener_stat;
+    nxt_router_route_step_t  *step;
 
     port = nxt_runtime_port_find(task->thread->runtime,
                                  msg->port_msg.pid,
@@ -972,6 +1339,29 @@ nxt_router_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 
     } nxt_queue_loop;
 
+    rtcf = NULL;
+
+    nxt_queue_each(skcf, &nxt_router->sockets, nxt_socket_conf_t, link) {
+
+        alloc += sizeof(nxt_status_listener_t) + skcf->name.length;
+
+        /* Routes of the current configuration are shared by listeners. */
+        rtcf = skcf->router_conf;
+
+    } nxt_queue_loop;
+
+    step = NULL;
+    n = 0;
+
+    if (rtcf != NULL && rtcf->route_steps != NULL) {
+        step = rtcf->route_steps->elts;
+        n = rtcf->route_steps->nelts;
+
+        for (i = 0; i < n; i++) {
+            alloc += sizeof(nxt_status_route_t) + step[i].name.length;
+        }
+    }
+
     b = nxt_buf_mem_alloc(port->mem_pool, alloc, 0);
     if (nxt_slow_path(b == NULL)) {
         type = NXT_PORT_MSG_RPC_ERROR;
@@ -1009,10 +1399,65 @@ nxt_router_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
         app_stat->processes = app->processes;
         app_stat->idle_processes = app->idle_processes;
 
+        nxt_router_app_shm_status(app, app_stat);
+
+        app_stat->adaptive = app->scaling.adaptive;
+        app_stat->scale_reason = app->scaling.reason;
+        app_stat->scale_ups = app->scaling.ups;
+        app_stat->scale_downs = app->scaling.downs;
+        app_stat->queue_wait = app->scaling.queue_wait;
+        app_stat->service_time = app->scaling.service_time;
+
+        nxt_memzero(&app_stat->stats, sizeof(nxt_status_app_stats_t));
+
+        for (i = 0; i < app->nstats; i++) {
+            nxt_status_app_stats_merge(&app_stat->stats, &app->stats[i]->stats);
+        }
+
         report->apps_count++;
         app_stat++;
     } nxt_queue_loop;
 
+    report->listeners_count = 0;
+    listener_stat = nxt_status_listeners(report);
+
+    nxt_queue_each(skcf, &nxt_router->sockets, nxt_socket_conf_t, link) {
+        p -= skcf->name.length;
+
+        nxt_memcpy(p, skcf->name.start, skcf->name.length);
+
+        listener_stat->name.length = skcf->name.length;
+        listener_stat->name.start = (u_char *) (p - b->mem.pos);
+
+#if (NXT_TLS)
+        listener_stat->tls = (skcf->tls != NULL);
+#else
+        listener_stat->tls = 0;
+#endif
+
+        nxt_router_traffic_status(skcf->router_conf, skcf->traffic,
+                                  &listener_stat->traffic);
+
+        report->listeners_count++;
+        listener_stat++;
+    } nxt_queue_loop;
+
+    report->routes_count = n;
+    route_stat = nxt_status_routes(report);
+
+    for (i = 0; i < n; i++) {
+        p -= step[i].name.length;
+
+        nxt_memcpy(p, step[i].name.start, step[i].name.length);
+
+        route_stat->name.length = step[i].name.length;
+        route_stat->name.start = (u_char *) (p - b->mem.pos);
+
+        nxt_router_traffic_status(rtcf, step[i].traffic, &route_stat->traffic);
+
+        route_stat++;
+    }
+
     type = NXT_PORT_MSG_RPC_READY_LAST;
 
 fail:
@@ -1021,6 +1466,84 @@ nxt_router_status_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
 }
 
 
+static void
+nxt_router_traffic_status(nxt_router_conf_t *rtcf,
+    nxt_router_traffic_t *traffic, nxt_status_traffic_t *stat)
+{
+    uint32_t  i;
+
+    nxt_memzero(stat, sizeof(nxt_status_traffic_t));
+
+    if (traffic == NULL) {
+        return;
+    }
+
+    for (i = 0; i <= rtcf->threads; i++) {
+        nxt_status_traffic_merge(stat, &traffic[i].traffic);
+    }
+}
+
+
+static void
+nxt_router_app_shm_status(nxt_app_t *app, nxt_status_app_t *app_stat)
+{
+    nxt_port_t  *port;
+
+    app_stat->shm_segments = 0;
+    app_stat->shm_chunks = 0;
+    app_stat->shm_busy_chunks = 0;
+    app_stat->shm_oosm = app->oosm;
+
+    nxt_router_mmaps_status(&app->outgoing, app->outgoing.chunks, app_stat);
+
+    /* Application processes use the same segment size for responses. */
+
+    nxt_thread_mutex_lock(&app->mutex);
+
+    nxt_queue_each(port, &app->ports, nxt_port_t, app_link) {
+
+        nxt_router_mmaps_status(&port->process->incoming, app->outgoing.chunks,
+                                app_stat);
+
+    } nxt_queue_loop;
+
+    nxt_thread_mutex_unlock(&app->mutex);
+}
+
+
+static void
+nxt_router_mmaps_status(nxt_port_mmaps_t *mmaps, uint32_t chunks,
+    nxt_status_app_t *app_stat)
+{
+    uint32_t                 i, c;
+    nxt_port_mmap_header_t   *hdr;
+    nxt_port_mmap_handler_t  *mmap_handler;
+
+    nxt_thread_mutex_lock(&mmaps->mutex);
+
+    for (i = 0; i < mmaps->size; i++) {
+        mmap_handler = mmaps->elts[i].mmap_handler;
+
+        if (mmap_handler == NULL || mmap_handler->hdr == NULL) {
+            continue;
+        }
+
+        hdr = mmap_handler->hdr;
+
+        app_stat->shm_segments++;
+        app_stat->shm_chunks += chunks;
+
+        for (c = 0; c < chunks; c++) {
+            if (nxt_port_mmap_get_chunk_busy(hdr->free_map, c)) {
+                app_stat->shm_busy_chunks++;
+            }
+        }
+    }
+
+    nxt_thread_mutex_unlock(&mmaps->mutex);
+}
+
+
 static void
 nxt_router_app_process_remove_pid(nxt_task_t *task, nxt_port_t *port,
     void *data)
@@ -1154,13 +1677,207 @@ nxt_router_app_can_start(nxt_app_t *app)
 }
 
 
-nxt_inline nxt_bool_t
-nxt_router_app_need_start(nxt_app_t *app)
-{
-    return (app->active_requests
-              > app->port_hash_count + app->pending_processes)
-           || (app->spare_processes
-                > app->idle_processes + app->pending_processes);
+/*
+ * The adaptive policy starts a process ahead of demand when every running
+ * process is busy or when requests wait in the shared queue for a noticeable
+ * part of their service time.  Idle processes are not stopped while the
+ * queue wait stays above a lower watermark or during the cooldown period
+ * after the last start, which prevents oscillation under steady load.
+ */
+
+#define NXT_ROUTER_SCALE_UP_WAIT    1000    /* usec */
+#define NXT_ROUTER_SCALE_DOWN_WAIT  250     /* usec */
+#define NXT_ROUTER_SCALE_STALE      5000    /* msec */
+
+
+nxt_inline nxt_bool_t
+nxt_router_app_queue_wait_fresh(nxt_app_t *app, nxt_msec_t now)
+{
+    return app->scaling.last_sample != 0
+           && nxt_msec_diff(now, app->scaling.last_sample)
+              < NXT_ROUTER_SCALE_STALE;
+}
+
+
+nxt_inline nxt_uint_t
+nxt_router_app_scale_ahead(nxt_app_t *app, nxt_msec_t now)
+{
+    nxt_app_scaling_t  *scaling;
+
+    if (app->pending_processes != 0) {
+        return NXT_STATUS_SCALE_NONE;
+    }
+
+    if (app->active_requests != 0
+        && app->active_requests >= app->port_hash_count)
+    {
+        return NXT_STATUS_SCALE_UP_DEMAND;
+    }
+
+    scaling = &app->scaling;
+
+    if (nxt_router_app_queue_wait_fresh(app, now)
+        && scaling->queue_wait >= NXT_ROUTER_SCALE_UP_WAIT
+        && scaling->queue_wait > scaling->service_time / 2)
+    {
+        return NXT_STATUS_SCALE_UP_QUEUE;
+    }
+
+    return NXT_STATUS_SCALE_NONE;
+}
+
+
+/*
+ * A process is started each time this returns true, so the adaptive policy
+ * accounts the decision here.  Called with app->mutex locked.
+ */
+
+nxt_inline nxt_bool_t
+nxt_router_app_need_start(nxt_app_t *app)
+{
+    nxt_uint_t  reason;
+    nxt_msec_t  now;
+
+    if (app->spare_processes > app->idle_processes + app->pending_processes) {
+        reason = NXT_STATUS_SCALE_UP_SPARE;
+
+    } else if (app->active_requests
+               > app->port_hash_count + app->pending_processes)
+    {
+        reason = NXT_STATUS_SCALE_UP_DEMAND;
+
+    } else {
+        reason = NXT_STATUS_SCALE_NONE;
+    }
+
+    if (!app->scaling.adaptive) {
+        return (reason != NXT_STATUS_SCALE_NONE);
+    }
+
+    now = nxt_thread_monotonic_time(nxt_thread()) / 1000000;
+
+    if (reason == NXT_STATUS_SCALE_NONE) {
+        reason = nxt_router_app_scale_ahead(app, now);
+
+        if (reason == NXT_STATUS_SCALE_NONE) {
+            return 0;
+        }
+    }
+
+    app->scaling.reason = reason;
+    app->scaling.last_up = now;
+    app->scaling.ups++;
+
+    return 1;
+}
+
+
+nxt_inline void
+nxt_router_app_scaling_sample(uint32_t *ewma, nxt_nsec_t start, nxt_nsec_t end)
+{
+    int64_t  sample;
+
+    sample = nxt_min((end - start) / 1000, NXT_INT32_T_MAX);
+
+    /* The smoothing factor is 1/8. */
+    *ewma = (int64_t) *ewma + (sample - (int64_t) *ewma) / 8;
+}
+
+
+/*
+ * Each router engine records request statistics only into its own slot,
+ * so no locking is needed; slots are merged by nxt_router_status_handler().
+ */
+
+nxt_inline nxt_status_app_stats_t *
+nxt_router_app_stats(nxt_task_t *task, nxt_app_t *app)
+{
+    uint32_t  id;
+
+    id = task->thread->engine->id;
+
+    return (id < app->nstats) ? &app->stats[id]->stats : NULL;
+}
+
+
+static void
+nxt_router_app_request_account(nxt_task_t *task,
+    nxt_request_rpc_data_t *req_rpc_data, nxt_status_req_outcome_t outcome)
+{
+    nxt_nsec_t              now;
+    nxt_http_request_t      *r;
+    nxt_status_app_stats_t  *stats;
+
+    if (req_rpc_data->app == NULL || req_rpc_data->accounted) {
+        return;
+    }
+
+    req_rpc_data->accounted = 1;
+
+    stats = nxt_router_app_stats(task, req_rpc_data->app);
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->requests[outcome]++;
+
+    if (outcome != NXT_STATUS_REQ_COMPLETED) {
+        return;
+    }
+
+    now = nxt_thread_monotonic_time(task->thread);
+
+    if (req_rpc_data->acked != 0) {
+        nxt_status_hist_add(&stats->service_time,
+                            (now - req_rpc_data->acked) / 1000);
+    }
+
+    r = req_rpc_data->request;
+
+    if (r != NULL) {
+        r->timing.app_done = now;
+
+        nxt_status_hist_add(&stats->total_time, (now - r->start_time) / 1000);
+    }
+}
+
+
+/*
+ * Tests whether idle processes of an adaptive application must be kept
+ * and sets the time until which they are kept.  Called with app->mutex
+ * locked.
+ */
+
+static nxt_bool_t
+nxt_router_app_scale_down_hold(nxt_app_t *app, nxt_msec_t now,
+    nxt_msec_t *until)
+{
+    nxt_app_scaling_t  *scaling;
+
+    scaling = &app->scaling;
+
+    if (scaling->ups != 0
+        && nxt_msec_diff(now, scaling->last_up) < (int32_t) scaling->cooldown)
+    {
+        scaling->reason = NXT_STATUS_SCALE_HOLD_COOLDOWN;
+
+        *until = scaling->last_up + scaling->cooldown;
+
+        return 1;
+    }
+
+    if (nxt_router_app_queue_wait_fresh(app, now)
+        && scaling->queue_wait >= NXT_ROUTER_SCALE_DOWN_WAIT
+        && scaling->queue_wait > scaling->service_time / 8)
+    {
+        scaling->reason = NXT_STATUS_SCALE_HOLD_QUEUE;
+
+        *until = scaling->last_sample + NXT_ROUTER_SCALE_STALE;
+
+        return 1;
+    }
+
+    return 0;
 }
 
 
@@ -1242,7 +1959,9 @@ nxt_router_conf_apply(nxt_task_t *task, void *obj, void *data)
 
     } nxt_queue_loop;
 
-    if (rtcf->access_log != NULL && rtcf->access_log->fd == -1) {
+    if ((rtcf->access_log != NULL && rtcf->access_log->fd == -1)
+        || (rtcf->trace_log != NULL && rtcf->trace_log->fd == -1))
+    {
         nxt_router_access_log_open(task, tmcf);
         return;
     }
@@ -1269,6 +1988,10 @@ nxt_router_conf_apply(nxt_task_t *task, void *obj, void *data)
 
     nxt_router_engines_post(router, tmcf);
 
+    router->cpu_bound = (rtcf->cpuset.n != 0);
+
+    nxt_router_listeners_traffic_keep(&updating_sockets, &keeping_sockets);
+
     nxt_queue_add(&router->sockets, &updating_sockets);
     nxt_queue_add(&router->sockets, &creating_sockets);
 
@@ -1280,6 +2003,14 @@ nxt_router_conf_apply(nxt_task_t *task, void *obj, void *data)
         router->access_log = rtcf->access_log;
     }
 
+    if (router->trace_log != rtcf->trace_log) {
+        nxt_router_access_log_use(&router->lock, rtcf->trace_log);
+
+        nxt_router_access_log_release(task, &router->lock, router->trace_log);
+
+        router->trace_log = rtcf->trace_log;
+    }
+
     nxt_router_conf_ready(task, tmcf);
 
     return;
@@ -1292,6 +2023,56 @@ nxt_router_conf_apply(nxt_task_t *task, void *obj, void *data)
 }
 
 
+/*
+ * Counters of listeners kept by a new configuration continue from the
+ * totals of the previous one, which are placed in the main engine slot.
+ * Requests still finishing with the previous configuration are not counted.
+ */
+
+static void
+nxt_router_listeners_traffic_keep(nxt_queue_t *updating, nxt_queue_t *keeping)
+{
+    uint32_t              i;
+    nxt_queue_link_t      *nqlk, *qlk;
+    nxt_socket_conf_t     *nskcf, *skcf;
+    nxt_status_traffic_t  *traffic;
+
+    for (nqlk = nxt_queue_first(updating);
+         nqlk != nxt_queue_tail(updating);
+         nqlk = nxt_queue_next(nqlk))
+    {
+        nskcf = nxt_queue_link_data(nqlk, nxt_socket_conf_t, link);
+
+        for (qlk = nxt_queue_first(keeping);
+             qlk != nxt_queue_tail(keeping);
+             qlk = nxt_queue_next(qlk))
+        {
+            skcf = nxt_queue_link_data(qlk, nxt_socket_conf_t, link);
+
+            if (skcf->listen != nskcf->listen) {
+                continue;
+            }
+
+            traffic = &nskcf->traffic[0].traffic;
+
+            for (i = 0; i <= skcf->router_conf->threads; i++) {
+                nxt_status_traffic_merge(traffic, &skcf->traffic[i].traffic);
+            }
+
+            break;
+        }
+    }
+}
+
+
+nxt_router_traffic_t *
+nxt_router_traffic_create(nxt_router_conf_t *rtcf)
+{
+    return nxt_mp_zalign(rtcf->mem_pool, 64,
+                         (rtcf->threads + 1) * sizeof(nxt_router_traffic_t));
+}
+
+
 static void
 nxt_router_conf_wait(nxt_task_t *task, void *obj, void *data)
 {
@@ -1334,6 +2115,7 @@ nxt_router_conf_ready(nxt_task_t *task, nxt_router_temp_conf_t *tmcf)
         nxt_router_apps_hash_use(task, rtcf, -1);
 
         nxt_router_access_log_release(task, lock, rtcf->access_log);
+        nxt_router_access_log_release(task, lock, rtcf->trace_log);
 
         nxt_mp_destroy(rtcf->mem_pool);
     }
@@ -1383,9 +2165,16 @@ nxt_router_conf_error(nxt_task_t *task, nxt_router_temp_conf_t *tmcf)
 
     nxt_queue_add(&router->apps, &tmcf->previous);
 
+#if (NXT_TLS)
+    nxt_router_tls_conf_release(task, &router->lock, &pending_sockets);
+    nxt_router_tls_conf_release(task, &router->lock, &creating_sockets);
+    nxt_router_tls_conf_release(task, &router->lock, &updating_sockets);
+#endif
+
     // TODO: new engines and threads
 
     nxt_router_access_log_release(task, &router->lock, rtcf->access_log);
+    nxt_router_access_log_release(task, &router->lock, rtcf->trace_log);
 
     nxt_mp_destroy(rtcf->mem_pool);
 
@@ -1441,11 +2230,29 @@ static nxt_conf_map_t  nxt_router_app_conf[] = {
         offsetof(nxt_router_app_conf_t, processes_value),
     },
 
+    {
+        nxt_string("restart"),
+        NXT_CONF_MAP_PTR,
+        offsetof(nxt_router_app_conf_t, restart_value),
+    },
+
     {
         nxt_string("targets"),
         NXT_CONF_MAP_PTR,
         offsetof(nxt_router_app_conf_t, targets_value),
     },
+
+    {
+        nxt_string("sendfile_root"),
+        NXT_CONF_MAP_STR,
+        offsetof(nxt_router_app_conf_t, sendfile_root),
+    },
+
+    {
+        nxt_string("ignore_client_abort"),
+        NXT_CONF_MAP_INT8,
+        offsetof(nxt_router_app_conf_t, ignore_client_abort),
+    },
 };
 
 
@@ -1455,6 +2262,39 @@ static nxt_conf_map_t  nxt_router_app_limits_conf[] = {
         NXT_CONF_MAP_MSEC,
         offsetof(nxt_router_app_conf_t, timeout),
     },
+
+    {
+        nxt_string("shm_segment"),
+        NXT_CONF_MAP_SIZE,
+        offsetof(nxt_router_app_conf_t, shm_segment),
+    },
+
+    {
+        nxt_string("shm_huge_pages"),
+        NXT_CONF_MAP_INT8,
+        offsetof(nxt_router_app_conf_t, shm_huge_pages),
+    },
+};
+
+
+static nxt_conf_map_t  nxt_router_app_restart_conf[] = {
+    {
+        nxt_string("mode"),
+        NXT_CONF_MAP_STR,
+        offsetof(nxt_router_app_conf_t, restart_mode),
+    },
+
+    {
+        nxt_string("batch"),
+        NXT_CONF_MAP_INT32,
+        offsetof(nxt_router_app_conf_t, restart_batch),
+    },
+
+    {
+        nxt_string("drain_timeout"),
+        NXT_CONF_MAP_MSEC,
+        offsetof(nxt_router_app_conf_t, drain_timeout),
+    },
 };
 
 
@@ -1476,6 +2316,18 @@ static nxt_conf_map_t  nxt_router_app_processes_conf[] = {
         NXT_CONF_MAP_MSEC,
         offsetof(nxt_router_app_conf_t, idle_timeout),
     },
+
+    {
+        nxt_string("policy"),
+        NXT_CONF_MAP_STR,
+        offsetof(nxt_router_app_conf_t, policy),
+    },
+
+    {
+        nxt_string("cooldown"),
+        NXT_CONF_MAP_MSEC,
+        offsetof(nxt_router_app_conf_t, cooldown),
+    },
 };
 
 
@@ -1597,6 +2449,21 @@ static nxt_conf_map_t  nxt_router_websocket_conf[] = {
 };
 
 
+static nxt_conf_map_t  nxt_router_cache_conf[] = {
+    {
+        nxt_string("size"),
+        NXT_CONF_MAP_SIZE,
+        offsetof(nxt_router_conf_t, cache_size),
+    },
+
+    {
+        nxt_string("max_entry_size"),
+        NXT_CONF_MAP_SIZE,
+        offsetof(nxt_router_conf_t, cache_max_entry_size),
+    },
+};
+
+
 static nxt_int_t
 nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     u_char *start, u_char *end)
@@ -1632,11 +2499,14 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     nxt_router_listener_conf_t  lscf;
 
     static nxt_str_t  http_path = nxt_string("/settings/http");
+    static nxt_str_t  cpu_affinity_path = nxt_string("/settings/cpu_affinity");
     static nxt_str_t  applications_path = nxt_string("/applications");
     static nxt_str_t  listeners_path = nxt_string("/listeners");
     static nxt_str_t  routes_path = nxt_string("/routes");
     static nxt_str_t  access_log_path = nxt_string("/access_log");
+    static nxt_str_t  tracing_path = nxt_string("/tracing");
 #if (NXT_TLS)
+    static nxt_str_t  tls_path = nxt_string("/tls");
     static nxt_str_t  certificate_path = nxt_string("/tls/certificate");
     static nxt_str_t  conf_commands_path = nxt_string("/tls/conf_commands");
     static nxt_str_t  conf_cache_path = nxt_string("/tls/session/cache_size");
@@ -1648,6 +2518,7 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
 #endif
     static nxt_str_t  static_path = nxt_string("/settings/http/static");
     static nxt_str_t  websocket_path = nxt_string("/settings/http/websocket");
+    static nxt_str_t  cache_path = nxt_string("/settings/http/cache");
     static nxt_str_t  forwarded_path = nxt_string("/forwarded");
     static nxt_str_t  client_ip_path = nxt_string("/client_ip");
 
@@ -1671,6 +2542,18 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
         rtcf->threads = nxt_ncpu;
     }
 
+    conf = nxt_conf_get_path(root, &cpu_affinity_path);
+
+    if (conf != NULL) {
+        nxt_conf_get_string(conf, &name);
+
+        ret = nxt_cpuset_parse(mp, &rtcf->cpuset, &name);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            nxt_alert(task, "invalid \"cpu_affinity\" value \"%V\"", &name);
+            return NXT_ERROR;
+        }
+    }
+
     conf = nxt_conf_get_path(root, &static_path);
 
     ret = nxt_router_conf_process_static(task, rtcf, conf);
@@ -1678,6 +2561,20 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
         return NXT_ERROR;
     }
 
+    rtcf->cache_size = 64 * 1024 * 1024;
+    rtcf->cache_max_entry_size = 1024 * 1024;
+
+    conf = nxt_conf_get_path(root, &cache_path);
+
+    if (conf != NULL) {
+        ret = nxt_conf_map_object(mp, conf, nxt_router_cache_conf,
+                                  nxt_nitems(nxt_router_cache_conf), rtcf);
+        if (ret != NXT_OK) {
+            nxt_alert(task, "cache map error");
+            return NXT_ERROR;
+        }
+    }
+
     router = rtcf->router;
 
     applications = nxt_conf_get_path(root, &applications_path);
@@ -1729,6 +2626,11 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
                 nxt_queue_remove(&prev->link);
                 nxt_queue_insert_tail(&tmcf->previous, &prev->link);
 
+                ret = nxt_router_app_stats_init(prev, rtcf->threads + 1);
+                if (nxt_slow_path(ret != NXT_OK)) {
+                    goto fail;
+                }
+
                 ret = nxt_router_apps_hash_add(rtcf, prev);
                 if (nxt_slow_path(ret != NXT_OK)) {
                     goto fail;
@@ -1742,9 +2644,19 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
             apcf.spare_processes = 0;
             apcf.timeout = 0;
             apcf.idle_timeout = 15000;
+            apcf.cooldown = 10000;
+            nxt_str_null(&apcf.policy);
+            nxt_str_null(&apcf.restart_mode);
+            apcf.restart_batch = 0;
+            apcf.drain_timeout = 30000;
+            apcf.shm_segment = PORT_MMAP_DATA_SIZE;
+            apcf.shm_huge_pages = 0;
             apcf.limits_value = NULL;
             apcf.processes_value = NULL;
+            apcf.restart_value = NULL;
             apcf.targets_value = NULL;
+            nxt_str_null(&apcf.sendfile_root);
+            apcf.ignore_client_abort = 0;
 
             app_joint = nxt_malloc(sizeof(nxt_app_joint_t));
             if (nxt_slow_path(app_joint == NULL)) {
@@ -1794,6 +2706,17 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
                 apcf.spare_processes = apcf.processes;
             }
 
+            if (apcf.restart_value != NULL) {
+                ret = nxt_conf_map_object(mp, apcf.restart_value,
+                                        nxt_router_app_restart_conf,
+                                        nxt_nitems(nxt_router_app_restart_conf),
+                                        &apcf);
+                if (ret != NXT_OK) {
+                    nxt_alert(task, "application restart map error");
+                    goto app_fail;
+                }
+            }
+
             if (apcf.targets_value != NULL) {
                 n = nxt_conf_object_members_count(apcf.targets_value);
 
@@ -1852,6 +2775,39 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
             app->timeout = apcf.timeout;
             app->idle_timeout = apcf.idle_timeout;
 
+            app->scaling.adaptive = nxt_str_eq(&apcf.policy, "adaptive", 8);
+            app->scaling.cooldown = apcf.cooldown;
+
+            app->rolling_restart = nxt_str_eq(&apcf.restart_mode, "rolling", 7);
+            app->restart_batch = apcf.restart_batch;
+            app->drain_timeout = apcf.drain_timeout;
+            app->ignore_client_abort = apcf.ignore_client_abort;
+
+            ret = nxt_router_app_stats_init(app, rtcf->threads + 1);
+            if (nxt_slow_path(ret != NXT_OK)) {
+                goto app_fail;
+            }
+
+            app->outgoing.chunks = nxt_min(apcf.shm_segment
+                                           + PORT_MMAP_CHUNK_SIZE - 1,
+                                           PORT_MMAP_DATA_SIZE)
+                                   / PORT_MMAP_CHUNK_SIZE;
+            app->outgoing.huge_pages = apcf.shm_huge_pages;
+
+            if (apcf.sendfile_root.length != 0) {
+                p = nxt_mp_nget(app_mp, apcf.sendfile_root.length + 1);
+                if (nxt_slow_path(p == NULL)) {
+                    goto app_fail;
+                }
+
+                app->sendfile_root.start = p;
+                app->sendfile_root.length = apcf.sendfile_root.length;
+
+                p = nxt_cpymem(p, apcf.sendfile_root.start,
+                               apcf.sendfile_root.length);
+                *p = '\0';
+            }
+
             app->targets = targets;
 
             engine = task->thread->engine;
@@ -1915,6 +2871,13 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
         }
     }
 
+    /*
+     * Unlike applications and TLS contexts, routes and upstreams are
+     * rebuilt for each configuration even if unchanged: they are allocated
+     * from the configuration memory pool, use its template state, and refer
+     * to the applications and upstreams of their generation.
+     */
+
     conf = nxt_conf_get_path(root, &routes_path);
     if (nxt_fast_path(conf != NULL)) {
         routes = nxt_http_routes_create(task, tmcf, conf);
@@ -2043,6 +3006,20 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
 #if (NXT_TLS)
             certificate = nxt_conf_get_path(listener, &certificate_path);
 
+            if (certificate != NULL) {
+                value = nxt_conf_get_path(listener, &tls_path);
+
+                ret = nxt_router_tls_conf_get(tmcf, skcf, value);
+                if (nxt_slow_path(ret == NXT_ERROR)) {
+                    goto fail;
+                }
+
+                if (ret == NXT_OK) {
+                    /* The contexts of the previous configuration are kept. */
+                    certificate = NULL;
+                }
+            }
+
             if (certificate != NULL) {
                 tls_init = nxt_mp_get(tmcf->mem_pool, sizeof(nxt_tls_init_t));
                 if (nxt_slow_path(tls_init == NULL)) {
@@ -2117,6 +3094,15 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
         }
     }
 
+    value = nxt_conf_get_path(root, &tracing_path);
+
+    if (value != NULL) {
+        ret = nxt_router_trace_create(task, rtcf, value);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            goto fail;
+        }
+    }
+
 #if (NXT_HAVE_NJS)
     js_module = nxt_conf_get_path(root, &js_module_path);
 
@@ -2150,47 +3136,189 @@ nxt_router_conf_create(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
 
     return NXT_OK;
 
-app_fail:
+app_fail:
+
+    nxt_mp_destroy(app_mp);
+
+fail:
+
+    nxt_queue_each(app, &tmcf->apps, nxt_app_t, link) {
+
+        nxt_queue_remove(&app->link);
+        nxt_thread_mutex_destroy(&app->mutex);
+        nxt_mp_destroy(app->mem_pool);
+
+    } nxt_queue_loop;
+
+    return NXT_ERROR;
+}
+
+
+#if (NXT_TLS)
+
+static nxt_int_t
+nxt_router_conf_tls_insert(nxt_router_temp_conf_t *tmcf,
+    nxt_conf_value_t *value, nxt_socket_conf_t *skcf,
+    nxt_tls_init_t *tls_init, nxt_bool_t last)
+{
+    nxt_router_tlssock_t  *tls;
+
+    tls = nxt_mp_get(tmcf->mem_pool, sizeof(nxt_router_tlssock_t));
+    if (nxt_slow_path(tls == NULL)) {
+        return NXT_ERROR;
+    }
+
+    tls->tls_init = tls_init;
+    tls->socket_conf = skcf;
+    tls->temp_conf = tmcf;
+    tls->last = last;
+    nxt_conf_get_string(value, &tls->name);
+
+    nxt_queue_insert_tail(&tmcf->tls, &tls->link);
+
+    return NXT_OK;
+}
+
+
+/*
+ * Listeners whose "tls" object has not changed keep using the contexts
+ * created for the previous configuration.  Certificates cannot be replaced
+ * while used in the configuration, so the same names mean the same content.
+ * Otherwise a new TLS configuration with its own memory pool is created;
+ * it can outlive the router configuration and is freed with the last
+ * listener socket configuration that refers to it.
+ */
+
+static nxt_int_t
+nxt_router_tls_conf_get(nxt_router_temp_conf_t *tmcf, nxt_socket_conf_t *skcf,
+    nxt_conf_value_t *value)
+{
+    u_char                 *p;
+    size_t                 size;
+    nxt_mp_t               *mp;
+    nxt_str_t              conf;
+    nxt_tls_conf_t         *tlscf;
+    nxt_queue_link_t       *qlk;
+    nxt_socket_conf_t      *prev;
+    nxt_thread_spinlock_t  *lock;
+
+    size = nxt_conf_json_length(value, NULL);
+
+    conf.start = nxt_mp_nget(tmcf->mem_pool, size);
+    if (nxt_slow_path(conf.start == NULL)) {
+        return NXT_ERROR;
+    }
+
+    p = nxt_conf_json_print(conf.start, value, NULL);
+    conf.length = p - conf.start;
+
+    for (qlk = nxt_queue_first(&keeping_sockets);
+         qlk != nxt_queue_tail(&keeping_sockets);
+         qlk = nxt_queue_next(qlk))
+    {
+        prev = nxt_queue_link_data(qlk, nxt_socket_conf_t, link);
+
+        if (prev->listen != skcf->listen || prev->tls == NULL) {
+            continue;
+        }
+
+        if (!nxt_strstr_eq(&prev->tls->conf, &conf)) {
+            break;
+        }
+
+        tlscf = prev->tls;
+
+        lock = &tmcf->router_conf->router->lock;
+
+        nxt_thread_spin_lock(lock);
+
+        tlscf->count++;
+
+        nxt_thread_spin_unlock(lock);
+
+        skcf->tls = tlscf;
+
+        return NXT_OK;
+    }
+
+    mp = nxt_mp_create(1024, 128, 256, 32);
+    if (nxt_slow_path(mp == NULL)) {
+        return NXT_ERROR;
+    }
+
+    tlscf = nxt_mp_zget(mp, sizeof(nxt_tls_conf_t));
+    if (nxt_slow_path(tlscf == NULL)) {
+        goto fail;
+    }
+
+    if (nxt_slow_path(nxt_str_dup(mp, &tlscf->conf, &conf) == NULL)) {
+        goto fail;
+    }
+
+    tlscf->mem_pool = mp;
+    tlscf->count = 1;
+    tlscf->no_wait_shutdown = 1;
+    tlscf->handshake_handler = nxt_http_conn_tls_handshake;
+
+    skcf->tls = tlscf;
+
+    return NXT_DECLINED;
+
+fail:
+
+    nxt_mp_destroy(mp);
+
+    return NXT_ERROR;
+}
+
+
+static void
+nxt_router_tls_conf_release(nxt_task_t *task, nxt_thread_spinlock_t *lock,
+    nxt_queue_t *sockets)
+{
+    nxt_tls_conf_t     *tlscf;
+    nxt_queue_link_t   *qlk;
+    nxt_socket_conf_t  *skcf;
+
+    for (qlk = nxt_queue_first(sockets);
+         qlk != nxt_queue_tail(sockets);
+         qlk = nxt_queue_next(qlk))
+    {
+        skcf = nxt_queue_link_data(qlk, nxt_socket_conf_t, link);
 
-    nxt_mp_destroy(app_mp);
+        tlscf = skcf->tls;
 
-fail:
+        if (tlscf == NULL) {
+            continue;
+        }
 
-    nxt_queue_each(app, &tmcf->apps, nxt_app_t, link) {
+        nxt_thread_spin_lock(lock);
 
-        nxt_queue_remove(&app->link);
-        nxt_thread_mutex_destroy(&app->mutex);
-        nxt_mp_destroy(app->mem_pool);
+        if (--tlscf->count != 0) {
+            tlscf = NULL;
+        }
 
-    } nxt_queue_loop;
+        nxt_thread_spin_unlock(lock);
 
-    return NXT_ERROR;
+        if (tlscf != NULL) {
+            nxt_router_tls_conf_free(task, tlscf);
+        }
+    }
 }
 
 
-#if (NXT_TLS)
-
-static nxt_int_t
-nxt_router_conf_tls_insert(nxt_router_temp_conf_t *tmcf,
-    nxt_conf_value_t *value, nxt_socket_conf_t *skcf,
-    nxt_tls_init_t *tls_init, nxt_bool_t last)
+static void
+nxt_router_tls_conf_free(nxt_task_t *task, nxt_tls_conf_t *tlscf)
 {
-    nxt_router_tlssock_t  *tls;
+    nxt_debug(task, "tls conf %p is destroyed", tlscf);
 
-    tls = nxt_mp_get(tmcf->mem_pool, sizeof(nxt_router_tlssock_t));
-    if (nxt_slow_path(tls == NULL)) {
-        return NXT_ERROR;
+    if (tlscf->bundle != NULL) {
+        task->thread->runtime->tls->server_free(task, tlscf);
     }
 
-    tls->tls_init = tls_init;
-    tls->socket_conf = skcf;
-    tls->temp_conf = tmcf;
-    tls->last = last;
-    nxt_conf_get_string(value, &tls->name);
-
-    nxt_queue_insert_tail(&tmcf->tls, &tls->link);
+    nxt_mp_thread_adopt(tlscf->mem_pool);
 
-    return NXT_OK;
+    nxt_mp_destroy(tlscf->mem_pool);
 }
 
 #endif
@@ -2469,6 +3597,50 @@ nxt_router_app_find(nxt_queue_t *queue, nxt_str_t *name)
 }
 
 
+/*
+ * The statistics slots are indexed by router engine id, so an application
+ * kept across reconfigurations needs more of them when the number of
+ * threads grows.  Running engines keep their ids and may still update
+ * their slots meanwhile, so the slots are allocated one by one and never
+ * move: only the array of pointers to them is replaced, and the previous
+ * one remains in the application memory pool.  New engines are started
+ * only after the new array is set.
+ */
+
+static nxt_int_t
+nxt_router_app_stats_init(nxt_app_t *app, uint32_t nstats)
+{
+    uint32_t         i;
+    nxt_app_stats_t  **stats;
+
+    if (nstats <= app->nstats) {
+        return NXT_OK;
+    }
+
+    stats = nxt_mp_get(app->mem_pool, nstats * sizeof(nxt_app_stats_t *));
+    if (nxt_slow_path(stats == NULL)) {
+        return NXT_ERROR;
+    }
+
+    for (i = 0; i < nstats; i++) {
+        if (i < app->nstats) {
+            stats[i] = app->stats[i];
+            continue;
+        }
+
+        stats[i] = nxt_mp_zalign(app->mem_pool, 64, sizeof(nxt_app_stats_t));
+        if (nxt_slow_path(stats[i] == NULL)) {
+            return NXT_ERROR;
+        }
+    }
+
+    app->stats = stats;
+    app->nstats = nstats;
+
+    return NXT_OK;
+}
+
+
 static nxt_int_t
 nxt_router_app_queue_init(nxt_task_t *task, nxt_port_t *port)
 {
@@ -2678,6 +3850,7 @@ nxt_router_socket_conf(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     nxt_str_t *name)
 {
     size_t               size;
+    nxt_mp_t             *mp;
     nxt_int_t            ret;
     nxt_bool_t           wildcard;
     nxt_sockaddr_t       *sa;
@@ -2695,11 +3868,22 @@ nxt_router_socket_conf(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     nxt_debug(task, "router listener: \"%*s\"",
               (size_t) sa->length, nxt_sockaddr_start(sa));
 
-    skcf = nxt_mp_zget(tmcf->router_conf->mem_pool, sizeof(nxt_socket_conf_t));
+    mp = tmcf->router_conf->mem_pool;
+
+    skcf = nxt_mp_zget(mp, sizeof(nxt_socket_conf_t));
     if (nxt_slow_path(skcf == NULL)) {
         return NULL;
     }
 
+    if (nxt_slow_path(nxt_str_dup(mp, &skcf->name, name) == NULL)) {
+        return NULL;
+    }
+
+    skcf->traffic = nxt_router_traffic_create(tmcf->router_conf);
+    if (nxt_slow_path(skcf->traffic == NULL)) {
+        return NULL;
+    }
+
     size = nxt_sockaddr_size(sa);
 
     ret = nxt_router_listen_socket_find(tmcf, skcf, sa);
@@ -2742,7 +3926,7 @@ nxt_router_socket_conf(nxt_task_t *task, nxt_router_temp_conf_t *tmcf,
     }
 
     if (!wildcard) {
-        skcf->sockaddr = nxt_mp_zget(tmcf->router_conf->mem_pool, size);
+        skcf->sockaddr = nxt_mp_zget(mp, size);
         if (nxt_slow_path(skcf->sockaddr == NULL)) {
             return NULL;
         }
@@ -2969,24 +4153,12 @@ nxt_router_tls_rpc_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
         goto fail;
     }
 
-    mp = tmcf->router_conf->mem_pool;
-
-    if (tls->socket_conf->tls == NULL){
-        tlscf = nxt_mp_zget(mp, sizeof(nxt_tls_conf_t));
-        if (nxt_slow_path(tlscf == NULL)) {
-            goto fail;
-        }
-
-        tlscf->no_wait_shutdown = 1;
-        tls->socket_conf->tls = tlscf;
-
-    } else {
-        tlscf = tls->socket_conf->tls;
-    }
+    tlscf = tls->socket_conf->tls;
+    mp = tlscf->mem_pool;
 
     tls->tls_init->conf = tlscf;
 
-    bundle = nxt_mp_get(mp, sizeof(nxt_tls_bundle_conf_t));
+    bundle = nxt_mp_zget(mp, sizeof(nxt_tls_bundle_conf_t));
     if (nxt_slow_path(bundle == NULL)) {
         goto fail;
     }
@@ -3223,6 +4395,10 @@ nxt_router_engines_create(nxt_task_t *task, nxt_router_t *router,
             recf->action = NXT_ROUTER_ENGINE_KEEP;
             ret = nxt_router_engine_conf_update(tmcf, recf);
 
+            if (ret == NXT_OK) {
+                ret = nxt_router_engine_cpu_bind(tmcf, recf, n);
+            }
+
         } else {
             recf->action = NXT_ROUTER_ENGINE_DELETE;
             ret = nxt_router_engine_conf_delete(tmcf, recf);
@@ -3250,11 +4426,19 @@ nxt_router_engines_create(nxt_task_t *task, nxt_router_t *router,
             return NXT_ERROR;
         }
 
+        /* Router threads are numbered from 1, the main engine has id 0. */
+        recf->engine->id = n + 1;
+
         ret = nxt_router_engine_conf_create(tmcf, recf);
         if (nxt_slow_path(ret != NXT_OK)) {
             return ret;
         }
 
+        ret = nxt_router_engine_cpu_bind(tmcf, recf, n);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            return ret;
+        }
+
         n++;
     }
 
@@ -3331,6 +4515,56 @@ nxt_router_engine_conf_delete(nxt_router_temp_conf_t *tmcf,
 }
 
 
+/*
+ * The job binds a worker thread to a CPU of the "cpu_affinity" list
+ * in a round-robin manner.  It is added last to be run first, so the
+ * engine allocates memory for connections on the local NUMA node.
+ * A worker thread is released if the list has been removed.  As the joint
+ * jobs, it is allocated from the temporary configuration memory pool and
+ * holds the configuration until it is done.
+ */
+
+static nxt_int_t
+nxt_router_engine_cpu_bind(nxt_router_temp_conf_t *tmcf,
+    nxt_router_engine_conf_t *recf, nxt_uint_t n)
+{
+    nxt_int_t          cpu;
+    nxt_joint_job_t    *job;
+    nxt_router_conf_t  *rtcf;
+
+    rtcf = tmcf->router_conf;
+
+    if (rtcf->cpuset.n != 0) {
+        cpu = rtcf->cpuset.cpu[n % rtcf->cpuset.n];
+
+    } else if (rtcf->router->cpu_bound) {
+        cpu = -1;
+
+    } else {
+        return NXT_OK;
+    }
+
+    job = nxt_mp_get(tmcf->mem_pool, sizeof(nxt_joint_job_t));
+    if (nxt_slow_path(job == NULL)) {
+        return NXT_ERROR;
+    }
+
+    job->work.next = recf->jobs;
+    recf->jobs = &job->work;
+
+    job->task = tmcf->engine->task;
+    job->work.handler = nxt_router_worker_thread_cpu_bind;
+    job->work.task = &job->task;
+    job->work.obj = job;
+    job->work.data = (void *) (intptr_t) cpu;
+    job->tmcf = tmcf;
+
+    tmcf->count++;
+
+    return NXT_OK;
+}
+
+
 static nxt_int_t
 nxt_router_engine_joints_create(nxt_router_temp_conf_t *tmcf,
     nxt_router_engine_conf_t *recf, nxt_queue_t *sockets,
@@ -3812,6 +5046,37 @@ nxt_router_worker_thread_quit(nxt_task_t *task, void *obj, void *data)
 }
 
 
+static void
+nxt_router_worker_thread_cpu_bind(nxt_task_t *task, void *obj, void *data)
+{
+    uint32_t         cpu;
+    nxt_int_t        n;
+    nxt_joint_job_t  *job;
+
+    job = obj;
+
+    n = (intptr_t) data;
+
+    if (n < 0) {
+        nxt_debug(task, "router worker thread cpu release");
+
+        (void) nxt_cpuset_bind(task, NULL, 0);
+
+    } else {
+        nxt_debug(task, "router worker thread cpu bind: %i", n);
+
+        cpu = n;
+
+        (void) nxt_cpuset_bind(task, &cpu, 1);
+    }
+
+    job->work.next = NULL;
+    job->work.handler = nxt_router_conf_wait;
+
+    nxt_event_engine_post(job->tmcf->engine, &job->work);
+}
+
+
 static void
 nxt_router_listen_socket_close(nxt_task_t *task, void *obj, void *data)
 {
@@ -3944,6 +5209,11 @@ nxt_router_conf_release(nxt_task_t *task, nxt_socket_conf_joint_t *joint)
     nxt_socket_conf_t      *skcf;
     nxt_router_conf_t      *rtcf;
     nxt_thread_spinlock_t  *lock;
+#if (NXT_TLS)
+    nxt_tls_conf_t         *tlscf;
+
+    tlscf = NULL;
+#endif
 
     nxt_debug(task, "conf joint %p count: %D", joint, joint->count);
 
@@ -3974,6 +5244,12 @@ nxt_router_conf_release(nxt_task_t *task, nxt_socket_conf_joint_t *joint)
     } else {
         nxt_queue_remove(&skcf->link);
 
+#if (NXT_TLS)
+        if (skcf->tls != NULL && --skcf->tls->count == 0) {
+            tlscf = skcf->tls;
+        }
+#endif
+
         if (--rtcf->count != 0) {
             rtcf = NULL;
         }
@@ -3982,8 +5258,8 @@ nxt_router_conf_release(nxt_task_t *task, nxt_socket_conf_joint_t *joint)
     nxt_thread_spin_unlock(lock);
 
 #if (NXT_TLS)
-    if (skcf != NULL && skcf->tls != NULL) {
-        task->thread->runtime->tls->server_free(task, skcf->tls);
+    if (tlscf != NULL) {
+        nxt_router_tls_conf_free(task, tlscf);
     }
 #endif
 
@@ -3995,6 +5271,7 @@ nxt_router_conf_release(nxt_task_t *task, nxt_socket_conf_joint_t *joint)
         nxt_router_apps_hash_use(task, rtcf, -1);
 
         nxt_router_access_log_release(task, lock, rtcf->access_log);
+        nxt_router_access_log_release(task, lock, rtcf->trace_log);
 
         nxt_tstr_state_release(rtcf->tstr_state);
 
@@ -4045,6 +5322,7 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 {
     size_t                  b_size, count;
     nxt_int_t               ret;
+    nxt_str_t               path;
     nxt_app_t               *app;
     nxt_buf_t               *b, *next;
     nxt_port_t              *app_port;
@@ -4088,6 +5366,19 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
             req_rpc_data->apr_action = NXT_APR_GOT_RESPONSE;
         }
 
+        nxt_router_app_request_account(task, req_rpc_data,
+                                       NXT_STATUS_REQ_COMPLETED);
+
+        if (app->scaling.adaptive && req_rpc_data->acked != 0) {
+            nxt_thread_mutex_lock(&app->mutex);
+
+            nxt_router_app_scaling_sample(&app->scaling.service_time,
+                                          req_rpc_data->acked,
+                                    nxt_thread_monotonic_time(task->thread));
+
+            nxt_thread_mutex_unlock(&app->mutex);
+        }
+
         nxt_request_rpc_data_unlink(task, req_rpc_data);
 
     } else {
@@ -4107,6 +5398,12 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
         msg->buf = NULL;
     }
 
+    if (r->x_sendfile) {
+        /* The response body is replaced with the file. */
+        nxt_router_response_discard(task, r, b);
+        return;
+    }
+
     if (r->header_sent) {
         nxt_buf_chain_add(&r->out, b);
         nxt_http_request_send_body(task, r, NULL);
@@ -4168,6 +5465,17 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 
         r->status = resp->status;
 
+        if (r->resp.x_sendfile != NULL && app->sendfile_root.length != 0) {
+            if (nxt_router_x_sendfile(task, r, &path) != NXT_OK) {
+                goto fail;
+            }
+
+            nxt_router_response_discard(task, r, b);
+
+            nxt_http_static_sendfile(task, r, &app->sendfile_root, &path);
+            return;
+        }
+
         if (resp->piggyback_content_length != 0) {
             b->mem.pos = nxt_unit_sptr_get(&resp->piggyback_content);
             b->mem.free = b->mem.pos + resp->piggyback_content_length;
@@ -4209,6 +5517,14 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
             nxt_router_app_port_release(task, app, app_port, NXT_APR_UPGRADE);
             req_rpc_data->apr_action = NXT_APR_CLOSE;
 
+            /*
+             * The request is complete once upgraded; WebSocket sessions
+             * are not accounted in service time.
+             */
+            nxt_router_app_request_account(task, req_rpc_data,
+                                           NXT_STATUS_REQ_COMPLETED);
+            req_rpc_data->acked = 0;
+
             nxt_debug(task, "stream #%uD upgrade", req_rpc_data->stream);
 
             r->state = &nxt_http_websocket;
@@ -4228,6 +5544,95 @@ nxt_router_response_ready_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 }
 
 
+/*
+ * The response with "X-Sendfile" is replaced with the file it names.  The
+ * response fields are copied, as the buffer they reside in is released
+ * along with the rest of the response.
+ */
+
+static nxt_int_t
+nxt_router_x_sendfile(nxt_task_t *task, nxt_http_request_t *r, nxt_str_t *path)
+{
+    u_char            *p;
+    nxt_http_field_t  *field;
+
+    path->length = r->resp.x_sendfile->value_length;
+
+    path->start = nxt_mp_nget(r->mem_pool, path->length);
+    if (nxt_slow_path(path->start == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_memcpy(path->start, r->resp.x_sendfile->value, path->length);
+
+    r->resp.x_sendfile->skip = 1;
+    r->resp.x_sendfile = NULL;
+
+    /* The length is that of the file. */
+
+    if (r->resp.content_length != NULL) {
+        r->resp.content_length->skip = 1;
+        r->resp.content_length = NULL;
+    }
+
+    nxt_list_each(field, r->resp.fields) {
+
+        if (field->skip) {
+            continue;
+        }
+
+        p = nxt_mp_nget(r->mem_pool, field->name_length + field->value_length);
+        if (nxt_slow_path(p == NULL)) {
+            return NXT_ERROR;
+        }
+
+        nxt_memcpy(p, field->name, field->name_length);
+        field->name = p;
+
+        p += field->name_length;
+
+        nxt_memcpy(p, field->value, field->value_length);
+        field->value = p;
+
+    } nxt_list_loop;
+
+    r->x_sendfile = 1;
+
+    nxt_debug(task, "router x-sendfile \"%V\"", path);
+
+    return NXT_OK;
+}
+
+
+/*
+ * The last buffer is returned to the request, so the file response
+ * completes the request instead.
+ */
+
+static void
+nxt_router_response_discard(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_buf_t *b)
+{
+    nxt_buf_t  *next;
+
+    while (b != NULL) {
+        next = b->next;
+        b->next = NULL;
+
+        if (nxt_buf_is_last(b)) {
+            r->last = b;
+            b = next;
+            continue;
+        }
+
+        nxt_work_queue_add(&task->thread->engine->fast_work_queue,
+                           b->completion_handler, task, b, b->parent);
+
+        b = next;
+    }
+}
+
+
 static void
 nxt_router_req_headers_ack_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg, nxt_request_rpc_data_t *req_rpc_data)
@@ -4235,10 +5640,11 @@ nxt_router_req_headers_ack_handler(nxt_task_t *task,
     int                 res;
     nxt_app_t           *app;
     nxt_buf_t           *b;
-    nxt_bool_t          start_process, unlinked;
-    nxt_port_t          *app_port, *main_app_port, *idle_port;
-    nxt_queue_link_t    *idle_lnk;
-    nxt_http_request_t  *r;
+    nxt_bool_t              start_process, unlinked;
+    nxt_port_t              *app_port, *main_app_port, *idle_port;
+    nxt_queue_link_t        *idle_lnk;
+    nxt_http_request_t      *r;
+    nxt_status_app_stats_t  *stats;
 
     nxt_debug(task, "stream #%uD: got ack from %PI:%d",
               req_rpc_data->stream,
@@ -4253,8 +5659,27 @@ nxt_router_req_headers_ack_handler(nxt_task_t *task,
     start_process = 0;
     unlinked = 0;
 
+    req_rpc_data->acked = nxt_thread_monotonic_time(task->thread);
+    r->timing.app_acked = req_rpc_data->acked;
+
+    stats = nxt_router_app_stats(task, app);
+
+    if (stats != NULL) {
+        nxt_status_hist_add(&stats->queue_wait,
+                            (req_rpc_data->acked - req_rpc_data->queued)
+                            / 1000);
+    }
+
     nxt_thread_mutex_lock(&app->mutex);
 
+    if (app->scaling.adaptive) {
+        nxt_router_app_scaling_sample(&app->scaling.queue_wait,
+                                      req_rpc_data->queued,
+                                      req_rpc_data->acked);
+
+        app->scaling.last_sample = req_rpc_data->acked / 1000000;
+    }
+
     if (r->app_link.next != NULL) {
         nxt_queue_remove(&r->app_link);
         r->app_link.next = NULL;
@@ -4404,6 +5829,8 @@ nxt_router_response_error_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg,
     /* TODO cancel message and return if cancelled. */
     // nxt_router_msg_cancel(task, &req_rpc_data->msg_info, req_rpc_data->stream);
 
+    nxt_router_app_request_account(task, req_rpc_data, NXT_STATUS_REQ_FAILED);
+
     if (req_rpc_data->request != NULL) {
         nxt_http_request_error(task, req_rpc_data->request,
                                NXT_HTTP_SERVICE_UNAVAILABLE);
@@ -4419,9 +5846,11 @@ nxt_router_app_port_ready(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 {
     uint32_t             n;
     nxt_app_t            *app;
-    nxt_bool_t           start_process, restarted;
+    nxt_bool_t           start_process, restarted, switched;
     nxt_port_t           *port;
     nxt_app_joint_t      *app_joint;
+    nxt_app_restart_t    *restart;
+    nxt_event_engine_t   *engine;
     nxt_app_joint_rpc_t  *app_joint_rpc;
 
     nxt_assert(data != NULL);
@@ -4521,8 +5950,28 @@ nxt_router_app_port_ready(nxt_task_t *task, nxt_port_recv_msg_t *msg,
     nxt_port_hash_add(&app->port_hash, port);
     app->port_hash_count++;
 
+    restart = app->restart;
+
+    switched = (restart != NULL && restart->next_shared_port != NULL
+                && ++restart->ready >= restart->batch);
+
+    if (switched) {
+        nxt_router_app_restart_switch(app);
+    }
+
     nxt_thread_mutex_unlock(&app->mutex);
 
+    if (switched) {
+        nxt_log(task, NXT_LOG_INFO, "application \"%V\" rolling restart: "
+                "requests switched to new processes", &app->name);
+
+        engine = task->thread->engine;
+
+        restart->deadline = engine->timers.now + app->drain_timeout;
+
+        nxt_timer_add(engine, &restart->timer, NXT_ROUTER_RESTART_POLL);
+    }
+
     nxt_debug(task, "app '%V' new port ready, pid %PI, %d/%d",
               &app->name, port->pid, app->processes, app->pending_processes);
 
@@ -4884,7 +6333,7 @@ nxt_router_adjust_idle_timer(nxt_task_t *task, void *obj, void *data)
     nxt_app_t           *app;
     nxt_bool_t          queued;
     nxt_port_t          *port;
-    nxt_msec_t          timeout, threshold;
+    nxt_msec_t          timeout, threshold, hold;
     nxt_queue_link_t    *lnk;
     nxt_event_engine_t  *engine;
 
@@ -4899,7 +6348,7 @@ nxt_router_adjust_idle_timer(nxt_task_t *task, void *obj, void *data)
     nxt_assert(app->engine == engine);
 
     threshold = engine->timers.now + app->joint->idle_timer.bias;
-    timeout = 0;
+    timeout = threshold;
 
     nxt_thread_mutex_lock(&app->mutex);
 
@@ -4924,10 +6373,23 @@ nxt_router_adjust_idle_timer(nxt_task_t *task, void *obj, void *data)
                   &app->name, port->pid,
                   port->idle_start, timeout, threshold);
 
-        if (timeout > threshold) {
+        if (nxt_msec_diff(timeout, threshold) > 0) {
             break;
         }
 
+        if (app->scaling.adaptive) {
+            if (nxt_router_app_scale_down_hold(app, engine->timers.now,
+                                               &hold))
+            {
+                timeout = (nxt_msec_diff(hold, threshold) > 0)
+                          ? hold : threshold + 1;
+                break;
+            }
+
+            app->scaling.reason = NXT_STATUS_SCALE_DOWN_IDLE;
+            app->scaling.downs++;
+        }
+
         nxt_queue_remove(lnk);
         lnk->next = NULL;
 
@@ -4957,7 +6419,7 @@ nxt_router_adjust_idle_timer(nxt_task_t *task, void *obj, void *data)
 
     nxt_thread_mutex_unlock(&app->mutex);
 
-    if (timeout > threshold) {
+    if (nxt_msec_diff(timeout, threshold) > 0) {
         nxt_timer_add(engine, &app->joint->idle_timer, timeout - threshold);
 
     } else {
@@ -5113,7 +6575,13 @@ nxt_router_app_port_get(nxt_task_t *task, nxt_app_t *app,
         start_process = 1;
     }
 
+    req_rpc_data->queued = nxt_thread_monotonic_time(task->thread);
+
     r = req_rpc_data->request;
+    r->timing.app_queued = req_rpc_data->queued;
+
+    nxt_probe4(app_dispatch, r, req_rpc_data->stream, app->name.start,
+               app->name.length);
 
     /*
      * Put request into application-wide list to be able to cancel request
@@ -5194,6 +6662,10 @@ nxt_router_process_http_request(nxt_task_t *task, nxt_http_request_t *r,
         r->last->completion_handler = nxt_router_http_request_done;
     }
 
+    if (!conf->app->ignore_client_abort) {
+        nxt_http_request_disconnect_watch(task, r);
+    }
+
     nxt_router_app_port_get(task, conf->app, req_rpc_data);
     nxt_router_app_prepare_request(task, req_rpc_data);
 }
@@ -5211,6 +6683,9 @@ nxt_router_http_request_error(nxt_task_t *task, void *obj, void *data)
     nxt_http_request_error(task, r, NXT_HTTP_SERVICE_UNAVAILABLE);
 
     if (r->req_rpc_data != NULL) {
+        nxt_router_app_request_account(task, r->req_rpc_data,
+                                       NXT_STATUS_REQ_FAILED);
+
         nxt_request_rpc_data_unlink(task, r->req_rpc_data);
     }
 
@@ -5393,7 +6868,7 @@ nxt_router_prepare_msg(nxt_task_t *task, nxt_http_request_t *r,
     void                *target_pos, *query_pos;
     u_char              *pos, *end, *p, c;
     size_t              fields_count, req_size, size, free_size;
-    size_t              copy_size;
+    size_t              copy_size, shm_size;
     nxt_off_t           content_length;
     nxt_buf_t           *b, *buf, *out, **tail;
     nxt_http_field_t    *field, *dup;
@@ -5423,7 +6898,9 @@ nxt_router_prepare_msg(nxt_task_t *task, nxt_http_request_t *r,
 
     req_size += fields_count * sizeof(nxt_unit_field_t);
 
-    if (nxt_slow_path(req_size > PORT_MMAP_DATA_SIZE)) {
+    shm_size = app->outgoing.chunks * PORT_MMAP_CHUNK_SIZE;
+
+    if (nxt_slow_path(req_size > shm_size)) {
         nxt_alert(task, "headers to big to fit in shared memory (%d)",
                   (int) req_size);
 
@@ -5431,7 +6908,7 @@ nxt_router_prepare_msg(nxt_task_t *task, nxt_http_request_t *r,
     }
 
     out = nxt_port_mmap_get_buf(task, &app->outgoing,
-              nxt_min(req_size + content_length, PORT_MMAP_DATA_SIZE));
+              nxt_min(req_size + content_length, shm_size));
     if (nxt_slow_path(out == NULL)) {
         return NULL;
     }
@@ -5620,7 +7097,7 @@ nxt_router_prepare_msg(nxt_task_t *task, nxt_http_request_t *r,
 
         while (size > 0) {
             if (buf == NULL) {
-                free_size = nxt_min(size, PORT_MMAP_DATA_SIZE);
+                free_size = nxt_min(size, shm_size);
 
                 buf = nxt_port_mmap_get_buf(task, &app->outgoing, free_size);
                 if (nxt_slow_path(buf == NULL)) {
@@ -5681,6 +7158,9 @@ nxt_router_app_timeout(nxt_task_t *task, void *obj, void *data)
     r = nxt_timer_data(timer, nxt_http_request_t, timer);
     req_rpc_data = r->timer_data;
 
+    nxt_router_app_request_account(task, req_rpc_data,
+                                   NXT_STATUS_REQ_TIMED_OUT);
+
     nxt_http_request_error(task, r, NXT_HTTP_SERVICE_UNAVAILABLE);
 
     nxt_request_rpc_data_unlink(task, req_rpc_data);
@@ -5714,18 +7194,28 @@ nxt_router_oosm_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
     size_t                   mi;
     uint32_t                 i;
     nxt_bool_t               ack;
+    nxt_port_t               *port;
     nxt_process_t            *process;
     nxt_free_map_t           *m;
     nxt_port_mmap_handler_t  *mmap_handler;
 
     nxt_debug(task, "oosm in %PI", msg->port_msg.pid);
 
+    nxt_probe1(shm_oosm, msg->port_msg.pid);
+
     process = nxt_runtime_process_find(task->thread->runtime,
                                        msg->port_msg.pid);
     if (nxt_slow_path(process == NULL)) {
         return;
     }
 
+    port = nxt_runtime_port_find(task->thread->runtime, msg->port_msg.pid,
+                                 msg->port_msg.reply_port);
+
+    if (port != NULL && port->app != NULL) {
+        (void) nxt_atomic_fetch_add(&port->app->oosm, 1);
+    }
+
     ack = 0;
 
     /*
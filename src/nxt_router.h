@@ -14,6 +14,7 @@
 
 typedef struct nxt_http_request_s  nxt_http_request_t;
 #include <nxt_application.h>
+#include <nxt_status.h>
 
 
 typedef struct nxt_http_action_s        nxt_http_action_t;
@@ -27,6 +28,15 @@ typedef struct nxt_router_access_log_s  nxt_router_access_log_t;
 #define NXT_HTTP_ACTION_ERROR  ((nxt_http_action_t *) -1)
 
 
+/*
+ * Traffic counters collected by a single router engine; cache line
+ * aligned to avoid false sharing between router threads.
+ */
+typedef struct {
+    nxt_status_traffic_t   traffic;
+} nxt_aligned(64) nxt_router_traffic_t;
+
+
 typedef struct {
     nxt_thread_spinlock_t    lock;
     nxt_queue_t              engines;
@@ -35,6 +45,9 @@ typedef struct {
     nxt_queue_t              apps;     /* of nxt_app_t */
 
     nxt_router_access_log_t  *access_log;
+    nxt_router_access_log_t  *trace_log;
+
+    uint8_t                  cpu_bound;  /* 1 bit */
 } nxt_router_t;
 
 
@@ -42,6 +55,8 @@ typedef struct {
     uint32_t                 count;
     uint32_t                 threads;
 
+    nxt_cpuset_t             cpuset;
+
     nxt_mp_t                 *mem_pool;
     nxt_tstr_state_t         *tstr_state;
 
@@ -54,9 +69,23 @@ typedef struct {
 
     nxt_router_access_log_t  *access_log;
     nxt_tstr_t               *log_format;
+
+    nxt_router_access_log_t  *trace_log;
+    uint32_t                 trace_sampling;  /* per million requests */
+
+    nxt_array_t              *route_steps;  /* of nxt_router_route_step_t */
+
+    size_t                   cache_size;
+    size_t                   cache_max_entry_size;
 } nxt_router_conf_t;
 
 
+typedef struct {
+    nxt_str_t                name;
+    nxt_router_traffic_t     *traffic;
+} nxt_router_route_step_t;
+
+
 typedef struct {
     nxt_event_engine_t     *engine;
     nxt_work_t             *jobs;
@@ -108,6 +137,53 @@ typedef struct {
 } nxt_app_joint_t;
 
 
+typedef struct {
+    nxt_app_t              *app;
+
+    /* Shared port of replacement processes until requests are switched. */
+    nxt_port_t             *next_shared_port;
+
+    nxt_port_t             *old_shared_port;
+    nxt_port_t             *old_proto_port;
+
+    nxt_port_t             **old_ports;
+    nxt_uint_t             nold_ports;
+
+    uint32_t               batch;
+    uint32_t               ready;
+    uint8_t                quit_sent;   /* 1 bit */
+
+    nxt_msec_t             deadline;
+    nxt_timer_t            timer;
+} nxt_app_restart_t;
+
+
+typedef struct {
+    uint8_t                adaptive;    /* 1 bit */
+    uint8_t                reason;      /* nxt_status_scale_reason_t */
+
+    nxt_msec_t             cooldown;
+    nxt_msec_t             last_up;
+    nxt_msec_t             last_sample;
+
+    /* Exponentially weighted moving averages, in microseconds. */
+    uint32_t               queue_wait;
+    uint32_t               service_time;
+
+    uint32_t               ups;
+    uint32_t               downs;
+} nxt_app_scaling_t;
+
+
+/*
+ * Request statistics of an application collected by a single router engine;
+ * cache line aligned to avoid false sharing between router threads.
+ */
+typedef struct {
+    nxt_status_app_stats_t  stats;
+} nxt_aligned(64) nxt_app_stats_t;
+
+
 struct nxt_app_s {
     nxt_thread_mutex_t     mutex;       /* Protects ports queue. */
     nxt_queue_t            ports;       /* of nxt_port_t.app_link */
@@ -139,6 +215,9 @@ struct nxt_app_s {
 
     nxt_str_t              *targets;
 
+    /* The directory of files served for the "X-Sendfile" responses. */
+    nxt_str_t              sendfile_root;
+
     nxt_app_type_t         type:8;
 
     nxt_mp_t               *mem_pool;
@@ -154,6 +233,21 @@ struct nxt_app_s {
     nxt_port_t             *proto_port;
 
     nxt_port_mmaps_t       outgoing;
+
+    /* Out of shared memory events reported by application processes. */
+    nxt_atomic_uint_t      oosm;
+
+    nxt_app_scaling_t      scaling;
+
+    /* Indexed by router engine id, merged on status requests. */
+    nxt_app_stats_t        **stats;
+    uint32_t               nstats;
+
+    uint8_t                rolling_restart;      /* 1 bit */
+    uint8_t                ignore_client_abort;  /* 1 bit */
+    uint32_t               restart_batch;
+    nxt_msec_t             drain_timeout;
+    nxt_app_restart_t      *restart;
 };
 
 
@@ -171,6 +265,9 @@ typedef struct {
 
     nxt_http_action_t      *action;
 
+    nxt_str_t              name;
+    nxt_router_traffic_t   *traffic;
+
     /*
      * A listen socket time can be shorter than socket configuration life
      * time, so a copy of the non-wildcard socket sockaddr is stored here
@@ -259,9 +356,35 @@ void nxt_router_access_log_use(nxt_thread_spinlock_t *lock,
     nxt_router_access_log_t *access_log);
 void nxt_router_access_log_release(nxt_task_t *task,
     nxt_thread_spinlock_t *lock, nxt_router_access_log_t *access_log);
+nxt_router_access_log_t *nxt_router_access_log_file(nxt_task_t *task,
+    nxt_router_access_log_t *current, nxt_str_t *path);
 void nxt_router_access_log_reopen_handler(nxt_task_t *task,
     nxt_port_recv_msg_t *msg);
 
+nxt_int_t nxt_router_trace_create(nxt_task_t *task, nxt_router_conf_t *rtcf,
+    nxt_conf_value_t *value);
+void nxt_router_trace_write(nxt_task_t *task, nxt_http_request_t *r);
+
+nxt_router_traffic_t *nxt_router_traffic_create(nxt_router_conf_t *rtcf);
+
+
+/*
+ * Returns the counters of the current router engine; the slots are indexed
+ * by engine id and merged by the status handler.
+ */
+
+nxt_inline nxt_status_traffic_t *
+nxt_router_traffic(nxt_task_t *task, nxt_router_conf_t *rtcf,
+    nxt_router_traffic_t *traffic)
+{
+    uint32_t  id;
+
+    id = task->thread->engine->id;
+
+    return (traffic != NULL && id <= rtcf->threads) ? &traffic[id].traffic
+                                                    : NULL;
+}
+
 
 extern nxt_router_t  *nxt_router;
 
@@ -29,10 +29,14 @@ static void nxt_router_access_log_write_ready(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_access_log_write_error(nxt_task_t *task, void *obj,
     void *data);
+static nxt_router_access_log_t *nxt_router_access_log_pending(
+    nxt_router_conf_t *rtcf);
 static void nxt_router_access_log_ready(nxt_task_t *task,
     nxt_port_recv_msg_t *msg, void *data);
 static void nxt_router_access_log_error(nxt_task_t *task,
     nxt_port_recv_msg_t *msg, void *data);
+static void nxt_router_access_log_reopen(nxt_task_t *task,
+    nxt_router_access_log_t *access_log);
 static void nxt_router_access_log_reopen_completion(nxt_task_t *task, void *obj,
     void *data);
 static void nxt_router_access_log_reopen_ready(nxt_task_t *task,
@@ -64,7 +68,6 @@ nxt_router_access_log_create(nxt_task_t *task, nxt_router_conf_t *rtcf,
     nxt_int_t                     ret;
     nxt_str_t                     str;
     nxt_tstr_t                    *format;
-    nxt_router_t                  *router;
     nxt_router_access_log_t       *access_log;
     nxt_router_access_log_conf_t  alcf;
 
@@ -88,32 +91,14 @@ nxt_router_access_log_create(nxt_task_t *task, nxt_router_conf_t *rtcf,
         }
     }
 
-    router = nxt_router;
-
-    access_log = router->access_log;
-
-    if (access_log != NULL && nxt_strstr_eq(&alcf.path, &access_log->path)) {
-        nxt_router_access_log_use(&router->lock, access_log);
-
-    } else {
-        access_log = nxt_malloc(sizeof(nxt_router_access_log_t)
-                                + alcf.path.length);
-        if (access_log == NULL) {
-            nxt_alert(task, "failed to allocate access log structure");
-            return NXT_ERROR;
-        }
-
-        access_log->fd = -1;
-        access_log->handler = &nxt_router_access_log_writer;
-        access_log->count = 1;
-
-        access_log->path.length = alcf.path.length;
-        access_log->path.start = (u_char *) access_log
-                                 + sizeof(nxt_router_access_log_t);
-
-        nxt_memcpy(access_log->path.start, alcf.path.start, alcf.path.length);
+    access_log = nxt_router_access_log_file(task, nxt_router->access_log,
+                                            &alcf.path);
+    if (nxt_slow_path(access_log == NULL)) {
+        return NXT_ERROR;
     }
 
+    access_log->handler = &nxt_router_access_log_writer;
+
     str.length = alcf.format.length + 1;
 
     str.start = nxt_malloc(str.length);
@@ -137,6 +122,43 @@ nxt_router_access_log_create(nxt_task_t *task, nxt_router_conf_t *rtcf,
 }
 
 
+/*
+ * Returns the current log if it is already opened for the path,
+ * or a new log to be opened.
+ */
+
+nxt_router_access_log_t *
+nxt_router_access_log_file(nxt_task_t *task, nxt_router_access_log_t *current,
+    nxt_str_t *path)
+{
+    nxt_router_access_log_t  *access_log;
+
+    if (current != NULL && nxt_strstr_eq(path, &current->path)) {
+        nxt_router_access_log_use(&nxt_router->lock, current);
+
+        return current;
+    }
+
+    access_log = nxt_malloc(sizeof(nxt_router_access_log_t) + path->length);
+    if (access_log == NULL) {
+        nxt_alert(task, "failed to allocate access log structure");
+        return NULL;
+    }
+
+    access_log->fd = -1;
+    access_log->handler = NULL;
+    access_log->count = 1;
+
+    access_log->path.length = path->length;
+    access_log->path.start = (u_char *) access_log
+                             + sizeof(nxt_router_access_log_t);
+
+    nxt_memcpy(access_log->path.start, path->start, path->length);
+
+    return access_log;
+}
+
+
 static void
 nxt_router_access_log_writer(nxt_task_t *task, nxt_http_request_t *r,
     nxt_router_access_log_t *access_log, nxt_tstr_t *format)
@@ -206,7 +228,7 @@ nxt_router_access_log_open(nxt_task_t *task, nxt_router_temp_conf_t *tmcf)
     nxt_runtime_t            *rt;
     nxt_router_access_log_t  *access_log;
 
-    access_log = tmcf->router_conf->access_log;
+    access_log = nxt_router_access_log_pending(tmcf->router_conf);
 
     b = nxt_buf_mem_alloc(tmcf->mem_pool, access_log->path.length + 1, 0);
     if (nxt_slow_path(b == NULL)) {
@@ -246,6 +268,19 @@ nxt_router_access_log_open(nxt_task_t *task, nxt_router_temp_conf_t *tmcf)
 }
 
 
+/* The access log is opened first, then the trace log. */
+
+static nxt_router_access_log_t *
+nxt_router_access_log_pending(nxt_router_conf_t *rtcf)
+{
+    if (rtcf->access_log != NULL && rtcf->access_log->fd == -1) {
+        return rtcf->access_log;
+    }
+
+    return rtcf->trace_log;
+}
+
+
 static void
 nxt_router_access_log_ready(nxt_task_t *task, nxt_port_recv_msg_t *msg,
     void *data)
@@ -255,7 +290,7 @@ nxt_router_access_log_ready(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 
     tmcf = data;
 
-    access_log = tmcf->router_conf->access_log;
+    access_log = nxt_router_access_log_pending(tmcf->router_conf);
 
     access_log->fd = msg->fd[0];
 
@@ -327,6 +362,18 @@ typedef struct {
 
 void
 nxt_router_access_log_reopen_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
+{
+    nxt_router_access_log_reopen(task, nxt_router->access_log);
+
+    if (nxt_router->trace_log != nxt_router->access_log) {
+        nxt_router_access_log_reopen(task, nxt_router->trace_log);
+    }
+}
+
+
+static void
+nxt_router_access_log_reopen(nxt_task_t *task,
+    nxt_router_access_log_t *access_log)
 {
     nxt_mp_t                        *mp;
     uint32_t                        stream;
@@ -334,11 +381,8 @@ nxt_router_access_log_reopen_handler(nxt_task_t *task, nxt_port_recv_msg_t *msg)
     nxt_buf_t                       *b;
     nxt_port_t                      *main_port, *router_port;
     nxt_runtime_t                   *rt;
-    nxt_router_access_log_t         *access_log;
     nxt_router_access_log_reopen_t  *reopen;
 
-    access_log = nxt_router->access_log;
-
     if (access_log == NULL) {
         return;
     }
@@ -420,7 +464,9 @@ nxt_router_access_log_reopen_ready(nxt_task_t *task, nxt_port_recv_msg_t *msg,
 
     access_log = reopen->access_log;
 
-    if (access_log == nxt_router->access_log) {
+    if (access_log == nxt_router->access_log
+        || access_log == nxt_router->trace_log)
+    {
 
         if (nxt_slow_path(dup2(msg->fd[0], access_log->fd) == -1)) {
             nxt_alert(task, "dup2(%FD, %FD) failed %E",
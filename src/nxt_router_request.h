@@ -34,6 +34,10 @@ typedef struct {
     nxt_msg_info_t          msg_info;
 
     nxt_bool_t              rpc_cancel;
+    uint8_t                 accounted;  /* 1 bit */
+
+    nxt_nsec_t              queued;
+    nxt_nsec_t              acked;
 } nxt_request_rpc_data_t;
 
 
@@ -0,0 +1,580 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_router.h>
+#include <nxt_conf.h>
+#include <nxt_http.h>
+
+
+/*
+ * Sampled requests are written to the trace log as OTLP/JSON lines,
+ * one ExportTraceServiceRequest per request.  The request span is
+ * the parent of a span for each phase the request went through.
+ */
+
+#define NXT_ROUTER_TRACE_ID_LEN  32
+#define NXT_ROUTER_SPAN_ID_LEN   16
+
+
+typedef struct {
+    u_char                    trace_id[NXT_ROUTER_TRACE_ID_LEN];
+    u_char                    parent_id[NXT_ROUTER_SPAN_ID_LEN];
+    u_char                    span_id[NXT_ROUTER_SPAN_ID_LEN];
+    nxt_nsec_t                base;
+
+    nxt_conf_value_t          *spans;
+    nxt_uint_t                nspans;
+} nxt_router_trace_t;
+
+
+typedef struct {
+    nxt_str_t                 name;
+    size_t                    start;
+    size_t                    end;
+} nxt_router_trace_phase_t;
+
+
+static nxt_bool_t nxt_router_trace_sampled(nxt_task_t *task,
+    nxt_http_request_t *r, nxt_router_trace_t *trace);
+static nxt_int_t nxt_router_trace_parent(nxt_http_request_t *r,
+    nxt_router_trace_t *trace);
+static void nxt_router_trace_id(nxt_task_t *task, u_char *p, size_t length);
+static nxt_conf_value_t *nxt_router_trace_span(nxt_http_request_t *r,
+    nxt_router_trace_t *trace, nxt_str_t *name, nxt_nsec_t start,
+    nxt_nsec_t end, nxt_uint_t nattrs);
+static nxt_int_t nxt_router_trace_time(nxt_mp_t *mp, nxt_conf_value_t *span,
+    nxt_str_t *name, nxt_nsec_t time, uint32_t index);
+static nxt_int_t nxt_router_trace_attr(nxt_mp_t *mp, nxt_conf_value_t *attrs,
+    uint32_t index, const char *key, const char *type, nxt_str_t *value);
+
+
+static const nxt_router_trace_phase_t  nxt_router_trace_phases[] = {
+    { nxt_string("request_header"),
+      offsetof(nxt_http_request_t, start_time),
+      offsetof(nxt_http_request_t, timing.header) },
+
+    { nxt_string("request_body"),
+      offsetof(nxt_http_request_t, timing.header),
+      offsetof(nxt_http_request_t, timing.body) },
+
+    { nxt_string("route"),
+      offsetof(nxt_http_request_t, timing.body),
+      offsetof(nxt_http_request_t, timing.route) },
+
+    { nxt_string("queue"),
+      offsetof(nxt_http_request_t, timing.app_queued),
+      offsetof(nxt_http_request_t, timing.app_acked) },
+
+    { nxt_string("application"),
+      offsetof(nxt_http_request_t, timing.app_acked),
+      offsetof(nxt_http_request_t, timing.app_done) },
+
+    { nxt_string("upstream"),
+      offsetof(nxt_http_request_t, timing.upstream),
+      offsetof(nxt_http_request_t, timing.upstream_done) },
+};
+
+
+nxt_int_t
+nxt_router_trace_create(nxt_task_t *task, nxt_router_conf_t *rtcf,
+    nxt_conf_value_t *value)
+{
+    double            sampling;
+    nxt_str_t         path;
+    nxt_conf_value_t  *member;
+
+    static nxt_str_t  path_str = nxt_string("path");
+    static nxt_str_t  sampling_str = nxt_string("sampling");
+
+    member = nxt_conf_get_object_member(value, &path_str, NULL);
+    nxt_conf_get_string(member, &path);
+
+    member = nxt_conf_get_object_member(value, &sampling_str, NULL);
+    sampling = (member != NULL) ? nxt_conf_get_number(member) : 1;
+
+    rtcf->trace_log = nxt_router_access_log_file(task, nxt_router->trace_log,
+                                                 &path);
+    if (nxt_slow_path(rtcf->trace_log == NULL)) {
+        return NXT_ERROR;
+    }
+
+    rtcf->trace_sampling = sampling * 1000000;
+
+    return NXT_OK;
+}
+
+
+void
+nxt_router_trace_write(nxt_task_t *task, nxt_http_request_t *r)
+{
+    u_char                    *p;
+    size_t                    size;
+    uint32_t                  i;
+    nxt_mp_t                  *mp;
+    nxt_str_t                 str, *method;
+    nxt_nsec_t                start, end, now;
+    nxt_conf_value_t          *root, *obj, *arr, *resource, *span, *attrs;
+    nxt_realtime_t            *realtime;
+    nxt_router_trace_t        trace;
+    nxt_router_access_log_t   *trace_log;
+
+    const nxt_router_trace_phase_t  *phase;
+
+    static nxt_str_t  resource_spans_str = nxt_string("resourceSpans");
+    static nxt_str_t  resource_str = nxt_string("resource");
+    static nxt_str_t  attributes_str = nxt_string("attributes");
+    static nxt_str_t  scope_spans_str = nxt_string("scopeSpans");
+    static nxt_str_t  scope_str = nxt_string("scope");
+    static nxt_str_t  name_str = nxt_string("name");
+    static nxt_str_t  version_str = nxt_string("version");
+    static nxt_str_t  spans_str = nxt_string("spans");
+    static nxt_str_t  unit_str = nxt_string("unit");
+    static nxt_str_t  unit_version_str = nxt_string(NXT_VERSION);
+    static nxt_str_t  other_str = nxt_string("_OTHER");
+
+    trace_log = r->conf->socket_conf->router_conf->trace_log;
+
+    if (!nxt_router_trace_sampled(task, r, &trace)) {
+        return;
+    }
+
+    mp = r->mem_pool;
+
+    now = nxt_thread_monotonic_time(task->thread);
+    realtime = nxt_thread_realtime(task->thread);
+
+    trace.base = (nxt_nsec_t) realtime->sec * 1000000000 + realtime->nsec
+                 - now;
+
+    nxt_router_trace_id(task, trace.span_id, NXT_ROUTER_SPAN_ID_LEN);
+
+    trace.spans = nxt_conf_create_array(mp,
+                                        1 + nxt_nitems(nxt_router_trace_phases));
+    if (nxt_slow_path(trace.spans == NULL)) {
+        return;
+    }
+
+    trace.nspans = 0;
+
+    /* The request line may be invalid. */
+    method = (r->method != NULL) ? r->method : &other_str;
+
+    span = nxt_router_trace_span(r, &trace, method, r->start_time, now,
+                                 2 + (r->path != NULL));
+    if (nxt_slow_path(span == NULL)) {
+        return;
+    }
+
+    attrs = nxt_conf_get_object_member(span, &attributes_str, NULL);
+
+    if (nxt_slow_path(nxt_router_trace_attr(mp, attrs, 0,
+                                            "http.request.method",
+                                            "stringValue", method)
+                      != NXT_OK))
+    {
+        return;
+    }
+
+    str.start = nxt_mp_nget(mp, NXT_INT_T_LEN);
+    if (nxt_slow_path(str.start == NULL)) {
+        return;
+    }
+
+    str.length = nxt_sprintf(str.start, str.start + NXT_INT_T_LEN, "%d",
+                             (int) r->status)
+                 - str.start;
+
+    if (nxt_slow_path(nxt_router_trace_attr(mp, attrs, 1,
+                                            "http.response.status_code",
+                                            "intValue", &str)
+                      != NXT_OK))
+    {
+        return;
+    }
+
+    if (r->path != NULL
+        && nxt_slow_path(nxt_router_trace_attr(mp, attrs, 2, "url.path",
+                                               "stringValue", r->path)
+                         != NXT_OK))
+    {
+        return;
+    }
+
+    /* Phase spans are children of the request span. */
+
+    nxt_memcpy(trace.parent_id, trace.span_id, NXT_ROUTER_SPAN_ID_LEN);
+
+    for (i = 0; i < nxt_nitems(nxt_router_trace_phases); i++) {
+        phase = &nxt_router_trace_phases[i];
+
+        start = *(nxt_nsec_t *) ((u_char *) r + phase->start);
+        end = *(nxt_nsec_t *) ((u_char *) r + phase->end);
+
+        if (start == 0 || end < start) {
+            continue;
+        }
+
+        nxt_router_trace_id(task, trace.span_id, NXT_ROUTER_SPAN_ID_LEN);
+
+        span = nxt_router_trace_span(r, &trace, (nxt_str_t *) &phase->name,
+                                     start, end, 0);
+        if (nxt_slow_path(span == NULL)) {
+            return;
+        }
+    }
+
+    root = nxt_conf_create_object(mp, 1);
+    arr = nxt_conf_create_array(mp, 1);
+    obj = nxt_conf_create_object(mp, 2);
+    resource = nxt_conf_create_object(mp, 1);
+    attrs = nxt_conf_create_array(mp, 1);
+
+    if (nxt_slow_path(root == NULL || arr == NULL || obj == NULL
+                      || resource == NULL || attrs == NULL))
+    {
+        return;
+    }
+
+    nxt_conf_set_member(root, &resource_spans_str, arr, 0);
+    nxt_conf_set_element(arr, 0, obj);
+
+    nxt_conf_set_member(obj, &resource_str, resource, 0);
+    nxt_conf_set_member(resource, &attributes_str, attrs, 0);
+
+    if (nxt_slow_path(nxt_router_trace_attr(mp, attrs, 0, "service.name",
+                                            "stringValue", &unit_str)
+                      != NXT_OK))
+    {
+        return;
+    }
+
+    arr = nxt_conf_create_array(mp, 1);
+    resource = nxt_conf_create_object(mp, 2);
+    span = nxt_conf_create_object(mp, 2);
+
+    if (nxt_slow_path(arr == NULL || resource == NULL || span == NULL)) {
+        return;
+    }
+
+    nxt_conf_set_member(obj, &scope_spans_str, arr, 1);
+    nxt_conf_set_element(arr, 0, resource);
+
+    nxt_conf_set_member(resource, &scope_str, span, 0);
+    nxt_conf_set_member_string(span, &name_str, &unit_str, 0);
+    nxt_conf_set_member_string(span, &version_str, &unit_version_str, 1);
+
+    /* The array has been allocated for the maximum number of spans. */
+    arr = nxt_conf_create_array(mp, trace.nspans);
+    if (nxt_slow_path(arr == NULL)) {
+        return;
+    }
+
+    for (i = 0; i < trace.nspans; i++) {
+        nxt_conf_set_element(arr, i,
+                             nxt_conf_get_array_element(trace.spans, i));
+    }
+
+    nxt_conf_set_member(resource, &spans_str, arr, 1);
+
+    size = nxt_conf_json_length(root, NULL) + 1;
+
+    p = nxt_mp_nget(mp, size);
+    if (nxt_slow_path(p == NULL)) {
+        return;
+    }
+
+    str.start = p;
+
+    p = nxt_conf_json_print(p, root, NULL);
+    *p++ = '\n';
+
+    nxt_fd_write(trace_log->fd, str.start, p - str.start);
+}
+
+
+/*
+ * A request with the W3C "traceparent" header continues the trace
+ * and follows its sampling decision; otherwise requests are sampled
+ * at the configured rate.
+ */
+
+static nxt_bool_t
+nxt_router_trace_sampled(nxt_task_t *task, nxt_http_request_t *r,
+    nxt_router_trace_t *trace)
+{
+    uint32_t           sampling;
+    nxt_int_t          ret;
+    nxt_router_conf_t  *rtcf;
+
+    nxt_memset(trace->parent_id, '\0', NXT_ROUTER_SPAN_ID_LEN);
+
+    ret = nxt_router_trace_parent(r, trace);
+
+    if (ret != NXT_DECLINED) {
+        return ret;
+    }
+
+    rtcf = r->conf->socket_conf->router_conf;
+    sampling = rtcf->trace_sampling;
+
+    if (sampling < 1000000
+        && nxt_random(&task->thread->random) % 1000000 >= sampling)
+    {
+        return 0;
+    }
+
+    nxt_router_trace_id(task, trace->trace_id, NXT_ROUTER_TRACE_ID_LEN);
+
+    return 1;
+}
+
+
+/*
+ * Returns the "sampled" flag of a valid "traceparent" header,
+ * or NXT_DECLINED if there is none.  As required by W3C Trace Context,
+ * only lowercase hex digits are valid, the "ff" version is forbidden,
+ * and all-zero trace and parent ids are invalid.
+ */
+
+static nxt_int_t
+nxt_router_trace_parent(nxt_http_request_t *r, nxt_router_trace_t *trace)
+{
+    u_char            c, *p;
+    size_t            i;
+    nxt_bool_t        trace_id, parent_id;
+    nxt_http_field_t  *field;
+
+    nxt_list_each(field, r->fields) {
+
+        if (field->name_length != nxt_length("traceparent")
+            || nxt_memcasecmp(field->name, "traceparent",
+                              nxt_length("traceparent")) != 0)
+        {
+            continue;
+        }
+
+        /* version "-" trace-id "-" parent-id "-" flags */
+
+        p = field->value;
+
+        if (field->value_length < 55 || p[2] != '-' || p[35] != '-'
+            || p[52] != '-')
+        {
+            return NXT_DECLINED;
+        }
+
+        trace_id = 0;
+        parent_id = 0;
+
+        for (i = 0; i < 55; i++) {
+            if (i == 2 || i == 35 || i == 52) {
+                continue;
+            }
+
+            c = p[i];
+
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+                return NXT_DECLINED;
+            }
+
+            if (i > 2 && i < 35) {
+                trace_id |= (c != '0');
+
+            } else if (i > 35 && i < 52) {
+                parent_id |= (c != '0');
+            }
+        }
+
+        if (p[0] == 'f' && p[1] == 'f') {
+            return NXT_DECLINED;
+        }
+
+        /* Future versions may append fields after a dash. */
+
+        if (field->value_length > 55
+            && ((p[0] == '0' && p[1] == '0') || p[55] != '-'))
+        {
+            return NXT_DECLINED;
+        }
+
+        if (trace_id == 0 || parent_id == 0) {
+            return NXT_DECLINED;
+        }
+
+        nxt_memcpy(trace->trace_id, &p[3], NXT_ROUTER_TRACE_ID_LEN);
+        nxt_memcpy(trace->parent_id, &p[36], NXT_ROUTER_SPAN_ID_LEN);
+
+        return (nxt_hex2int[p[54]] & 1);
+
+    } nxt_list_loop;
+
+    return NXT_DECLINED;
+}
+
+
+static void
+nxt_router_trace_id(nxt_task_t *task, u_char *p, size_t length)
+{
+    u_char  buf[9];
+    size_t  i;
+
+    for (i = 0; i < length; i += 8) {
+        (void) nxt_sprintf(buf, buf + 9, "%08xD",
+                           nxt_random(&task->thread->random));
+
+        nxt_memcpy(&p[i], buf, 8);
+    }
+}
+
+
+static nxt_conf_value_t *
+nxt_router_trace_span(nxt_http_request_t *r, nxt_router_trace_t *trace,
+    nxt_str_t *name, nxt_nsec_t start, nxt_nsec_t end, nxt_uint_t nattrs)
+{
+    uint32_t          n;
+    nxt_mp_t          *mp;
+    nxt_str_t         str;
+    nxt_conf_value_t  *span, *attrs;
+
+    static nxt_str_t  trace_id_str = nxt_string("traceId");
+    static nxt_str_t  span_id_str = nxt_string("spanId");
+    static nxt_str_t  parent_id_str = nxt_string("parentSpanId");
+    static nxt_str_t  name_str = nxt_string("name");
+    static nxt_str_t  kind_str = nxt_string("kind");
+    static nxt_str_t  start_str = nxt_string("startTimeUnixNano");
+    static nxt_str_t  end_str = nxt_string("endTimeUnixNano");
+    static nxt_str_t  attributes_str = nxt_string("attributes");
+
+    mp = r->mem_pool;
+
+    span = nxt_conf_create_object(mp, 8);
+    if (nxt_slow_path(span == NULL)) {
+        return NULL;
+    }
+
+    n = 0;
+
+    str.length = NXT_ROUTER_TRACE_ID_LEN;
+    str.start = trace->trace_id;
+
+    if (nxt_slow_path(nxt_conf_set_member_string_dup(span, mp, &trace_id_str,
+                                                     &str, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    str.length = NXT_ROUTER_SPAN_ID_LEN;
+    str.start = trace->span_id;
+
+    if (nxt_slow_path(nxt_conf_set_member_string_dup(span, mp, &span_id_str,
+                                                     &str, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    str.start = trace->parent_id;
+
+    if (str.start[0] == '\0') {
+        str.length = 0;
+    }
+
+    if (nxt_slow_path(nxt_conf_set_member_string_dup(span, mp, &parent_id_str,
+                                                     &str, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    if (nxt_slow_path(nxt_conf_set_member_string_dup(span, mp, &name_str,
+                                                     name, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    /* SPAN_KIND_SERVER for the request, SPAN_KIND_INTERNAL for phases. */
+    nxt_conf_set_member_integer(span, &kind_str, (nattrs != 0) ? 2 : 1, n++);
+
+    if (nxt_slow_path(nxt_router_trace_time(mp, span, &start_str,
+                                            trace->base + start, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    if (nxt_slow_path(nxt_router_trace_time(mp, span, &end_str,
+                                            trace->base + end, n++)
+                      != NXT_OK))
+    {
+        return NULL;
+    }
+
+    attrs = nxt_conf_create_array(mp, nattrs);
+    if (nxt_slow_path(attrs == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(span, &attributes_str, attrs, n);
+
+    nxt_conf_set_element(trace->spans, trace->nspans++, span);
+
+    return nxt_conf_get_array_element(trace->spans, trace->nspans - 1);
+}
+
+
+/* OTLP/JSON encodes 64-bit integers as decimal strings. */
+
+static nxt_int_t
+nxt_router_trace_time(nxt_mp_t *mp, nxt_conf_value_t *span, nxt_str_t *name,
+    nxt_nsec_t time, uint32_t index)
+{
+    u_char     buf[NXT_INT64_T_LEN];
+    nxt_str_t  str;
+
+    str.start = buf;
+    str.length = nxt_sprintf(buf, buf + NXT_INT64_T_LEN, "%uL", time) - buf;
+
+    return nxt_conf_set_member_string_dup(span, mp, name, &str, index);
+}
+
+
+static nxt_int_t
+nxt_router_trace_attr(nxt_mp_t *mp, nxt_conf_value_t *attrs, uint32_t index,
+    const char *key, const char *type, nxt_str_t *value)
+{
+    nxt_str_t         str;
+    nxt_conf_value_t  *attr, *val;
+
+    static nxt_str_t  key_str = nxt_string("key");
+    static nxt_str_t  value_str = nxt_string("value");
+
+    attr = nxt_conf_create_object(mp, 2);
+    val = nxt_conf_create_object(mp, 1);
+
+    if (nxt_slow_path(attr == NULL || val == NULL)) {
+        return NXT_ERROR;
+    }
+
+    str.start = (u_char *) key;
+    str.length = nxt_strlen(key);
+
+    nxt_conf_set_member_string(attr, &key_str, &str, 0);
+    nxt_conf_set_member(attr, &value_str, val, 1);
+
+    str.start = (u_char *) type;
+    str.length = nxt_strlen(type);
+
+    if (nxt_slow_path(nxt_conf_set_member_string_dup(val, mp, &str, value, 0)
+                      != NXT_OK))
+    {
+        return NXT_ERROR;
+    }
+
+    nxt_conf_set_element(attrs, index, attr);
+
+    return NXT_OK;
+}
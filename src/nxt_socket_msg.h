@@ -68,6 +68,15 @@ NXT_EXPORT ssize_t nxt_sendmsg(nxt_socket_t s, nxt_iobuf_t *iob,
 NXT_EXPORT ssize_t nxt_recvmsg(nxt_socket_t s,
     nxt_iobuf_t *iob, nxt_uint_t niob, nxt_recv_oob_t *oob);
 
+#if (NXT_HAVE_SENDMMSG)
+NXT_EXPORT ssize_t nxt_socketpair_send_batch(nxt_fd_event_t *ev,
+    struct mmsghdr *msgs, nxt_uint_t n);
+#endif
+#if (NXT_HAVE_RECVMMSG)
+NXT_EXPORT ssize_t nxt_socketpair_recv_batch(nxt_fd_event_t *ev,
+    struct mmsghdr *msgs, nxt_uint_t n);
+#endif
+
 
 nxt_inline struct cmsghdr *
 NXT_CMSG_NXTHDR(struct msghdr *msgh, struct cmsghdr *cmsg)
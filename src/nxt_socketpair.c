@@ -185,3 +185,121 @@ nxt_socketpair_recv(nxt_fd_event_t *ev, nxt_iobuf_t *iob, nxt_uint_t niob,
         }
     }
 }
+
+
+#if (NXT_HAVE_SENDMMSG)
+
+ssize_t
+nxt_socketpair_send_batch(nxt_fd_event_t *ev, struct mmsghdr *msgs,
+    nxt_uint_t n)
+{
+    int        ret;
+    nxt_err_t  err;
+
+    for ( ;; ) {
+        ret = sendmmsg(ev->fd, msgs, n, 0);
+
+        err = (ret == -1) ? nxt_socket_errno : 0;
+
+        nxt_debug(ev->task, "sendmmsg(%d, %ui): %d", ev->fd, n, ret);
+
+        if (ret > 0) {
+            return ret;
+        }
+
+        /* ret == -1 */
+
+        switch (err) {
+
+        case NXT_EAGAIN:
+            nxt_debug(ev->task, "sendmmsg(%d) not ready", ev->fd);
+            break;
+
+        case NXT_ENOBUFS:
+            nxt_debug(ev->task, "sendmmsg(%d) no buffers", ev->fd);
+            break;
+
+        case NXT_EINTR:
+            nxt_debug(ev->task, "sendmmsg(%d) interrupted", ev->fd);
+            continue;
+
+        default:
+            nxt_alert(ev->task, "sendmmsg(%d, %ui) failed %E", ev->fd, n, err);
+
+            return NXT_ERROR;
+        }
+
+        ev->write_ready = 0;
+
+        return NXT_AGAIN;
+    }
+}
+
+#endif
+
+
+#if (NXT_HAVE_RECVMMSG)
+
+/*
+ * A zero-length message means the peer has closed the socket,
+ * so messages received before it are returned first.
+ */
+
+ssize_t
+nxt_socketpair_recv_batch(nxt_fd_event_t *ev, struct mmsghdr *msgs,
+    nxt_uint_t n)
+{
+    int        i, ret;
+    nxt_err_t  err;
+
+    for ( ;; ) {
+        ret = recvmmsg(ev->fd, msgs, n, 0, NULL);
+
+        err = (ret == -1) ? nxt_socket_errno : 0;
+
+        nxt_debug(ev->task, "recvmmsg(%d, %ui): %d", ev->fd, n, ret);
+
+        if (ret > 0) {
+            for (i = 0; i < ret; i++) {
+                if (msgs[i].msg_len == 0) {
+                    break;
+                }
+            }
+
+            if (i != 0) {
+                return i;
+            }
+
+            ret = 0;
+        }
+
+        if (ret == 0) {
+            ev->closed = 1;
+            ev->read_ready = 0;
+
+            return 0;
+        }
+
+        /* ret == -1 */
+
+        switch (err) {
+
+        case NXT_EAGAIN:
+            nxt_debug(ev->task, "recvmmsg(%d) not ready", ev->fd);
+            ev->read_ready = 0;
+
+            return NXT_AGAIN;
+
+        case NXT_EINTR:
+            nxt_debug(ev->task, "recvmmsg(%d) interrupted", ev->fd);
+            continue;
+
+        default:
+            nxt_alert(ev->task, "recvmmsg(%d, %ui) failed %E", ev->fd, n, err);
+
+            return NXT_ERROR;
+        }
+    }
+}
+
+#endif
@@ -8,14 +8,170 @@
 #include <nxt_status.h>
 
 
+static nxt_conf_value_t *nxt_status_hist_get(nxt_status_hist_t *hist,
+    nxt_mp_t *mp);
+static nxt_conf_value_t *nxt_status_traffic_get(nxt_status_traffic_t *traffic,
+    nxt_bool_t tls, nxt_mp_t *mp);
+static void nxt_status_app_name(nxt_status_report_t *report,
+    nxt_status_app_t *app, nxt_str_t *name);
+static nxt_bool_t nxt_status_traffic_entry(nxt_status_report_t *report,
+    nxt_bool_t route, size_t i, nxt_str_t *name,
+    nxt_status_traffic_t **traffic);
+static u_char *nxt_status_metrics_family(u_char *p, u_char *end,
+    const char *name, const char *type, const char *help);
+static u_char *nxt_status_metrics_label(u_char *p, u_char *end,
+    const char *label, nxt_str_t *value);
+static u_char *nxt_status_metrics_hist(u_char *p, u_char *end,
+    nxt_status_report_t *report, const char *name, const char *help,
+    size_t offset);
+static u_char *nxt_status_metrics_traffic(u_char *p, u_char *end,
+    nxt_status_report_t *report, nxt_bool_t route);
+
+
+typedef struct {
+    const char        *name;
+    const char        *help;
+    size_t            offset;
+    uint8_t           counter;  /* 1 bit */
+    uint8_t           wide;     /* 1 bit */
+} nxt_status_metric_t;
+
+
+/*
+ * The longest metric name, labels except the escaped label value, and
+ * value fit in this many bytes.
+ */
+#define NXT_STATUS_METRICS_LINE  192
+
+#define nxt_status_app_metric(name, counter, help, field)                    \
+    { name, help, offsetof(nxt_status_app_t, field), counter,                 \
+      sizeof(((nxt_status_app_t *) 0)->field) == 8 }
+
+
+typedef struct {
+    const char        *name;
+    const char        *help;
+    size_t            offset;
+    uint8_t           tls;      /* 1 bit */
+} nxt_status_traffic_metric_t;
+
+
+#define nxt_status_traffic_metric(name, tls, help, field)                    \
+    { name, help, offsetof(nxt_status_traffic_t, field), tls }
+
+
+const uint32_t  nxt_status_hist_bounds[NXT_STATUS_HIST_BUCKETS - 1] = {
+    50, 100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000,
+};
+
+
+static nxt_str_t  nxt_status_hist_les[NXT_STATUS_HIST_BUCKETS] = {
+    nxt_string("50"),
+    nxt_string("100"),
+    nxt_string("250"),
+    nxt_string("500"),
+    nxt_string("1000"),
+    nxt_string("2500"),
+    nxt_string("5000"),
+    nxt_string("10000"),
+    nxt_string("25000"),
+    nxt_string("50000"),
+    nxt_string("100000"),
+    nxt_string("250000"),
+    nxt_string("500000"),
+    nxt_string("1000000"),
+    nxt_string("2500000"),
+    nxt_string("5000000"),
+    nxt_string("10000000"),
+    nxt_string("+Inf"),
+};
+
+
+/* OpenMetrics "le" labels are in seconds. */
+
+static const char  *nxt_status_metrics_les[NXT_STATUS_HIST_BUCKETS] = {
+    "0.00005", "0.0001", "0.00025", "0.0005",
+    "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "0.5",
+    "1.0", "2.5", "5.0", "10.0", "+Inf",
+};
+
+
+static const nxt_status_metric_t  nxt_status_app_metrics[] = {
+    nxt_status_app_metric("unit_application_processes_running", 0,
+                          "Running application processes.", processes),
+    nxt_status_app_metric("unit_application_processes_starting", 0,
+                          "Application processes being started.",
+                          pending_processes),
+    nxt_status_app_metric("unit_application_processes_idle", 0,
+                          "Idle application processes.", idle_processes),
+    nxt_status_app_metric("unit_application_requests_active", 0,
+                          "Requests being handled by the application.",
+                          active_requests),
+    nxt_status_app_metric("unit_application_shm_segments", 0,
+                          "Shared memory segments.", shm_segments),
+    nxt_status_app_metric("unit_application_shm_chunks", 0,
+                          "Shared memory chunks.", shm_chunks),
+    nxt_status_app_metric("unit_application_shm_busy_chunks", 0,
+                          "Shared memory chunks in use.", shm_busy_chunks),
+    nxt_status_app_metric("unit_application_shm_oosm", 1,
+                          "Out of shared memory events.", shm_oosm),
+};
+
+
+static const nxt_status_traffic_metric_t  nxt_status_traffic_metrics[] = {
+    nxt_status_traffic_metric("requests", 0, "Client requests.", requests),
+    nxt_status_traffic_metric("bytes_received", 0,
+                              "Request body bytes received.", bytes_in),
+    nxt_status_traffic_metric("bytes_sent", 0,
+                              "Response body bytes sent.", bytes_out),
+    nxt_status_traffic_metric("tls_handshakes", 1,
+                              "Completed TLS handshakes.", tls_handshakes),
+    nxt_status_traffic_metric("tls_failures", 1,
+                              "Failed or abandoned TLS handshakes.",
+                              tls_failures),
+};
+
+
+static nxt_str_t  nxt_status_response_classes[] = {
+    nxt_string("1xx"),
+    nxt_string("2xx"),
+    nxt_string("3xx"),
+    nxt_string("4xx"),
+    nxt_string("5xx"),
+};
+
+
+static nxt_str_t  nxt_status_req_outcomes[NXT_STATUS_REQ_NOUTCOMES] = {
+    nxt_string("completed"),
+    nxt_string("failed"),
+    nxt_string("timed_out"),
+    nxt_string("cancelled"),
+};
+
+
+static nxt_str_t  nxt_status_scale_reasons[] = {
+    nxt_string("none"),
+    nxt_string("start: spare"),
+    nxt_string("start: demand"),
+    nxt_string("start: queue wait"),
+    nxt_string("stop: idle"),
+    nxt_string("hold: cooldown"),
+    nxt_string("hold: queue wait"),
+};
+
+
 nxt_conf_value_t *
 nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp)
 {
-    size_t            i;
-    nxt_str_t         name;
-    nxt_int_t         ret;
-    nxt_status_app_t  *app;
-    nxt_conf_value_t  *status, *obj, *apps, *app_obj;
+    size_t                 i, j;
+    nxt_str_t              name;
+    nxt_int_t              ret;
+    nxt_status_app_t       *app;
+    nxt_conf_value_t       *status, *obj, *apps, *app_obj, *hist;
+    nxt_status_route_t     *route;
+    nxt_status_listener_t  *listener;
 
     static nxt_str_t conns_str = nxt_string("connections");
     static nxt_str_t acc_str = nxt_string("accepted");
@@ -28,8 +184,25 @@ nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp)
     static nxt_str_t procs_str = nxt_string("processes");
     static nxt_str_t run_str = nxt_string("running");
     static nxt_str_t start_str = nxt_string("starting");
+    static nxt_str_t shm_str = nxt_string("shm");
+    static nxt_str_t segments_str = nxt_string("segments");
+    static nxt_str_t chunks_str = nxt_string("chunks");
+    static nxt_str_t busy_str = nxt_string("busy");
+    static nxt_str_t oosm_str = nxt_string("oosm");
+    static nxt_str_t scaling_str = nxt_string("scaling");
+    static nxt_str_t policy_str = nxt_string("policy");
+    static nxt_str_t adaptive_str = nxt_string("adaptive");
+    static nxt_str_t queue_wait_str = nxt_string("queue_wait");
+    static nxt_str_t service_time_str = nxt_string("service_time");
+    static nxt_str_t ups_str = nxt_string("started");
+    static nxt_str_t downs_str = nxt_string("stopped");
+    static nxt_str_t reason_str = nxt_string("reason");
+    static nxt_str_t latency_str = nxt_string("latency");
+    static nxt_str_t total_time_str = nxt_string("total_time");
+    static nxt_str_t listeners_str = nxt_string("listeners");
+    static nxt_str_t routes_str = nxt_string("routes");
 
-    status = nxt_conf_create_object(mp, 3);
+    status = nxt_conf_create_object(mp, 5);
     if (nxt_slow_path(status == NULL)) {
         return NULL;
     }
@@ -67,7 +240,7 @@ nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp)
     for (i = 0; i < report->apps_count; i++) {
         app = &report->apps[i];
 
-        app_obj = nxt_conf_create_object(mp, 2);
+        app_obj = nxt_conf_create_object(mp, 4 + (app->adaptive != 0));
         if (nxt_slow_path(app_obj == NULL)) {
             return NULL;
         }
@@ -91,7 +264,7 @@ nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp)
         nxt_conf_set_member_integer(obj, &start_str, app->pending_processes, 1);
         nxt_conf_set_member_integer(obj, &idle_str, app->idle_processes, 2);
 
-        obj = nxt_conf_create_object(mp, 1);
+        obj = nxt_conf_create_object(mp, 1 + NXT_STATUS_REQ_NOUTCOMES);
         if (nxt_slow_path(obj == NULL)) {
             return NULL;
         }
@@ -99,7 +272,662 @@ nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp)
         nxt_conf_set_member(app_obj, &reqs_str, obj, 1);
 
         nxt_conf_set_member_integer(obj, &active_str, app->active_requests, 0);
+
+        for (j = 0; j < NXT_STATUS_REQ_NOUTCOMES; j++) {
+            nxt_conf_set_member_integer(obj, &nxt_status_req_outcomes[j],
+                                        app->stats.requests[j], 1 + j);
+        }
+
+        obj = nxt_conf_create_object(mp, 4);
+        if (nxt_slow_path(obj == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(app_obj, &shm_str, obj, 2);
+
+        nxt_conf_set_member_integer(obj, &segments_str, app->shm_segments, 0);
+        nxt_conf_set_member_integer(obj, &chunks_str, app->shm_chunks, 1);
+        nxt_conf_set_member_integer(obj, &busy_str, app->shm_busy_chunks, 2);
+        nxt_conf_set_member_integer(obj, &oosm_str, app->shm_oosm, 3);
+
+        obj = nxt_conf_create_object(mp, 3);
+        if (nxt_slow_path(obj == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(app_obj, &latency_str, obj, 3);
+
+        hist = nxt_status_hist_get(&app->stats.queue_wait, mp);
+        if (nxt_slow_path(hist == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(obj, &queue_wait_str, hist, 0);
+
+        hist = nxt_status_hist_get(&app->stats.service_time, mp);
+        if (nxt_slow_path(hist == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(obj, &service_time_str, hist, 1);
+
+        hist = nxt_status_hist_get(&app->stats.total_time, mp);
+        if (nxt_slow_path(hist == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(obj, &total_time_str, hist, 2);
+
+        if (!app->adaptive) {
+            continue;
+        }
+
+        obj = nxt_conf_create_object(mp, 6);
+        if (nxt_slow_path(obj == NULL)) {
+            return NULL;
+        }
+
+        nxt_conf_set_member(app_obj, &scaling_str, obj, 4);
+
+        nxt_conf_set_member_string(obj, &policy_str, &adaptive_str, 0);
+        nxt_conf_set_member_integer(obj, &queue_wait_str, app->queue_wait, 1);
+        nxt_conf_set_member_integer(obj, &service_time_str, app->service_time,
+                                    2);
+        nxt_conf_set_member_integer(obj, &ups_str, app->scale_ups, 3);
+        nxt_conf_set_member_integer(obj, &downs_str, app->scale_downs, 4);
+        nxt_conf_set_member_string(obj, &reason_str,
+                                &nxt_status_scale_reasons[app->scale_reason],
+                                   5);
+    }
+
+    obj = nxt_conf_create_object(mp, report->listeners_count);
+    if (nxt_slow_path(obj == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(status, &listeners_str, obj, 3);
+
+    listener = nxt_status_listeners(report);
+
+    for (i = 0; i < report->listeners_count; i++) {
+        app_obj = nxt_status_traffic_get(&listener[i].traffic, listener[i].tls,
+                                         mp);
+        if (nxt_slow_path(app_obj == NULL)) {
+            return NULL;
+        }
+
+        name.length = listener[i].name.length;
+        name.start = nxt_pointer_to(report,
+                                    (uintptr_t) listener[i].name.start);
+
+        ret = nxt_conf_set_member_dup(obj, mp, &name, app_obj, i);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            return NULL;
+        }
+    }
+
+    obj = nxt_conf_create_object(mp, report->routes_count);
+    if (nxt_slow_path(obj == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(status, &routes_str, obj, 4);
+
+    route = nxt_status_routes(report);
+
+    for (i = 0; i < report->routes_count; i++) {
+        app_obj = nxt_status_traffic_get(&route[i].traffic, 0, mp);
+        if (nxt_slow_path(app_obj == NULL)) {
+            return NULL;
+        }
+
+        name.length = route[i].name.length;
+        name.start = nxt_pointer_to(report, (uintptr_t) route[i].name.start);
+
+        ret = nxt_conf_set_member_dup(obj, mp, &name, app_obj, i);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            return NULL;
+        }
     }
 
     return status;
 }
+
+
+static nxt_conf_value_t *
+nxt_status_traffic_get(nxt_status_traffic_t *traffic, nxt_bool_t tls,
+    nxt_mp_t *mp)
+{
+    nxt_uint_t        i;
+    nxt_conf_value_t  *obj, *member;
+
+    static nxt_str_t reqs_str = nxt_string("requests");
+    static nxt_str_t bytes_str = nxt_string("bytes");
+    static nxt_str_t in_str = nxt_string("in");
+    static nxt_str_t out_str = nxt_string("out");
+    static nxt_str_t responses_str = nxt_string("responses");
+    static nxt_str_t tls_str = nxt_string("tls");
+    static nxt_str_t handshakes_str = nxt_string("handshakes");
+    static nxt_str_t failures_str = nxt_string("failures");
+
+    obj = nxt_conf_create_object(mp, 3 + (tls != 0));
+    if (nxt_slow_path(obj == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member_integer(obj, &reqs_str, traffic->requests, 0);
+
+    member = nxt_conf_create_object(mp, 2);
+    if (nxt_slow_path(member == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(obj, &bytes_str, member, 1);
+
+    nxt_conf_set_member_integer(member, &in_str, traffic->bytes_in, 0);
+    nxt_conf_set_member_integer(member, &out_str, traffic->bytes_out, 1);
+
+    member = nxt_conf_create_object(mp, nxt_nitems(traffic->responses));
+    if (nxt_slow_path(member == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(obj, &responses_str, member, 2);
+
+    for (i = 0; i < nxt_nitems(traffic->responses); i++) {
+        nxt_conf_set_member_integer(member, &nxt_status_response_classes[i],
+                                    traffic->responses[i], i);
+    }
+
+    if (!tls) {
+        return obj;
+    }
+
+    member = nxt_conf_create_object(mp, 2);
+    if (nxt_slow_path(member == NULL)) {
+        return NULL;
+    }
+
+    nxt_conf_set_member(obj, &tls_str, member, 3);
+
+    nxt_conf_set_member_integer(member, &handshakes_str,
+                                traffic->tls_handshakes, 0);
+    nxt_conf_set_member_integer(member, &failures_str,
+                                traffic->tls_failures, 1);
+
+    return obj;
+}
+
+
+/*
+ * Buckets are reported cumulatively: each "le" member counts the samples
+ * that took no more than the given number of microseconds.
+ */
+
+static nxt_conf_value_t *
+nxt_status_hist_get(nxt_status_hist_t *hist, nxt_mp_t *mp)
+{
+    uint64_t          count;
+    nxt_uint_t        i;
+    nxt_conf_value_t  *obj, *buckets;
+
+    static nxt_str_t count_str = nxt_string("count");
+    static nxt_str_t sum_str = nxt_string("sum");
+    static nxt_str_t buckets_str = nxt_string("buckets");
+
+    obj = nxt_conf_create_object(mp, 3);
+    if (nxt_slow_path(obj == NULL)) {
+        return NULL;
+    }
+
+    buckets = nxt_conf_create_object(mp, NXT_STATUS_HIST_BUCKETS);
+    if (nxt_slow_path(buckets == NULL)) {
+        return NULL;
+    }
+
+    count = 0;
+
+    for (i = 0; i < NXT_STATUS_HIST_BUCKETS; i++) {
+        count += hist->buckets[i];
+        nxt_conf_set_member_integer(buckets, &nxt_status_hist_les[i], count, i);
+    }
+
+    nxt_conf_set_member_integer(obj, &count_str, count, 0);
+    nxt_conf_set_member_integer(obj, &sum_str, hist->sum, 1);
+    nxt_conf_set_member(obj, &buckets_str, buckets, 2);
+
+    return obj;
+}
+
+
+static void
+nxt_status_hist_merge(nxt_status_hist_t *dst, const nxt_status_hist_t *src)
+{
+    nxt_uint_t  i;
+
+    for (i = 0; i < NXT_STATUS_HIST_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+
+    dst->sum += src->sum;
+}
+
+
+void
+nxt_status_app_stats_merge(nxt_status_app_stats_t *dst,
+    const nxt_status_app_stats_t *src)
+{
+    nxt_uint_t  i;
+
+    for (i = 0; i < NXT_STATUS_REQ_NOUTCOMES; i++) {
+        dst->requests[i] += src->requests[i];
+    }
+
+    nxt_status_hist_merge(&dst->queue_wait, &src->queue_wait);
+    nxt_status_hist_merge(&dst->service_time, &src->service_time);
+    nxt_status_hist_merge(&dst->total_time, &src->total_time);
+}
+
+
+void
+nxt_status_traffic_merge(nxt_status_traffic_t *dst,
+    const nxt_status_traffic_t *src)
+{
+    nxt_uint_t  i;
+
+    dst->requests += src->requests;
+    dst->bytes_in += src->bytes_in;
+    dst->bytes_out += src->bytes_out;
+
+    for (i = 0; i < nxt_nitems(dst->responses); i++) {
+        dst->responses[i] += src->responses[i];
+    }
+
+    dst->tls_handshakes += src->tls_handshakes;
+    dst->tls_failures += src->tls_failures;
+}
+
+
+static void
+nxt_status_app_name(nxt_status_report_t *report, nxt_status_app_t *app,
+    nxt_str_t *name)
+{
+    name->length = app->name.length;
+    name->start = nxt_pointer_to(report, (uintptr_t) app->name.start);
+}
+
+
+/* Returns whether the listener or the route entry is a TLS listener. */
+
+static nxt_bool_t
+nxt_status_traffic_entry(nxt_status_report_t *report, nxt_bool_t route,
+    size_t i, nxt_str_t *name, nxt_status_traffic_t **traffic)
+{
+    nxt_status_route_t     *rt;
+    nxt_status_listener_t  *listener;
+
+    if (route) {
+        rt = &nxt_status_routes(report)[i];
+
+        name->length = rt->name.length;
+        name->start = nxt_pointer_to(report, (uintptr_t) rt->name.start);
+        *traffic = &rt->traffic;
+
+        return 0;
+    }
+
+    listener = &nxt_status_listeners(report)[i];
+
+    name->length = listener->name.length;
+    name->start = nxt_pointer_to(report, (uintptr_t) listener->name.start);
+    *traffic = &listener->traffic;
+
+    return listener->tls;
+}
+
+
+/*
+ * Renders the report in the OpenMetrics text format.  Samples of a metric
+ * family must be adjacent, so each family iterates over all applications.
+ */
+
+nxt_buf_t *
+nxt_status_metrics(nxt_status_report_t *report, nxt_mp_t *mp)
+{
+    u_char                 *p, *end;
+    size_t                 i, j, size, names, lines;
+    uint64_t               value;
+    nxt_buf_t              *b;
+    nxt_str_t              name;
+    nxt_status_app_t       *app;
+    nxt_status_route_t     *route;
+    nxt_status_listener_t  *listener;
+
+    const nxt_status_metric_t  *metric;
+
+    names = 0;
+
+    for (i = 0; i < report->apps_count; i++) {
+        names += report->apps[i].name.length;
+    }
+
+    /*
+     * Two description lines for each of 5 global, 6 other application,
+     * and traffic metric families, 5 global samples, and "# EOF".
+     */
+    lines = 2 * (5 + nxt_nitems(nxt_status_app_metrics) + 6
+                 + 2 * (nxt_nitems(nxt_status_traffic_metrics) + 1))
+            + 5 + 1;
+
+    size = lines * NXT_STATUS_METRICS_LINE;
+
+    /* Samples per application: plain, outcomes, histograms, and scaling. */
+    lines = nxt_nitems(nxt_status_app_metrics) + NXT_STATUS_REQ_NOUTCOMES
+            + 3 * (NXT_STATUS_HIST_BUCKETS + 2) + 2;
+
+    /* Label values may be escaped up to twice their length. */
+    size += lines * (report->apps_count * NXT_STATUS_METRICS_LINE + 2 * names);
+
+    /* Samples per listener and per route: plain and response classes. */
+    lines = nxt_nitems(nxt_status_traffic_metrics)
+            + nxt_nitems(nxt_status_response_classes);
+
+    listener = nxt_status_listeners(report);
+    route = nxt_status_routes(report);
+
+    names = 0;
+
+    for (i = 0; i < report->listeners_count; i++) {
+        names += listener[i].name.length;
+    }
+
+    for (i = 0; i < report->routes_count; i++) {
+        names += route[i].name.length;
+    }
+
+    size += lines * ((report->listeners_count + report->routes_count)
+                     * NXT_STATUS_METRICS_LINE + 2 * names);
+
+    b = nxt_buf_mem_alloc(mp, size, 0);
+    if (nxt_slow_path(b == NULL)) {
+        return NULL;
+    }
+
+    p = b->mem.free;
+    end = b->mem.end;
+
+    p = nxt_status_metrics_family(p, end, "unit_connections_accepted",
+                                  "counter", "Accepted client connections.");
+    p = nxt_sprintf(p, end, "unit_connections_accepted_total %uL\n",
+                    report->accepted_conns);
+
+    p = nxt_status_metrics_family(p, end, "unit_connections_active", "gauge",
+                                  "Client connections being processed.");
+    p = nxt_sprintf(p, end, "unit_connections_active %uL\n",
+                    report->accepted_conns - report->closed_conns
+                    - report->idle_conns);
+
+    p = nxt_status_metrics_family(p, end, "unit_connections_idle", "gauge",
+                                  "Idle keep-alive client connections.");
+    p = nxt_sprintf(p, end, "unit_connections_idle %uL\n",
+                    report->idle_conns);
+
+    p = nxt_status_metrics_family(p, end, "unit_connections_closed",
+                                  "counter", "Closed client connections.");
+    p = nxt_sprintf(p, end, "unit_connections_closed_total %uL\n",
+                    report->closed_conns);
+
+    p = nxt_status_metrics_family(p, end, "unit_requests", "counter",
+                                  "Client requests.");
+    p = nxt_sprintf(p, end, "unit_requests_total %uL\n", report->requests);
+
+    for (j = 0; j < nxt_nitems(nxt_status_app_metrics); j++) {
+        metric = &nxt_status_app_metrics[j];
+
+        p = nxt_status_metrics_family(p, end, metric->name,
+                                      metric->counter ? "counter" : "gauge",
+                                      metric->help);
+
+        for (i = 0; i < report->apps_count; i++) {
+            app = &report->apps[i];
+
+            value = metric->wide
+                    ? *(uint64_t *) ((u_char *) app + metric->offset)
+                    : *(uint32_t *) ((u_char *) app + metric->offset);
+
+            nxt_status_app_name(report, app, &name);
+
+            p = nxt_sprintf(p, end, "%s%s", metric->name,
+                            metric->counter ? "_total" : "");
+            p = nxt_status_metrics_label(p, end, "application", &name);
+            p = nxt_sprintf(p, end, "} %uL\n", value);
+        }
+    }
+
+    p = nxt_status_metrics_family(p, end, "unit_application_requests",
+                                  "counter",
+                                  "Application requests by outcome.");
+
+    for (i = 0; i < report->apps_count; i++) {
+        app = &report->apps[i];
+
+        nxt_status_app_name(report, app, &name);
+
+        for (j = 0; j < NXT_STATUS_REQ_NOUTCOMES; j++) {
+            p = nxt_sprintf(p, end, "unit_application_requests_total");
+            p = nxt_status_metrics_label(p, end, "application", &name);
+            p = nxt_sprintf(p, end, ",outcome=\"%V\"} %uL\n",
+                            &nxt_status_req_outcomes[j],
+                            app->stats.requests[j]);
+        }
+    }
+
+    p = nxt_status_metrics_hist(p, end, report,
+                                "unit_application_queue_wait_seconds",
+                                "Time requests waited for a process.",
+                                offsetof(nxt_status_app_t, stats.queue_wait));
+
+    p = nxt_status_metrics_hist(p, end, report,
+                                "unit_application_service_seconds",
+                                "Time processes spent on requests.",
+                                offsetof(nxt_status_app_t,
+                                         stats.service_time));
+
+    p = nxt_status_metrics_hist(p, end, report,
+                                "unit_application_request_seconds",
+                                "Total time of application requests.",
+                                offsetof(nxt_status_app_t, stats.total_time));
+
+    p = nxt_status_metrics_family(p, end, "unit_application_scaling_started",
+                                  "counter",
+                                  "Processes started by the adaptive policy.");
+
+    for (i = 0; i < report->apps_count; i++) {
+        app = &report->apps[i];
+
+        if (app->adaptive) {
+            nxt_status_app_name(report, app, &name);
+
+            p = nxt_sprintf(p, end, "unit_application_scaling_started_total");
+            p = nxt_status_metrics_label(p, end, "application", &name);
+            p = nxt_sprintf(p, end, "} %uD\n", app->scale_ups);
+        }
+    }
+
+    p = nxt_status_metrics_family(p, end, "unit_application_scaling_stopped",
+                                  "counter",
+                                  "Processes stopped by the adaptive policy.");
+
+    for (i = 0; i < report->apps_count; i++) {
+        app = &report->apps[i];
+
+        if (app->adaptive) {
+            nxt_status_app_name(report, app, &name);
+
+            p = nxt_sprintf(p, end, "unit_application_scaling_stopped_total");
+            p = nxt_status_metrics_label(p, end, "application", &name);
+            p = nxt_sprintf(p, end, "} %uD\n", app->scale_downs);
+        }
+    }
+
+    p = nxt_status_metrics_traffic(p, end, report, 0);
+    p = nxt_status_metrics_traffic(p, end, report, 1);
+
+    p = nxt_sprintf(p, end, "# EOF\n");
+
+    b->mem.free = p;
+
+    return b;
+}
+
+
+static u_char *
+nxt_status_metrics_family(u_char *p, u_char *end, const char *name,
+    const char *type, const char *help)
+{
+    return nxt_sprintf(p, end, "# TYPE %s %s\n# HELP %s %s\n",
+                       name, type, name, help);
+}
+
+
+/* Opens the label set with the escaped label value. */
+
+static u_char *
+nxt_status_metrics_label(u_char *p, u_char *end, const char *label,
+    nxt_str_t *value)
+{
+    u_char  ch;
+    size_t  i;
+
+    p = nxt_sprintf(p, end, "{%s=\"", label);
+
+    for (i = 0; i < value->length && end - p > 2; i++) {
+        ch = value->start[i];
+
+        switch (ch) {
+
+        case '\\':
+        case '"':
+            *p++ = '\\';
+            *p++ = ch;
+            break;
+
+        case '\n':
+            *p++ = '\\';
+            *p++ = 'n';
+            break;
+
+        default:
+            *p++ = ch;
+            break;
+        }
+    }
+
+    return nxt_sprintf(p, end, "\"");
+}
+
+
+static u_char *
+nxt_status_metrics_hist(u_char *p, u_char *end, nxt_status_report_t *report,
+    const char *name, const char *help, size_t offset)
+{
+    size_t             i, j;
+    uint64_t           count;
+    nxt_str_t          app_name;
+    nxt_status_app_t   *app;
+    nxt_status_hist_t  *hist;
+
+    p = nxt_status_metrics_family(p, end, name, "histogram", help);
+
+    for (i = 0; i < report->apps_count; i++) {
+        app = &report->apps[i];
+        hist = (nxt_status_hist_t *) ((u_char *) app + offset);
+
+        nxt_status_app_name(report, app, &app_name);
+
+        count = 0;
+
+        for (j = 0; j < NXT_STATUS_HIST_BUCKETS; j++) {
+            count += hist->buckets[j];
+
+            p = nxt_sprintf(p, end, "%s_bucket", name);
+            p = nxt_status_metrics_label(p, end, "application", &app_name);
+            p = nxt_sprintf(p, end, ",le=\"%s\"} %uL\n",
+                            nxt_status_metrics_les[j], count);
+        }
+
+        p = nxt_sprintf(p, end, "%s_count", name);
+        p = nxt_status_metrics_label(p, end, "application", &app_name);
+        p = nxt_sprintf(p, end, "} %uL\n", count);
+
+        p = nxt_sprintf(p, end, "%s_sum", name);
+        p = nxt_status_metrics_label(p, end, "application", &app_name);
+        p = nxt_sprintf(p, end, "} %uL.%06uL\n",
+                        hist->sum / 1000000, hist->sum % 1000000);
+    }
+
+    return p;
+}
+
+
+static u_char *
+nxt_status_metrics_traffic(u_char *p, u_char *end, nxt_status_report_t *report,
+    nxt_bool_t route)
+{
+    size_t                 i, j, n;
+    uint64_t               value;
+    nxt_str_t              name;
+    nxt_bool_t             tls;
+    const char             *kind;
+    nxt_status_traffic_t   *traffic;
+
+    const nxt_status_traffic_metric_t  *metric;
+
+    kind = route ? "route" : "listener";
+    n = route ? report->routes_count : report->listeners_count;
+
+    for (j = 0; j < nxt_nitems(nxt_status_traffic_metrics); j++) {
+        metric = &nxt_status_traffic_metrics[j];
+
+        if (route && metric->tls) {
+            continue;
+        }
+
+        p = nxt_sprintf(p, end, "# TYPE unit_%s_%s counter\n"
+                                "# HELP unit_%s_%s %s\n",
+                        kind, metric->name, kind, metric->name, metric->help);
+
+        for (i = 0; i < n; i++) {
+            tls = nxt_status_traffic_entry(report, route, i, &name, &traffic);
+
+            if (metric->tls && !tls) {
+                continue;
+            }
+
+            value = *(uint64_t *) ((u_char *) traffic + metric->offset);
+
+            p = nxt_sprintf(p, end, "unit_%s_%s_total", kind, metric->name);
+            p = nxt_status_metrics_label(p, end, kind, &name);
+            p = nxt_sprintf(p, end, "} %uL\n", value);
+        }
+    }
+
+    p = nxt_sprintf(p, end, "# TYPE unit_%s_responses counter\n"
+                            "# HELP unit_%s_responses "
+                            "Responses by status class.\n",
+                    kind, kind);
+
+    for (i = 0; i < n; i++) {
+        (void) nxt_status_traffic_entry(report, route, i, &name, &traffic);
+
+        for (j = 0; j < nxt_nitems(nxt_status_response_classes); j++) {
+            p = nxt_sprintf(p, end, "unit_%s_responses_total", kind);
+            p = nxt_status_metrics_label(p, end, kind, &name);
+            p = nxt_sprintf(p, end, ",code=\"%V\"} %uL\n",
+                            &nxt_status_response_classes[j],
+                            traffic->responses[j]);
+        }
+    }
+
+    return p;
+}
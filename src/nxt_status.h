@@ -7,27 +7,149 @@
 #define _NXT_STATUS_H_INCLUDED_
 
 
+/*
+ * Latency histograms use fixed log-scale buckets (1-2.5-5 series) from
+ * 50 microseconds to 10 seconds; the last bucket counts the rest.
+ */
+
+#define NXT_STATUS_HIST_BUCKETS  18
+
+
+typedef struct {
+    uint64_t          buckets[NXT_STATUS_HIST_BUCKETS];
+    uint64_t          sum;              /* microseconds */
+} nxt_status_hist_t;
+
+
+typedef enum {
+    NXT_STATUS_REQ_COMPLETED = 0,
+    NXT_STATUS_REQ_FAILED,
+    NXT_STATUS_REQ_TIMED_OUT,
+    NXT_STATUS_REQ_CANCELLED,
+
+    NXT_STATUS_REQ_NOUTCOMES,
+} nxt_status_req_outcome_t;
+
+
+typedef struct {
+    uint64_t           requests[NXT_STATUS_REQ_NOUTCOMES];
+
+    nxt_status_hist_t  queue_wait;
+    nxt_status_hist_t  service_time;
+    nxt_status_hist_t  total_time;
+} nxt_status_app_stats_t;
+
+
+typedef enum {
+    NXT_STATUS_SCALE_NONE = 0,
+    NXT_STATUS_SCALE_UP_SPARE,
+    NXT_STATUS_SCALE_UP_DEMAND,
+    NXT_STATUS_SCALE_UP_QUEUE,
+    NXT_STATUS_SCALE_DOWN_IDLE,
+    NXT_STATUS_SCALE_HOLD_COOLDOWN,
+    NXT_STATUS_SCALE_HOLD_QUEUE,
+} nxt_status_scale_reason_t;
+
+
 typedef struct {
     nxt_str_t         name;
     uint32_t          active_requests;
     uint32_t          pending_processes;
     uint32_t          processes;
     uint32_t          idle_processes;
+
+    uint32_t          shm_segments;
+    uint32_t          shm_chunks;
+    uint32_t          shm_busy_chunks;
+    uint64_t          shm_oosm;
+
+    uint8_t           adaptive;
+    uint8_t           scale_reason;     /* nxt_status_scale_reason_t */
+    uint32_t          scale_ups;
+    uint32_t          scale_downs;
+    uint32_t          queue_wait;
+    uint32_t          service_time;
+
+    nxt_status_app_stats_t  stats;
 } nxt_status_app_t;
 
 
+typedef struct {
+    uint64_t          requests;
+    uint64_t          bytes_in;
+    uint64_t          bytes_out;
+    uint64_t          responses[5];     /* 1xx to 5xx */
+
+    uint64_t          tls_handshakes;
+    uint64_t          tls_failures;
+} nxt_status_traffic_t;
+
+
+typedef struct {
+    nxt_str_t             name;
+    uint8_t               tls;          /* 1 bit */
+    nxt_status_traffic_t  traffic;
+} nxt_status_listener_t;
+
+
+typedef struct {
+    nxt_str_t             name;
+    nxt_status_traffic_t  traffic;
+} nxt_status_route_t;
+
+
+/*
+ * The report is followed by listeners_count of nxt_status_listener_t,
+ * routes_count of nxt_status_route_t, and then by the names.
+ */
+
 typedef struct {
     uint64_t          accepted_conns;
     uint64_t          idle_conns;
     uint64_t          closed_conns;
     uint64_t          requests;
 
+    size_t            listeners_count;
+    size_t            routes_count;
+
     size_t            apps_count;
     nxt_status_app_t  apps[];
 } nxt_status_report_t;
 
 
+#define nxt_status_listeners(report)                                          \
+    ((nxt_status_listener_t *) &(report)->apps[(report)->apps_count])
+
+#define nxt_status_routes(report)                                             \
+    ((nxt_status_route_t *)                                                   \
+         &nxt_status_listeners(report)[(report)->listeners_count])
+
+
 nxt_conf_value_t *nxt_status_get(nxt_status_report_t *report, nxt_mp_t *mp);
+nxt_buf_t *nxt_status_metrics(nxt_status_report_t *report, nxt_mp_t *mp);
+void nxt_status_app_stats_merge(nxt_status_app_stats_t *dst,
+    const nxt_status_app_stats_t *src);
+void nxt_status_traffic_merge(nxt_status_traffic_t *dst,
+    const nxt_status_traffic_t *src);
+
+
+extern const uint32_t  nxt_status_hist_bounds[NXT_STATUS_HIST_BUCKETS - 1];
+
+
+nxt_inline void
+nxt_status_hist_add(nxt_status_hist_t *hist, uint64_t usec)
+{
+    nxt_uint_t  i;
+
+    for (i = 0; i < NXT_STATUS_HIST_BUCKETS - 1; i++) {
+        if (usec <= nxt_status_hist_bounds[i]) {
+            break;
+        }
+    }
+
+    hist->buckets[i]++;
+    hist->sum += usec;
+}
 
 
 #endif /* _NXT_STATUS_H_INCLUDED_ */
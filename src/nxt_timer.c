@@ -9,7 +9,7 @@
 
 /*
  * Timer operations are batched in the changes array to improve instruction
- * and data cache locality of rbtree operations.
+ * and data cache locality of timer wheel operations.
  *
  * nxt_timer_add() adds or modify a timer.
  *
@@ -19,18 +19,65 @@
  * changes in the changes array or 0 otherwise.
  */
 
-static intptr_t nxt_timer_rbtree_compare(nxt_rbtree_node_t *node1,
-    nxt_rbtree_node_t *node2);
+static void nxt_timer_wheel_insert(nxt_timers_t *timers, nxt_timer_t *timer);
+static void nxt_timer_wheel_delete(nxt_timers_t *timers, nxt_timer_t *timer);
 static void nxt_timer_change(nxt_event_engine_t *engine, nxt_timer_t *timer,
     nxt_timer_operation_t change, nxt_msec_t time);
 static void nxt_timer_changes_commit(nxt_event_engine_t *engine);
 static void nxt_timer_handler(nxt_task_t *task, void *obj, void *data);
 
 
+#if (NXT_HAVE_BUILTIN_CTZLL)
+
+#define nxt_timer_ctz64(value)                                                \
+    __builtin_ctzll(value)
+
+#else
+
+nxt_inline nxt_uint_t
+nxt_timer_ctz64(uint64_t value)
+{
+    nxt_uint_t  n;
+
+    for (n = 0; (value & 1) == 0; n++) {
+        value >>= 1;
+    }
+
+    return n;
+}
+
+#endif
+
+
+#define nxt_timer_level_shift(lvl)                                            \
+    ((lvl) * NXT_TIMER_WHEEL_SHIFT)
+
+/*
+ * The maximum timeout which fits in a level.  One slot is reserved
+ * to round a timer time up to the slot granularity without wrapping
+ * around to the current slot.
+ */
+#define nxt_timer_level_range(lvl)                                            \
+    ((int32_t) (NXT_TIMER_WHEEL_SIZE - 1) << nxt_timer_level_shift(lvl))
+
+
 nxt_int_t
 nxt_timers_init(nxt_timers_t *timers, nxt_uint_t mchanges)
 {
-    nxt_rbtree_init(&timers->tree, nxt_timer_rbtree_compare);
+    nxt_uint_t         i, n;
+    nxt_timer_level_t  *level;
+
+    for (i = 0; i < NXT_TIMER_WHEEL_LEVELS; i++) {
+        level = &timers->level[i];
+
+        level->occupied = 0;
+
+        for (n = 0; n < NXT_TIMER_WHEEL_SIZE; n++) {
+            nxt_queue_init(&level->slot[n]);
+        }
+    }
+
+    nxt_queue_init(&timers->due);
 
     if (mchanges > NXT_TIMER_MAX_CHANGES) {
         mchanges = NXT_TIMER_MAX_CHANGES;
@@ -48,24 +95,6 @@ nxt_timers_init(nxt_timers_t *timers, nxt_uint_t mchanges)
 }
 
 
-static intptr_t
-nxt_timer_rbtree_compare(nxt_rbtree_node_t *node1, nxt_rbtree_node_t *node2)
-{
-    nxt_timer_t  *timer1, *timer2;
-
-    timer1 = (nxt_timer_t *) node1;
-    timer2 = (nxt_timer_t *) node2;
-
-    /*
-     * Timer values are distributed in small range, usually several minutes
-     * and overflow every 49 days if nxt_msec_t is stored in 32 bits.
-     * This signed comparison takes into account that overflow.
-     */
-                      /* timer1->time < timer2->time */
-    return nxt_msec_diff(timer1->time , timer2->time);
-}
-
-
 void
 nxt_timer_add(nxt_event_engine_t *engine, nxt_timer_t *timer,
     nxt_msec_t timeout)
@@ -80,13 +109,13 @@ nxt_timer_add(nxt_event_engine_t *engine, nxt_timer_t *timer,
 
     timer->enabled = 1;
 
-    if (nxt_timer_is_in_tree(timer)) {
+    if (nxt_timer_is_in_wheel(timer)) {
 
         diff = nxt_msec_diff(time, timer->time);
         /*
          * Use the previous timer if difference between it and the
-         * new timer is within bias: this decreases number of rbtree
-         * operations for fast connections.
+         * new timer is within bias: this decreases number of timer
+         * wheel operations for fast connections.
          */
         if (nxt_abs(diff) <= timer->bias) {
             nxt_debug(timer->task, "timer previous: %M±%d",
@@ -109,7 +138,7 @@ nxt_timer_delete(nxt_event_engine_t *engine, nxt_timer_t *timer)
 
     timer->enabled = 0;
 
-    if (nxt_timer_is_in_tree(timer)) {
+    if (nxt_timer_is_in_wheel(timer)) {
 
         nxt_timer_change(engine, timer, NXT_TIMER_DELETE, 0);
 
@@ -161,7 +190,7 @@ nxt_timer_changes_commit(nxt_event_engine_t *engine)
 {
     nxt_timer_t         *timer;
     nxt_timers_t        *timers;
-    nxt_timer_change_t  *ch, *end, *add, *add_end;
+    nxt_timer_change_t  *ch, *end;
 
     timers = &engine->timers;
 
@@ -170,9 +199,6 @@ nxt_timer_changes_commit(nxt_event_engine_t *engine)
     ch = timers->changes;
     end = ch + timers->nchanges;
 
-    add = ch;
-    add_end = add;
-
     while (ch < end) {
         timer = ch->timer;
 
@@ -183,24 +209,18 @@ nxt_timer_changes_commit(nxt_event_engine_t *engine)
 
         case NXT_TIMER_ADD:
 
-            timer->time = ch->time;
-
-            add_end->timer = timer;
-            add_end++;
-
-            if (!nxt_timer_is_in_tree(timer)) {
-                break;
+            if (nxt_timer_is_in_wheel(timer)) {
+                nxt_timer_wheel_delete(timers, timer);
             }
 
-            /* Fall through. */
+            timer->time = ch->time;
 
-        case NXT_TIMER_DELETE:
-            nxt_debug(timer->task, "timer rbtree delete: %M±%d",
-                      timer->time, timer->bias);
+            nxt_timer_wheel_insert(timers, timer);
 
-            nxt_rbtree_delete(&timers->tree, &timer->node);
-            nxt_timer_in_tree_clear(timer);
+            break;
 
+        case NXT_TIMER_DELETE:
+            nxt_timer_wheel_delete(timers, timer);
             break;
         }
 
@@ -209,31 +229,111 @@ nxt_timer_changes_commit(nxt_event_engine_t *engine)
         ch++;
     }
 
-    while (add < add_end) {
-        timer = add->timer;
+    timers->nchanges = 0;
+}
+
+
+static void
+nxt_timer_wheel_insert(nxt_timers_t *timers, nxt_timer_t *timer)
+{
+    int32_t            delta;
+    uint32_t           slot;
+    nxt_uint_t         lvl, shift;
+    nxt_timer_level_t  *level;
+
+    delta = nxt_msec_diff(timer->time, timers->now);
 
-        nxt_debug(timer->task, "timer rbtree insert: %M±%d",
+    if (delta <= 0) {
+        nxt_debug(timer->task, "timer wheel due: %M±%d",
                   timer->time, timer->bias);
 
-        nxt_rbtree_insert(&timers->tree, &timer->node);
-        nxt_timer_in_tree_set(timer);
+        nxt_queue_insert_tail(&timers->due, &timer->link);
+        return;
+    }
 
-        add++;
+    for (lvl = 0; lvl < NXT_TIMER_WHEEL_LEVELS - 1; lvl++) {
+        if (delta < nxt_timer_level_range(lvl)) {
+            break;
+        }
     }
 
-    timers->nchanges = 0;
+    shift = nxt_timer_level_shift(lvl);
+
+    if (nxt_fast_path(delta < nxt_timer_level_range(lvl))) {
+        /* Round the time up to the slot granularity. */
+        slot = (timer->time + (1 << shift) - 1) >> shift;
+
+    } else {
+        /*
+         * The timeout is larger than the wheel range: the timer is
+         * placed in the farthest slot and reinserted on its expiry.
+         */
+        slot = (timers->now >> shift) + NXT_TIMER_WHEEL_SIZE - 1;
+    }
+
+    slot &= NXT_TIMER_WHEEL_MASK;
+
+    nxt_debug(timer->task, "timer wheel insert: %M±%d %ui:%uD",
+              timer->time, timer->bias, lvl, slot);
+
+    level = &timers->level[lvl];
+
+    nxt_queue_insert_tail(&level->slot[slot], &timer->link);
+    level->occupied |= (uint64_t) 1 << slot;
+}
+
+
+static void
+nxt_timer_wheel_delete(nxt_timers_t *timers, nxt_timer_t *timer)
+{
+    nxt_uint_t         lvl, slot;
+    nxt_queue_t        *queue;
+    nxt_queue_link_t   *next;
+    nxt_timer_level_t  *level;
+
+    nxt_debug(timer->task, "timer wheel delete: %M±%d",
+              timer->time, timer->bias);
+
+    next = timer->link.next;
+
+    nxt_queue_remove(&timer->link);
+    nxt_timer_in_wheel_clear(timer);
+
+    /*
+     * If the timer was the only one in its slot, then the slot's queue
+     * head is both its previous and next link, so the slot becomes empty.
+     */
+
+    if (next->next != next) {
+        return;
+    }
+
+    for (lvl = 0; lvl < NXT_TIMER_WHEEL_LEVELS; lvl++) {
+        level = &timers->level[lvl];
+        queue = (nxt_queue_t *) next;
+
+        if (queue >= &level->slot[0]
+            && queue < &level->slot[NXT_TIMER_WHEEL_SIZE])
+        {
+            slot = queue - &level->slot[0];
+            level->occupied &= ~((uint64_t) 1 << slot);
+
+            return;
+        }
+    }
 }
 
 
 nxt_msec_t
 nxt_timer_find(nxt_event_engine_t *engine)
 {
-    int32_t            delta;
+    int32_t            delta, min;
+    uint32_t           base, start;
+    uint64_t           occupied;
+    nxt_uint_t         lvl, shift;
     nxt_msec_t         time;
-    nxt_timer_t        *timer;
     nxt_timers_t       *timers;
-    nxt_rbtree_t       *tree;
-    nxt_rbtree_node_t  *node, *next;
+    nxt_timer_level_t  *level;
 
     timers = &engine->timers;
 
@@ -241,35 +341,61 @@ nxt_timer_find(nxt_event_engine_t *engine)
         nxt_timer_changes_commit(engine);
     }
 
-    tree = &timers->tree;
+    if (!nxt_queue_is_empty(&timers->due)) {
+        timers->minimum = timers->now;
 
-    for (node = nxt_rbtree_min(tree);
-         nxt_rbtree_is_there_successor(tree, node);
-         node = next)
-    {
-        next = nxt_rbtree_node_successor(tree, node);
+        nxt_debug(&engine->task, "timer found due: %M", timers->now);
 
-        timer = (nxt_timer_t *) node;
+        return 0;
+    }
 
-        /*
-         * Disabled timers are not deleted here since the minimum active
-         * timer may be larger than a disabled timer, but event poll may
-         * return much earlier and the disabled timer can be reactivated.
-         */
+    min = NXT_INT32_T_MAX;
 
-        if (timer->enabled) {
-            time = timer->time;
-            timers->minimum = time - timer->bias;
+    for (lvl = 0; lvl < NXT_TIMER_WHEEL_LEVELS; lvl++) {
+        level = &timers->level[lvl];
+        occupied = level->occupied;
+
+        if (occupied == 0) {
+            continue;
+        }
+
+        shift = nxt_timer_level_shift(lvl);
+
+        /* The slot of the current time has been already expired. */
+        base = (timers->now >> shift) + 1;
+        start = base & NXT_TIMER_WHEEL_MASK;
+
+        /* Rotate the bitmap so the bit 0 corresponds to the next slot. */
+        if (start != 0) {
+            occupied = (occupied >> start)
+                       | (occupied << (NXT_TIMER_WHEEL_SIZE - start));
+        }
 
-            nxt_debug(timer->task, "timer found minimum: %M±%d:%M",
-                      time, timer->bias, timers->now);
+        time = (base + nxt_timer_ctz64(occupied)) << shift;
 
-            delta = nxt_msec_diff(time, timers->now);
+        delta = nxt_msec_diff(time, timers->now);
 
-            return (nxt_msec_t) nxt_max(delta, 0);
+        if (delta < min) {
+            min = delta;
         }
     }
 
+    /*
+     * Slots may contain disabled timers only, these timers are not
+     * deleted here since the event poll may return earlier and the
+     * disabled timers can be reactivated.  In the worst case the
+     * engine wakes up once for a slot without active timers.
+     */
+
+    if (min != NXT_INT32_T_MAX) {
+        timers->minimum = timers->now + min;
+
+        nxt_debug(&engine->task, "timer found minimum: %M:%M",
+                  timers->minimum, timers->now);
+
+        return (nxt_msec_t) min;
+    }
+
     /* Set minimum time one day ahead. */
     timers->minimum = timers->now + 24 * 60 * 60 * 1000;
 
@@ -280,42 +406,91 @@ nxt_timer_find(nxt_event_engine_t *engine)
 void
 nxt_timer_expire(nxt_event_engine_t *engine, nxt_msec_t now)
 {
+    uint32_t           slot, nslots;
+    nxt_msec_t         prev;
+    nxt_uint_t         lvl, shift;
+    nxt_queue_t        expired;
     nxt_timer_t        *timer;
     nxt_timers_t       *timers;
-    nxt_rbtree_t       *tree;
-    nxt_rbtree_node_t  *node, *next;
+    nxt_queue_link_t   *lnk;
+    nxt_timer_level_t  *level;
 
     timers = &engine->timers;
+
+    prev = timers->now;
     timers->now = now;
 
     nxt_debug(&engine->task, "timer expire minimum: %M:%M",
               timers->minimum, now);
 
+    nxt_queue_init(&expired);
+
+    if (!nxt_queue_is_empty(&timers->due)) {
+        nxt_queue_add(&expired, &timers->due);
+        nxt_queue_init(&timers->due);
+    }
+
                    /* timers->minimum > now */
     if (nxt_msec_diff(timers->minimum , now) > 0) {
-        return;
+        goto done;
     }
 
-    tree = &timers->tree;
+    for (lvl = 0; lvl < NXT_TIMER_WHEEL_LEVELS; lvl++) {
+        shift = nxt_timer_level_shift(lvl);
 
-    for (node = nxt_rbtree_min(tree);
-         nxt_rbtree_is_there_successor(tree, node);
-         node = next)
-    {
-        timer = (nxt_timer_t *) node;
+        /*
+         * The number of slots passed since the previous expiration,
+         * the subtraction takes into account the time overflow.
+         */
+        nslots = (now - (prev & ~((1 << shift) - 1))) >> shift;
 
-                       /* timer->time > now + timer->bias */
-        if (nxt_msec_diff(timer->time , now) > (int32_t) timer->bias) {
-            return;
+        if (nslots == 0) {
+            /* Upper levels have not moved either. */
+            break;
         }
 
-        next = nxt_rbtree_node_successor(tree, node);
+        level = &timers->level[lvl];
+
+        if (level->occupied == 0) {
+            continue;
+        }
+
+        nslots = nxt_min(nslots, NXT_TIMER_WHEEL_SIZE);
+        slot = prev >> shift;
+
+        while (nslots != 0) {
+            slot = (slot + 1) & NXT_TIMER_WHEEL_MASK;
+
+            if (level->occupied & ((uint64_t) 1 << slot)) {
+                level->occupied &= ~((uint64_t) 1 << slot);
+
+                nxt_queue_add(&expired, &level->slot[slot]);
+                nxt_queue_init(&level->slot[slot]);
+            }
+
+            nslots--;
+        }
+    }
+
+done:
+
+    while (!nxt_queue_is_empty(&expired)) {
+        lnk = nxt_queue_first(&expired);
+        timer = nxt_queue_link_data(lnk, nxt_timer_t, link);
+
+        nxt_queue_remove(lnk);
+
+                       /* timer->time > now */
+        if (nxt_slow_path(nxt_msec_diff(timer->time, now) > 0)) {
+            /* A timer with timeout larger than the wheel range. */
+            nxt_timer_wheel_insert(timers, timer);
+            continue;
+        }
 
         nxt_debug(timer->task, "timer expire delete: %M±%d",
                   timer->time, timer->bias);
 
-        nxt_rbtree_delete(tree, &timer->node);
-        nxt_timer_in_tree_clear(timer);
+        nxt_timer_in_wheel_clear(timer);
 
         if (timer->enabled) {
             timer->queued = 1;
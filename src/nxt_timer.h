@@ -22,8 +22,7 @@
 
 
 typedef struct {
-    /* The rbtree node must be the first field. */
-    NXT_RBTREE_NODE           (node);
+    nxt_queue_link_t          link;
 
     uint8_t                   bias;
 
@@ -41,7 +40,7 @@ typedef struct {
 } nxt_timer_t;
 
 
-#define NXT_TIMER             { NXT_RBTREE_NODE_INIT, 0, NXT_TIMER_NO_CHANGE, \
+#define NXT_TIMER             { { NULL, NULL }, 0, NXT_TIMER_NO_CHANGE,       \
                                 0, 0, 0, NULL, NULL, NULL, NULL }
 
 
@@ -59,8 +58,35 @@ typedef struct {
 } nxt_timer_change_t;
 
 
+/*
+ * Timers are kept in a hashed hierarchical timer wheel.  Each level has
+ * 64 slots, and the slot granularity grows eight times per level: 1ms,
+ * 8ms, 64ms, 512ms, 4.096s, 32.768s, 262.144s, and 2097.152s.  A timer
+ * is placed on the lowest level whose range covers its timeout, so short
+ * timeouts expire precisely while long idle timeouts are hashed into coarse
+ * buckets and may expire up to 1/8 of the timeout later.  Timers are never
+ * cascaded between levels.
+ */
+
+#define NXT_TIMER_WHEEL_LEVELS  8
+#define NXT_TIMER_WHEEL_BITS    6
+#define NXT_TIMER_WHEEL_SIZE    (1 << NXT_TIMER_WHEEL_BITS)
+#define NXT_TIMER_WHEEL_MASK    (NXT_TIMER_WHEEL_SIZE - 1)
+#define NXT_TIMER_WHEEL_SHIFT   3
+
+
 typedef struct {
-    nxt_rbtree_t              tree;
+    /* A bitmap of non-empty slots. */
+    uint64_t                  occupied;
+    nxt_queue_t               slot[NXT_TIMER_WHEEL_SIZE];
+} nxt_timer_level_t;
+
+
+typedef struct {
+    nxt_timer_level_t         level[NXT_TIMER_WHEEL_LEVELS];
+
+    /* Timers which are due on the next nxt_timer_expire() call. */
+    nxt_queue_t               due;
 
     /* An overflown milliseconds counter. */
     nxt_msec_t                now;
@@ -78,18 +104,15 @@ typedef struct {
 
 
 /*
- * When timer resides in rbtree all links of its node are not NULL.
- * A parent link is the nearst to other timer flags.
+ * When timer resides in the wheel its link is not NULL.  The link is
+ * cleared explicitly since nxt_queue_remove() clears it in debug mode only.
  */
 
-#define nxt_timer_is_in_tree(timer)                                           \
-    ((timer)->node.parent != NULL)
-
-#define nxt_timer_in_tree_set(timer)
-    /* Noop, because rbtree insertion sets a node's parent link. */
+#define nxt_timer_is_in_wheel(timer)                                          \
+    ((timer)->link.next != NULL)
 
-#define nxt_timer_in_tree_clear(timer)                                        \
-    (timer)->node.parent = NULL
+#define nxt_timer_in_wheel_clear(timer)                                       \
+    (timer)->link.next = NULL
 
 
 nxt_int_t nxt_timers_init(nxt_timers_t *timers, nxt_uint_t mchanges);
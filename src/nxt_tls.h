@@ -65,10 +65,16 @@ struct nxt_tls_conf_s {
     nxt_tls_bundle_conf_t         *bundle;
     nxt_lvlhsh_t                  bundle_hash;
 
+    nxt_mp_t                      *mem_pool;
+    nxt_str_t                     conf;
+    nxt_uint_t                    count;
+
     nxt_tls_tickets_t             *tickets;
 
     void                          (*conn_init)(nxt_task_t *task,
                                       nxt_tls_conf_t *conf, nxt_conn_t *c);
+    void                          (*handshake_handler)(nxt_task_t *task,
+                                      nxt_conn_t *c);
 
     const nxt_tls_lib_t           *lib;
 
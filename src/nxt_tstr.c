@@ -51,6 +51,9 @@ struct nxt_tstr_query_s {
     nxt_strchr_start(str, '`')
 
 
+static nxt_bool_t nxt_tstr_js_literal(nxt_str_t *str, nxt_str_t *literal);
+
+
 nxt_tstr_state_t *
 nxt_tstr_state_new(nxt_mp_t *mp, nxt_bool_t test)
 {
@@ -85,11 +88,18 @@ nxt_tstr_compile(nxt_tstr_state_t *state, nxt_str_t *str,
     nxt_tstr_flags_t flags)
 {
     u_char      *p;
+    nxt_str_t   literal;
     nxt_tstr_t  *tstr;
-    nxt_bool_t  strz;
+    nxt_bool_t  strz, is_literal;
 
     strz = (flags & NXT_TSTR_STRZ) != 0;
 
+    is_literal = nxt_tstr_js_literal(str, &literal);
+
+    if (is_literal) {
+        str = &literal;
+    }
+
     tstr = nxt_mp_get(state->pool, sizeof(nxt_tstr_t));
     if (nxt_slow_path(tstr == NULL)) {
         return NULL;
@@ -110,7 +120,10 @@ nxt_tstr_compile(nxt_tstr_state_t *state, nxt_str_t *str,
 
     tstr->flags = flags;
 
-    if (nxt_tstr_is_js(str)) {
+    if (is_literal) {
+        tstr->type = NXT_TSTR_CONST;
+
+    } else if (nxt_tstr_is_js(str)) {
 
 #if (NXT_HAVE_NJS)
 
@@ -147,6 +160,47 @@ nxt_tstr_compile(nxt_tstr_state_t *state, nxt_str_t *str,
 }
 
 
+/*
+ * A JS template literal without substitutions and escapes evaluates
+ * to its own text, so it is handled as a constant string.
+ */
+
+static nxt_bool_t
+nxt_tstr_js_literal(nxt_str_t *str, nxt_str_t *literal)
+{
+    u_char  *p, *end;
+
+    if (str->length < 2
+        || str->start[0] != '`'
+        || str->start[str->length - 1] != '`')
+    {
+        return 0;
+    }
+
+    end = str->start + str->length - 1;
+
+    for (p = str->start + 1; p < end; p++) {
+
+        switch (*p) {
+        case '`':
+        case '\\':
+        case '\r':
+            return 0;
+
+        case '$':
+            if (p + 1 < end && p[1] == '{') {
+                return 0;
+            }
+        }
+    }
+
+    literal->start = str->start + 1;
+    literal->length = str->length - 2;
+
+    return 1;
+}
+
+
 nxt_int_t
 nxt_tstr_test(nxt_tstr_state_t *state, nxt_str_t *str, u_char *error)
 {
@@ -338,6 +392,6 @@ void
 nxt_tstr_query_release(nxt_tstr_query_t *query)
 {
 #if (NXT_HAVE_NJS)
-    nxt_js_release(&query->cache->js);
+    nxt_js_release(query->state->jcf, &query->cache->js);
 #endif
 }
@@ -24,6 +24,9 @@
 #define NXT_UNIT_LOCAL_BUF_SIZE  \
     (NXT_UNIT_MAX_PLAIN_SIZE + sizeof(nxt_port_msg_t))
 
+/* The minimum interval between reads of the port for cancellations, usec. */
+#define NXT_UNIT_CANCEL_CHECK_INTERVAL  100000
+
 enum {
     NXT_QUIT_NORMAL   = 0,
     NXT_QUIT_GRACEFUL = 1,
@@ -42,6 +45,7 @@ typedef struct nxt_unit_request_info_impl_s     nxt_unit_request_info_impl_t;
 typedef struct nxt_unit_websocket_frame_impl_s  nxt_unit_websocket_frame_impl_t;
 
 static nxt_unit_impl_t *nxt_unit_create(nxt_unit_init_t *init);
+static uint32_t nxt_unit_shm_segment_size(uint32_t size);
 static int nxt_unit_ctx_init(nxt_unit_impl_t *lib,
     nxt_unit_ctx_impl_t *ctx_impl, void *data);
 nxt_inline void nxt_unit_ctx_use(nxt_unit_ctx_t *ctx);
@@ -57,7 +61,8 @@ static int nxt_unit_read_env(nxt_unit_port_t *ready_port,
     nxt_unit_port_t *router_port, nxt_unit_port_t *read_port,
     int *shared_port_fd, int *shared_queue_fd,
     int *log_fd, uint32_t *stream, uint32_t *shm_limit,
-    uint32_t *request_limit);
+    uint32_t *request_limit, uint32_t *shm_segment, int *shm_huge_pages,
+    uint32_t *busy_poll);
 static int nxt_unit_ready(nxt_unit_ctx_t *ctx, int ready_fd, uint32_t stream,
     int queue_fd);
 static int nxt_unit_process_msg(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf,
@@ -69,6 +74,10 @@ static int nxt_unit_process_req_headers(nxt_unit_ctx_t *ctx,
     nxt_unit_recv_msg_t *recv_msg, nxt_unit_request_info_t **preq);
 static int nxt_unit_process_req_body(nxt_unit_ctx_t *ctx,
     nxt_unit_recv_msg_t *recv_msg);
+static int nxt_unit_process_req_cancel(nxt_unit_ctx_t *ctx,
+    nxt_unit_recv_msg_t *recv_msg);
+static nxt_unit_request_info_t *nxt_unit_request_cancel(nxt_unit_ctx_t *ctx,
+    uint32_t stream);
 static int nxt_unit_request_check_response_port(nxt_unit_request_info_t *req,
     nxt_unit_port_id_t *port_id);
 static int nxt_unit_send_req_headers_ack(nxt_unit_request_info_t *req);
@@ -99,6 +108,10 @@ static nxt_unit_mmap_buf_t *nxt_unit_request_preread(
     nxt_unit_request_info_t *req, size_t size);
 static ssize_t nxt_unit_buf_read(nxt_unit_buf_t **b, uint64_t *len, void *dst,
     size_t size);
+static ssize_t nxt_unit_buf_write(nxt_unit_request_info_t *req, int fd,
+    size_t size);
+static ssize_t nxt_unit_fd_copy(nxt_unit_request_info_t *req, int fd,
+    size_t size);
 static nxt_port_mmap_header_t *nxt_unit_mmap_get(nxt_unit_ctx_t *ctx,
     nxt_unit_port_t *port, nxt_chunk_id_t *c, int *n, int min_n);
 static int nxt_unit_send_oosm(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port);
@@ -136,6 +149,9 @@ static nxt_unit_process_t *nxt_unit_process_find(nxt_unit_impl_t *lib,
 static nxt_unit_process_t *nxt_unit_process_pop_first(nxt_unit_impl_t *lib);
 static int nxt_unit_run_once_impl(nxt_unit_ctx_t *ctx);
 static int nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf);
+static void nxt_unit_busy_poll_adjust(nxt_unit_ctx_impl_t *ctx_impl,
+    uint32_t max, uint64_t idle);
+nxt_inline uint64_t nxt_unit_usec(void);
 static int nxt_unit_chk_ready(nxt_unit_ctx_t *ctx);
 static int nxt_unit_process_pending_rbuf(nxt_unit_ctx_t *ctx);
 static void nxt_unit_process_ready_req(nxt_unit_ctx_t *ctx);
@@ -181,6 +197,8 @@ static int nxt_unit_port_recv(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
     nxt_unit_read_buf_t *rbuf);
 static int nxt_unit_port_queue_recv(nxt_unit_port_t *port,
     nxt_unit_read_buf_t *rbuf);
+static void nxt_unit_port_queue_awake(nxt_unit_port_t *port);
+static int nxt_unit_port_queue_sleep(nxt_unit_port_t *port);
 static int nxt_unit_app_queue_recv(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
     nxt_unit_read_buf_t *rbuf);
 nxt_inline int nxt_unit_close(int fd);
@@ -254,6 +272,10 @@ struct nxt_unit_request_info_impl_s {
     nxt_unit_req_state_t     state;
     uint8_t                  websocket;
     uint8_t                  in_hash;
+    uint8_t                  cancelled;
+
+    /* The time of the last read of the port for cancellations, usec. */
+    uint64_t                 cancel_check;
 
     /*  for nxt_unit_ctx_impl_t.free_req or active_req */
     nxt_queue_link_t         link;
@@ -323,6 +345,9 @@ struct nxt_unit_ctx_impl_s {
     uint8_t                       ready;        /* 1 bit */
     uint8_t                       quit_param;
 
+    /* Current queue polling time before sleep, usec. */
+    uint32_t                      busy_poll;
+
     nxt_unit_mmap_buf_t           ctx_buf[2];
     nxt_unit_read_buf_t           ctx_read_buf;
 
@@ -358,6 +383,8 @@ struct nxt_unit_impl_s {
     uint32_t                 request_data_size;
     uint32_t                 shm_mmap_limit;
     uint32_t                 request_limit;
+    uint32_t                 busy_poll;
+    uint8_t                  shm_huge_pages;  /* 1 bit */
 
     pthread_mutex_t          mutex;
 
@@ -397,6 +424,8 @@ struct nxt_unit_port_impl_s {
 
     int                      from_socket;
     nxt_unit_read_buf_t      *socket_rbuf;
+
+    int                      awake;
 };
 
 
@@ -422,13 +451,17 @@ typedef struct {
 
 static pid_t  nxt_unit_pid;
 
+/* Usable data size of shared memory segments created by the process. */
+static uint32_t  nxt_unit_shm_size = PORT_MMAP_DATA_SIZE;
+
 
 nxt_unit_ctx_t *
 nxt_unit_init(nxt_unit_init_t *init)
 {
-    int              rc, queue_fd, shared_queue_fd;
+    int              rc, queue_fd, shared_queue_fd, shm_huge_pages;
     void             *mem;
-    uint32_t         ready_stream, shm_limit, request_limit;
+    uint32_t         ready_stream, shm_limit, request_limit, shm_segment;
+    uint32_t         busy_poll;
     nxt_unit_ctx_t   *ctx;
     nxt_unit_impl_t  *lib;
     nxt_unit_port_t  ready_port, router_port, read_port, shared_port;
@@ -469,14 +502,19 @@ nxt_unit_init(nxt_unit_init_t *init)
         rc = nxt_unit_read_env(&ready_port, &router_port, &read_port,
                                &shared_port.in_fd, &shared_queue_fd,
                                &lib->log_fd, &ready_stream, &shm_limit,
-                               &request_limit);
+                               &request_limit, &shm_segment, &shm_huge_pages,
+                               &busy_poll);
         if (nxt_slow_path(rc != NXT_UNIT_OK)) {
             goto fail;
         }
 
-        lib->shm_mmap_limit = (shm_limit + PORT_MMAP_DATA_SIZE - 1)
-                                / PORT_MMAP_DATA_SIZE;
+        nxt_unit_shm_size = nxt_unit_shm_segment_size(shm_segment);
+
+        lib->shm_mmap_limit = (shm_limit + nxt_unit_shm_size - 1)
+                                / nxt_unit_shm_size;
+        lib->shm_huge_pages = (shm_huge_pages != 0);
         lib->request_limit = request_limit;
+        lib->busy_poll = busy_poll;
     }
 
     if (nxt_slow_path(lib->shm_mmap_limit < 1)) {
@@ -613,9 +651,13 @@ nxt_unit_create(nxt_unit_init_t *init)
     lib->callbacks = init->callbacks;
 
     lib->request_data_size = init->request_data_size;
-    lib->shm_mmap_limit = (init->shm_limit + PORT_MMAP_DATA_SIZE - 1)
-                            / PORT_MMAP_DATA_SIZE;
+    nxt_unit_shm_size = nxt_unit_shm_segment_size(init->shm_segment);
+
+    lib->shm_mmap_limit = (init->shm_limit + nxt_unit_shm_size - 1)
+                            / nxt_unit_shm_size;
+    lib->shm_huge_pages = (init->shm_huge_pages != 0);
     lib->request_limit = init->request_limit;
+    lib->busy_poll = init->busy_poll;
 
     lib->processes.slot = NULL;
     lib->ports.slot = NULL;
@@ -695,6 +737,7 @@ nxt_unit_ctx_init(nxt_unit_impl_t *lib, nxt_unit_ctx_impl_t *ctx_impl,
     ctx_impl->online = 1;
     ctx_impl->ready = 0;
     ctx_impl->quit_param = NXT_QUIT_GRACEFUL;
+    ctx_impl->busy_poll = 0;
 
     nxt_queue_init(&ctx_impl->free_req);
     nxt_queue_init(&ctx_impl->free_ws);
@@ -844,7 +887,8 @@ static int
 nxt_unit_read_env(nxt_unit_port_t *ready_port, nxt_unit_port_t *router_port,
     nxt_unit_port_t *read_port, int *shared_port_fd, int *shared_queue_fd,
     int *log_fd, uint32_t *stream,
-    uint32_t *shm_limit, uint32_t *request_limit)
+    uint32_t *shm_limit, uint32_t *request_limit,
+    uint32_t *shm_segment, int *shm_huge_pages, uint32_t *busy_poll)
 {
     int       rc;
     int       ready_fd, router_fd, read_in_fd, read_out_fd;
@@ -890,13 +934,14 @@ nxt_unit_read_env(nxt_unit_port_t *ready_port, nxt_unit_port_t *router_port,
                 "%"PRId64",%"PRIu32",%d;"
                 "%"PRId64",%"PRIu32",%d,%d;"
                 "%d,%d;"
-                "%d,%"PRIu32",%"PRIu32,
+                "%d,%"PRIu32",%"PRIu32",%"PRIu32",%d,%"PRIu32,
                 &ready_stream,
                 &ready_pid, &ready_id, &ready_fd,
                 &router_pid, &router_id, &router_fd,
                 &read_pid, &read_id, &read_in_fd, &read_out_fd,
                 shared_port_fd, shared_queue_fd,
-                log_fd, shm_limit, request_limit);
+                log_fd, shm_limit, request_limit, shm_segment, shm_huge_pages,
+                busy_poll);
 
     if (nxt_slow_path(rc == EOF)) {
         nxt_unit_alert(NULL, "sscanf(%s) failed: %s (%d) for %s env",
@@ -905,9 +950,9 @@ nxt_unit_read_env(nxt_unit_port_t *ready_port, nxt_unit_port_t *router_port,
         return NXT_UNIT_ERROR;
     }
 
-    if (nxt_slow_path(rc != 16)) {
+    if (nxt_slow_path(rc != 19)) {
         nxt_unit_alert(NULL, "invalid number of variables in %s env: "
-                       "found %d of %d in %s", NXT_UNIT_INIT_ENV, rc, 16, vars);
+                       "found %d of %d in %s", NXT_UNIT_INIT_ENV, rc, 19, vars);
 
         return NXT_UNIT_ERROR;
     }
@@ -1117,6 +1162,10 @@ nxt_unit_process_msg(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf,
         rc = nxt_unit_process_req_body(ctx, &recv_msg);
         break;
 
+    case _NXT_PORT_MSG_REQ_CANCEL:
+        rc = nxt_unit_process_req_cancel(ctx, &recv_msg);
+        break;
+
     case _NXT_PORT_MSG_WEBSOCKET:
         rc = nxt_unit_process_websocket(ctx, &recv_msg);
         break;
@@ -1352,6 +1401,8 @@ nxt_unit_process_req_headers(nxt_unit_ctx_t *ctx, nxt_unit_recv_msg_t *recv_msg,
     req_impl->state = NXT_UNIT_RS_START;
     req_impl->websocket = 0;
     req_impl->in_hash = 0;
+    req_impl->cancelled = 0;
+    req_impl->cancel_check = nxt_unit_usec();
 
     nxt_unit_debug(ctx, "#%"PRIu32": %.*s %.*s (%d)", recv_msg->stream,
                    (int) r->method_length,
@@ -1360,6 +1411,9 @@ nxt_unit_process_req_headers(nxt_unit_ctx_t *ctx, nxt_unit_recv_msg_t *recv_msg,
                    (char *) nxt_unit_sptr_get(&r->target),
                    (int) r->content_length);
 
+    nxt_probe4(unit_request_receive, req, recv_msg->stream,
+               nxt_unit_sptr_get(&r->target), r->target_length);
+
     nxt_unit_port_id_init(&port_id, recv_msg->pid, recv_msg->reply_port);
 
     res = nxt_unit_request_check_response_port(req, &port_id);
@@ -1463,6 +1517,72 @@ nxt_unit_process_req_body(nxt_unit_ctx_t *ctx, nxt_unit_recv_msg_t *recv_msg)
 }
 
 
+static int
+nxt_unit_process_req_cancel(nxt_unit_ctx_t *ctx, nxt_unit_recv_msg_t *recv_msg)
+{
+    nxt_unit_impl_t               *lib;
+    nxt_unit_request_info_t       *req;
+    nxt_unit_request_info_impl_t  *req_impl;
+
+    req = nxt_unit_request_cancel(ctx, recv_msg->stream);
+    if (req == NULL) {
+        return NXT_UNIT_OK;
+    }
+
+    lib = nxt_container_of(ctx->unit, nxt_unit_impl_t, unit);
+    req_impl = nxt_container_of(req, nxt_unit_request_info_impl_t, req);
+
+    if (req_impl->in_hash && lib->callbacks.data_handler == NULL) {
+        /* The body is incomplete, so the request has not been handled yet. */
+        nxt_unit_request_done(req, NXT_UNIT_ERROR);
+
+        return NXT_UNIT_OK;
+    }
+
+    if (lib->callbacks.cancel_handler != NULL) {
+        nxt_unit_req_debug(req, "cancel_handler");
+
+        lib->callbacks.cancel_handler(req);
+    }
+
+    return NXT_UNIT_OK;
+}
+
+
+static nxt_unit_request_info_t *
+nxt_unit_request_cancel(nxt_unit_ctx_t *ctx, uint32_t stream)
+{
+    nxt_unit_ctx_impl_t           *ctx_impl;
+    nxt_unit_request_info_t       *req;
+    nxt_unit_request_info_impl_t  *req_impl;
+
+    ctx_impl = nxt_container_of(ctx, nxt_unit_ctx_impl_t, ctx);
+
+    req = NULL;
+
+    pthread_mutex_lock(&ctx_impl->mutex);
+
+    nxt_queue_each(req_impl, &ctx_impl->active_req,
+                   nxt_unit_request_info_impl_t, link)
+    {
+        if (req_impl->stream == stream && !req_impl->cancelled) {
+            req_impl->cancelled = 1;
+            req = &req_impl->req;
+            break;
+        }
+
+    } nxt_queue_loop;
+
+    pthread_mutex_unlock(&ctx_impl->mutex);
+
+    if (req != NULL) {
+        nxt_unit_req_debug(req, "cancelled");
+    }
+
+    return req;
+}
+
+
 static int
 nxt_unit_request_check_response_port(nxt_unit_request_info_t *req,
     nxt_unit_port_id_t *port_id)
@@ -1562,6 +1682,7 @@ nxt_unit_request_check_response_port(nxt_unit_request_info_t *req,
     port_impl->queue = NULL;
     port_impl->from_socket = 0;
     port_impl->socket_rbuf = NULL;
+    port_impl->awake = 0;
 
     nxt_queue_init(&port_impl->awaiting_req);
 
@@ -2373,6 +2494,9 @@ nxt_unit_response_send(nxt_unit_request_info_t *req)
                        (int) (req->response_buf->free
                               - req->response_buf->start));
 
+    nxt_probe3(unit_response_send, req, req_impl->stream,
+               req->response->status);
+
     mmap_buf = nxt_container_of(req->response_buf, nxt_unit_mmap_buf_t, buf);
 
     rc = nxt_unit_mmap_buf_send(req, mmap_buf, 0);
@@ -2406,7 +2530,7 @@ nxt_unit_response_buf_alloc(nxt_unit_request_info_t *req, uint32_t size)
     nxt_unit_mmap_buf_t           *mmap_buf;
     nxt_unit_request_info_impl_t  *req_impl;
 
-    if (nxt_slow_path(size > PORT_MMAP_DATA_SIZE)) {
+    if (nxt_slow_path(size > nxt_unit_shm_size)) {
         nxt_unit_req_warn(req, "response_buf_alloc: "
                           "requested buffer (%"PRIu32") too big", size);
 
@@ -2856,10 +2980,26 @@ nxt_unit_buf_next(nxt_unit_buf_t *buf)
 }
 
 
+/*
+ * Rounds the configured segment size up to whole chunks, zero stands
+ * for the default maximum size.
+ */
+
+static uint32_t
+nxt_unit_shm_segment_size(uint32_t size)
+{
+    if (size == 0 || size > PORT_MMAP_DATA_SIZE) {
+        return PORT_MMAP_DATA_SIZE;
+    }
+
+    return (size + PORT_MMAP_CHUNK_SIZE - 1) & ~(PORT_MMAP_CHUNK_SIZE - 1);
+}
+
+
 uint32_t
 nxt_unit_buf_max(void)
 {
-    return PORT_MMAP_DATA_SIZE;
+    return nxt_unit_shm_size;
 }
 
 
@@ -2930,7 +3070,7 @@ nxt_unit_response_write_nb(nxt_unit_request_info_t *req, const void *start,
     }
 
     while (size > 0) {
-        part_size = nxt_min(size, PORT_MMAP_DATA_SIZE);
+        part_size = nxt_min(size, nxt_unit_shm_size);
         min_part_size = nxt_min(min_size, part_size);
         min_part_size = nxt_min(min_part_size, PORT_MMAP_CHUNK_SIZE);
 
@@ -3031,7 +3171,7 @@ nxt_unit_response_write_cb(nxt_unit_request_info_t *req,
         nxt_unit_req_debug(req, "write_cb, alloc %"PRIu32"",
                            read_info->buf_size);
 
-        buf_size = nxt_min(read_info->buf_size, PORT_MMAP_DATA_SIZE);
+        buf_size = nxt_min(read_info->buf_size, nxt_unit_shm_size);
 
         rc = nxt_unit_get_outgoing_buf(req->ctx, req->response_port,
                                        buf_size, buf_size,
@@ -3154,6 +3294,261 @@ nxt_unit_request_readline_size(nxt_unit_request_info_t *req, size_t max_size)
 }
 
 
+int
+nxt_unit_request_content_map(nxt_unit_request_info_t *req, const void **start,
+    size_t *size)
+{
+    long         pagesize;
+    off_t        offset, aligned;
+    void         *p;
+    struct stat  sb;
+
+    if (nxt_slow_path(req->content_fd == -1)) {
+        nxt_unit_req_warn(req, "request body is not in a file");
+
+        return NXT_UNIT_ERROR;
+    }
+
+    if (req->content_length == 0) {
+        *start = NULL;
+        *size = 0;
+
+        return NXT_UNIT_OK;
+    }
+
+    if (nxt_slow_path(fstat(req->content_fd, &sb) == -1)) {
+        nxt_unit_req_alert(req, "fstat(%d) failed: %s (%d)",
+                           req->content_fd, strerror(errno), errno);
+
+        return NXT_UNIT_ERROR;
+    }
+
+    /*
+     * The file holds the whole body, and the unread rest is at its end
+     * regardless of what nxt_unit_request_readline_size() has preread.
+     */
+
+    offset = sb.st_size - req->content_length;
+
+    if (nxt_slow_path(offset < 0)) {
+        nxt_unit_req_alert(req, "content file is truncated");
+
+        return NXT_UNIT_ERROR;
+    }
+
+    pagesize = sysconf(_SC_PAGESIZE);
+    aligned = offset & ~((off_t) pagesize - 1);
+
+    p = mmap(NULL, offset - aligned + req->content_length, PROT_READ,
+             MAP_SHARED, req->content_fd, aligned);
+    if (nxt_slow_path(p == MAP_FAILED)) {
+        nxt_unit_req_alert(req, "mmap(%d) failed: %s (%d)",
+                           req->content_fd, strerror(errno), errno);
+
+        return NXT_UNIT_ERROR;
+    }
+
+    *start = nxt_pointer_to(p, offset - aligned);
+    *size = req->content_length;
+
+    return NXT_UNIT_OK;
+}
+
+
+void
+nxt_unit_request_content_unmap(const void *start, size_t size)
+{
+    long       pagesize;
+    uintptr_t  p, aligned;
+
+    if (start == NULL) {
+        return;
+    }
+
+    pagesize = sysconf(_SC_PAGESIZE);
+
+    p = (uintptr_t) start;
+    aligned = p & ~((uintptr_t) pagesize - 1);
+
+    munmap((void *) aligned, p - aligned + size);
+}
+
+
+ssize_t
+nxt_unit_request_content_copy(nxt_unit_request_info_t *req, int fd,
+    size_t size)
+{
+    ssize_t  buf_res, res;
+
+    size = nxt_min(size, req->content_length);
+
+    buf_res = nxt_unit_buf_write(req, fd, size);
+    if (nxt_slow_path(buf_res < 0)) {
+        return buf_res;
+    }
+
+    if (buf_res < (ssize_t) size && req->content_fd != -1) {
+        res = nxt_unit_fd_copy(req, fd, size - buf_res);
+        if (nxt_slow_path(res < 0)) {
+            return res;
+        }
+
+    } else {
+        res = 0;
+    }
+
+    return buf_res + res;
+}
+
+
+static ssize_t
+nxt_unit_buf_write(nxt_unit_request_info_t *req, int fd, size_t size)
+{
+    size_t          rest, copy;
+    ssize_t         n;
+    nxt_unit_buf_t  *buf, *next;
+
+    rest = size;
+    buf = req->content_buf;
+
+    while (buf != NULL && rest != 0) {
+        copy = nxt_min(rest, (size_t) (buf->end - buf->free));
+
+        while (copy != 0) {
+            n = write(fd, buf->free, copy);
+            if (nxt_slow_path(n == -1)) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                nxt_unit_req_alert(req, "write(%d) failed: %s (%d)",
+                                   fd, strerror(errno), errno);
+
+                req->content_buf = buf;
+
+                return -1;
+            }
+
+            buf->free += n;
+            copy -= n;
+            rest -= n;
+            req->content_length -= n;
+        }
+
+        next = nxt_unit_buf_next(buf);
+        if (next == NULL) {
+            break;
+        }
+
+        buf = next;
+    }
+
+    req->content_buf = buf;
+
+    return size - rest;
+}
+
+
+/*
+ * The body file offset is shared by all methods, so a method that fails
+ * midway leaves the rest to the next one: copy_file_range() needs both
+ * files on the same file system with older kernels, sendfile() refuses
+ * descriptors opened with O_APPEND, and read()/write() always works.
+ */
+
+static ssize_t
+nxt_unit_fd_copy(nxt_unit_request_info_t *req, int fd, size_t size)
+{
+    char     buf[16384];
+    size_t   rest;
+    ssize_t  n, w, written;
+
+    rest = size;
+    n = -1;
+
+#if (NXT_HAVE_COPY_FILE_RANGE)
+
+    while (rest != 0) {
+        n = copy_file_range(req->content_fd, NULL, fd, NULL, rest, 0);
+        if (n <= 0) {
+            break;
+        }
+
+        rest -= n;
+    }
+
+#endif
+
+#if (NXT_HAVE_LINUX_SENDFILE)
+
+    if (n == -1) {
+        while (rest != 0) {
+            n = sendfile(fd, req->content_fd, NULL, rest);
+            if (n <= 0) {
+                break;
+            }
+
+            rest -= n;
+        }
+    }
+
+#endif
+
+    if (n == -1) {
+        while (rest != 0) {
+            n = read(req->content_fd, buf, nxt_min(rest, sizeof(buf)));
+            if (n <= 0) {
+                if (n == -1 && errno == EINTR) {
+                    continue;
+                }
+
+                break;
+            }
+
+            for (written = 0; written < n; written += w) {
+                w = write(fd, buf + written, n - written);
+                if (nxt_slow_path(w == -1)) {
+                    if (errno == EINTR) {
+                        w = 0;
+                        continue;
+                    }
+
+                    nxt_unit_req_alert(req, "write(%d) failed: %s (%d)",
+                                       fd, strerror(errno), errno);
+
+                    goto fail;
+                }
+            }
+
+            rest -= n;
+        }
+
+        if (nxt_slow_path(n == -1)) {
+            nxt_unit_req_alert(req, "read(%d) failed: %s (%d)",
+                               req->content_fd, strerror(errno), errno);
+
+            goto fail;
+        }
+    }
+
+    if (rest != 0) {
+        nxt_unit_close(req->content_fd);
+
+        req->content_fd = -1;
+    }
+
+    req->content_length -= size - rest;
+
+    return size - rest;
+
+fail:
+
+    req->content_length -= size - rest;
+
+    return -1;
+}
+
+
 static nxt_unit_mmap_buf_t *
 nxt_unit_request_preread(nxt_unit_request_info_t *req, size_t size)
 {
@@ -3266,6 +3661,8 @@ nxt_unit_request_done(nxt_unit_request_info_t *req, int rc)
 
     nxt_unit_req_debug(req, "done: %d", rc);
 
+    nxt_probe3(unit_request_done, req, req_impl->stream, rc);
+
     if (nxt_slow_path(rc != NXT_UNIT_OK)) {
         goto skip_response_send;
     }
@@ -3317,6 +3714,105 @@ nxt_unit_request_done(nxt_unit_request_info_t *req, int rc)
 }
 
 
+/*
+ * A request handler that does not return to the event loop sees the
+ * cancellation only if it reads its port; as in nxt_unit_wait_shm_ack(),
+ * other messages are left for the event loop.  The port is read at most
+ * once per NXT_UNIT_CANCEL_CHECK_INTERVAL, so the function is cheap enough
+ * to be called on each response write; otherwise only the flag is checked.
+ */
+
+int
+nxt_unit_request_is_cancelled(nxt_unit_request_info_t *req)
+{
+    int                           res;
+    uint32_t                      stream;
+    uint64_t                      now;
+    nxt_port_msg_t                *port_msg;
+    nxt_unit_impl_t               *lib;
+    nxt_unit_ctx_impl_t           *ctx_impl;
+    struct pollfd                 pfd;
+    nxt_unit_read_buf_t           *rbuf;
+    nxt_unit_port_impl_t          *port_impl;
+    nxt_unit_request_info_impl_t  *req_impl;
+
+    req_impl = nxt_container_of(req, nxt_unit_request_info_impl_t, req);
+    ctx_impl = nxt_container_of(req->ctx, nxt_unit_ctx_impl_t, ctx);
+    lib = nxt_container_of(req->unit, nxt_unit_impl_t, unit);
+
+    if (req_impl->cancelled
+        || lib->callbacks.port_recv != NULL
+        || ctx_impl->read_port == NULL)
+    {
+        return req_impl->cancelled;
+    }
+
+    now = nxt_unit_usec();
+
+    if (now - req_impl->cancel_check < NXT_UNIT_CANCEL_CHECK_INTERVAL) {
+        return 0;
+    }
+
+    req_impl->cancel_check = now;
+
+    port_impl = nxt_container_of(ctx_impl->read_port, nxt_unit_port_impl_t,
+                                 port);
+
+    for ( ;; ) {
+        /* The port socket is blocking, so look before reading it. */
+
+        if (port_impl->from_socket == 0
+            && nxt_port_queue_is_empty(port_impl->queue))
+        {
+            pfd.fd = ctx_impl->read_port->in_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+
+            if (poll(&pfd, 1, 0) <= 0) {
+                break;
+            }
+        }
+
+        rbuf = nxt_unit_read_buf_get(req->ctx);
+        if (nxt_slow_path(rbuf == NULL)) {
+            break;
+        }
+
+        res = nxt_unit_ctx_port_recv(req->ctx, ctx_impl->read_port, rbuf);
+        if (res != NXT_UNIT_OK) {
+            nxt_unit_read_buf_release(req->ctx, rbuf);
+            break;
+        }
+
+        if (rbuf->size == (ssize_t) sizeof(nxt_port_msg_t)) {
+            port_msg = (nxt_port_msg_t *) rbuf->buf;
+
+            if (port_msg->type == _NXT_PORT_MSG_REQ_CANCEL) {
+                stream = port_msg->stream;
+
+                nxt_unit_read_buf_release(req->ctx, rbuf);
+
+                (void) nxt_unit_request_cancel(req->ctx, stream);
+
+                continue;
+            }
+        }
+
+        pthread_mutex_lock(&ctx_impl->mutex);
+
+        nxt_queue_insert_tail(&ctx_impl->pending_rbuf, &rbuf->link);
+
+        pthread_mutex_unlock(&ctx_impl->mutex);
+
+        if (nxt_unit_is_quit(rbuf)) {
+            break;
+        }
+    }
+
+    return req_impl->cancelled;
+}
+
+
 int
 nxt_unit_websocket_send(nxt_unit_request_info_t *req, uint8_t opcode,
     uint8_t last, const void *start, size_t size)
@@ -3347,7 +3843,7 @@ nxt_unit_websocket_sendv(nxt_unit_request_info_t *req, uint8_t opcode,
     }
 
     buf_size = 10 + payload_len;
-    alloc_size = nxt_min(buf_size, PORT_MMAP_DATA_SIZE);
+    alloc_size = nxt_min(buf_size, nxt_unit_shm_size);
 
     rc = nxt_unit_get_outgoing_buf(req->ctx, req->response_port,
                                    alloc_size, alloc_size,
@@ -3390,7 +3886,7 @@ nxt_unit_websocket_sendv(nxt_unit_request_info_t *req, uint8_t opcode,
                     }
                 }
 
-                alloc_size = nxt_min(buf_size, PORT_MMAP_DATA_SIZE);
+                alloc_size = nxt_min(buf_size, nxt_unit_shm_size);
 
                 rc = nxt_unit_get_outgoing_buf(req->ctx, req->response_port,
                                                alloc_size, alloc_size,
@@ -3565,7 +4061,8 @@ nxt_unit_mmap_get(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
         }
 
         if (nxt_slow_path(lib->outgoing.allocated_chunks + min_n
-                          >= lib->shm_mmap_limit * PORT_MMAP_CHUNK_COUNT))
+                          >= lib->shm_mmap_limit
+                             * (nxt_unit_shm_size / PORT_MMAP_CHUNK_SIZE)))
         {
             /* Memory allocated by application, but not send to router. */
             return NULL;
@@ -3573,6 +4070,8 @@ nxt_unit_mmap_get(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
 
         /* Notify router about OOSM condition. */
 
+        nxt_probe2(unit_shm_oosm, lib->pid, outgoing_size);
+
         res = nxt_unit_send_oosm(ctx, port);
         if (nxt_slow_path(res != NXT_UNIT_OK)) {
             return NULL;
@@ -3601,8 +4100,12 @@ nxt_unit_mmap_get(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
     *c = 0;
     hdr = nxt_unit_new_mmap(ctx, port, *n);
 
+    nxt_probe2(unit_shm_segment, lib->outgoing.size, *n);
+
 unlock:
 
+    nxt_probe3(unit_shm_alloc, hdr, *c, *n);
+
     nxt_atomic_fetch_add(&lib->outgoing.allocated_chunks, *n);
 
     nxt_unit_debug(ctx, "allocated_chunks %d",
@@ -3774,6 +4277,17 @@ nxt_unit_new_mmap(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port, int n)
         goto remove_fail;
     }
 
+#if (NXT_HAVE_MADV_HUGEPAGE)
+
+    if (lib->shm_huge_pages
+        && madvise(mem, PORT_MMAP_SIZE, MADV_HUGEPAGE) != 0)
+    {
+        nxt_unit_warn(ctx, "madvise(MADV_HUGEPAGE) failed: %s (%d)",
+                      strerror(errno), errno);
+    }
+
+#endif
+
     mm->hdr = mem;
     hdr = mem;
 
@@ -3791,9 +4305,17 @@ nxt_unit_new_mmap(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port, int n)
         nxt_port_mmap_set_chunk_busy(hdr->free_map, i);
     }
 
-    /* Mark as busy chunk followed the last available chunk. */
-    nxt_port_mmap_set_chunk_busy(hdr->free_map, PORT_MMAP_CHUNK_COUNT);
-    nxt_port_mmap_set_chunk_busy(hdr->free_tracking_map, PORT_MMAP_CHUNK_COUNT);
+    /*
+     * Mark as busy chunks followed the last available chunk, the pages
+     * of a smaller segment beyond its chunks are never touched.
+     */
+    for (i = nxt_unit_shm_size / PORT_MMAP_CHUNK_SIZE;
+         i <= PORT_MMAP_CHUNK_COUNT;
+         i++)
+    {
+        nxt_port_mmap_set_chunk_busy(hdr->free_map, i);
+        nxt_port_mmap_set_chunk_busy(hdr->free_tracking_map, i);
+    }
 
     pthread_mutex_unlock(&lib->outgoing.mutex);
 
@@ -4543,6 +5065,8 @@ nxt_unit_run(nxt_unit_ctx_t *ctx)
     rc = NXT_UNIT_OK;
 
     while (nxt_fast_path(ctx_impl->online)) {
+        nxt_unit_port_queue_awake(ctx_impl->read_port);
+
         rc = nxt_unit_run_once_impl(ctx);
 
         if (nxt_slow_path(rc == NXT_UNIT_ERROR)) {
@@ -4551,6 +5075,8 @@ nxt_unit_run(nxt_unit_ctx_t *ctx)
         }
     }
 
+    (void) nxt_unit_port_queue_sleep(ctx_impl->read_port);
+
     nxt_unit_ctx_release(ctx);
 
     return rc;
@@ -4610,6 +5136,7 @@ static int
 nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf)
 {
     int                   nevents, res, err;
+    uint64_t              now, idle;
     nxt_uint_t            nfds;
     nxt_unit_impl_t       *lib;
     nxt_unit_ctx_impl_t   *ctx_impl;
@@ -4627,6 +5154,8 @@ nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf)
 
     lib = nxt_container_of(ctx->unit, nxt_unit_impl_t, unit);
 
+    idle = 0;
+
 retry:
 
     if (port_impl->from_socket == 0) {
@@ -4666,6 +5195,23 @@ nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf)
         nfds = 1;
     }
 
+    if (lib->busy_poll != 0 && port_impl->from_socket == 0) {
+        now = nxt_unit_usec();
+
+        if (idle == 0) {
+            idle = now;
+        }
+
+        if (now - idle < ctx_impl->busy_poll) {
+            nxt_cpu_pause();
+            goto retry;
+        }
+    }
+
+    if (nxt_unit_port_queue_sleep(ctx_impl->read_port) != NXT_UNIT_OK) {
+        goto retry;
+    }
+
     fds[0].fd = ctx_impl->read_port->in_fd;
     fds[0].events = POLLIN;
     fds[0].revents = 0;
@@ -4688,6 +5234,11 @@ nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf)
         return (err == EAGAIN) ? NXT_UNIT_AGAIN : NXT_UNIT_ERROR;
     }
 
+    if (idle != 0) {
+        nxt_unit_busy_poll_adjust(ctx_impl, lib->busy_poll,
+                                  nxt_unit_usec() - idle);
+    }
+
     nxt_unit_debug(ctx, "poll(%d,%d): %d, revents [%04X, %04X]",
                    fds[0].fd, fds[1].fd, nevents, fds[0].revents,
                    fds[1].revents);
@@ -4718,6 +5269,40 @@ nxt_unit_read_buf(nxt_unit_ctx_t *ctx, nxt_unit_read_buf_t *rbuf)
 }
 
 
+/*
+ * The queues are polled before sleeping for a time that follows request
+ * arrivals: it grows up to the configured maximum while the context sleeps
+ * for less than the maximum, and shrinks when sleeps are longer, so a mostly
+ * idle context does not burn CPU.
+ */
+
+static void
+nxt_unit_busy_poll_adjust(nxt_unit_ctx_impl_t *ctx_impl, uint32_t max,
+    uint64_t idle)
+{
+    if (idle > max) {
+        ctx_impl->busy_poll /= 2;
+
+    } else if (ctx_impl->busy_poll == 0) {
+        ctx_impl->busy_poll = nxt_max(max / 8, 1);
+
+    } else {
+        ctx_impl->busy_poll = nxt_min(ctx_impl->busy_poll * 2, max);
+    }
+}
+
+
+nxt_inline uint64_t
+nxt_unit_usec(void)
+{
+    struct timespec  ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
 static int
 nxt_unit_chk_ready(nxt_unit_ctx_t *ctx)
 {
@@ -4867,6 +5452,8 @@ nxt_unit_run_ctx(nxt_unit_ctx_t *ctx)
             break;
         }
 
+        nxt_unit_port_queue_awake(ctx_impl->read_port);
+
     retry:
 
         rc = nxt_unit_ctx_port_recv(ctx, ctx_impl->read_port, rbuf);
@@ -4887,6 +5474,8 @@ nxt_unit_run_ctx(nxt_unit_ctx_t *ctx)
         nxt_unit_process_ready_req(ctx);
     }
 
+    (void) nxt_unit_port_queue_sleep(ctx_impl->read_port);
+
     nxt_unit_ctx_release(ctx);
 
     return rc;
@@ -5569,6 +6158,7 @@ nxt_unit_add_port(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port, void *queue)
     new_port->queue = queue;
     new_port->from_socket = 0;
     new_port->socket_rbuf = NULL;
+    new_port->awake = 0;
 
     nxt_queue_init(&new_port->awaiting_req);
 
@@ -6084,6 +6674,10 @@ nxt_unit_ctx_port_recv(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
         return NXT_UNIT_AGAIN;
     }
 
+    if (nxt_unit_port_queue_sleep(port) != NXT_UNIT_OK) {
+        goto retry;
+    }
+
     res = nxt_unit_port_recv(ctx, port, rbuf);
     if (nxt_slow_path(res == NXT_UNIT_ERROR)) {
         return NXT_UNIT_ERROR;
@@ -6264,6 +6858,65 @@ nxt_unit_port_queue_recv(nxt_unit_port_t *port, nxt_unit_read_buf_t *rbuf)
 }
 
 
+/*
+ * The router notifies the port socket only when the port queue becomes
+ * non-empty.  While the context is busy and is going to look into the queue
+ * anyway, an extra item counted in the queue suppresses these notifications
+ * as the router does for its own ports, saving a sendmsg() and a recvmsg().
+ * The item must be dropped before blocking on the port socket.
+ *
+ * Only the nxt_unit_run() and nxt_unit_run_ctx() loops keep the port
+ * awake: after nxt_unit_run_once() or nxt_unit_process_port_msg() the
+ * application may poll the port socket in its own event loop, so it must
+ * be notified of each new message.
+ */
+
+static void
+nxt_unit_port_queue_awake(nxt_unit_port_t *port)
+{
+    nxt_port_queue_t      *queue;
+    nxt_unit_port_impl_t  *port_impl;
+
+    port_impl = nxt_container_of(port, nxt_unit_port_impl_t, port);
+    queue = port_impl->queue;
+
+    if (port_impl->awake || queue == NULL) {
+        return;
+    }
+
+    nxt_atomic_fetch_add(&queue->nitems, 1);
+
+    port_impl->awake = 1;
+}
+
+
+static int
+nxt_unit_port_queue_sleep(nxt_unit_port_t *port)
+{
+    nxt_port_queue_t      *queue;
+    nxt_unit_port_impl_t  *port_impl;
+
+    port_impl = nxt_container_of(port, nxt_unit_port_impl_t, port);
+    queue = port_impl->queue;
+
+    if (!port_impl->awake) {
+        return NXT_UNIT_OK;
+    }
+
+    port_impl->awake = 0;
+
+    nxt_atomic_fetch_add(&queue->nitems, -1);
+
+    /* A message enqueued while awake has not been notified. */
+
+    if (port_impl->from_socket == 0 && !nxt_port_queue_is_empty(queue)) {
+        return NXT_UNIT_AGAIN;
+    }
+
+    return NXT_UNIT_OK;
+}
+
+
 static int
 nxt_unit_app_queue_recv(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port,
     nxt_unit_read_buf_t *rbuf)
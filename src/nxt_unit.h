@@ -158,6 +158,13 @@ struct nxt_unit_callbacks_s {
                  void *buf, size_t buf_size, void *oob, size_t *oob_size);
 
     int      (*ready_handler)(nxt_unit_ctx_t *);
+
+    /*
+     * Request cancelled: the client has gone away or the application
+     * timeout has expired, and the response will be discarded.  The
+     * application still has to complete the request.  Optional.
+     */
+    void     (*cancel_handler)(nxt_unit_request_info_t *req);
 };
 
 
@@ -169,6 +176,9 @@ struct nxt_unit_init_s {
     uint32_t              request_data_size;
     uint32_t              shm_limit;
     uint32_t              request_limit;
+    uint32_t              shm_segment;
+    int                   shm_huge_pages;
+    uint32_t              busy_poll; /* Max queue polling before sleep, usec. */
 
     nxt_unit_callbacks_t  callbacks;
 
@@ -316,8 +326,33 @@ ssize_t nxt_unit_request_read(nxt_unit_request_info_t *req, void *dst,
 ssize_t nxt_unit_request_readline_size(nxt_unit_request_info_t *req,
     size_t max_size);
 
+/*
+ * Map the unread rest of the request body spooled to a temporary file
+ * read-only into memory; the body must be in a file, that is, content_fd
+ * is not -1.  The mapping does not consume the body, may outlive the request,
+ * and must be released with nxt_unit_request_content_unmap().
+ */
+int nxt_unit_request_content_map(nxt_unit_request_info_t *req,
+    const void **start, size_t *size);
+
+void nxt_unit_request_content_unmap(const void *start, size_t size);
+
+/*
+ * Copy up to 'size' bytes of the request body to file descriptor 'fd',
+ * in kernel where possible.  Returns the number of bytes copied.
+ */
+ssize_t nxt_unit_request_content_copy(nxt_unit_request_info_t *req, int fd,
+    size_t size);
+
 void nxt_unit_request_done(nxt_unit_request_info_t *req, int rc);
 
+/*
+ * Check whether the request has been cancelled.  Meant for request handlers
+ * that block the event loop: pending messages are read from the context port
+ * and the rest of them are left to the event loop.
+ */
+int nxt_unit_request_is_cancelled(nxt_unit_request_info_t *req);
+
 
 int nxt_unit_websocket_send(nxt_unit_request_info_t *req, uint8_t opcode,
     uint8_t last, const void *start, size_t size);
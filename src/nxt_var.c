@@ -8,6 +8,7 @@
 
 struct nxt_var_s {
     size_t              length;
+    size_t              fixed;
     nxt_uint_t          vars;
     u_char              data[];
 
@@ -41,6 +42,13 @@ struct nxt_var_query_s {
 };
 
 
+/*
+ * Values of up to NXT_VAR_VALUES variables are collected on the stack,
+ * which covers the common access log formats, including the combined one.
+ */
+#define NXT_VAR_VALUES  16
+
+
 #define nxt_var_subs(var)  ((nxt_var_sub_t *) (var)->data)
 
 #define nxt_var_raw_start(var)                                                \
@@ -131,6 +139,7 @@ nxt_var_ref_get(nxt_tstr_state_t *state, nxt_str_t *name)
     }
 
     ref->index = state->var_refs->nelts - 1;
+    ref->uses = 0;
 
     ref->name = nxt_str_dup(state->pool, NULL, name);
     if (nxt_slow_path(ref->name == NULL)) {
@@ -343,6 +352,7 @@ nxt_var_compile(nxt_tstr_state_t *state, nxt_str_t *str)
     }
 
     var->length = str->length;
+    var->fixed = str->length;
     var->vars = n;
 
     subs = nxt_var_subs(var);
@@ -362,10 +372,14 @@ nxt_var_compile(nxt_tstr_state_t *state, nxt_str_t *str)
                 return NULL;
             }
 
+            ref->uses++;
+
             subs[n].index = ref->index;
             subs[n].length = next - p;
             subs[n].position = p - str->start;
 
+            var->fixed -= subs[n].length;
+
             n++;
         }
 
@@ -491,38 +505,62 @@ nxt_var_interpreter(nxt_task_t *task, nxt_tstr_state_t *state,
 {
     u_char         *p, *src;
     size_t         length, last, next;
-    nxt_str_t      *value, **part;
+    nxt_int_t      ret;
+    nxt_str_t      *value, *values, stack[NXT_VAR_VALUES];
     nxt_uint_t     i;
-    nxt_array_t    parts;
+    nxt_var_ref_t  *refs, *ref;
     nxt_var_sub_t  *subs;
 
-    nxt_memzero(&parts, sizeof(nxt_array_t));
-    nxt_array_init(&parts, cache->pool, sizeof(nxt_str_t *));
+    if (nxt_fast_path(var->vars <= NXT_VAR_VALUES)) {
+        values = stack;
+
+    } else {
+        values = nxt_mp_nget(cache->pool, var->vars * sizeof(nxt_str_t));
+        if (nxt_slow_path(values == NULL)) {
+            return NXT_ERROR;
+        }
+    }
 
+    refs = state->var_refs->elts;
     subs = nxt_var_subs(var);
 
-    length = var->length;
+    length = var->fixed;
 
     for (i = 0; i < var->vars; i++) {
-        value = nxt_var_cache_value(task, state, cache, subs[i].index, ctx);
-        if (nxt_slow_path(value == NULL)) {
-            return NXT_ERROR;
-        }
+        ref = &refs[subs[i].index];
 
-        part = nxt_array_add(&parts);
-        if (nxt_slow_path(part == NULL)) {
-            return NXT_ERROR;
-        }
+        if (ref->cacheable && ref->uses > 1) {
+            value = nxt_var_cache_value(task, state, cache, subs[i].index,
+                                        ctx);
+            if (nxt_slow_path(value == NULL)) {
+                return NXT_ERROR;
+            }
 
-        *part = value;
+            values[i] = *value;
 
-        length += value->length - subs[i].length;
+        } else {
+            /* The value cannot be requested again, no need to cache it. */
+
+            nxt_str_null(&values[i]);
 
-        if (logging && value->start == NULL) {
+            ret = ref->handler(task, &values[i], ctx, ref->data);
+            if (nxt_slow_path(ret != NXT_OK)) {
+                return NXT_ERROR;
+            }
+        }
+
+        length += values[i].length;
+
+        if (logging && values[i].start == NULL) {
             length += 1;
         }
     }
 
+    if (var->fixed == 0 && var->vars == 1 && values[0].start != NULL) {
+        *str = values[0];
+        return NXT_OK;
+    }
+
     p = nxt_mp_nget(cache->pool, length);
     if (nxt_slow_path(p == NULL)) {
         return NXT_ERROR;
@@ -531,7 +569,6 @@ nxt_var_interpreter(nxt_task_t *task, nxt_tstr_state_t *state,
     str->length = length;
     str->start = p;
 
-    part = parts.elts;
     src = nxt_var_raw_start(var);
 
     last = 0;
@@ -543,9 +580,10 @@ nxt_var_interpreter(nxt_task_t *task, nxt_tstr_state_t *state,
             p = nxt_cpymem(p, &src[last], next - last);
         }
 
-        p = nxt_cpymem(p, part[i]->start, part[i]->length);
+        if (values[i].start != NULL) {
+            p = nxt_cpymem(p, values[i].start, values[i].length);
 
-        if (logging && part[i]->start == NULL) {
+        } else if (logging) {
             *p++ = '-';
         }
 
@@ -553,7 +591,7 @@ nxt_var_interpreter(nxt_task_t *task, nxt_tstr_state_t *state,
     }
 
     if (last != var->length) {
-        p = nxt_cpymem(p, &src[last], var->length - last);
+        nxt_memcpy(p, &src[last], var->length - last);
     }
 
     return NXT_OK;
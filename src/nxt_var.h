@@ -29,6 +29,7 @@ typedef struct {
     nxt_var_handler_t       handler;
     void                    *data;
     uint32_t                index;
+    uint32_t                uses;
     uint8_t                 cacheable;  /* 1 bit */
 } nxt_var_ref_t;
 
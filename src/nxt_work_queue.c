@@ -309,3 +309,62 @@ nxt_locked_work_queue_move(nxt_thread_t *thr, nxt_locked_work_queue_t *lwq,
         work = work->next;
     }
 }
+
+
+/*
+ * Add a work to a lock-free work queue.  The function returns 1 if the queue
+ * was empty, so the consumer should be notified, or 0 if the consumer has
+ * been already notified by a previous producer and has not taken the works
+ * yet.  This allows to coalesce wakeups of the consumer.
+ */
+
+nxt_bool_t
+nxt_atomic_work_queue_add(nxt_atomic_work_queue_t *awq, nxt_work_t *work)
+{
+    nxt_work_t  *head;
+
+    do {
+        head = (nxt_work_t *) awq->head;
+        work->next = head;
+
+    } while (!nxt_atomic_cmp_set(&awq->head, (nxt_atomic_uint_t) head,
+                                 (nxt_atomic_uint_t) work));
+
+    return (head == NULL);
+}
+
+
+/* Move all works from a lock-free work queue to a usual work queue. */
+
+void
+nxt_atomic_work_queue_move(nxt_thread_t *thr, nxt_atomic_work_queue_t *awq,
+    nxt_work_queue_t *wq)
+{
+    nxt_work_t  *work, *next, *prev;
+
+    if (awq->head == 0) {
+        return;
+    }
+
+    work = (nxt_work_t *) nxt_atomic_xchg(&awq->head, 0);
+
+    /* Restore the order in which the works have been added. */
+
+    prev = NULL;
+
+    while (work != NULL) {
+        next = work->next;
+        work->next = prev;
+        prev = work;
+        work = next;
+    }
+
+    for (work = prev; work != NULL; work = next) {
+        next = work->next;
+
+        work->task->thread = thr;
+
+        nxt_work_queue_add(wq, work->handler, work->task,
+                           work->obj, work->data);
+    }
+}
@@ -28,6 +28,11 @@ static nxt_int_t nxt_python3_init_config(nxt_int_t pep405);
 
 static nxt_int_t nxt_python_start(nxt_task_t *task,
     nxt_process_data_t *data);
+static nxt_int_t nxt_python_preload(nxt_task_t *task,
+    nxt_process_data_t *data);
+static void nxt_python_before_fork(nxt_task_t *task);
+static void nxt_python_after_fork(nxt_task_t *task);
+static nxt_int_t nxt_python_init(nxt_task_t *task, nxt_process_data_t *data);
 static nxt_int_t nxt_python_set_target(nxt_task_t *task,
     nxt_python_target_t *target, nxt_conf_value_t *conf);
 nxt_inline nxt_int_t nxt_python_set_prefix(nxt_task_t *task,
@@ -54,6 +59,9 @@ NXT_EXPORT nxt_app_module_t  nxt_app_module = {
     nxt_nitems(nxt_python_mounts),
     NULL,
     nxt_python_start,
+    nxt_python_preload,
+    nxt_python_before_fork,
+    nxt_python_after_fork,
 };
 
 static PyObject           *nxt_py_stderr_flush;
@@ -68,6 +76,7 @@ static char               *nxt_py_home;
 static pthread_attr_t        *nxt_py_thread_attr;
 static nxt_py_thread_info_t  *nxt_py_threads;
 static nxt_python_proto_t    nxt_py_proto;
+static nxt_bool_t            nxt_py_preloaded;
 
 
 #if PY_VERSION_HEX >= NXT_PYTHON_VER(3, 8)
@@ -147,13 +156,179 @@ static nxt_int_t
 nxt_python_start(nxt_task_t *task, nxt_process_data_t *data)
 {
     int                    rc;
+    nxt_str_t              proto, probe_proto;
+    nxt_int_t              i;
+    nxt_unit_ctx_t         *unit_ctx;
+    nxt_unit_init_t        python_init;
+    nxt_python_targets_t   *targets;
+    nxt_common_app_conf_t  *app_conf;
+    nxt_python_app_conf_t  *c;
+
+    static const nxt_str_t  wsgi = nxt_string("wsgi");
+    static const nxt_str_t  asgi = nxt_string("asgi");
+
+    app_conf = data->app;
+    c = &app_conf->u.python;
+
+    python_init.ctx_data = NULL;
+
+    if (nxt_py_preloaded) {
+        /*
+         * The interpreter and the application were loaded by the prototype,
+         * reinitialize the interpreter state and run the "after_in_child"
+         * hooks registered with os.register_at_fork().
+         */
+
+#if PY_VERSION_HEX >= NXT_PYTHON_VER(3, 7)
+        PyOS_AfterFork_Child();
+#else
+        PyOS_AfterFork();
+#endif
+
+    } else if (nxt_python_init(task, data) != NXT_OK) {
+        goto fail;
+    }
+
+    targets = nxt_py_targets;
+
+    nxt_unit_default_init(task, &python_init, data->app);
+
+    python_init.data = c;
+    python_init.callbacks.ready_handler = nxt_python_ready_handler;
+
+    proto = c->protocol;
+
+    if (proto.length == 0) {
+        proto = nxt_python_asgi_check(targets->target[0].application)
+                ? asgi : wsgi;
+
+        for (i = 1; i < targets->count; i++) {
+            probe_proto = nxt_python_asgi_check(targets->target[i].application)
+                          ? asgi : wsgi;
+            if (probe_proto.start != proto.start) {
+                nxt_alert(task, "A mix of ASGI & WSGI targets is forbidden, "
+                                "specify protocol in config if incorrect");
+                goto fail;
+            }
+        }
+    }
+
+    if (nxt_strstr_eq(&proto, &asgi)) {
+        rc = nxt_python_asgi_init(&python_init, &nxt_py_proto);
+
+    } else {
+        rc = nxt_python_wsgi_init(&python_init, &nxt_py_proto);
+    }
+
+    if (nxt_slow_path(rc == NXT_UNIT_ERROR)) {
+        goto fail;
+    }
+
+    rc = nxt_py_proto.ctx_data_alloc(&python_init.ctx_data, 1);
+    if (nxt_slow_path(rc != NXT_UNIT_OK)) {
+        goto fail;
+    }
+
+    rc = nxt_python_init_threads(c);
+    if (nxt_slow_path(rc == NXT_UNIT_ERROR)) {
+        goto fail;
+    }
+
+    if (nxt_py_proto.startup != NULL) {
+        if (nxt_py_proto.startup(python_init.ctx_data) != NXT_UNIT_OK) {
+            goto fail;
+        }
+    }
+
+    unit_ctx = nxt_unit_init(&python_init);
+    if (nxt_slow_path(unit_ctx == NULL)) {
+        goto fail;
+    }
+
+    rc = nxt_py_proto.run(unit_ctx);
+
+    nxt_python_join_threads(unit_ctx, c);
+
+    nxt_unit_done(unit_ctx);
+
+    nxt_py_proto.ctx_data_free(python_init.ctx_data);
+
+    nxt_python_atexit();
+
+    exit(rc);
+
+    return NXT_OK;
+
+fail:
+
+    nxt_python_join_threads(NULL, c);
+
+    if (python_init.ctx_data != NULL) {
+        nxt_py_proto.ctx_data_free(python_init.ctx_data);
+    }
+
+    nxt_python_atexit();
+
+    return NXT_ERROR;
+}
+
+
+/*
+ * With the "preload" option the prototype process initializes
+ * the interpreter and imports the application targets once, and
+ * application processes inherit them copy-on-write.
+ */
+
+static nxt_int_t
+nxt_python_preload(nxt_task_t *task, nxt_process_data_t *data)
+{
+    if (nxt_python_init(task, data) != NXT_OK) {
+        nxt_python_atexit();
+        return NXT_ERROR;
+    }
+
+    nxt_py_preloaded = 1;
+
+    return NXT_OK;
+}
+
+
+/*
+ * The same hooks as os.fork() runs: the interpreter locks are acquired
+ * before fork() and released in the prototype after it, the child
+ * reinitializes them in nxt_python_start().
+ */
+
+static void
+nxt_python_before_fork(nxt_task_t *task)
+{
+#if PY_VERSION_HEX >= NXT_PYTHON_VER(3, 7)
+    if (nxt_py_preloaded) {
+        PyOS_BeforeFork();
+    }
+#endif
+}
+
+
+static void
+nxt_python_after_fork(nxt_task_t *task)
+{
+#if PY_VERSION_HEX >= NXT_PYTHON_VER(3, 7)
+    if (nxt_py_preloaded) {
+        PyOS_AfterFork_Parent();
+    }
+#endif
+}
+
+
+static nxt_int_t
+nxt_python_init(nxt_task_t *task, nxt_process_data_t *data)
+{
     size_t                 len, size;
     uint32_t               next;
     PyObject               *obj;
-    nxt_str_t              proto, probe_proto, name;
+    nxt_str_t              name;
     nxt_int_t              ret, n, i;
-    nxt_unit_ctx_t         *unit_ctx;
-    nxt_unit_init_t        python_init;
     nxt_conf_value_t       *cv;
     nxt_python_targets_t   *targets;
     nxt_common_app_conf_t  *app_conf;
@@ -166,9 +341,6 @@ nxt_python_start(nxt_task_t *task, nxt_process_data_t *data)
     static const char bin_python[] = "/bin/python";
 #endif
 
-    static const nxt_str_t  wsgi = nxt_string("wsgi");
-    static const nxt_str_t  asgi = nxt_string("asgi");
-
     app_conf = data->app;
     c = &app_conf->u.python;
 
@@ -237,10 +409,6 @@ nxt_python_start(nxt_task_t *task, nxt_process_data_t *data)
     }
 #endif
 
-    obj = NULL;
-
-    python_init.ctx_data = NULL;
-
     obj = PySys_GetObject((char *) "stderr");
     if (nxt_slow_path(obj == NULL)) {
         nxt_alert(task, "Python failed to get \"sys.stderr\" object");
@@ -312,86 +480,12 @@ nxt_python_start(nxt_task_t *task, nxt_process_data_t *data)
         }
     }
 
-    nxt_unit_default_init(task, &python_init, data->app);
-
-    python_init.data = c;
-    python_init.callbacks.ready_handler = nxt_python_ready_handler;
-
-    proto = c->protocol;
-
-    if (proto.length == 0) {
-        proto = nxt_python_asgi_check(targets->target[0].application)
-                ? asgi : wsgi;
-
-        for (i = 1; i < targets->count; i++) {
-            probe_proto = nxt_python_asgi_check(targets->target[i].application)
-                          ? asgi : wsgi;
-            if (probe_proto.start != proto.start) {
-                nxt_alert(task, "A mix of ASGI & WSGI targets is forbidden, "
-                                "specify protocol in config if incorrect");
-                goto fail;
-            }
-        }
-    }
-
-    if (nxt_strstr_eq(&proto, &asgi)) {
-        rc = nxt_python_asgi_init(&python_init, &nxt_py_proto);
-
-    } else {
-        rc = nxt_python_wsgi_init(&python_init, &nxt_py_proto);
-    }
-
-    if (nxt_slow_path(rc == NXT_UNIT_ERROR)) {
-        goto fail;
-    }
-
-    rc = nxt_py_proto.ctx_data_alloc(&python_init.ctx_data, 1);
-    if (nxt_slow_path(rc != NXT_UNIT_OK)) {
-        goto fail;
-    }
-
-    rc = nxt_python_init_threads(c);
-    if (nxt_slow_path(rc == NXT_UNIT_ERROR)) {
-        goto fail;
-    }
-
-    if (nxt_py_proto.startup != NULL) {
-        if (nxt_py_proto.startup(python_init.ctx_data) != NXT_UNIT_OK) {
-            goto fail;
-        }
-    }
-
-    unit_ctx = nxt_unit_init(&python_init);
-    if (nxt_slow_path(unit_ctx == NULL)) {
-        goto fail;
-    }
-
-    rc = nxt_py_proto.run(unit_ctx);
-
-    nxt_python_join_threads(unit_ctx, c);
-
-    nxt_unit_done(unit_ctx);
-
-    nxt_py_proto.ctx_data_free(python_init.ctx_data);
-
-    nxt_python_atexit();
-
-    exit(rc);
-
     return NXT_OK;
 
 fail:
 
-    nxt_python_join_threads(NULL, c);
-
-    if (python_init.ctx_data != NULL) {
-        nxt_py_proto.ctx_data_free(python_init.ctx_data);
-    }
-
     Py_XDECREF(obj);
 
-    nxt_python_atexit();
-
     return NXT_ERROR;
 }
 
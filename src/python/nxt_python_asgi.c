@@ -192,6 +192,7 @@ nxt_python_asgi_init(nxt_unit_init_t *init, nxt_python_proto_t *proto)
     init->callbacks.data_handler = nxt_py_asgi_http_data_handler;
     init->callbacks.websocket_handler = nxt_py_asgi_websocket_handler;
     init->callbacks.close_handler = nxt_py_asgi_close_handler;
+    init->callbacks.cancel_handler = nxt_py_asgi_close_handler;
     init->callbacks.quit = nxt_py_asgi_quit;
     init->callbacks.shm_ack_handler = nxt_py_asgi_shm_ack_handler;
     init->callbacks.add_port = nxt_py_asgi_add_port;
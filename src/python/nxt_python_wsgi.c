@@ -51,6 +51,14 @@ typedef struct {
 }  nxt_python_ctx_t;
 
 
+typedef struct {
+    PyObject_HEAD
+
+    const void               *start;
+    size_t                   size;
+}  nxt_python_input_buffer_t;
+
+
 static int nxt_python_wsgi_ctx_data_alloc(void **pdata, int main);
 static void nxt_python_wsgi_ctx_data_free(void *data);
 static int nxt_python_wsgi_run(nxt_unit_ctx_t *ctx);
@@ -90,6 +98,12 @@ static PyObject *nxt_py_input_readline(nxt_python_ctx_t *pctx,
 static PyObject *nxt_py_input_getline(nxt_python_ctx_t *pctx, size_t size);
 static PyObject *nxt_py_input_readlines(nxt_python_ctx_t *self,
     PyObject *args);
+static PyObject *nxt_py_input_getbuffer(nxt_python_ctx_t *pctx,
+    PyObject *args);
+static PyObject *nxt_py_input_copy_to(nxt_python_ctx_t *pctx, PyObject *args);
+static void nxt_py_input_buffer_dealloc(nxt_python_input_buffer_t *buffer);
+static int nxt_py_input_buffer_get(nxt_python_input_buffer_t *buffer,
+    Py_buffer *view, int flags);
 
 static PyObject *nxt_py_input_iter(PyObject *pctx);
 static PyObject *nxt_py_input_next(PyObject *pctx);
@@ -111,6 +125,8 @@ static PyMethodDef nxt_py_input_methods[] = {
     { "read",      (PyCFunction) nxt_py_input_read,      METH_VARARGS, 0 },
     { "readline",  (PyCFunction) nxt_py_input_readline,  METH_VARARGS, 0 },
     { "readlines", (PyCFunction) nxt_py_input_readlines, METH_VARARGS, 0 },
+    { "getbuffer", (PyCFunction) nxt_py_input_getbuffer, METH_NOARGS,  0 },
+    { "copy_to",   (PyCFunction) nxt_py_input_copy_to,   METH_VARARGS, 0 },
     { NULL, NULL, 0, 0 }
 };
 
@@ -129,6 +145,27 @@ static PyTypeObject nxt_py_input_type = {
 };
 
 
+static PyBufferProcs nxt_py_input_buffer_procs = {
+    .bf_getbuffer = (getbufferproc) nxt_py_input_buffer_get,
+};
+
+
+static PyTypeObject nxt_py_input_buffer_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+    .tp_name      = "unit._input_buffer",
+    .tp_basicsize = sizeof(nxt_python_input_buffer_t),
+    .tp_dealloc   = (destructor) nxt_py_input_buffer_dealloc,
+#if PY_MAJOR_VERSION == 3
+    .tp_flags     = Py_TPFLAGS_DEFAULT,
+#else
+    .tp_flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER,
+#endif
+    .tp_doc       = "unit mapped request body.",
+    .tp_as_buffer = &nxt_py_input_buffer_procs,
+};
+
+
 static PyObject  *nxt_py_environ_ptyp;
 
 static PyObject  *nxt_py_80_str;
@@ -545,6 +582,12 @@ nxt_python_create_environ(nxt_python_app_conf_t *c)
         goto fail;
     }
 
+    if (nxt_slow_path(PyType_Ready(&nxt_py_input_buffer_type) != 0)) {
+        nxt_unit_alert(NULL,
+                  "Python failed to initialize the input buffer type object");
+        goto fail;
+    }
+
 
     err = PySys_GetObject((char *) "stderr");
 
@@ -1313,6 +1356,146 @@ nxt_py_input_readlines(nxt_python_ctx_t *pctx, PyObject *args)
 }
 
 
+/*
+ * A request body spooled to a temporary file is mapped instead of being
+ * read.  The mapping belongs to the buffer object, so memoryviews of it stay
+ * valid after the request is done.  None is returned if the body is kept
+ * in memory and should be read as usual.
+ */
+
+static PyObject *
+nxt_py_input_getbuffer(nxt_python_ctx_t *pctx, PyObject *args)
+{
+    int                        rc;
+    size_t                     size;
+    PyObject                   *view;
+    const void                 *start;
+    nxt_python_input_buffer_t  *buffer;
+
+    if (nxt_slow_path(pctx->req == NULL)) {
+        return PyErr_Format(PyExc_RuntimeError,
+                            "wsgi.input.getbuffer() is called "
+                            "outside of WSGI request processing");
+    }
+
+    if (pctx->req->content_fd == -1) {
+        Py_RETURN_NONE;
+    }
+
+    rc = nxt_unit_request_content_map(pctx->req, &start, &size);
+    if (nxt_slow_path(rc != NXT_UNIT_OK)) {
+        return PyErr_Format(PyExc_IOError, "failed to map the request body");
+    }
+
+    buffer = PyObject_New(nxt_python_input_buffer_t,
+                          &nxt_py_input_buffer_type);
+    if (nxt_slow_path(buffer == NULL)) {
+        nxt_unit_request_content_unmap(start, size);
+        return NULL;
+    }
+
+    buffer->start = start;
+    buffer->size = size;
+
+    view = PyMemoryView_FromObject((PyObject *) buffer);
+
+    Py_DECREF(buffer);
+
+    return view;
+}
+
+
+static PyObject *
+nxt_py_input_copy_to(nxt_python_ctx_t *pctx, PyObject *args)
+{
+    int         fd;
+    ssize_t     res;
+    PyObject    *file, *obj;
+    Py_ssize_t  size, n;
+
+    if (nxt_slow_path(pctx->req == NULL)) {
+        return PyErr_Format(PyExc_RuntimeError,
+                            "wsgi.input.copy_to() is called "
+                            "outside of WSGI request processing");
+    }
+
+    n = PyTuple_GET_SIZE(args);
+
+    if (n != 1 && n != 2) {
+        return PyErr_Format(PyExc_TypeError, "invalid number of arguments");
+    }
+
+    size = pctx->req->content_length;
+
+    if (n == 2) {
+        obj = PyTuple_GET_ITEM(args, 1);
+
+        size = PyNumber_AsSsize_t(obj, PyExc_OverflowError);
+
+        if (nxt_slow_path(size < 0)) {
+            if (size == -1 && PyErr_Occurred()) {
+                return NULL;
+            }
+
+            if (size != -1) {
+                return PyErr_Format(PyExc_ValueError,
+                                  "the copy body size cannot be zero or less");
+            }
+        }
+
+        if (size == -1 || size > (Py_ssize_t) pctx->req->content_length) {
+            size = pctx->req->content_length;
+        }
+    }
+
+    file = PyTuple_GET_ITEM(args, 0);
+
+    /* Data buffered by a file object must precede the body. */
+
+    if (!PyLong_Check(file) && PyObject_HasAttrString(file, "flush")) {
+        obj = PyObject_CallMethod(file, "flush", NULL);
+        if (nxt_slow_path(obj == NULL)) {
+            return NULL;
+        }
+
+        Py_DECREF(obj);
+    }
+
+    fd = PyObject_AsFileDescriptor(file);
+    if (nxt_slow_path(fd == -1)) {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    res = nxt_unit_request_content_copy(pctx->req, fd, size);
+    Py_END_ALLOW_THREADS
+
+    if (nxt_slow_path(res < 0)) {
+        return PyErr_Format(PyExc_IOError, "failed to copy the request body");
+    }
+
+    return PyLong_FromSsize_t(res);
+}
+
+
+static void
+nxt_py_input_buffer_dealloc(nxt_python_input_buffer_t *buffer)
+{
+    nxt_unit_request_content_unmap(buffer->start, buffer->size);
+
+    PyObject_Del(buffer);
+}
+
+
+static int
+nxt_py_input_buffer_get(nxt_python_input_buffer_t *buffer, Py_buffer *view,
+    int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *) buffer, (void *) buffer->start,
+                             buffer->size, 1, flags);
+}
+
+
 static PyObject *
 nxt_py_input_iter(PyObject *self)
 {
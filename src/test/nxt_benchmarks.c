@@ -0,0 +1,257 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+/*
+ * Microbenchmarks of core data structures and IPC.
+ *
+ *   benchmarks [-r runs] [-q] [name ...]
+ *
+ * Each benchmark is run once to warm up and then the given number of times
+ * (5 by default); "-q" runs a tenth of the operations.  Names select
+ * benchmarks by prefix.  The results are printed to stdout as JSON lines:
+ * a header line with the version and the CPU count, followed by a line per
+ * benchmark with the median, minimum, and maximum time per operation in
+ * nanoseconds, and the median CPU cycles per operation where available.
+ */
+
+#include <nxt_main.h>
+#include "nxt_tests.h"
+#include "nxt_benchmarks.h"
+
+
+extern char  **environ;
+
+nxt_module_init_t  nxt_init_modules[1];
+nxt_uint_t         nxt_init_modules_n;
+
+
+static nxt_int_t nxt_bench_run(nxt_bench_t *bench, nxt_uint_t runs,
+    nxt_uint_t div);
+static int nxt_cdecl nxt_bench_cmp(const void *one, const void *two);
+static nxt_bool_t nxt_bench_match(nxt_bench_t *bench, char **names);
+static nxt_nsec_t nxt_bench_time(void);
+
+
+#define NXT_BENCH_MAX_RUNS  100
+
+
+static nxt_bench_t  nxt_benchmarks[] = {
+    { "http_parse_simple", nxt_http_parse_bench, 1000 * 1000,
+      &nxt_http_bench_simple_request, NULL, 0, 0, 0, 0 },
+    { "http_parse_big", nxt_http_parse_bench, 200 * 1000,
+      &nxt_http_bench_big_request, NULL, 0, 0, 0, 0 },
+    { "lvlhsh_insert", nxt_lvlhsh_insert_bench, 1000 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "lvlhsh_find", nxt_lvlhsh_find_bench, 1000 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "mp_alloc_free", nxt_mp_alloc_bench, 2000 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "mp_request_pool", nxt_mp_request_bench, 500 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "nncq_threads", nxt_nncq_bench, 2000 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "app_queue_threads", nxt_app_queue_bench, 2000 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "port_queue_rtt", nxt_port_queue_rtt_bench, 200 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+    { "port_socket_rtt", nxt_port_socket_rtt_bench, 100 * 1000,
+      NULL, NULL, 0, 0, 0, 0 },
+};
+
+
+int nxt_cdecl
+main(int argc, char **argv)
+{
+    char          **args, **names, *p;
+    nxt_int_t     runs;
+    nxt_uint_t    i, div;
+    nxt_task_t    task;
+    nxt_thread_t  *thr;
+
+    if (nxt_lib_start("benchmarks", argv, &environ) != NXT_OK) {
+        return 1;
+    }
+
+    nxt_main_log.level = NXT_LOG_INFO;
+    task.log = &nxt_main_log;
+
+    thr = nxt_thread();
+    thr->task = &task;
+
+    runs = 5;
+    div = 1;
+
+    /* The arguments may have been moved by nxt_lib_start(). */
+    args = nxt_process_argv;
+
+    for (i = 1; args[i] != NULL; i++) {
+        p = args[i];
+
+        if (nxt_strcmp(p, "-q") == 0) {
+            div = 10;
+            continue;
+        }
+
+        if (nxt_strcmp(p, "-r") == 0 && args[i + 1] != NULL) {
+            runs = nxt_int_parse((u_char *) args[i + 1],
+                                 nxt_strlen(args[i + 1]));
+            if (runs < 1 || runs > NXT_BENCH_MAX_RUNS) {
+                nxt_log_alert(thr->log, "invalid number of runs \"%s\"",
+                              args[i + 1]);
+                return 1;
+            }
+
+            i++;
+            continue;
+        }
+
+        break;
+    }
+
+    names = &args[i];
+
+    printf("{\"version\":\"%s\",\"cpus\":%d,\"runs\":%d,\"quick\":%s}\n",
+           NXT_VERSION, (int) nxt_ncpu, (int) runs,
+           (div != 1) ? "true" : "false");
+
+    for (i = 0; i < nxt_nitems(nxt_benchmarks); i++) {
+        if (!nxt_bench_match(&nxt_benchmarks[i], names)) {
+            continue;
+        }
+
+        nxt_benchmarks[i].thread = thr;
+
+        if (nxt_bench_run(&nxt_benchmarks[i], runs, div) != NXT_OK) {
+            nxt_log_alert(thr->log, "benchmark \"%s\" failed",
+                          nxt_benchmarks[i].name);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static nxt_bool_t
+nxt_bench_match(nxt_bench_t *bench, char **names)
+{
+    if (*names == NULL) {
+        return 1;
+    }
+
+    while (*names != NULL) {
+        if (nxt_strncmp(bench->name, *names, nxt_strlen(*names)) == 0) {
+            return 1;
+        }
+
+        names++;
+    }
+
+    return 0;
+}
+
+
+static nxt_int_t
+nxt_bench_run(nxt_bench_t *bench, nxt_uint_t runs, nxt_uint_t div)
+{
+    double      ns[NXT_BENCH_MAX_RUNS], cycles[NXT_BENCH_MAX_RUNS];
+    double      median;
+    nxt_uint_t  i, ops;
+
+    ops = bench->ops / div;
+
+    /* Warm up caches, allocators, and page tables. */
+
+    bench->ops = nxt_max(ops / 10, 1);
+
+    if (bench->handler(bench) != NXT_OK) {
+        return NXT_ERROR;
+    }
+
+    bench->ops = ops;
+
+    for (i = 0; i < runs; i++) {
+        bench->elapsed = 0;
+        bench->cycles = 0;
+
+        if (bench->handler(bench) != NXT_OK) {
+            return NXT_ERROR;
+        }
+
+        ns[i] = (double) bench->elapsed / ops;
+        cycles[i] = (double) bench->cycles / ops;
+    }
+
+    nxt_qsort(ns, runs, sizeof(double), nxt_bench_cmp);
+    nxt_qsort(cycles, runs, sizeof(double), nxt_bench_cmp);
+
+    median = ns[runs / 2];
+
+    printf("{\"name\":\"%s\",\"ops\":%lu,"
+           "\"ns_per_op\":%.2f,\"ns_per_op_min\":%.2f,\"ns_per_op_max\":%.2f,",
+           bench->name, (unsigned long) ops, median, ns[0], ns[runs - 1]);
+
+#if (NXT_TEST_RTDTSC)
+    printf("\"cycles_per_op\":%.1f,", cycles[runs / 2]);
+#else
+    printf("\"cycles_per_op\":null,");
+#endif
+
+    printf("\"ops_per_sec\":%.0f}\n", (median > 0) ? 1e9 / median : 0);
+
+    fflush(stdout);
+
+    return NXT_OK;
+}
+
+
+static int nxt_cdecl
+nxt_bench_cmp(const void *one, const void *two)
+{
+    double  a, b;
+
+    a = *(const double *) one;
+    b = *(const double *) two;
+
+    return (a > b) - (a < b);
+}
+
+
+/*
+ * The thread time uses coarse clocks where available, so the benchmarks
+ * read the precise monotonic clock directly.
+ */
+
+static nxt_nsec_t
+nxt_bench_time(void)
+{
+    struct timespec  ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (nxt_nsec_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+void
+nxt_bench_start(nxt_bench_t *bench)
+{
+    bench->start = nxt_bench_time();
+
+#if (NXT_TEST_RTDTSC)
+    bench->start_cycles = nxt_rdtsc();
+#endif
+}
+
+
+void
+nxt_bench_stop(nxt_bench_t *bench)
+{
+#if (NXT_TEST_RTDTSC)
+    bench->cycles += nxt_rdtsc() - bench->start_cycles;
+#endif
+
+    bench->elapsed += nxt_bench_time() - bench->start;
+}
@@ -0,0 +1,65 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NXT_BENCHMARKS_H_INCLUDED_
+#define _NXT_BENCHMARKS_H_INCLUDED_
+
+
+typedef struct nxt_bench_s  nxt_bench_t;
+
+/* A handler performs bench->ops operations between start and stop calls. */
+typedef nxt_int_t (*nxt_bench_handler_t)(nxt_bench_t *bench);
+
+
+struct nxt_bench_s {
+    const char           *name;
+    nxt_bench_handler_t  handler;
+    nxt_uint_t           ops;
+    void                 *data;
+
+    nxt_thread_t         *thread;
+
+    nxt_nsec_t           start;
+    nxt_nsec_t           elapsed;
+    uint64_t             start_cycles;
+    uint64_t             cycles;
+};
+
+
+void nxt_bench_start(nxt_bench_t *bench);
+void nxt_bench_stop(nxt_bench_t *bench);
+
+
+/* Busy waiting on a single CPU gives the other side a chance to run. */
+
+nxt_inline void
+nxt_bench_spin(void)
+{
+    if (nxt_ncpu == 1) {
+        nxt_thread_yield();
+
+    } else {
+        nxt_cpu_pause();
+    }
+}
+
+
+nxt_int_t nxt_http_parse_bench(nxt_bench_t *bench);
+nxt_int_t nxt_lvlhsh_insert_bench(nxt_bench_t *bench);
+nxt_int_t nxt_lvlhsh_find_bench(nxt_bench_t *bench);
+nxt_int_t nxt_mp_alloc_bench(nxt_bench_t *bench);
+nxt_int_t nxt_mp_request_bench(nxt_bench_t *bench);
+
+nxt_int_t nxt_nncq_bench(nxt_bench_t *bench);
+nxt_int_t nxt_app_queue_bench(nxt_bench_t *bench);
+nxt_int_t nxt_port_queue_rtt_bench(nxt_bench_t *bench);
+nxt_int_t nxt_port_socket_rtt_bench(nxt_bench_t *bench);
+
+
+extern nxt_str_t  nxt_http_bench_simple_request;
+extern nxt_str_t  nxt_http_bench_big_request;
+
+
+#endif /* _NXT_BENCHMARKS_H_INCLUDED_ */
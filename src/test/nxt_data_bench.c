@@ -0,0 +1,332 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_main.h>
+#include "nxt_benchmarks.h"
+
+
+static nxt_int_t nxt_http_bench_field(void *ctx, nxt_http_field_t *field,
+    uintptr_t data);
+static nxt_int_t nxt_lvlhsh_bench_key_test(nxt_lvlhsh_query_t *lhq,
+    void *data);
+static nxt_int_t nxt_lvlhsh_bench_fill(nxt_lvlhsh_t *lh, nxt_mp_t *mp,
+    nxt_uint_t n);
+
+
+nxt_str_t  nxt_http_bench_simple_request = nxt_string(
+    "GET /page HTTP/1.1\r\n"
+    "Host: example.com\r\n\r\n"
+);
+
+
+nxt_str_t  nxt_http_bench_big_request = nxt_string(
+    "POST /path/to/very/interesting/article/on.this.site?arg1=value&arg2=value"
+        "2&very_big_arg=even_bigger_value HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 "
+        "Firefox/115.0\r\n"
+    "Accept: text/html,application/json,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Language: en-US,en;q=0.8,de;q=0.6\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "If-Modified-Since: Wed, 31 Dec 1986 16:00:00 GMT\r\n"
+    "Referer: https://example.org/path/to/not-interesting/article.html\r\n"
+    "Cookie: name=value; name2=value2; session=1Q2w3E4r5T6y7U8i9O0p1Q2w3E4r"
+        "5T6y7U8i9O0p1Q2w3E4r5T6y7U8i9O0p\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Type: application/x-www-form-urlencoded\r\n"
+    "Content-Length: 0\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "Pragma: no-cache\r\n"
+    "Cache-Control: no-cache\r\n"
+    "X-Forwarded-For: 192.0.2.0, 198.51.100.0, 203.0.113.0\r\n"
+    "\r\n"
+);
+
+
+static nxt_http_field_proc_t  nxt_http_bench_fields[] = {
+    { nxt_string("Host"),            &nxt_http_bench_field, 0 },
+    { nxt_string("User-Agent"),      &nxt_http_bench_field, 0 },
+    { nxt_string("Accept"),          &nxt_http_bench_field, 0 },
+    { nxt_string("Accept-Encoding"), &nxt_http_bench_field, 0 },
+    { nxt_string("Connection"),      &nxt_http_bench_field, 0 },
+    { nxt_string("Content-Length"),  &nxt_http_bench_field, 0 },
+    { nxt_string("Content-Type"),    &nxt_http_bench_field, 0 },
+    { nxt_string("Cookie"),          &nxt_http_bench_field, 0 },
+    { nxt_string("X-Forwarded-For"), &nxt_http_bench_field, 0 },
+};
+
+
+static const nxt_lvlhsh_proto_t  nxt_lvlhsh_bench_proto  nxt_aligned(64) = {
+    NXT_LVLHSH_LARGE_SLAB,
+    nxt_lvlhsh_bench_key_test,
+    nxt_mp_lvlhsh_alloc,
+    nxt_mp_lvlhsh_free,
+};
+
+
+static nxt_int_t
+nxt_http_bench_field(void *ctx, nxt_http_field_t *field, uintptr_t data)
+{
+    return NXT_OK;
+}
+
+
+/*
+ * Parses the request and processes its header fields the way the router
+ * does, with a memory pool per request.
+ */
+
+nxt_int_t
+nxt_http_parse_bench(nxt_bench_t *bench)
+{
+    nxt_mp_t                  *mp;
+    nxt_str_t                 *request;
+    nxt_int_t                 ret;
+    nxt_uint_t                i;
+    nxt_lvlhsh_t              hash;
+    nxt_buf_mem_t             buf;
+    nxt_http_request_parse_t  rp;
+
+    request = bench->data;
+
+    nxt_memzero(&hash, sizeof(nxt_lvlhsh_t));
+
+    ret = nxt_http_fields_hash(&hash, nxt_http_bench_fields,
+                               nxt_nitems(nxt_http_bench_fields));
+    if (nxt_slow_path(ret != NXT_OK)) {
+        return NXT_ERROR;
+    }
+
+    buf.start = request->start;
+    buf.end = request->start + request->length;
+
+    nxt_bench_start(bench);
+
+    for (i = 0; i < bench->ops; i++) {
+        nxt_memzero(&rp, sizeof(nxt_http_request_parse_t));
+
+        mp = nxt_mp_create(1024, 128, 256, 32);
+        if (nxt_slow_path(mp == NULL)) {
+            return NXT_ERROR;
+        }
+
+        if (nxt_slow_path(nxt_http_parse_request_init(&rp, mp) != NXT_OK)) {
+            return NXT_ERROR;
+        }
+
+        buf.pos = buf.start;
+        buf.free = buf.end;
+
+        if (nxt_slow_path(nxt_http_parse_request(&rp, &buf) != NXT_DONE)) {
+            return NXT_ERROR;
+        }
+
+        ret = nxt_http_fields_process(rp.fields, &hash, NULL);
+        if (nxt_slow_path(ret != NXT_OK)) {
+            return NXT_ERROR;
+        }
+
+        nxt_mp_destroy(mp);
+    }
+
+    nxt_bench_stop(bench);
+
+    return NXT_OK;
+}
+
+
+static nxt_int_t
+nxt_lvlhsh_bench_key_test(nxt_lvlhsh_query_t *lhq, void *data)
+{
+    if (*(uint32_t *) lhq->key.start == (uint32_t) (uintptr_t) data) {
+        return NXT_OK;
+    }
+
+    return NXT_DECLINED;
+}
+
+
+static nxt_int_t
+nxt_lvlhsh_bench_fill(nxt_lvlhsh_t *lh, nxt_mp_t *mp, nxt_uint_t n)
+{
+    uint32_t            key;
+    nxt_uint_t          i;
+    nxt_lvlhsh_query_t  lhq;
+
+    lhq.replace = 0;
+    lhq.key.length = sizeof(uint32_t);
+    lhq.key.start = (u_char *) &key;
+    lhq.proto = &nxt_lvlhsh_bench_proto;
+    lhq.pool = mp;
+
+    key = 0;
+
+    for (i = 0; i < n; i++) {
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        lhq.key_hash = key;
+        lhq.value = (void *) (uintptr_t) key;
+
+        if (nxt_slow_path(nxt_lvlhsh_insert(lh, &lhq) != NXT_OK)) {
+            return NXT_ERROR;
+        }
+    }
+
+    return NXT_OK;
+}
+
+
+nxt_int_t
+nxt_lvlhsh_insert_bench(nxt_bench_t *bench)
+{
+    nxt_mp_t      *mp;
+    nxt_int_t     ret;
+    nxt_lvlhsh_t  lh;
+
+    mp = nxt_mp_create(4096, 128, 1024, 32);
+    if (nxt_slow_path(mp == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_memzero(&lh, sizeof(nxt_lvlhsh_t));
+
+    nxt_bench_start(bench);
+
+    ret = nxt_lvlhsh_bench_fill(&lh, mp, bench->ops);
+
+    nxt_bench_stop(bench);
+
+    nxt_mp_destroy(mp);
+
+    return ret;
+}
+
+
+nxt_int_t
+nxt_lvlhsh_find_bench(nxt_bench_t *bench)
+{
+    uint32_t            key;
+    nxt_mp_t            *mp;
+    nxt_int_t           ret;
+    nxt_uint_t          i;
+    nxt_lvlhsh_t        lh;
+    nxt_lvlhsh_query_t  lhq;
+
+    mp = nxt_mp_create(4096, 128, 1024, 32);
+    if (nxt_slow_path(mp == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_memzero(&lh, sizeof(nxt_lvlhsh_t));
+
+    ret = nxt_lvlhsh_bench_fill(&lh, mp, bench->ops);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        goto done;
+    }
+
+    lhq.key.length = sizeof(uint32_t);
+    lhq.key.start = (u_char *) &key;
+    lhq.proto = &nxt_lvlhsh_bench_proto;
+
+    key = 0;
+
+    nxt_bench_start(bench);
+
+    for (i = 0; i < bench->ops; i++) {
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        lhq.key_hash = key;
+
+        if (nxt_slow_path(nxt_lvlhsh_find(&lh, &lhq) != NXT_OK)) {
+            ret = NXT_ERROR;
+            break;
+        }
+    }
+
+    nxt_bench_stop(bench);
+
+done:
+
+    nxt_mp_destroy(mp);
+
+    return ret;
+}
+
+
+/* Allocation and freeing of blocks from 16 to 1024 bytes. */
+
+nxt_int_t
+nxt_mp_alloc_bench(nxt_bench_t *bench)
+{
+    void        *blocks[64];
+    size_t      size;
+    nxt_mp_t    *mp;
+    nxt_uint_t  i, j;
+
+    mp = nxt_mp_create(4096, 128, 1024, 16);
+    if (nxt_slow_path(mp == NULL)) {
+        return NXT_ERROR;
+    }
+
+    size = 16;
+
+    nxt_bench_start(bench);
+
+    for (i = 0; i < bench->ops; i += nxt_nitems(blocks)) {
+
+        for (j = 0; j < nxt_nitems(blocks); j++) {
+            blocks[j] = nxt_mp_alloc(mp, size);
+            if (nxt_slow_path(blocks[j] == NULL)) {
+                return NXT_ERROR;
+            }
+
+            size = (size < 1024) ? size * 2 : 16;
+        }
+
+        for (j = 0; j < nxt_nitems(blocks); j++) {
+            nxt_mp_free(mp, blocks[j]);
+        }
+    }
+
+    nxt_bench_stop(bench);
+
+    nxt_mp_destroy(mp);
+
+    return NXT_OK;
+}
+
+
+/*
+ * The life cycle of a request memory pool: creation with the router
+ * parameters, a few small allocations, and destruction.
+ */
+
+nxt_int_t
+nxt_mp_request_bench(nxt_bench_t *bench)
+{
+    nxt_mp_t    *mp;
+    nxt_uint_t  i, j;
+
+    nxt_bench_start(bench);
+
+    for (i = 0; i < bench->ops; i++) {
+        mp = nxt_mp_create(1024, 128, 256, 32);
+        if (nxt_slow_path(mp == NULL)) {
+            return NXT_ERROR;
+        }
+
+        for (j = 0; j < 16; j++) {
+            if (nxt_slow_path(nxt_mp_get(mp, 24 + j * 8) == NULL)) {
+                return NXT_ERROR;
+            }
+        }
+
+        nxt_mp_destroy(mp);
+    }
+
+    nxt_bench_stop(bench);
+
+    return NXT_OK;
+}
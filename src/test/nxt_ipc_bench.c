@@ -0,0 +1,426 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_main.h>
+#include <nxt_port_queue.h>
+#include <nxt_app_queue.h>
+#include "nxt_benchmarks.h"
+
+
+typedef struct {
+    nxt_nncq_t              free_items;
+    nxt_nncq_t              queue;
+} nxt_nncq_bench_t;
+
+
+typedef struct {
+    nxt_port_queue_t        ping;
+    nxt_port_queue_t        pong;
+} nxt_port_bench_t;
+
+
+typedef struct {
+    nxt_uint_t              n;
+    void                    *queue;
+    nxt_atomic_t            go;
+    nxt_thread_handle_t     handle;
+} nxt_bench_producer_t;
+
+
+static nxt_int_t nxt_bench_producer_start(nxt_bench_producer_t *producer,
+    nxt_thread_start_t start);
+static void nxt_nncq_bench_producer(void *data);
+static void nxt_app_queue_bench_producer(void *data);
+static nxt_int_t nxt_port_bench_rtt(nxt_bench_t *bench, nxt_bool_t notify);
+static void nxt_port_bench_echo(nxt_port_bench_t *pb, nxt_socket_t fd,
+    nxt_uint_t n);
+static void nxt_port_bench_send(nxt_port_queue_t *q, nxt_socket_t fd,
+    uint32_t value);
+static nxt_int_t nxt_port_bench_recv(nxt_port_queue_t *q, nxt_socket_t fd,
+    uint32_t *value);
+
+
+static nxt_int_t
+nxt_bench_producer_start(nxt_bench_producer_t *producer,
+    nxt_thread_start_t start)
+{
+    nxt_thread_link_t  *link;
+
+    link = nxt_zalloc(sizeof(nxt_thread_link_t));
+    if (nxt_slow_path(link == NULL)) {
+        return NXT_ERROR;
+    }
+
+    link->start = start;
+    link->work.data = producer;
+
+    return nxt_thread_create(&producer->handle, link);
+}
+
+
+/*
+ * A producer thread passes item indexes to the consumer through a queue
+ * and the consumer returns them through a free items queue, the way port
+ * queues use NNCQ.
+ */
+
+nxt_int_t
+nxt_nncq_bench(nxt_bench_t *bench)
+{
+    nxt_int_t             ret;
+    nxt_uint_t            i;
+    nxt_nncq_atomic_t     item;
+    nxt_nncq_bench_t      *q;
+    nxt_bench_producer_t  producer;
+
+    q = nxt_malloc(sizeof(nxt_nncq_bench_t));
+    if (nxt_slow_path(q == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_nncq_init(&q->free_items);
+    nxt_nncq_init(&q->queue);
+
+    for (i = 0; i < NXT_NNCQ_SIZE; i++) {
+        nxt_nncq_enqueue(&q->free_items, i);
+    }
+
+    producer.n = bench->ops;
+    producer.queue = q;
+    producer.go = 0;
+
+    ret = nxt_bench_producer_start(&producer, nxt_nncq_bench_producer);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        nxt_free(q);
+        return NXT_ERROR;
+    }
+
+    nxt_bench_start(bench);
+
+    producer.go = 1;
+
+    for (i = 0; i < bench->ops; i++) {
+
+        for ( ;; ) {
+            item = nxt_nncq_dequeue(&q->queue);
+
+            if (item != nxt_nncq_empty(&q->queue)) {
+                break;
+            }
+
+            nxt_bench_spin();
+        }
+
+        nxt_nncq_enqueue(&q->free_items, item);
+    }
+
+    nxt_bench_stop(bench);
+
+    nxt_thread_wait(producer.handle);
+
+    nxt_free(q);
+
+    return NXT_OK;
+}
+
+
+static void
+nxt_nncq_bench_producer(void *data)
+{
+    nxt_uint_t            i;
+    nxt_nncq_atomic_t     item;
+    nxt_nncq_bench_t      *q;
+    nxt_bench_producer_t  *producer;
+
+    producer = data;
+    q = producer->queue;
+
+    while (!producer->go) {
+        nxt_bench_spin();
+    }
+
+    for (i = 0; i < producer->n; i++) {
+
+        for ( ;; ) {
+            item = nxt_nncq_dequeue(&q->free_items);
+
+            if (item != nxt_nncq_empty(&q->free_items)) {
+                break;
+            }
+
+            nxt_bench_spin();
+        }
+
+        nxt_nncq_enqueue(&q->queue, item);
+    }
+}
+
+
+/* The application queue carrying 16-byte messages between two threads. */
+
+nxt_int_t
+nxt_app_queue_bench(nxt_bench_t *bench)
+{
+    u_char                buf[NXT_APP_QUEUE_MSG_SIZE];
+    ssize_t               n;
+    uint32_t              cookie;
+    uint64_t              value;
+    nxt_int_t             ret;
+    nxt_uint_t            i;
+    nxt_app_queue_t       *q;
+    nxt_bench_producer_t  producer;
+
+    q = nxt_malloc(sizeof(nxt_app_queue_t));
+    if (nxt_slow_path(q == NULL)) {
+        return NXT_ERROR;
+    }
+
+    nxt_app_queue_init(q);
+
+    producer.n = bench->ops;
+    producer.queue = q;
+    producer.go = 0;
+
+    ret = nxt_bench_producer_start(&producer, nxt_app_queue_bench_producer);
+    if (nxt_slow_path(ret != NXT_OK)) {
+        nxt_free(q);
+        return NXT_ERROR;
+    }
+
+    ret = NXT_OK;
+
+    nxt_bench_start(bench);
+
+    producer.go = 1;
+
+    for (i = 0; i < bench->ops; i++) {
+
+        for ( ;; ) {
+            n = nxt_app_queue_recv(q, buf, &cookie);
+
+            if (n >= 0) {
+                break;
+            }
+
+            nxt_bench_spin();
+        }
+
+        nxt_memcpy(&value, buf, sizeof(uint64_t));
+
+        if (nxt_slow_path(n != 16 || value != i)) {
+            ret = NXT_ERROR;
+        }
+    }
+
+    nxt_bench_stop(bench);
+
+    nxt_thread_wait(producer.handle);
+
+    nxt_free(q);
+
+    return ret;
+}
+
+
+static void
+nxt_app_queue_bench_producer(void *data)
+{
+    u_char                buf[16];
+    uint32_t              cookie;
+    uint64_t              value;
+    nxt_app_queue_t       *q;
+    nxt_bench_producer_t  *producer;
+
+    producer = data;
+    q = producer->queue;
+
+    nxt_memzero(buf, sizeof(buf));
+
+    while (!producer->go) {
+        nxt_bench_spin();
+    }
+
+    for (value = 0; value < producer->n; value++) {
+        nxt_memcpy(buf, &value, sizeof(uint64_t));
+
+        while (nxt_app_queue_send(q, buf, sizeof(buf), 0, NULL, &cookie)
+               != NXT_OK)
+        {
+            nxt_bench_spin();
+        }
+    }
+}
+
+
+/*
+ * A round trip of a port queue message between two processes through
+ * shared memory.  The receivers poll the queues.
+ */
+
+nxt_int_t
+nxt_port_queue_rtt_bench(nxt_bench_t *bench)
+{
+    return nxt_port_bench_rtt(bench, 0);
+}
+
+
+/*
+ * The same round trip with socket notifications sent when a queue becomes
+ * non-empty, as port queues do; the receivers block on the sockets.
+ */
+
+nxt_int_t
+nxt_port_socket_rtt_bench(nxt_bench_t *bench)
+{
+    return nxt_port_bench_rtt(bench, 1);
+}
+
+
+static nxt_int_t
+nxt_port_bench_rtt(nxt_bench_t *bench, nxt_bool_t notify)
+{
+    int               status;
+    pid_t             pid;
+    uint32_t          value;
+    nxt_int_t         ret;
+    nxt_uint_t        i;
+    nxt_socket_t      pair[2];
+    nxt_port_bench_t  *pb;
+
+    pb = nxt_mem_mmap(NULL, sizeof(nxt_port_bench_t),
+                      NXT_MEM_MAP_READ | NXT_MEM_MAP_WRITE,
+                      NXT_MEM_MAP_SHARED, -1, 0);
+    if (nxt_slow_path(pb == NXT_MEM_MAP_FAILED)) {
+        return NXT_ERROR;
+    }
+
+    nxt_port_queue_init(&pb->ping);
+    nxt_port_queue_init(&pb->pong);
+
+    pair[0] = -1;
+    pair[1] = -1;
+
+    /* Blocking sockets stand for the event engine wait. */
+
+    if (notify && socketpair(AF_UNIX, SOCK_DGRAM, 0, pair) != 0) {
+        nxt_log_alert(bench->thread->log, "socketpair() failed %E",
+                      nxt_errno);
+        nxt_mem_munmap(pb, sizeof(nxt_port_bench_t));
+        return NXT_ERROR;
+    }
+
+    pid = fork();
+
+    if (pid == 0) {
+        nxt_port_bench_echo(pb, pair[1], bench->ops);
+        _exit(0);
+    }
+
+    ret = NXT_OK;
+
+    if (nxt_slow_path(pid == -1)) {
+        nxt_log_alert(bench->thread->log, "fork() failed %E", nxt_errno);
+        ret = NXT_ERROR;
+        goto done;
+    }
+
+    nxt_bench_start(bench);
+
+    for (i = 0; i < bench->ops; i++) {
+        nxt_port_bench_send(&pb->ping, pair[0], i);
+
+        if (nxt_slow_path(nxt_port_bench_recv(&pb->pong, pair[0], &value)
+                          != NXT_OK
+                          || value != i))
+        {
+            kill(pid, SIGKILL);
+            ret = NXT_ERROR;
+            break;
+        }
+    }
+
+    nxt_bench_stop(bench);
+
+    (void) waitpid(pid, &status, 0);
+
+done:
+
+    if (notify) {
+        nxt_socket_close(bench->thread->task, pair[0]);
+        nxt_socket_close(bench->thread->task, pair[1]);
+    }
+
+    nxt_mem_munmap(pb, sizeof(nxt_port_bench_t));
+
+    return ret;
+}
+
+
+static void
+nxt_port_bench_echo(nxt_port_bench_t *pb, nxt_socket_t fd, nxt_uint_t n)
+{
+    uint32_t    value;
+    nxt_uint_t  i;
+
+    for (i = 0; i < n; i++) {
+        if (nxt_port_bench_recv(&pb->ping, fd, &value) != NXT_OK) {
+            return;
+        }
+
+        nxt_port_bench_send(&pb->pong, fd, value);
+    }
+}
+
+
+static void
+nxt_port_bench_send(nxt_port_queue_t *q, nxt_socket_t fd, uint32_t value)
+{
+    int     notify;
+    u_char  msg[16];
+
+    nxt_memzero(msg, sizeof(msg));
+    nxt_memcpy(msg, &value, sizeof(uint32_t));
+
+    while (nxt_port_queue_send(q, msg, sizeof(msg), &notify) != NXT_OK) {
+        nxt_bench_spin();
+    }
+
+    if (fd != -1 && notify) {
+        (void) write(fd, msg, 1);
+    }
+}
+
+
+static nxt_int_t
+nxt_port_bench_recv(nxt_port_queue_t *q, nxt_socket_t fd, uint32_t *value)
+{
+    u_char   msg[NXT_PORT_QUEUE_MSG_SIZE];
+    ssize_t  n;
+
+    for ( ;; ) {
+        n = nxt_port_queue_recv(q, msg);
+
+        if (n >= 0) {
+            break;
+        }
+
+        if (fd == -1) {
+            nxt_bench_spin();
+            continue;
+        }
+
+        /* Wait for a notification; stale ones are skipped by the loop. */
+
+        n = read(fd, msg, sizeof(msg));
+
+        if (nxt_slow_path(n <= 0 && nxt_errno != NXT_EINTR)) {
+            return NXT_ERROR;
+        }
+    }
+
+    nxt_memcpy(value, msg, sizeof(uint32_t));
+
+    return NXT_OK;
+}
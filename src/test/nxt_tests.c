@@ -98,6 +98,10 @@ main(int argc, char **argv)
         return 1;
     }
 
+    if (nxt_timer_test(thr, 100 * 1000) != NXT_OK) {
+        return 1;
+    }
+
     if (nxt_mp_test(thr, 100, 40000, 128 - 1) != NXT_OK) {
         return 1;
     }
@@ -138,6 +142,10 @@ main(int argc, char **argv)
         return 1;
     }
 
+    if (nxt_work_queue_test(thr, 4, 1000 * 1000) != NXT_OK) {
+        return 1;
+    }
+
     if (nxt_gmtime_test(thr) != NXT_OK) {
         return 1;
     }
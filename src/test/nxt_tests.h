@@ -38,6 +38,7 @@ nxt_int_t nxt_msec_diff_test(nxt_thread_t *thr, nxt_msec_less_t);
 
 nxt_int_t nxt_rbtree_test(nxt_thread_t *thr, nxt_uint_t n);
 nxt_int_t nxt_rbtree1_test(nxt_thread_t *thr, nxt_uint_t n);
+nxt_int_t nxt_timer_test(nxt_thread_t *thr, nxt_uint_t n);
 
 #if (NXT_TEST_RTDTSC)
 
@@ -57,6 +58,8 @@ nxt_int_t nxt_mem_zone_test(nxt_thread_t *thr, nxt_uint_t runs,
     nxt_uint_t nblocks, size_t max_size);
 nxt_int_t nxt_lvlhsh_test(nxt_thread_t *thr, nxt_uint_t n,
     nxt_bool_t use_pool);
+nxt_int_t nxt_work_queue_test(nxt_thread_t *thr, nxt_uint_t nthreads,
+    nxt_uint_t n);
 
 nxt_int_t nxt_gmtime_test(nxt_thread_t *thr);
 nxt_int_t nxt_sprintf_test(nxt_thread_t *thr);
@@ -0,0 +1,368 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_main.h>
+#include "nxt_tests.h"
+
+
+typedef struct {
+    nxt_timer_t         timer;
+    nxt_msec_t          expected;
+    nxt_uint_t          fired;
+} nxt_timer_test_t;
+
+
+typedef struct {
+    NXT_RBTREE_NODE     (node);
+    nxt_msec_t          time;
+} nxt_timer_test_node_t;
+
+
+static nxt_event_engine_t *nxt_timer_test_engine(nxt_thread_t *thr,
+    nxt_work_queue_cache_t *cache, nxt_work_queue_t *wq);
+static void nxt_timer_test_run(nxt_event_engine_t *engine,
+    nxt_work_queue_t *wq, nxt_msec_t now);
+static void nxt_timer_test_handler(nxt_task_t *task, void *obj, void *data);
+static nxt_int_t nxt_timer_test_bench(nxt_thread_t *thr, nxt_uint_t n,
+    nxt_uint_t changes);
+static intptr_t nxt_timer_test_rbtree_compare(nxt_rbtree_node_t *node1,
+    nxt_rbtree_node_t *node2);
+
+
+/* Start near the overflow to test wrapping of the milliseconds counter. */
+#define NXT_TIMER_TEST_START  0xFFFF0000
+
+#define NXT_TIMER_TEST_STEP   37
+#define NXT_TIMER_TEST_RANGE  (600 * 1000)
+
+
+static nxt_msec_t  nxt_timer_test_now;
+static nxt_uint_t  nxt_timer_test_errors;
+
+
+nxt_int_t
+nxt_timer_test(nxt_thread_t *thr, nxt_uint_t n)
+{
+    uint32_t                key;
+    nxt_int_t               ret;
+    nxt_uint_t              i, fired;
+    nxt_msec_t              now, timeout, end;
+    nxt_work_queue_t        wq;
+    nxt_timer_test_t        *items, *item;
+    nxt_event_engine_t      *engine;
+    nxt_work_queue_cache_t  cache;
+
+    nxt_thread_time_update(thr);
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log, "timer test started: %ui", n);
+
+    engine = nxt_timer_test_engine(thr, &cache, &wq);
+    if (engine == NULL) {
+        return NXT_ERROR;
+    }
+
+    ret = NXT_ERROR;
+
+    items = nxt_zalloc(n * sizeof(nxt_timer_test_t));
+    if (items == NULL) {
+        goto fail;
+    }
+
+    nxt_timer_test_errors = 0;
+    now = NXT_TIMER_TEST_START;
+    key = 0;
+
+    for (i = 0; i < n; i++) {
+        item = &items[i];
+
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        /* A quarter of timers are short ones, others are idle timeouts. */
+        timeout = (i % 4 == 0) ? key % 100 : key % NXT_TIMER_TEST_RANGE;
+
+        item->timer.work_queue = &wq;
+        item->timer.handler = nxt_timer_test_handler;
+        item->timer.task = &engine->task;
+        item->timer.log = thr->log;
+
+        item->expected = now + timeout;
+
+        nxt_timer_add(engine, &item->timer, timeout);
+
+        /* Delete every eighth timer and modify every fifth one. */
+
+        if (i % 8 == 1) {
+            nxt_timer_delete(engine, &item->timer);
+            item->fired = 1;
+
+        } else if (i % 5 == 2 && timeout != 0) {
+            nxt_timer_test_run(engine, &wq, now);
+
+            item->expected = now + timeout / 2;
+            nxt_timer_add(engine, &item->timer, timeout / 2);
+        }
+    }
+
+    end = now + NXT_TIMER_TEST_RANGE + NXT_TIMER_TEST_RANGE / 7;
+
+    while (nxt_msec_diff(now, end) <= 0) {
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        nxt_timer_test_run(engine, &wq, now);
+
+        now += key % NXT_TIMER_TEST_STEP;
+    }
+
+    nxt_timer_test_run(engine, &wq, now);
+
+    if (nxt_timer_find(engine) != NXT_INFINITE_MSEC) {
+        nxt_log_alert(thr->log, "timer test failed: wheel is not empty");
+        goto fail;
+    }
+
+    fired = 0;
+
+    for (i = 0; i < n; i++) {
+        if (items[i].fired != 1) {
+            nxt_log_alert(thr->log, "timer test failed: timer %ui %M "
+                          "fired %ui times", i, items[i].expected,
+                          items[i].fired);
+            goto fail;
+        }
+
+        fired++;
+    }
+
+    if (nxt_timer_test_errors != 0) {
+        goto fail;
+    }
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log, "timer test passed");
+
+    ret = nxt_timer_test_bench(thr, n, 10 * n);
+
+fail:
+
+    nxt_free(items);
+    nxt_free(engine->timers.changes);
+    nxt_free(engine);
+    nxt_work_queue_cache_destroy(&cache);
+
+    return ret;
+}
+
+
+static nxt_event_engine_t *
+nxt_timer_test_engine(nxt_thread_t *thr, nxt_work_queue_cache_t *cache,
+    nxt_work_queue_t *wq)
+{
+    nxt_event_engine_t  *engine;
+
+    engine = nxt_zalloc(sizeof(nxt_event_engine_t));
+    if (engine == NULL) {
+        return NULL;
+    }
+
+    engine->task.thread = thr;
+    engine->task.log = thr->log;
+
+    if (nxt_timers_init(&engine->timers, 1024) != NXT_OK) {
+        nxt_free(engine);
+        return NULL;
+    }
+
+    engine->timers.now = NXT_TIMER_TEST_START;
+
+    nxt_work_queue_cache_create(cache, 0);
+
+    nxt_memzero(wq, sizeof(nxt_work_queue_t));
+    wq->cache = cache;
+
+    return engine;
+}
+
+
+static void
+nxt_timer_test_run(nxt_event_engine_t *engine, nxt_work_queue_t *wq,
+    nxt_msec_t now)
+{
+    void                *obj, *data;
+    nxt_task_t          *task;
+    nxt_work_handler_t  handler;
+
+    (void) nxt_timer_find(engine);
+
+    nxt_timer_test_now = now;
+
+    nxt_timer_expire(engine, now);
+
+    while (wq->head != NULL) {
+        handler = nxt_work_queue_pop(wq, &task, &obj, &data);
+
+        handler(task, obj, data);
+    }
+}
+
+
+static void
+nxt_timer_test_handler(nxt_task_t *task, void *obj, void *data)
+{
+    int32_t           late;
+    nxt_timer_t       *timer;
+    nxt_timer_test_t  *item;
+
+    timer = obj;
+    item = nxt_timer_data(timer, nxt_timer_test_t, timer);
+
+    item->fired++;
+
+    late = nxt_msec_diff(nxt_timer_test_now, item->expected);
+
+    /*
+     * A timer must not expire early and may expire later at most
+     * by 1/7 of its timeout due to the slot granularity.
+     */
+
+    if (late < 0
+        || late > (int32_t) ((item->expected - NXT_TIMER_TEST_START) / 7
+                             + NXT_TIMER_TEST_STEP))
+    {
+        nxt_log_alert(task->log, "timer test failed: %M expired at %M",
+                      item->expected, nxt_timer_test_now);
+
+        nxt_timer_test_errors++;
+    }
+}
+
+
+static nxt_int_t
+nxt_timer_test_bench(nxt_thread_t *thr, nxt_uint_t n, nxt_uint_t changes)
+{
+    uint32_t                key;
+    nxt_uint_t              i;
+    nxt_msec_t              now;
+    nxt_nsec_t              start, end;
+    nxt_rbtree_t            tree;
+    nxt_work_queue_t        wq;
+    nxt_timer_test_t        *items;
+    nxt_event_engine_t      *engine;
+    nxt_timer_test_node_t   *nodes;
+    nxt_work_queue_cache_t  cache;
+
+    items = nxt_zalloc(n * sizeof(nxt_timer_test_t));
+    if (items == NULL) {
+        return NXT_ERROR;
+    }
+
+    nodes = nxt_zalloc(n * sizeof(nxt_timer_test_node_t));
+    if (nodes == NULL) {
+        nxt_free(items);
+        return NXT_ERROR;
+    }
+
+    engine = nxt_timer_test_engine(thr, &cache, &wq);
+    if (engine == NULL) {
+        nxt_free(nodes);
+        nxt_free(items);
+        return NXT_ERROR;
+    }
+
+    /*
+     * The benchmark emulates idle timers of keepalive connections which
+     * are modified on each request and rarely expire.  Timers are modified
+     * in batches as an event engine does between event polls.
+     */
+
+    nxt_thread_time_update(thr);
+    start = nxt_thread_monotonic_time(thr);
+
+    now = NXT_TIMER_TEST_START;
+    key = 0;
+
+    for (i = 0; i < n; i++) {
+        items[i].timer.work_queue = &wq;
+        items[i].timer.handler = nxt_timer_test_handler;
+        items[i].timer.task = &engine->task;
+
+        nxt_timer_add(engine, &items[i].timer, 60000 + i % 1000);
+    }
+
+    for (i = 0; i < changes; i++) {
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        nxt_timer_add(engine, &items[key % n].timer, 60000 + key % 1000);
+
+        if (i % 256 == 0) {
+            (void) nxt_timer_find(engine);
+
+            now++;
+            engine->timers.now = now;
+        }
+    }
+
+    (void) nxt_timer_find(engine);
+
+    nxt_thread_time_update(thr);
+    end = nxt_thread_monotonic_time(thr);
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log,
+                  "timer wheel bench: %ui timers, %ui changes: %0.3fs",
+                  n, changes, (end - start) / 1000000000.0);
+
+    nxt_rbtree_init(&tree, nxt_timer_test_rbtree_compare);
+
+    nxt_thread_time_update(thr);
+    start = nxt_thread_monotonic_time(thr);
+
+    now = NXT_TIMER_TEST_START;
+    key = 0;
+
+    for (i = 0; i < n; i++) {
+        nodes[i].time = now + 60000 + i % 1000;
+        nxt_rbtree_insert(&tree, &nodes[i].node);
+    }
+
+    for (i = 0; i < changes; i++) {
+        key = nxt_murmur_hash2(&key, sizeof(uint32_t));
+
+        nxt_rbtree_delete(&tree, &nodes[key % n].node);
+        nodes[key % n].time = now + 60000 + key % 1000;
+        nxt_rbtree_insert(&tree, &nodes[key % n].node);
+
+        if (i % 256 == 0) {
+            (void) nxt_rbtree_min(&tree);
+
+            now++;
+        }
+    }
+
+    nxt_thread_time_update(thr);
+    end = nxt_thread_monotonic_time(thr);
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log,
+                  "timer rbtree bench: %ui timers, %ui changes: %0.3fs",
+                  n, changes, (end - start) / 1000000000.0);
+
+    nxt_free(nodes);
+    nxt_free(items);
+    nxt_free(engine->timers.changes);
+    nxt_free(engine);
+    nxt_work_queue_cache_destroy(&cache);
+
+    return NXT_OK;
+}
+
+
+static intptr_t
+nxt_timer_test_rbtree_compare(nxt_rbtree_node_t *node1,
+    nxt_rbtree_node_t *node2)
+{
+    nxt_timer_test_node_t  *item1, *item2;
+
+    item1 = (nxt_timer_test_node_t *) node1;
+    item2 = (nxt_timer_test_node_t *) node2;
+
+    return nxt_msec_diff(item1->time, item2->time);
+}
@@ -9,6 +9,8 @@
 #include <pthread.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <poll.h>
 
 
 #define CONTENT_TYPE  "Content-Type"
@@ -30,15 +32,25 @@
 #define FIELD_SEP     ": "
 #define BODY          "  Body:\n"
 
+#define BODY_MAX      16384
+
 
 static int ready_handler(nxt_unit_ctx_t *ctx);
 static void *worker(void *main_ctx);
+static int add_port(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port);
+static void quit(nxt_unit_ctx_t *ctx);
+static int run_poll(nxt_unit_ctx_t *ctx);
 static void greeting_app_request_handler(nxt_unit_request_info_t *req);
 static inline char *copy(char *p, const void *src, uint32_t len);
 
 
-static int        thread_count;
-static pthread_t  *threads;
+static int              thread_count;
+static pthread_t        *threads;
+
+static int              quit_done;
+static int              nfds;
+static struct pollfd    fds[2];
+static nxt_unit_port_t  *ports[2];
 
 
 int
@@ -48,21 +60,33 @@ main(int argc, char **argv)
     nxt_unit_ctx_t   *ctx;
     nxt_unit_init_t  init;
 
+    memset(&init, 0, sizeof(nxt_unit_init_t));
+
+    init.callbacks.request_handler = greeting_app_request_handler;
+    init.callbacks.ready_handler = ready_handler;
+
     if (argc == 3 && strcmp(argv[1], "-t") == 0) {
         thread_count = atoi(argv[2]);
     }
 
-    memset(&init, 0, sizeof(nxt_unit_init_t));
+    /* The "-p" option runs an own poll() loop over nxt_unit_run_once(). */
 
-    init.callbacks.request_handler = greeting_app_request_handler;
-    init.callbacks.ready_handler = ready_handler;
+    if (argc == 2 && strcmp(argv[1], "-p") == 0) {
+        init.callbacks.add_port = add_port;
+        init.callbacks.quit = quit;
+    }
 
     ctx = nxt_unit_init(&init);
     if (ctx == NULL) {
         return 1;
     }
 
-    err = nxt_unit_run(ctx);
+    if (init.callbacks.add_port != NULL) {
+        err = run_poll(ctx);
+
+    } else {
+        err = nxt_unit_run(ctx);
+    }
 
     nxt_unit_debug(ctx, "main worker finished with %d code", err);
 
@@ -117,6 +141,79 @@ ready_handler(nxt_unit_ctx_t *ctx)
 }
 
 
+static int
+add_port(nxt_unit_ctx_t *ctx, nxt_unit_port_t *port)
+{
+    if (port->in_fd == -1 || nfds == 2) {
+        return NXT_UNIT_OK;
+    }
+
+    nxt_unit_debug(ctx, "add port %d", port->in_fd);
+
+    fds[nfds].fd = port->in_fd;
+    fds[nfds].events = POLLIN;
+    ports[nfds] = port;
+    nfds++;
+
+    return NXT_UNIT_OK;
+}
+
+
+static void
+quit(nxt_unit_ctx_t *ctx)
+{
+    nxt_unit_debug(ctx, "quit");
+
+    quit_done = 1;
+}
+
+
+/*
+ * nxt_unit_run_once() reads the shared port queue but not its socket,
+ * so the shared port is processed explicitly to keep poll() from spinning.
+ */
+
+static int
+run_poll(nxt_unit_ctx_t *ctx)
+{
+    int  i, rc;
+
+    while (!quit_done) {
+        rc = poll(fds, nfds, -1);
+
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            nxt_unit_alert(ctx, "poll() failed: %s (%d)",
+                           strerror(errno), errno);
+
+            return NXT_UNIT_ERROR;
+        }
+
+        for (i = 0; i < nfds; i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+
+            if (ports[i]->id.id == NXT_UNIT_SHARED_PORT_ID) {
+                rc = nxt_unit_process_port_msg(ctx, ports[i]);
+
+            } else {
+                rc = nxt_unit_run_once(ctx);
+            }
+
+            if (rc == NXT_UNIT_ERROR) {
+                return rc;
+            }
+        }
+    }
+
+    return NXT_UNIT_OK;
+}
+
+
 static void *
 worker(void *main_ctx)
 {
@@ -180,8 +277,11 @@ greeting_app_request_handler(nxt_unit_request_info_t *req)
 
     r = req->request;
 
-    buf = nxt_unit_response_buf_alloc(req, (req->request_buf->end
+    /* The preread body fills the request buffer; echo its head only. */
+
+    buf = nxt_unit_response_buf_alloc(req, (req->content_buf->free
                                             - req->request_buf->start)
+                                      + nxt_min(r->content_length, BODY_MAX)
                                       + nxt_length(REQUEST_DATA)
                                       + nxt_length(METHOD)
                                       + nxt_length(NEW_LINE)
@@ -0,0 +1,249 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#include <nxt_main.h>
+#include "nxt_tests.h"
+
+
+typedef struct {
+    nxt_thread_handle_t      handle;
+    nxt_task_t               task;
+    nxt_work_t               *works;
+    nxt_uint_t               n;
+    nxt_uint_t               last;
+    nxt_uint_t               signals;
+    nxt_locked_work_queue_t  *lwq;
+    nxt_atomic_work_queue_t  *awq;
+} nxt_work_queue_test_producer_t;
+
+
+static nxt_int_t nxt_work_queue_test_run(nxt_thread_t *thr,
+    nxt_work_queue_test_producer_t *producers, nxt_uint_t nthreads,
+    nxt_uint_t n, nxt_locked_work_queue_t *lwq, nxt_atomic_work_queue_t *awq);
+static void nxt_work_queue_test_producer(void *data);
+static void nxt_work_queue_test_handler(nxt_task_t *task, void *obj,
+    void *data);
+
+
+static nxt_uint_t  nxt_work_queue_test_errors;
+
+
+nxt_int_t
+nxt_work_queue_test(nxt_thread_t *thr, nxt_uint_t nthreads, nxt_uint_t n)
+{
+    nxt_int_t                       ret;
+    nxt_uint_t                      i;
+    nxt_locked_work_queue_t         lwq;
+    nxt_atomic_work_queue_t         awq;
+    nxt_work_queue_test_producer_t  *producers;
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log,
+                  "work queue test started: %ui threads, %ui works",
+                  nthreads, n);
+
+    producers = nxt_zalloc(nthreads * sizeof(nxt_work_queue_test_producer_t));
+    if (producers == NULL) {
+        return NXT_ERROR;
+    }
+
+    ret = NXT_ERROR;
+
+    for (i = 0; i < nthreads; i++) {
+        producers[i].works = nxt_zalloc(n * sizeof(nxt_work_t));
+        if (producers[i].works == NULL) {
+            goto fail;
+        }
+
+        producers[i].n = n;
+        producers[i].task.log = thr->log;
+    }
+
+    nxt_memzero(&lwq, sizeof(nxt_locked_work_queue_t));
+
+    if (nxt_work_queue_test_run(thr, producers, nthreads, n, &lwq, NULL)
+        != NXT_OK)
+    {
+        goto fail;
+    }
+
+    nxt_memzero(&awq, sizeof(nxt_atomic_work_queue_t));
+
+    if (nxt_work_queue_test_run(thr, producers, nthreads, n, NULL, &awq)
+        != NXT_OK)
+    {
+        goto fail;
+    }
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log, "work queue test passed");
+
+    ret = NXT_OK;
+
+fail:
+
+    for (i = 0; i < nthreads; i++) {
+        nxt_free(producers[i].works);
+    }
+
+    nxt_free(producers);
+
+    return ret;
+}
+
+
+static nxt_int_t
+nxt_work_queue_test_run(nxt_thread_t *thr,
+    nxt_work_queue_test_producer_t *producers, nxt_uint_t nthreads,
+    nxt_uint_t n, nxt_locked_work_queue_t *lwq, nxt_atomic_work_queue_t *awq)
+{
+    void                            *obj, *data;
+    nxt_uint_t                      i, signals;
+    nxt_nsec_t                      start, end;
+    nxt_task_t                      *task;
+    nxt_work_queue_t                wq;
+    nxt_thread_link_t               *link;
+    nxt_work_handler_t              handler;
+    nxt_work_queue_cache_t          cache;
+    nxt_work_queue_test_producer_t  *producer;
+
+    nxt_work_queue_test_errors = 0;
+
+    nxt_work_queue_cache_create(&cache, 0);
+
+    nxt_memzero(&wq, sizeof(nxt_work_queue_t));
+    wq.cache = &cache;
+
+    nxt_thread_time_update(thr);
+    start = nxt_thread_monotonic_time(thr);
+
+    for (i = 0; i < nthreads; i++) {
+        producer = &producers[i];
+
+        producer->last = 0;
+        producer->signals = 0;
+        producer->lwq = lwq;
+        producer->awq = awq;
+
+        link = nxt_zalloc(sizeof(nxt_thread_link_t));
+        if (link == NULL) {
+            return NXT_ERROR;
+        }
+
+        link->start = nxt_work_queue_test_producer;
+        link->work.data = producer;
+
+        if (nxt_thread_create(&producer->handle, link) != NXT_OK) {
+            return NXT_ERROR;
+        }
+    }
+
+    /* The consumer thread. */
+
+    for ( ;; ) {
+        if (lwq != NULL) {
+            nxt_locked_work_queue_move(thr, lwq, &wq);
+
+        } else {
+            nxt_atomic_work_queue_move(thr, awq, &wq);
+        }
+
+        if (wq.head == NULL) {
+
+            for (i = 0; i < nthreads; i++) {
+                if (producers[i].last != n) {
+                    break;
+                }
+            }
+
+            if (i == nthreads) {
+                break;
+            }
+
+            nxt_cpu_pause();
+            continue;
+        }
+
+        while (wq.head != NULL) {
+            handler = nxt_work_queue_pop(&wq, &task, &obj, &data);
+
+            handler(task, obj, data);
+        }
+    }
+
+    nxt_thread_time_update(thr);
+    end = nxt_thread_monotonic_time(thr);
+
+    signals = 0;
+
+    for (i = 0; i < nthreads; i++) {
+        nxt_thread_wait(producers[i].handle);
+
+        signals += producers[i].signals;
+    }
+
+    nxt_work_queue_cache_destroy(&cache);
+
+    if (nxt_work_queue_test_errors != 0) {
+        nxt_log_alert(thr->log, "%s work queue test failed: "
+                      "%ui works out of order",
+                      (lwq != NULL) ? "locked" : "atomic",
+                      nxt_work_queue_test_errors);
+
+        return NXT_ERROR;
+    }
+
+    nxt_log_error(NXT_LOG_NOTICE, thr->log,
+                  "%s work queue bench: %ui works, %ui signals: %0.3fs",
+                  (lwq != NULL) ? "locked" : "atomic", nthreads * n, signals,
+                  (end - start) / 1000000000.0);
+
+    return NXT_OK;
+}
+
+
+static void
+nxt_work_queue_test_producer(void *data)
+{
+    nxt_uint_t                      i;
+    nxt_work_t                      *w;
+    nxt_work_queue_test_producer_t  *producer;
+
+    producer = data;
+
+    for (i = 0; i < producer->n; i++) {
+        w = &producer->works[i];
+
+        nxt_work_set(w, nxt_work_queue_test_handler, &producer->task,
+                     producer, (void *) (uintptr_t) (i + 1));
+
+        /* A producer has to wake up a consumer on each locked queue add. */
+
+        if (producer->lwq != NULL) {
+            nxt_locked_work_queue_add(producer->lwq, w);
+            producer->signals++;
+
+        } else {
+            producer->signals += nxt_atomic_work_queue_add(producer->awq, w);
+        }
+    }
+}
+
+
+static void
+nxt_work_queue_test_handler(nxt_task_t *task, void *obj, void *data)
+{
+    nxt_uint_t                      i;
+    nxt_work_queue_test_producer_t  *producer;
+
+    producer = obj;
+    i = (uintptr_t) data;
+
+    /* Works of a producer must be received in the order they were added. */
+
+    if (i != producer->last + 1) {
+        nxt_work_queue_test_errors++;
+    }
+
+    producer->last = i;
+}
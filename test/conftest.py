@@ -68,6 +68,41 @@ def pytest_addoption(parser):
         action="store_true",
         help="Force Unit to restart after every test",
     )
+    parser.addoption(
+        "--perf",
+        default=False,
+        action="store_true",
+        help="Run performance tests",
+    )
+    parser.addoption(
+        "--perf-baseline",
+        type=str,
+        help="Baseline file to compare performance results against",
+    )
+    parser.addoption(
+        "--perf-save",
+        default=False,
+        action="store_true",
+        help="Save performance results as the new baseline",
+    )
+    parser.addoption(
+        "--perf-tolerance",
+        type=float,
+        default=0.1,
+        help="Allowed relative regression from the baseline",
+    )
+    parser.addoption(
+        "--perf-duration",
+        type=float,
+        default=5,
+        help="Duration of each performance test in seconds",
+    )
+    parser.addoption(
+        "--perf-connections",
+        type=int,
+        default=4,
+        help="Number of concurrent connections in performance tests",
+    )
 
 
 unit_instance = {}
@@ -96,6 +131,12 @@ def pytest_configure(config):
     option.unsafe = config.option.unsafe
     option.user = config.option.user
     option.restart = config.option.restart
+    option.perf = config.option.perf
+    option.perf_baseline = config.option.perf_baseline
+    option.perf_save = config.option.perf_save
+    option.perf_tolerance = config.option.perf_tolerance
+    option.perf_duration = config.option.perf_duration
+    option.perf_connections = config.option.perf_connections
 
     option.generated_tests = {}
     option.current_dir = os.path.abspath(
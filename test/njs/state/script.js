@@ -0,0 +1,9 @@
+var last;
+
+export default {
+    "route": function(headers) {
+        var route = (last === undefined) ? 'clean' : 'stale';
+        last = headers;
+        return route;
+    }
+}
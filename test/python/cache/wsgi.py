@@ -0,0 +1,31 @@
+import time
+from urllib.parse import parse_qs
+
+counter = 0
+
+
+def application(environ, start_response):
+    global counter
+
+    counter += 1
+
+    args = parse_qs(environ['QUERY_STRING'])
+    delay = float(environ.get('HTTP_X_DELAY', 0))
+    size = int(args.get('size', [0])[0])
+
+    body = str(counter).encode() + b'x' * size
+
+    headers = [
+        ('Content-Type', 'text/plain'),
+        ('Content-Length', str(len(body))),
+        ('X-Counter', str(counter)),
+    ]
+
+    for name in ('Cache-Control', 'Expires', 'Vary', 'Set-Cookie'):
+        if name in args:
+            headers.append((name, args[name][0]))
+
+    time.sleep(delay)
+
+    start_response(args.get('status', ['200'])[0], headers)
+    return [body]
@@ -0,0 +1,15 @@
+async def application(scope, receive, send):
+    assert scope['type'] == 'http'
+
+    while True:
+        m = await receive()
+        if not m.get('more_body', False):
+            break
+
+    m = await receive()
+
+    with open(scope['query_string'].decode(), 'w') as f:
+        f.write(m['type'])
+
+    await send({'type': 'http.response.start', 'status': 200, 'headers': []})
+    await send({'type': 'http.response.body', 'body': b''})
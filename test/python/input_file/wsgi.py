@@ -0,0 +1,43 @@
+from tempfile import TemporaryFile
+
+
+def application(environ, start_response):
+    stream = environ['wsgi.input']
+    mode = environ.get('HTTP_X_MODE', 'buffer')
+    headers = []
+
+    prefix = stream.readline() if 'HTTP_X_READLINE' in environ else b''
+
+    if mode == 'buffer':
+        view = stream.getbuffer()
+
+        if view is None:
+            headers.append(('X-Mapped', 'no'))
+            body = stream.read()
+
+        else:
+            headers.append(('X-Mapped', 'yes'))
+            body = view.tobytes()
+
+            if 'HTTP_X_READ' in environ:
+                body += stream.read()
+
+    else:
+        size = int(environ.get('HTTP_X_SIZE', -1))
+
+        with TemporaryFile() as f:
+            f.write(prefix)
+            prefix = b''
+
+            dst = f.fileno() if mode == 'fd' else f
+            headers.append(('X-Copied', str(stream.copy_to(dst, size))))
+
+            f.seek(0)
+            body = f.read() + stream.read()
+
+    body = prefix + body
+
+    start_response(
+        '200', headers + [('Content-Length', str(len(body)))]
+    )
+    return [body]
@@ -0,0 +1,17 @@
+async def application(scope, receive, send):
+    assert scope['type'] == 'http'
+
+    body = b'Hello World\n'
+
+    await send(
+        {
+            'type': 'http.response.start',
+            'status': 200,
+            'headers': [
+                (b'content-type', b'text/plain'),
+                (b'content-length', str(len(body)).encode()),
+            ],
+        }
+    )
+
+    await send({'type': 'http.response.body', 'body': body})
@@ -0,0 +1,8 @@
+def application(env, start_response):
+    body = b'Hello World\n'
+
+    start_response(
+        '200',
+        [('Content-Type', 'text/plain'), ('Content-Length', str(len(body)))],
+    )
+    return [body]
@@ -0,0 +1,10 @@
+import os
+
+loaded_pid = os.getpid()
+
+
+def application(environ, start_response):
+    body = f'{loaded_pid} {os.getpid()}'.encode()
+
+    start_response('200', [('Content-Length', str(len(body)))])
+    return [body]
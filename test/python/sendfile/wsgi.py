@@ -0,0 +1,14 @@
+from urllib.parse import parse_qs
+
+
+def application(environ, start_response):
+    args = parse_qs(environ['QUERY_STRING'])
+
+    headers = [('Content-Length', '8'), ('X-Application', 'sendfile')]
+
+    for name in ('X-Sendfile', 'Content-Type', 'Content-Disposition'):
+        if name in args:
+            headers.append((name, args[name][0]))
+
+    start_response('200', headers)
+    return [b'app body']
@@ -1,9 +1,11 @@
+import os
 import re
 import time
 
 import pytest
 from packaging import version
 from unit.applications.lang.python import ApplicationPython
+from unit.utils import waitforfiles
 
 prerequisites = {
     'modules': {'python': lambda v: version.parse(v) >= version.parse('3.5')}
@@ -388,6 +390,50 @@ def test_asgi_process_switch():
     client.get(headers=headers_delay_1)
 
 
+def test_asgi_application_disconnect(temp_dir):
+    client.load('disconnect')
+
+    path = f'{temp_dir}/disconnect'
+
+    sock = client.get(url=f'/?{path}', no_recv=True)
+
+    time.sleep(0.5)
+
+    assert not os.path.exists(path), 'no disconnect while connected'
+
+    sock.close()
+
+    assert waitforfiles(path), 'disconnect received'
+
+    with open(path) as f:
+        assert f.read() == 'http.disconnect', 'disconnect message'
+
+
+def test_asgi_application_ignore_client_abort(temp_dir):
+    client.load('disconnect')
+
+    assert 'error' in client.conf(
+        '"yes"', 'applications/disconnect/ignore_client_abort'
+    ), 'ignore_client_abort invalid'
+    assert 'success' in client.conf(
+        'true', 'applications/disconnect/ignore_client_abort'
+    )
+    assert 'success' in client.conf(
+        {"timeout": 2}, 'applications/disconnect/limits'
+    )
+
+    path = f'{temp_dir}/disconnect'
+
+    sock = client.get(url=f'/?{path}', no_recv=True)
+    sock.close()
+
+    time.sleep(1)
+
+    assert not os.path.exists(path), 'no disconnect'
+
+    assert waitforfiles(path), 'request timeout'
+
+
 def test_asgi_application_loading_error(skip_alert):
     skip_alert(r'Python failed to import module "blah"')
 
@@ -403,13 +449,15 @@ def test_asgi_application_threading(wait_for_record):
 
     client.load('threading')
 
-    for _ in range(10):
-        client.get(no_recv=True)
+    socks = [client.get(no_recv=True) for _ in range(10)]
 
     assert (
         wait_for_record(r'\(5\) Thread: 100', wait=50) is not None
     ), 'last thread finished'
 
+    for sock in socks:
+        sock.close()
+
 
 def test_asgi_application_threads():
     client.load('threads', threads=2)
@@ -0,0 +1,427 @@
+import time
+from urllib.parse import quote
+
+import pytest
+from unit.applications.lang.python import ApplicationPython
+from unit.option import option
+
+prerequisites = {'modules': {'python': 'any'}}
+
+client = ApplicationPython()
+
+
+@pytest.fixture(autouse=True)
+def setup_method_fixture():
+    python_dir = f'{option.test_dir}/python'
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {
+                "*:7080": {"pass": "routes"},
+                "*:7081": {"pass": "applications/cache"},
+            },
+            "routes": [
+                {
+                    "match": {"uri": "/proxy/*"},
+                    "action": {
+                        "proxy": "http://127.0.0.1:7081",
+                        "cache": {},
+                        "response_headers": {"X-Cache": "$cache_status"},
+                    },
+                },
+                {
+                    "action": {
+                        "pass": "applications/cache",
+                        "cache": {},
+                        "response_headers": {"X-Cache": "$cache_status"},
+                    }
+                },
+            ],
+            "applications": {
+                "cache": {
+                    "type": client.get_application_type(),
+                    "processes": 1,
+                    "path": f'{python_dir}/cache',
+                    "working_directory": f'{python_dir}/cache',
+                    "module": "wsgi",
+                }
+            },
+        }
+    ), 'cache configuration'
+
+
+def set_cache(cache):
+    assert 'success' in client.conf(cache, 'routes/1/action/cache')
+
+
+def get(url, **kwargs):
+    resp = client.get(url=url, **kwargs)
+
+    assert resp['status'] == 200, 'status'
+
+    return resp
+
+
+def url_cc(path, value, **args):
+    url = f'{path}?Cache-Control={quote(value)}'
+
+    for name, arg in args.items():
+        url += f'&{name.replace("_", "-")}={quote(arg)}'
+
+    return url
+
+
+def test_cache_hit():
+    url = url_cc('/hit', 'public, max-age=60')
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'MISS', 'miss'
+    counter = resp['headers']['X-Counter']
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'HIT', 'hit'
+    assert resp['headers']['X-Counter'] == counter, 'hit counter'
+    assert resp['body'] == counter, 'hit body'
+    assert resp['headers']['Content-Type'] == 'text/plain', 'content type'
+    assert resp['headers']['Content-Length'] == str(len(counter)), 'length'
+    assert 'Age' in resp['headers'], 'age'
+    assert 'Date' in resp['headers'], 'date'
+
+    resp = get(url_cc('/hit', 'public, max-age=60', a='b'))
+    assert resp['headers']['X-Cache'] == 'MISS', 'other key'
+
+
+def test_cache_s_maxage():
+    url = url_cc('/', 'max-age=0, s-maxage=60')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'HIT', 's-maxage'
+
+
+def test_cache_not_cacheable():
+    for value in ['no-store', 'no-cache', 'private, max-age=60', 'public']:
+        url = url_cc('/', value)
+
+        assert get(url)['headers']['X-Cache'] == 'MISS', value
+        assert get(url)['headers']['X-Cache'] == 'MISS', value
+
+    url = '/?Set-Cookie=a%3Db&Cache-Control=max-age%3D60'
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'MISS', 'set-cookie'
+
+    url = '/?Cache-Control=max-age%3D60&status=500'
+
+    counter = client.get(url=url)['headers']['X-Counter']
+    assert client.get(url=url)['headers']['X-Counter'] != counter, 'status'
+
+
+def test_cache_expires():
+    expires = time.strftime(
+        '%a, %d %b %Y %H:%M:%S GMT', time.gmtime(time.time() + 60)
+    )
+
+    url = f'/?Expires={quote(expires)}'
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'HIT', 'expires'
+
+    url = '/?Expires=Thu%2C%2001%20Jan%201970%2000%3A00%3A00%20GMT'
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'MISS', 'expired'
+
+
+def test_cache_expired():
+    url = url_cc('/', 'max-age=1')
+
+    counter = get(url)['headers']['X-Counter']
+    assert get(url)['headers']['X-Counter'] == counter, 'fresh'
+
+    time.sleep(2)
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'EXPIRED', 'expired'
+    assert resp['headers']['X-Counter'] != counter, 'expired counter'
+
+
+def test_cache_bypass():
+    url = url_cc('/', 'max-age=60')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+
+    headers = {'Host': 'localhost', 'Connection': 'close'}
+
+    resp = get(url, headers=dict(headers, Cookie='a=b'))
+    assert resp['headers']['X-Cache'] == 'BYPASS', 'cookie'
+
+    resp = get(url, headers=dict(headers, Authorization='Basic dTpw'))
+    assert resp['headers']['X-Cache'] == 'BYPASS', 'authorization'
+
+    resp = client.post(url=url, body='')
+    assert resp['headers']['X-Cache'] == 'BYPASS', 'post'
+
+    assert get(url)['headers']['X-Cache'] == 'HIT', 'hit'
+
+
+def test_cache_key():
+    set_cache({"key": "$uri"})
+
+    url = url_cc('/key', 'max-age=60')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(f'{url}&a=b')['headers']['X-Cache'] == 'HIT', 'key'
+    assert get(url_cc('/key2', 'max-age=60'))['headers']['X-Cache'] == 'MISS'
+
+
+def test_cache_vary():
+    url = url_cc('/', 'max-age=60', Vary='Accept')
+
+    def accept(value):
+        return get(
+            url,
+            headers={
+                'Host': 'localhost',
+                'Accept': value,
+                'Connection': 'close',
+            },
+        )['headers']['X-Cache']
+
+    assert accept('text/html') == 'MISS'
+    assert accept('text/html') == 'HIT'
+    assert accept('text/plain') == 'MISS', 'vary miss'
+    assert accept('text/plain') == 'HIT', 'vary replaced'
+    assert accept('text/html') == 'MISS', 'vary replaced miss'
+
+    url = url_cc('/', 'max-age=60', Vary='*')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'MISS', 'vary star'
+
+
+def test_cache_stale_while_revalidate():
+    set_cache({"key": "$uri"})
+
+    url = url_cc('/swr', 'max-age=1, stale-while-revalidate=30')
+
+    counter = get(url)['headers']['X-Counter']
+
+    time.sleep(2)
+
+    sock = client.get(
+        url=url,
+        headers={'Host': 'localhost', 'X-Delay': '2', 'Connection': 'close'},
+        no_recv=True,
+    )
+
+    time.sleep(0.5)
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'UPDATING', 'updating'
+    assert resp['headers']['X-Counter'] == counter, 'stale'
+
+    resp = client._resp_to_dict(client.recvall(sock).decode())
+    sock.close()
+
+    assert resp['headers']['X-Cache'] == 'EXPIRED', 'revalidated'
+    assert resp['headers']['X-Counter'] != counter, 'revalidated counter'
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'HIT', 'refreshed'
+    assert resp['headers']['X-Counter'] != counter, 'refreshed counter'
+
+
+def test_cache_stale_while_revalidate_conf():
+    set_cache({"stale_while_revalidate": 30})
+
+    url = url_cc('/', 'max-age=1')
+
+    get(url)
+
+    time.sleep(2)
+
+    assert get(url)['headers']['X-Cache'] == 'EXPIRED'
+    assert get(url)['headers']['X-Cache'] == 'HIT', 'refreshed'
+
+
+def collapse(url, waiters=3, headers=None):
+    headers = {} if headers is None else headers
+
+    socks = [
+        client.get(
+            url=url,
+            headers={'Host': 'localhost', 'X-Delay': '1', 'Connection': 'close'},
+            no_recv=True,
+        )
+    ]
+
+    time.sleep(0.3)
+
+    for _ in range(waiters):
+        socks.append(
+            client.get(
+                url=url,
+                headers=dict(
+                    {'Host': 'localhost', 'Connection': 'close'}, **headers
+                ),
+                no_recv=True,
+            )
+        )
+
+    resps = []
+
+    for sock in socks:
+        resps.append(client._resp_to_dict(client.recvall(sock).decode()))
+        sock.close()
+
+    return resps
+
+
+def test_cache_collapse():
+    set_cache({"collapse": "all"})
+
+    url = url_cc('/collapse', 'max-age=60')
+
+    resps = collapse(url)
+
+    assert resps[0]['headers']['X-Cache'] == 'MISS', 'first'
+    counter = resps[0]['headers']['X-Counter']
+
+    for resp in resps[1:]:
+        assert resp['status'] == 200, 'status'
+        assert resp['headers']['X-Cache'] == 'COLLAPSED', 'collapsed'
+        assert resp['headers']['X-Counter'] == counter, 'collapsed counter'
+        assert resp['body'] == counter, 'collapsed body'
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'HIT', 'hit'
+    assert resp['headers']['X-Counter'] == counter, 'hit counter'
+
+
+def test_cache_collapse_not_stored():
+    set_cache({"collapse": "all"})
+
+    resps = collapse('/collapse')
+
+    counter = resps[0]['headers']['X-Counter']
+
+    for resp in resps[1:]:
+        assert resp['headers']['X-Cache'] == 'COLLAPSED', 'collapsed'
+        assert resp['headers']['X-Counter'] == counter, 'collapsed counter'
+
+    resp = get('/collapse')
+    assert resp['headers']['X-Cache'] == 'MISS', 'not stored'
+    assert resp['headers']['X-Counter'] != counter, 'not stored counter'
+
+
+def test_cache_collapse_private():
+    set_cache({"collapse": "all"})
+
+    resps = collapse(url_cc('/collapse', 'private'))
+
+    counters = {resp['headers']['X-Counter'] for resp in resps}
+    assert len(counters) == len(resps), 'private'
+
+    for resp in resps:
+        assert resp['headers']['X-Cache'] == 'MISS', 'private miss'
+
+    resps = collapse('/collapse?Set-Cookie=a%3Db')
+
+    counters = {resp['headers']['X-Counter'] for resp in resps}
+    assert len(counters) == len(resps), 'set-cookie'
+
+
+def test_cache_collapse_vary():
+    set_cache({"collapse": "all"})
+
+    url = url_cc('/collapse', 'max-age=60', Vary='Accept')
+
+    resps = collapse(url, waiters=1, headers={'Accept': 'text/plain'})
+
+    assert resps[1]['headers']['X-Cache'] == 'MISS', 'vary'
+    assert (
+        resps[1]['headers']['X-Counter'] != resps[0]['headers']['X-Counter']
+    ), 'vary counter'
+
+
+def test_cache_proxy():
+    url = url_cc('/proxy/', 'max-age=60')
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'MISS'
+    counter = resp['headers']['X-Counter']
+
+    resp = get(url)
+    assert resp['headers']['X-Cache'] == 'HIT', 'proxy hit'
+    assert resp['body'] == counter, 'proxy body'
+
+
+def test_cache_scope():
+    assert 'success' in client.conf(
+        {
+            "match": {"uri": "/scope"},
+            "action": {
+                "proxy": "http://127.0.0.1:7081",
+                "cache": {"key": "$uri"},
+                "response_headers": {"X-Cache": "$cache_status"},
+            },
+        },
+        'routes/0',
+    )
+    set_cache({"key": "$uri"})
+
+    url = url_cc('/scope', 'max-age=60')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'HIT'
+
+    assert 'success' in client.conf_delete('routes/0')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS', 'other action'
+    assert get(url)['headers']['X-Cache'] == 'HIT'
+
+
+def test_cache_size():
+    assert 'success' in client.conf(
+        {"http": {"cache": {"max_entry_size": 100}}}, 'settings'
+    )
+
+    url = url_cc('/', 'max-age=60', size='200')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'MISS', 'max entry size'
+
+    url = url_cc('/', 'max-age=60', size='10')
+
+    assert get(url)['headers']['X-Cache'] == 'MISS'
+    assert get(url)['headers']['X-Cache'] == 'HIT', 'small entry'
+
+    assert 'success' in client.conf({"size": 0}, 'settings/http/cache')
+
+    assert get(url)['headers']['X-Cache'] == 'BYPASS', 'disabled'
+
+
+def test_cache_configuration():
+    assert 'error' in client.conf('"x"', 'routes/1/action/cache')
+    assert 'error' in client.conf({"key": 1}, 'routes/1/action/cache')
+    assert 'error' in client.conf({"unknown": 1}, 'routes/1/action/cache')
+    assert 'error' in client.conf({"collapse": 1}, 'routes/1/action/cache')
+    assert 'error' in client.conf(
+        {"stale_while_revalidate": -1}, 'routes/1/action/cache'
+    )
+    assert 'error' in client.conf(
+        {"stale_while_revalidate": 2147483648}, 'routes/1/action/cache'
+    )
+    assert 'error' in client.conf({"size": -1}, 'settings/http/cache')
+    assert 'error' in client.conf(
+        {"max_entry_size": -1}, 'settings/http/cache'
+    )
+    assert 'error' in client.conf(
+        {"collapse": "engine"}, 'routes/1/action/cache'
+    )
+    assert 'success' in client.conf(
+        {"collapse": "thread"}, 'routes/1/action/cache'
+    )
+    assert 'error' in client.conf(
+        {"return": 200, "cache": {}}, 'routes/1/action'
+    ), 'return'
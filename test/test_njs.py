@@ -48,6 +48,51 @@ def test_njs_template_string(temp_dir):
     assert client.get()['status'] == 200
 
 
+def test_njs_template_literal(temp_dir):
+    create_files('$uri')
+
+    set_share(f'"`{temp_dir}/assets/$uri`"')
+    assert client.get(url='/str')['status'] == 200, 'dollar is literal'
+
+
+def test_njs_vm_reuse(temp_dir):
+    create_files('a', 'b')
+
+    set_share(f'"`{temp_dir}/assets${{uri}}`"')
+
+    for _ in range(100):
+        assert client.get(url='/a')['status'] == 200
+        assert client.get(url='/b')['status'] == 200
+        assert client.get(url='/c')['status'] == 404
+
+
+def test_njs_vm_reuse_request_objects(temp_dir):
+    create_files('stored', 'undefined')
+
+    assert 'success' in client.conf(
+        [
+            {
+                "match": {"uri": "/store"},
+                "action": {
+                    "share": f"`{temp_dir}/assets/"
+                    "${globalThis.h = headers, 'stored'}`"
+                },
+            },
+            {
+                "action": {
+                    "share": f"`{temp_dir}/assets/"
+                    "${globalThis.h ? globalThis.h.Host : 'undefined'}`"
+                }
+            },
+        ],
+        'routes',
+    )
+
+    for _ in range(10):
+        assert client.get(url='/store')['status'] == 200, 'store'
+        assert client.get()['status'] == 200, 'released request'
+
+
 def test_njs_template_expression():
     create_files('str', 'localhost')
 
@@ -98,6 +98,27 @@ def test_njs_modules_this():
     assert client.get()['status'] == 200
 
 
+def test_njs_modules_state():
+    njs_script_load('state')
+
+    assert 'success' in client.conf(
+        {
+            "settings": {"js_module": "state"},
+            "listeners": {"*:7080": {"pass": "routes/first"}},
+            "routes": {
+                "first": [
+                    {"action": {"pass": "`routes/${state.route(headers)}`"}}
+                ],
+                "clean": [{"action": {"return": 200}}],
+                "stale": [{"action": {"return": 500}}],
+            },
+        }
+    )
+
+    for _ in range(5):
+        assert client.get()['status'] == 200, 'module state per request'
+
+
 def test_njs_modules_invalid(skip_alert):
     skip_alert(r'.*JS compile module.*failed.*')
 
@@ -0,0 +1,149 @@
+import os
+
+import pytest
+from unit.applications.lang.node import ApplicationNode
+from unit.applications.lang.php import ApplicationPHP
+from unit.applications.lang.python import ApplicationPython
+from unit.applications.proto import ApplicationProto
+from unit.option import option
+from unit.perf import Perf
+
+client = ApplicationProto()
+perf = Perf()
+
+# Performance tests are run only on demand:
+#
+#   pytest test_perf.py --perf [--perf-baseline=FILE [--perf-save]]
+#
+# Every scenario is measured over keepalive and non-keepalive connections.
+# With a baseline file each result is compared against the stored one and
+# the test fails if it regressed by more than --perf-tolerance; --perf-save
+# writes the results to the baseline file instead.  Baselines depend on the
+# machine and the build, so none is stored in the tree.
+
+
+@pytest.fixture(autouse=True)
+def setup_method_fixture():
+    if not option.perf:
+        pytest.skip('performance tests are run with --perf')
+
+
+@pytest.fixture(params=['keepalive', 'close'])
+def measure(request):
+    keepalive = request.param == 'keepalive'
+
+    def _measure(name, url='/'):
+        name = f'{name}_{request.param}'
+        result = perf.run(url=url, keepalive=keepalive)
+
+        print(
+            f'\n{name}: {result["rps"]} req/s, '
+            f'p50 {result["p50"]}ms, p99 {result["p99"]}ms, '
+            f'p999 {result["p999"]}ms, {result["errors"]} errors'
+        )
+
+        assert result['requests'] > 0, 'requests'
+        assert result['errors'] == 0, 'errors'
+
+        path = option.perf_baseline
+
+        if path is None:
+            return
+
+        if option.perf_save:
+            Perf.save_baseline(path, name, result)
+            return
+
+        baseline = Perf.load_baseline(path).get(name)
+
+        if baseline is None:
+            pytest.skip(f'no baseline for {name}')
+
+        regressions = Perf.compare(baseline, result, option.perf_tolerance)
+        assert not regressions, f'{name}: {", ".join(regressions)}'
+
+    return _measure
+
+
+def test_perf_return(measure):
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "routes"}},
+            "routes": [{"action": {"return": 200}}],
+            "applications": {},
+        }
+    )
+
+    measure('return')
+
+
+def test_perf_static(measure, temp_dir):
+    os.makedirs(f'{temp_dir}/assets')
+
+    with open(f'{temp_dir}/assets/index.html', 'w') as index:
+        index.write('0123456789' * 100)
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "routes"}},
+            "routes": [{"action": {"share": f'{temp_dir}/assets$uri'}}],
+            "applications": {},
+        }
+    )
+
+    measure('static', '/index.html')
+
+
+def test_perf_proxy(measure, temp_dir):
+    os.makedirs(f'{temp_dir}/assets')
+
+    with open(f'{temp_dir}/assets/index.html', 'w') as index:
+        index.write('0123456789' * 100)
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {
+                "*:7080": {"pass": "routes/proxy"},
+                "127.0.0.1:7081": {"pass": "routes/static"},
+            },
+            "routes": {
+                "proxy": [{"action": {"proxy": "http://127.0.0.1:7081"}}],
+                "static": [{"action": {"share": f'{temp_dir}/assets$uri'}}],
+            },
+            "applications": {},
+        }
+    )
+
+    measure('proxy', '/index.html')
+
+
+def test_perf_wsgi(measure, require):
+    require({'modules': {'python': 'any'}})
+
+    ApplicationPython().load('perf', processes=1)
+
+    measure('wsgi')
+
+
+def test_perf_asgi(measure, require):
+    require({'modules': {'python': 'any'}})
+
+    ApplicationPython(load_module='asgi').load('perf', processes=1)
+
+    measure('asgi')
+
+
+def test_perf_php(measure, require):
+    require({'modules': {'php': 'any'}})
+
+    ApplicationPHP().load('perf', processes=1)
+
+    measure('php')
+
+
+def test_perf_node(measure, require):
+    require({'modules': {'node': 'any'}})
+
+    ApplicationNode().load('basic', processes=1)
+
+    measure('node')
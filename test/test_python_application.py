@@ -636,13 +636,37 @@ def test_python_application_threading(wait_for_record):
 
     client.load('threading')
 
-    for _ in range(10):
-        client.get(no_recv=True)
+    socks = [client.get(no_recv=True) for _ in range(10)]
 
     assert (
         wait_for_record(r'\(5\) Thread: 100', wait=50) is not None
     ), 'last thread finished'
 
+    for sock in socks:
+        sock.close()
+
+
+def test_python_application_preload():
+    client.load('preload', processes=2)
+
+    pids = client.get()['body'].split()
+    assert pids[0] == pids[1], 'no preload'
+
+    client.load('preload', processes=2, preload=True)
+
+    prototypes = set()
+
+    for _ in range(10):
+        loaded, worker = client.get(
+            headers={'Host': 'localhost', 'Connection': 'close'}
+        )['body'].split()
+
+        assert loaded != worker, 'preloaded in prototype'
+        prototypes.add(loaded)
+
+    assert len(prototypes) == 1, 'loaded once'
+    assert 'error' in client.conf('"yes"', 'applications/preload/preload')
+
 
 def test_python_application_iter_exception(findall, wait_for_record):
     client.load('iter_exception')
@@ -896,6 +920,21 @@ def test_python_application_path_invalid():
     check_path('["/blah", []]')
 
 
+def test_python_application_busy_poll():
+    client.load('mirror', limits={'busy_poll': 1000}, threads=2)
+
+    for i in range(50):
+        body = f'request {i}'
+        assert client.post(body=body)['body'] == body, 'busy poll'
+
+    assert 'error' in client.conf(
+        '-1', 'applications/mirror/limits/busy_poll'
+    ), 'busy poll negative'
+    assert 'error' in client.conf(
+        '100001', 'applications/mirror/limits/busy_poll'
+    ), 'busy poll too large'
+
+
 def test_python_application_threads():
     client.load('threads', threads=4)
 
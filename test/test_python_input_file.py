@@ -0,0 +1,80 @@
+import pytest
+from unit.applications.lang.python import ApplicationPython
+
+prerequisites = {'modules': {'python': 'any'}}
+
+client = ApplicationPython()
+
+
+@pytest.fixture(autouse=True)
+def setup_method_fixture():
+    client.load('input_file')
+
+    assert 'success' in client.conf(
+        {'http': {'body_buffer_size': 1024}}, 'settings'
+    )
+
+
+def post(body, **headers):
+    return client.post(
+        headers={
+            'Host': 'localhost',
+            'Content-Type': 'text/html',
+            'Connection': 'close',
+            **headers,
+        },
+        body=body,
+        read_buffer_size=1024 * 1024,
+    )
+
+
+def test_python_input_file_buffer():
+    body = '0123456789abcdef' * 64 * 1024
+
+    resp = post(body)
+    assert resp['headers']['X-Mapped'] == 'yes', 'mapped'
+    assert resp['body'] == body, 'body'
+
+    resp = post(body, **{'X-Read': '1'})
+    assert resp['body'] == body * 2, 'map does not consume body'
+
+
+def test_python_input_file_buffer_memory():
+    resp = post('0123456789')
+    assert resp['headers']['X-Mapped'] == 'no', 'in memory'
+    assert resp['body'] == '0123456789', 'body'
+
+
+def test_python_input_file_buffer_readline():
+    body = 'first\n' + 'x' * 40000
+
+    resp = post(body, **{'X-Readline': '1'})
+    assert resp['headers']['X-Mapped'] == 'yes', 'mapped'
+    assert resp['body'] == body, 'rest after readline'
+
+
+@pytest.mark.parametrize('mode', ['file', 'fd'])
+def test_python_input_file_copy(mode):
+    body = '0123456789abcdef' * 64 * 1024
+
+    resp = post(body, **{'X-Mode': mode})
+    assert resp['headers']['X-Copied'] == str(len(body)), 'copied'
+    assert resp['body'] == body, 'body'
+
+    resp = post(body, **{'X-Mode': mode, 'X-Size': '100'})
+    assert resp['headers']['X-Copied'] == '100', 'copied part'
+    assert resp['body'] == body, 'body rest'
+
+
+def test_python_input_file_copy_memory():
+    resp = post('0123456789', **{'X-Mode': 'file', 'X-Size': '4'})
+    assert resp['headers']['X-Copied'] == '4', 'copied'
+    assert resp['body'] == '0123456789', 'body'
+
+
+def test_python_input_file_copy_readline():
+    body = 'first\n' + 'x' * 40000
+
+    resp = post(body, **{'X-Mode': 'file', 'X-Readline': '1'})
+    assert resp['headers']['X-Copied'] == str(len(body) - 6), 'copied'
+    assert resp['body'] == body, 'body'
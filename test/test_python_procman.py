@@ -192,6 +192,87 @@ def test_python_processes_connection_keepalive():
     sock.close()
 
 
+def test_python_restart_rolling():
+    client.load(
+        'restart',
+        name=client.app_name,
+        module="longstart",
+        processes=2,
+        restart={"mode": "rolling", "drain_timeout": 10},
+    )
+
+    pids = pids_for_process()
+    assert len(pids) == 2, 'rolling started'
+
+    assert 'success' in client.conf_get(
+        f'/control/applications/{client.app_name}/restart'
+    ), 'restart processes'
+
+    assert 'error' in client.conf_get(
+        f'/control/applications/{client.app_name}/restart'
+    ), 'restart in progress'
+
+    # Replacements load for 2 seconds; old processes keep serving.
+
+    start = time.time()
+    resp = client.get()
+    assert time.time() - start < 1, 'no stall'
+    assert resp['body'] in pids, 'served by old process'
+
+    for _ in range(50):
+        new_pids = pids_for_process()
+        if len(new_pids) == 2 and not new_pids & pids:
+            break
+
+        time.sleep(0.1)
+
+    assert len(new_pids) == 2, 'rolling still 2'
+    assert len(new_pids & pids) == 0, 'rolling all new'
+    assert client.get()['body'] in new_pids, 'served by new process'
+
+
+def test_python_restart_rolling_drain():
+    client.load(
+        'delayed',
+        name=client.app_name,
+        module='asgi',
+        processes=1,
+        restart={"mode": "rolling", "drain_timeout": 10},
+    )
+
+    sock = client.get(
+        headers={'Host': 'localhost', 'X-Delay': '2', 'Connection': 'close'},
+        no_recv=True,
+    )
+
+    time.sleep(0.5)
+
+    assert 'success' in client.conf_get(
+        f'/control/applications/{client.app_name}/restart'
+    ), 'restart processes'
+
+    assert client.get()['status'] == 200, 'new request'
+
+    resp = client._resp_to_dict(client.recvall(sock).decode())
+    sock.close()
+
+    assert resp['status'] == 200, 'in-flight request finished'
+
+
+def test_python_restart_rolling_invalid():
+    def check_restart(restart):
+        return client.conf(restart, f'applications/{client.app_name}/restart')
+
+    assert 'success' in check_restart({"mode": "immediate"})
+    assert 'success' in check_restart(
+        {"mode": "rolling", "batch": 2, "drain_timeout": 0}
+    )
+    assert 'error' in check_restart({"mode": "blue-green"})
+    assert 'error' in check_restart({"batch": 0})
+    assert 'error' in check_restart({"drain_timeout": -1})
+    assert 'error' in check_restart({"timeout": 1})
+
+
 def test_python_processes_access():
     conf_proc('1')
 
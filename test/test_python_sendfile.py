@@ -0,0 +1,120 @@
+import os
+from pathlib import Path
+from urllib.parse import quote
+
+import pytest
+from unit.applications.lang.python import ApplicationPython
+
+prerequisites = {'modules': {'python': 'any'}}
+
+client = ApplicationPython()
+
+
+@pytest.fixture(autouse=True)
+def setup_method_fixture(temp_dir):
+    os.makedirs(f'{temp_dir}/files/dir')
+    Path(f'{temp_dir}/files/file.txt').write_text('0123456789')
+    Path(f'{temp_dir}/files/dir/file.bin').write_text('blah')
+    Path(f'{temp_dir}/secret.txt').write_text('secret')
+
+    client.load('sendfile')
+
+    assert 'success' in client.conf(
+        f'"{temp_dir}/files"', 'applications/sendfile/sendfile_root'
+    )
+
+
+def get_file(path, **args):
+    url = f'/?X-Sendfile={quote(path)}'
+
+    for name, arg in args.items():
+        url += f'&{name.replace("_", "-")}={quote(arg)}'
+
+    return client.get(url=url)
+
+
+def test_python_sendfile(temp_dir):
+    resp = get_file(f'{temp_dir}/files/file.txt')
+    assert resp['status'] == 200, 'status'
+    assert resp['body'] == '0123456789', 'body'
+    assert resp['headers']['Content-Length'] == '10', 'length'
+    assert resp['headers']['Content-Type'] == 'text/plain', 'type'
+    assert resp['headers']['X-Application'] == 'sendfile', 'app field'
+    assert 'ETag' in resp['headers'], 'etag'
+    assert 'Last-Modified' in resp['headers'], 'last modified'
+    assert 'X-Sendfile' not in resp['headers'], 'x-sendfile'
+
+    resp = get_file('dir/file.bin')
+    assert resp['status'] == 200, 'relative status'
+    assert resp['body'] == 'blah', 'relative body'
+
+
+def test_python_sendfile_fields():
+    resp = get_file(
+        'file.txt',
+        Content_Type='application/octet-stream',
+        Content_Disposition='attachment; filename="file.txt"',
+    )
+    assert resp['body'] == '0123456789', 'body'
+    assert resp['headers']['Content-Type'] == 'application/octet-stream'
+    assert (
+        resp['headers']['Content-Disposition']
+        == 'attachment; filename="file.txt"'
+    ), 'disposition'
+
+
+def test_python_sendfile_head():
+    resp = client.head(url='/?X-Sendfile=file.txt')
+    assert resp['status'] == 200, 'status'
+    assert resp['headers']['Content-Length'] == '10', 'length'
+    assert resp['body'] == '', 'body'
+
+
+def test_python_sendfile_keepalive():
+    (resp, sock) = client.get(
+        url='/?X-Sendfile=file.txt',
+        headers={'Host': 'localhost', 'Connection': 'keep-alive'},
+        start=True,
+        read_timeout=1,
+    )
+    assert resp['body'] == '0123456789', 'first'
+
+    resp = client.get(url='/?X-Sendfile=dir/file.bin', sock=sock)
+    assert resp['body'] == 'blah', 'second'
+
+
+def test_python_sendfile_not_found(temp_dir):
+    assert get_file('missing')['status'] == 404, 'missing'
+    assert get_file('dir')['status'] == 404, 'directory'
+    assert get_file('dir/')['status'] == 404, 'slash'
+    assert get_file(f'{temp_dir}/files')['status'] in [403, 404], 'root'
+
+
+def test_python_sendfile_outside(temp_dir):
+    resp = get_file(f'{temp_dir}/secret.txt')
+    assert resp['status'] == 403, 'absolute'
+
+    for path in ['../secret.txt', 'dir/../../secret.txt']:
+        resp = get_file(path)
+        assert resp['status'] in [403, 404], path
+        assert 'secret' not in resp['body'], path
+
+
+def test_python_sendfile_disabled(temp_dir):
+    assert 'success' in client.conf_delete(
+        'applications/sendfile/sendfile_root'
+    )
+
+    resp = get_file('file.txt')
+    assert resp['status'] == 200, 'status'
+    assert resp['body'] == 'app body', 'body'
+    assert resp['headers']['X-Sendfile'] == 'file.txt', 'passed'
+
+
+def test_python_sendfile_configuration():
+    assert 'error' in client.conf(
+        '"files"', 'applications/sendfile/sendfile_root'
+    ), 'relative'
+    assert 'error' in client.conf(
+        '""', 'applications/sendfile/sendfile_root'
+    ), 'empty'
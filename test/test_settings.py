@@ -387,6 +387,37 @@ def test_settings_max_body_size_large():
     assert resp['body'] == body, 'status body 32'
 
 
+def test_settings_cpu_affinity():
+    client.load('empty')
+
+    assert 'success' in client.conf({}, 'settings')
+
+    for cpus in ['auto', '0', '0-0', '0,0']:
+        assert 'success' in client.conf(
+            f'"{cpus}"', 'settings/cpu_affinity'
+        ), f'cpu_affinity {cpus}'
+        assert client.get()['status'] == 200
+
+    assert 'success' in client.conf_delete('settings/cpu_affinity')
+    assert client.get()['status'] == 200
+
+    for cpus in ['', 'any', '1-0', '0,', '-1', '0-', '1024']:
+        assert 'error' in client.conf(
+            f'"{cpus}"', 'settings/cpu_affinity'
+        ), f'cpu_affinity invalid {cpus}'
+
+    assert 'error' in client.conf('0', 'settings/cpu_affinity')
+
+    assert 'success' in client.conf(
+        '"0"', 'applications/empty/cpu_affinity'
+    ), 'application cpu_affinity'
+    assert client.get()['status'] == 200
+
+    assert 'error' in client.conf(
+        '"0-"', 'applications/empty/cpu_affinity'
+    ), 'application cpu_affinity invalid'
+
+
 @pytest.mark.skip('not yet')
 def test_settings_negative_value():
     assert 'error' in client.conf(
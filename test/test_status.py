@@ -152,13 +152,19 @@ def test_status_applications():
         assert apps == expert.sort()
 
     def check_application(name, running, starting, idle, active):
-        assert Status.get(f'/applications/{name}') == {
+        status = Status.get(f'/applications/{name}')
+        del status['shm']
+        del status['latency']
+
+        assert status['requests']['active'] == active
+        del status['requests']
+
+        assert status == {
             'processes': {
                 'running': running,
                 'starting': starting,
                 'idle': idle,
             },
-            'requests': {'active': active},
         }
 
     client.load('delayed')
@@ -210,10 +216,11 @@ def test_status_applications():
     check_application('restart', 0, 0, 0, 0)
     check_application('delayed', 0, 0, 0, 0)
 
-    client.get(read_timeout=1)
+    (_, sock) = client.get(start=True, read_timeout=1)
 
     check_application('restart', 0, 1, 0, 1)
     check_application('delayed', 0, 0, 0, 0)
+    sock.close()
 
 
 def test_status_proxy():
@@ -240,3 +247,323 @@ def test_status_proxy():
     assert client.get()['status'] == 200
     check_connections(2, 0, 0, 2)
     assert Status.get('/requests/total') == 2, 'proxy'
+
+
+def test_status_shm():
+    app = app_default("mirror")
+    app['limits'] = {'shm_segment': 65536, 'shm_huge_pages': True}
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "applications/mirror"}},
+            "routes": [],
+            "applications": {"mirror": app},
+        },
+    )
+
+    body = '0123456789' * 50000
+
+    resp = client.post(body=body, read_buffer_size=1024 * 1024)
+    assert resp['status'] == 200
+    assert resp['body'] == body
+
+    shm = client.conf_get('/status/applications/mirror/shm')
+    assert shm['segments'] >= 2, 'segments'
+    assert shm['chunks'] == shm['segments'] * 4, 'chunks'
+    assert shm['busy'] <= shm['chunks'], 'busy'
+    assert shm['oosm'] >= 0, 'oosm'
+
+
+def test_status_shm_segment_invalid():
+    def check_segment(size):
+        return client.conf(size, 'applications/empty/limits/shm_segment')
+
+    app = app_default()
+    app['limits'] = {}
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "applications/empty"}},
+            "routes": [],
+            "applications": {"empty": app},
+        },
+    )
+
+    assert 'success' in check_segment('16384')
+    assert 'success' in check_segment('10485760')
+    assert 'error' in check_segment('16383')
+    assert 'error' in check_segment('10485761')
+    assert 'error' in check_segment('"1m"')
+
+
+def test_status_latency(skip_alert):
+    skip_alert(r'Python failed to import module "blah"')
+
+    app = app_default("threads")
+    app['limits'] = {'timeout': 1}
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {
+                "*:7080": {"pass": "applications/threads"},
+                "*:7081": {"pass": "applications/blah"},
+            },
+            "routes": [],
+            "applications": {
+                "threads": app,
+                "blah": {
+                    "type": client.get_application_type(),
+                    "processes": {"spare": 0},
+                    "module": "blah",
+                },
+            },
+        },
+    )
+
+    Status.init()
+
+    for _ in range(3):
+        assert client.get()['status'] == 200
+
+    assert (
+        client.get(
+            headers={
+                'Host': 'localhost',
+                'X-Delay': '2',
+                'Connection': 'close',
+            },
+        )['status']
+        == 503
+    )
+
+    assert client.get(port=7081)['status'] == 503
+
+    requests = Status.get('/applications/threads/requests')
+    assert requests['completed'] == 3, 'completed'
+    assert requests['timed_out'] == 1, 'timed out'
+    assert requests['failed'] == 0, 'no failures'
+
+    assert Status.get('/applications/blah/requests/failed') == 1, 'failed'
+
+    latency = client.conf_get('/status/applications/threads/latency')
+
+    for name in ('queue_wait', 'service_time', 'total_time'):
+        hist = latency[name]
+        buckets = list(hist['buckets'].values())
+
+        assert buckets == sorted(buckets), f'{name} cumulative'
+        assert hist['buckets']['+Inf'] == hist['count'], f'{name} count'
+
+    assert latency['queue_wait']['count'] == 4, 'queue wait count'
+    assert latency['service_time']['count'] == 3, 'service time count'
+    assert latency['total_time']['count'] == 3, 'total time count'
+    assert (
+        latency['total_time']['sum'] >= latency['service_time']['sum']
+    ), 'total time includes service time'
+
+
+def test_status_traffic():
+    assert 'success' in client.conf(
+        {
+            "listeners": {
+                "*:7080": {"pass": "routes/main"},
+                "*:7081": {"pass": "applications/mirror"},
+            },
+            "routes": {
+                "main": [
+                    {"match": {"uri": "/ok"}, "action": {"return": 200}},
+                    {"action": {"return": 404}},
+                ],
+            },
+            "applications": {"mirror": app_default("mirror")},
+        },
+    )
+
+    Status.init()
+
+    assert client.get(url='/ok')['status'] == 200
+    assert client.get(url='/ok')['status'] == 200
+    assert client.get(url='/missing')['status'] == 404
+
+    body = '0123456789'
+    resp = client.post(port=7081, body=body)
+    assert resp['status'] == 200
+    assert resp['body'] == body
+
+    listeners = Status.get('/listeners')
+
+    assert listeners['*:7080']['requests'] == 3, 'listener requests'
+    assert listeners['*:7080']['responses'] == {
+        '1xx': 0,
+        '2xx': 2,
+        '3xx': 0,
+        '4xx': 1,
+        '5xx': 0,
+    }, 'listener responses'
+    assert 'tls' not in listeners['*:7080'], 'no tls'
+
+    assert listeners['*:7081']['requests'] == 1
+    assert listeners['*:7081']['bytes'] == {
+        'in': len(body),
+        'out': len(body),
+    }, 'listener bytes'
+    assert listeners['*:7081']['responses']['2xx'] == 1
+
+    routes = Status.get('/routes')
+
+    assert routes['routes/main/0']['requests'] == 2, 'route step requests'
+    assert routes['routes/main/0']['responses']['2xx'] == 2
+    assert routes['routes/main/1']['requests'] == 1
+    assert routes['routes/main/1']['responses']['4xx'] == 1
+
+
+def test_status_metrics():
+    def metrics():
+        resp = client.get(
+            url='/status/metrics',
+            sock_type='unix',
+            addr=f'{option.temp_dir}/control.unit.sock',
+        )
+        assert resp['status'] == 200
+        assert resp['headers']['Content-Type'].startswith(
+            'application/openmetrics-text'
+        ), 'content type'
+        assert resp['body'].endswith('# EOF\n'), 'EOF'
+
+        return {
+            name: float(value)
+            for name, value in (
+                line.rsplit(' ', 1)
+                for line in resp['body'].splitlines()
+                if not line.startswith('#')
+            )
+        }
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {
+                "*:7080": {"pass": "routes"},
+                "*:7081": {"pass": "applications/empty"},
+            },
+            "routes": [{"action": {"return": 200}}],
+            "applications": {
+                "empty": app_default(),
+                'esc"ape\\': app_default(),
+            },
+        },
+    )
+
+    before = metrics()
+
+    assert client.get()['status'] == 200
+    assert client.get(port=7081)['status'] == 200
+
+    after = metrics()
+
+    def diff(name):
+        return after[name] - before[name]
+
+    app = 'application="empty"'
+
+    assert diff('unit_requests_total') == 2, 'requests'
+    assert diff('unit_connections_accepted_total') == 2, 'accepted'
+    assert diff('unit_listener_requests_total{listener="*:7080"}') == 1
+    assert (
+        diff('unit_route_responses_total{route="routes/0",code="2xx"}') == 1
+    ), 'route responses'
+    assert (
+        diff(f'unit_application_requests_total{{{app},outcome="completed"}}')
+        == 1
+    ), 'completed'
+    assert after[f'unit_application_processes_running{{{app}}}'] == 1
+    assert (
+        diff(f'unit_application_request_seconds_bucket{{{app},le="+Inf"}}')
+        == 1
+    ), 'histogram'
+    assert diff(f'unit_application_request_seconds_count{{{app}}}') == 1
+    assert diff(f'unit_application_request_seconds_sum{{{app}}}') > 0
+
+    assert (
+        'unit_application_processes_running{application="esc\\"ape\\\\"}'
+        in after
+    ), 'escaping'
+
+
+def test_status_scaling():
+    app = app_default("delayed")
+    app['processes'] = {
+        "max": 4,
+        "spare": 0,
+        "idle_timeout": 1,
+        "policy": "adaptive",
+        "cooldown": 1,
+    }
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "applications/delayed"}},
+            "routes": [],
+            "applications": {"delayed": app},
+        },
+    )
+
+    scaling = client.conf_get('/status/applications/delayed/scaling')
+    assert scaling['policy'] == 'adaptive', 'policy'
+    assert scaling['started'] == 0, 'no starts'
+    assert scaling['reason'] == 'none', 'no reason'
+
+    socks = []
+    for _ in range(4):
+        socks.append(
+            client.get(
+                headers={
+                    'Host': 'localhost',
+                    'X-Delay': '1',
+                    'Connection': 'close',
+                },
+                no_recv=True,
+            )
+        )
+
+    for sock in socks:
+        assert client._resp_to_dict(client.recvall(sock).decode())[
+            'status'
+        ] == 200
+        sock.close()
+
+    scaling = client.conf_get('/status/applications/delayed/scaling')
+    assert scaling['started'] >= 2, 'scaled up'
+    assert scaling['reason'].startswith(('start:', 'hold:')), 'reason'
+    assert scaling['service_time'] > 0, 'service time'
+
+    for _ in range(50):
+        if client.conf_get('/status/applications/delayed/processes/running') == 0:
+            break
+
+        time.sleep(0.2)
+
+    scaling = client.conf_get('/status/applications/delayed/scaling')
+    assert client.conf_get('/status/applications/delayed/processes/running') == 0
+    assert scaling['stopped'] >= 1, 'scaled down'
+    assert scaling['reason'] == 'stop: idle', 'stop reason'
+
+
+def test_status_scaling_invalid():
+    def check_processes(processes):
+        return client.conf(processes, 'applications/empty/processes')
+
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "applications/empty"}},
+            "routes": [],
+            "applications": {"empty": app_default()},
+        },
+    )
+
+    assert 'scaling' not in client.conf_get('/status/applications/empty'), 'static'
+
+    assert 'success' in check_processes({"policy": "static"})
+    assert 'success' in check_processes({"policy": "adaptive", "cooldown": 0})
+    assert 'error' in check_processes({"policy": "fast"})
+    assert 'error' in check_processes({"cooldown": -1})
+    assert 'error' in check_processes({"cooldown": "1s"})
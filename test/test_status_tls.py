@@ -1,3 +1,6 @@
+import socket
+import time
+
 from unit.applications.tls import ApplicationTLS
 from unit.status import Status
 
@@ -6,7 +9,7 @@ prerequisites = {'modules': {'openssl': 'any'}}
 client = ApplicationTLS()
 
 
-def test_status_tls_requests():
+def conf_tls():
     client.certificate()
 
     assert 'success' in client.conf(
@@ -23,9 +26,47 @@ def test_status_tls_requests():
         }
     )
 
+
+def test_status_tls_requests():
+    conf_tls()
+
     Status.init()
 
     assert client.get()['status'] == 200
     assert client.get_ssl(port=7081)['status'] == 200
 
     assert Status.get('/requests/total') == 2
+
+
+def test_status_tls_handshakes():
+    def check_handshakes(handshakes, failures):
+        for _ in range(50):
+            tls = Status.get('/listeners')['*:7081']['tls']
+
+            if tls == {'handshakes': handshakes, 'failures': failures}:
+                break
+
+            time.sleep(0.1)
+
+        assert tls == {'handshakes': handshakes, 'failures': failures}
+
+    conf_tls()
+
+    Status.init()
+
+    assert client.get_ssl(port=7081)['status'] == 200
+    check_handshakes(1, 0)
+
+    # completed handshake without a request
+
+    sock = socket.create_connection(('127.0.0.1', 7081))
+    sock = client._default_context.wrap_socket(sock)
+    sock.close()
+    check_handshakes(2, 0)
+
+    # broken ClientHello
+
+    sock = socket.create_connection(('127.0.0.1', 7081))
+    sock.sendall(b'\x16\x03\x01\x00\x05hello')
+    sock.close()
+    check_handshakes(2, 1)
@@ -1,4 +1,5 @@
 import io
+import socket
 import ssl
 import subprocess
 import time
@@ -6,6 +7,7 @@ import time
 import pytest
 from unit.applications.tls import ApplicationTLS
 from unit.option import option
+from unit.status import Status
 
 prerequisites = {'modules': {'python': 'any', 'openssl': 'any'}}
 
@@ -536,6 +538,30 @@ def test_tls_keepalive():
     assert resp['body'] == '0123456789', 'keepalive 2'
 
 
+def test_tls_status():
+    client.load('empty')
+
+    client.certificate()
+
+    add_tls()
+
+    Status.init()
+
+    assert client.get_ssl()['status'] == 200, 'handshake 1'
+    assert client.get_ssl()['status'] == 200, 'handshake 2'
+
+    sock = socket.create_connection(('127.0.0.1', 7080))
+    sock.sendall(b'\x16\x03\x01\x00\x01\x00')
+    sock.close()
+
+    time.sleep(0.5)
+
+    listener = Status.get('/listeners/*:7080')
+
+    assert listener['requests'] == 2, 'requests'
+    assert listener['tls'] == {'handshakes': 2, 'failures': 1}, 'tls'
+
+
 def test_tls_no_close_notify():
     client.certificate()
 
@@ -702,3 +728,53 @@ def test_tls_multi_listener():
     assert client.get_ssl()['status'] == 200, 'listener #1'
 
     assert client.get_ssl(port=7081)['status'] == 200, 'listener #2'
+
+
+def test_tls_reconfigure_keep_contexts():
+    client.load('empty')
+
+    client.certificate()
+
+    assert 'success' in client.conf(
+        {
+            "pass": "applications/empty",
+            "tls": {"certificate": "default", "session": {"cache_size": 10}},
+        },
+        'listeners/*:7080',
+    )
+
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+    context.check_hostname = False
+    context.verify_mode = ssl.CERT_NONE
+    context.maximum_version = ssl.TLSVersion.TLSv1_2
+    context.options |= ssl.OP_NO_TICKET
+
+    def connect(session=None):
+        sock = socket.create_connection(('127.0.0.1', 7080))
+        sock = context.wrap_socket(sock, session=session)
+        reused = sock.session_reused
+        session = sock.session
+        sock.close()
+
+        return session, reused
+
+    session, reused = connect()
+    assert not reused, 'new session'
+
+    _, reused = connect(session)
+    assert reused, 'session reused'
+
+    assert 'success' in client.conf([{"action": {"return": 204}}], 'routes')
+    assert 'success' in client.conf('"routes"', 'listeners/*:7080/pass')
+
+    _, reused = connect(session)
+    assert reused, 'session reused after reconfiguration'
+
+    assert client.get_ssl()['status'] == 204, 'new routes'
+
+    assert 'success' in client.conf(
+        '11', 'listeners/*:7080/tls/session/cache_size'
+    )
+
+    _, reused = connect(session)
+    assert not reused, 'tls changed'
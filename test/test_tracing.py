@@ -0,0 +1,198 @@
+import json
+import time
+from pathlib import Path
+
+from unit.applications.lang.python import ApplicationPython
+from unit.option import option
+
+prerequisites = {'modules': {'python': 'any'}}
+
+client = ApplicationPython()
+
+TRACE_ID = '4bf92f3577b34da6a3ce929d0e0e4736'
+PARENT_ID = '00f067aa0ba902b7'
+
+
+def set_tracing(sampling=None):
+    tracing = {'path': f'{option.temp_dir}/trace.json'}
+
+    if sampling is not None:
+        tracing['sampling'] = sampling
+
+    assert 'success' in client.conf(tracing, 'tracing'), 'tracing'
+
+
+def traces(count):
+    path = Path(f'{option.temp_dir}/trace.json')
+
+    for _ in range(50):
+        if path.exists():
+            lines = path.read_text(encoding='utf-8').splitlines()
+
+            if len(lines) >= count:
+                return [json.loads(line) for line in lines]
+
+        time.sleep(0.1)
+
+    return []
+
+
+def spans(trace):
+    scope_spans = trace['resourceSpans'][0]['scopeSpans'][0]
+    assert scope_spans['scope']['name'] == 'unit'
+
+    return {span['name']: span for span in scope_spans['spans']}
+
+
+def attrs(span):
+    return {
+        attr['key']: list(attr['value'].values())[0]
+        for attr in span['attributes']
+    }
+
+
+def test_tracing_spans():
+    client.load('delayed')
+
+    set_tracing()
+
+    assert (
+        client.get(
+            url='/trace',
+            headers={
+                'Host': 'localhost',
+                'X-Delay': '1',
+                'Connection': 'close',
+            },
+        )['status']
+        == 200
+    )
+
+    trace = traces(1)
+    assert len(trace) == 1, 'trace written'
+
+    resource = trace[0]['resourceSpans'][0]['resource']
+    assert attrs(resource) == {'service.name': 'unit'}, 'resource'
+
+    s = spans(trace[0])
+    request = s['GET']
+
+    assert request['kind'] == 2, 'server span'
+    assert request['parentSpanId'] == '', 'root span'
+    assert attrs(request) == {
+        'http.request.method': 'GET',
+        'http.response.status_code': '200',
+        'url.path': '/trace',
+    }, 'request attributes'
+
+    for name in ['request_header', 'request_body', 'queue', 'application']:
+        span = s[name]
+
+        assert span['kind'] == 1, f'{name} kind'
+        assert span['traceId'] == request['traceId'], f'{name} trace'
+        assert span['parentSpanId'] == request['spanId'], f'{name} parent'
+        assert int(span['startTimeUnixNano']) <= int(span['endTimeUnixNano'])
+
+    assert 'upstream' not in s, 'no upstream'
+
+    application = s['application']
+    assert (
+        int(application['endTimeUnixNano'])
+        - int(application['startTimeUnixNano'])
+        >= 1000000000
+    ), 'application time'
+
+    assert int(request['startTimeUnixNano']) <= int(
+        s['request_header']['startTimeUnixNano']
+    ), 'request start'
+
+
+def test_tracing_traceparent():
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "routes"}},
+            "routes": [{"action": {"return": 204}}],
+        }
+    )
+
+    set_tracing(sampling=0)
+
+    assert client.get(url='/none')['status'] == 204
+
+    def traceparent(flags):
+        return client.get(
+            headers={
+                'Host': 'localhost',
+                'Traceparent': f'00-{TRACE_ID}-{PARENT_ID}-{flags}',
+                'Connection': 'close',
+            }
+        )
+
+    assert traceparent('00')['status'] == 204
+    assert traceparent('01')['status'] == 204
+
+    trace = traces(1)
+    assert len(trace) == 1, 'only the sampled parent'
+
+    s = spans(trace[0])
+    request = s['GET']
+
+    assert request['traceId'] == TRACE_ID, 'trace id'
+    assert request['parentSpanId'] == PARENT_ID, 'parent span id'
+    assert attrs(request)['http.response.status_code'] == '204'
+    assert s['route']['parentSpanId'] == request['spanId'], 'route span'
+
+
+def test_tracing_traceparent_invalid():
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "routes"}},
+            "routes": [{"action": {"return": 204}}],
+        }
+    )
+
+    set_tracing(sampling=1)
+
+    invalid = [
+        f'00-{TRACE_ID.upper()}-{PARENT_ID}-01',
+        f'00-{TRACE_ID}-{PARENT_ID.upper()}-01',
+        f'00-{"0" * 32}-{PARENT_ID}-01',
+        f'00-{TRACE_ID}-{"0" * 16}-01',
+        f'ff-{TRACE_ID}-{PARENT_ID}-01',
+        f'0g-{TRACE_ID}-{PARENT_ID}-01',
+        f'00-{TRACE_ID}-{PARENT_ID}-01-extra',
+        f'01-{TRACE_ID}-{PARENT_ID}-01extra',
+    ]
+
+    for value in invalid:
+        assert (
+            client.get(
+                headers={
+                    'Host': 'localhost',
+                    'Traceparent': value,
+                    'Connection': 'close',
+                }
+            )['status']
+            == 204
+        )
+
+    trace = traces(len(invalid))
+    assert len(trace) == len(invalid), 'all sampled'
+
+    for t in trace:
+        request = spans(t)['GET']
+
+        assert request['traceId'] != TRACE_ID, 'new trace'
+        assert request['parentSpanId'] == '', 'root span'
+
+
+def test_tracing_invalid():
+    def check_error(conf):
+        assert 'error' in client.conf(conf, 'tracing')
+
+    check_error({})
+    check_error({'path': ''})
+    check_error({'path': f'{option.temp_dir}/trace.json', 'sampling': 2})
+    check_error({'path': f'{option.temp_dir}/trace.json', 'sampling': -1})
+    check_error({'path': f'{option.temp_dir}/trace.json', 'blah': 1})
+    check_error('"path"')
@@ -0,0 +1,59 @@
+import os
+
+import pytest
+from unit.applications.proto import ApplicationProto
+from unit.option import option
+
+client = ApplicationProto()
+
+
+@pytest.fixture(autouse=True)
+def setup_method_fixture():
+    executable = f'{option.current_dir}/build/unit_app_test'
+
+    if not os.path.exists(executable):
+        pytest.skip('unit_app_test is not built')
+
+    assert 'success' in client.conf(
+        {
+            "settings": {"http": {"body_buffer_size": 2 * 1024 * 1024}},
+            "listeners": {"*:7080": {"pass": "applications/poll"}},
+            "applications": {
+                "poll": {
+                    "type": "external",
+                    "processes": 1,
+                    "executable": executable,
+                    "arguments": ["-p"],
+                    "limits": {"shm_segment": 65536},
+                }
+            },
+        }
+    )
+
+
+def test_unit_app_poll(wait_for_record):
+    for _ in range(10):
+        assert client.get()['status'] == 200, 'get'
+
+    # the body exceeds the shared memory segment, so its tail
+    # follows the request headers through the port queue
+
+    body = '0123456789' * 10000
+
+    for _ in range(5):
+        resp = client.post(body=body, read_timeout=5)
+        assert resp['status'] == 200, 'post'
+        assert 'Body:' in resp['body'], 'post body'
+
+    assert client.get()['status'] == 200, 'get after post'
+
+    # QUIT is delivered through the port queue
+
+    assert 'success' in client.conf(
+        {"listeners": {}, "applications": {}}
+    ), 'remove application'
+
+    assert (
+        wait_for_record(r'app process \d+ exited with code 0', wait=50)
+        is not None
+    ), 'application quit'
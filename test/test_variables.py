@@ -79,6 +79,50 @@ Connection: close
     assert wait_for_record(r'\/r_time_2 [1-9]\.\d{3}', 'access.log') is not None
 
 
+def test_variables_phase_time(wait_for_record):
+    set_format(
+        '$uri $request_header_time $route_time $queue_time $app_time '
+        '$upstream_time'
+    )
+
+    sock = client.http(b'GET /phase_1 HTTP/1.1\r\n', raw=True, no_recv=True)
+
+    time.sleep(1)
+
+    client.http(
+        b"""Host: localhost
+Connection: close
+
+""",
+        sock=sock,
+        raw=True,
+    )
+    assert (
+        wait_for_record(r'\/phase_1 [1-9]\.\d{3} 0\.\d{3} - - -', 'access.log')
+        is not None
+    )
+
+    client_python.load('delayed')
+
+    set_format('$uri $queue_time $app_time $upstream_time')
+
+    assert (
+        client_python.get(
+            url='/phase_2',
+            headers={
+                'Host': 'localhost',
+                'X-Delay': '1',
+                'Connection': 'close',
+            },
+        )['status']
+        == 200
+    )
+    assert (
+        wait_for_record(r'\/phase_2 0\.\d{3} [1-9]\.\d{3} -', 'access.log')
+        is not None
+    )
+
+
 def test_variables_method(search_in_file, wait_for_record):
     set_format('$method')
 
@@ -290,6 +334,34 @@ def test_variables_many(search_in_file, wait_for_record):
     set_format('$method$method')
     check_vars('/', 'GETGET')
 
+    set_format(' '.join(['$uri'] * 20))
+    check_vars('/4', ' '.join(['/4'] * 20))
+
+
+def test_variables_single():
+    assert 'success' in client.conf(
+        {
+            "listeners": {"*:7080": {"pass": "routes"}},
+            "routes": [
+                {
+                    "action": {
+                        "return": 301,
+                        "location": "$request_uri",
+                        "response_headers": {
+                            "X-Host": "$host",
+                            "X-Foo": "$header_foo",
+                        },
+                    }
+                }
+            ],
+        }
+    )
+
+    resp = client.get(url='/single?a=b')
+    assert resp['headers']['Location'] == '/single?a=b'
+    assert resp['headers']['X-Host'] == 'localhost'
+    assert resp['headers']['X-Foo'] == ''
+
 
 def test_variables_dynamic(wait_for_record):
     set_format('$header_foo$cookie_foo$arg_foo')
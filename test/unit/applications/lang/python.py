@@ -48,7 +48,9 @@ class ApplicationPython(ApplicationProto):
             'home',
             'limits',
             'path',
+            'preload',
             'protocol',
+            'restart',
             'targets',
             'threads',
             'prefix',
@@ -0,0 +1,228 @@
+import json
+import os
+import socket
+import time
+from multiprocessing import Process, Queue
+
+from unit.option import option
+
+
+class Perf:
+    """Closed-loop HTTP/1.1 load generator and baseline comparison.
+
+    Each connection is driven by a separate process that sends a request,
+    reads the whole response and sends the next one, so the concurrency
+    equals the number of connections.  Without keepalive every request is
+    sent over a new connection with "Connection: close".
+    """
+
+    metrics = ('rps', 'p50', 'p99', 'p999')
+
+    def __init__(self, port=7080, host='127.0.0.1'):
+        self.port = port
+        self.host = host
+
+    def run(
+        self,
+        url='/',
+        keepalive=True,
+        duration=None,
+        connections=None,
+        headers=None,
+    ):
+        duration = option.perf_duration if duration is None else duration
+        connections = (
+            option.perf_connections if connections is None else connections
+        )
+
+        request = self._request(url, keepalive, headers)
+
+        queue = Queue()
+        start = time.monotonic() + 0.5
+        workers = []
+
+        for _ in range(connections):
+            worker = Process(
+                target=self._worker,
+                args=(queue, request, keepalive, start, start + duration),
+            )
+            worker.start()
+            workers.append(worker)
+
+        latencies = []
+        errors = 0
+
+        for _ in workers:
+            result = queue.get(timeout=duration + 30)
+            latencies.extend(result['latencies'])
+            errors += result['errors']
+
+        for worker in workers:
+            worker.join()
+
+        return self._summary(latencies, errors, duration)
+
+    def _request(self, url, keepalive, headers):
+        fields = {
+            'Host': 'localhost',
+            'Connection': 'keep-alive' if keepalive else 'close',
+        }
+
+        if headers is not None:
+            fields.update(headers)
+
+        request = f'GET {url} HTTP/1.1\r\n'
+
+        for name, value in fields.items():
+            request += f'{name}: {value}\r\n'
+
+        return f'{request}\r\n'.encode()
+
+    def _connect(self):
+        sock = socket.create_connection((self.host, self.port), timeout=10)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+        return sock
+
+    def _worker(self, queue, request, keepalive, start, end):
+        latencies = []
+        errors = 0
+        sock = None
+
+        while time.monotonic() < start:
+            time.sleep(0.01)
+
+        while time.monotonic() < end:
+            begin = time.perf_counter_ns()
+
+            try:
+                if sock is None:
+                    sock = self._connect()
+
+                sock.sendall(request)
+
+                if not self._read_response(sock, keepalive):
+                    errors += 1
+
+                if not keepalive:
+                    sock.close()
+                    sock = None
+
+            except OSError:
+                errors += 1
+
+                if sock is not None:
+                    sock.close()
+                    sock = None
+
+                continue
+
+            latencies.append(time.perf_counter_ns() - begin)
+
+        if sock is not None:
+            sock.close()
+
+        queue.put({'latencies': latencies, 'errors': errors})
+
+    def _read_response(self, sock, keepalive):
+        data = b''
+
+        while b'\r\n\r\n' not in data:
+            chunk = sock.recv(16384)
+            if not chunk:
+                return False
+
+            data += chunk
+
+        head, body = data.split(b'\r\n\r\n', 1)
+
+        if not head.startswith(b'HTTP/1.1 200'):
+            return False
+
+        length = None
+
+        for line in head.split(b'\r\n')[1:]:
+            name, value = line.split(b':', 1)
+
+            if name.strip().lower() == b'content-length':
+                length = int(value)
+
+        if length is None:
+            if keepalive:
+                return False
+
+            length = float('inf')
+
+        while len(body) < length:
+            chunk = sock.recv(65536)
+            if not chunk:
+                return length == float('inf')
+
+            body += chunk
+
+        return True
+
+    def _summary(self, latencies, errors, duration):
+        latencies.sort()
+
+        def percentile(p):
+            if not latencies:
+                return None
+
+            i = min(len(latencies) - 1, int(len(latencies) * p))
+
+            return round(latencies[i] / 1e6, 3)
+
+        return {
+            'requests': len(latencies),
+            'errors': errors,
+            'rps': round(len(latencies) / duration, 1),
+            'p50': percentile(0.5),
+            'p99': percentile(0.99),
+            'p999': percentile(0.999),
+        }
+
+    @staticmethod
+    def load_baseline(path):
+        if path is None or not os.path.isfile(path):
+            return {}
+
+        with open(path, 'r') as f:
+            return json.load(f)
+
+    @staticmethod
+    def save_baseline(path, name, result):
+        baseline = Perf.load_baseline(path)
+        baseline[name] = {m: result[m] for m in Perf.metrics}
+
+        with open(path, 'w') as f:
+            json.dump(baseline, f, indent=4, sort_keys=True)
+            f.write('\n')
+
+    @staticmethod
+    def compare(baseline, result, tolerance):
+        """Returns the metrics that regressed beyond the tolerance.
+
+        Throughput must not drop and p50/p99 latencies must not grow by more
+        than the tolerance.  The p999 latency is reported but not compared:
+        in short runs it is dominated by a handful of samples.
+        """
+
+        regressions = []
+
+        if result['rps'] < baseline['rps'] * (1 - tolerance):
+            regressions.append(
+                f'rps {result["rps"]} < baseline {baseline["rps"]}'
+            )
+
+        for metric in ('p50', 'p99'):
+            if baseline.get(metric) is None or result[metric] is None:
+                continue
+
+            if result[metric] > baseline[metric] * (1 + tolerance):
+                regressions.append(
+                    f'{metric} {result[metric]}ms > '
+                    f'baseline {baseline[metric]}ms'
+                )
+
+        return regressions
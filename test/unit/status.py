@@ -15,6 +15,8 @@ class Status:
             },
             'requests': {'total': 0},
             'applications': {},
+            'listeners': {},
+            'routes': {},
         }
 
     def init(status=None):